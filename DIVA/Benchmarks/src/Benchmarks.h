@@ -0,0 +1,59 @@
+//===-- Benchmarks/Benchmarks.h ---------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declarations of the benchmarks and some helpers for
+/// timing them.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+/// \brief Get the path to a file in the Examples directory.
+std::string getExampleFilePath(const std::string &FileName);
+
+/// \brief Time how long a function takes to run, in seconds.
+template <typename FuncTy> double timeRun(FuncTy Func) {
+  auto Start = std::chrono::steady_clock::now();
+  Func();
+  std::chrono::duration<double> Elapsed =
+      std::chrono::steady_clock::now() - Start;
+  return Elapsed.count();
+}
+
+/// \brief Print the result of a timed run over Count items.
+void reportResult(const std::string &Name, size_t Count, double Seconds);
+
+/// \brief Compare walking the DIE tree with DwarfDieChildIterator and
+/// DwarfDieChildCursor. The input is scaled up by walking it Scale times.
+///
+/// Returns false if the iterators didn't visit the same number of DIEs.
+bool benchmarkDieIteration(unsigned Scale);
+
+#endif // BENCHMARKS_H
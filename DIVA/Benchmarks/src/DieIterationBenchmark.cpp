@@ -0,0 +1,100 @@
+//===-- Benchmarks/DieIterationBenchmark.cpp --------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains a benchmark of the ways to walk a tree of DIEs.
+///
+//===----------------------------------------------------------------------===//
+
+#include "Benchmarks.h"
+#include "FileUtilities.h"
+#include "LibDwarfHelpers.h"
+#include "NativeDwarfDecoder.h"
+
+#include <iostream>
+
+using namespace ElfDwarfReader;
+
+namespace {
+
+// Count the Dies in a subtree, allocating a shared DwarfDie for each child.
+size_t countWithIterator(const DwarfDie &Die) {
+  size_t Count = 1U;
+  for (auto IT = Die.childrenBegin(), End = Die.childrenEnd(); IT != End; ++IT)
+    Count += countWithIterator(*IT);
+  return Count;
+}
+
+// Count the Dies in a subtree, reusing one Die per depth.
+template <typename DieTy> size_t countWithCursor(const DieTy &Die) {
+  size_t Count = 1U;
+  for (typename DieTy::ChildCursor Child(Die); !Child.atEnd(); Child.next())
+    Count += countWithCursor(*Child);
+  return Count;
+}
+
+} // end anonymous namespace
+
+bool benchmarkDieIteration(unsigned Scale) {
+  std::string InputPath = getExampleFilePath("example_16_lto.elf");
+  std::cout << "DIE iteration: " << InputPath << " x " << Scale << "\n";
+
+  LibScopeView::FileDescriptor FD(InputPath);
+  DwarfDebugData DebugData(*FD);
+  auto CompileUnits = DebugData.getCompileUnits();
+
+  size_t IteratorCount = 0U;
+  double IteratorTime = timeRun([&]() {
+    for (unsigned Repeat = 0U; Repeat < Scale; ++Repeat)
+      for (const auto &CU : CompileUnits)
+        IteratorCount += countWithIterator(CU.CUDie);
+  });
+  reportResult("DwarfDieChildIterator", IteratorCount, IteratorTime);
+
+  size_t CursorCount = 0U;
+  double CursorTime = timeRun([&]() {
+    for (unsigned Repeat = 0U; Repeat < Scale; ++Repeat)
+      for (const auto &CU : CompileUnits)
+        CursorCount += countWithCursor(CU.CUDie);
+  });
+  reportResult("DwarfDieChildCursor", CursorCount, CursorTime);
+
+  // The native decoder, for reference.
+  size_t NativeCount = 0U;
+  if (auto Native = NativeDebugData::create(InputPath)) {
+    double NativeTime = timeRun([&]() {
+      for (unsigned Repeat = 0U; Repeat < Scale; ++Repeat)
+        for (const auto &Unit : Native->getUnits())
+          NativeCount += countWithCursor(Native->getDie(Unit.FirstDieOffset));
+    });
+    reportResult("NativeDieChildCursor", NativeCount, NativeTime);
+  }
+
+  if (CursorCount != IteratorCount ||
+      (NativeCount != 0U && NativeCount != IteratorCount)) {
+    std::cerr << "error: the iterators visited different numbers of DIEs\n";
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,63 @@
+//===-- Benchmarks/main.cpp -------------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Entry point for the benchmarks executable.
+///
+/// Usage: benchmarks [scale]
+///
+/// The scale is the number of times each benchmark repeats its input.
+///
+//===----------------------------------------------------------------------===//
+
+#include "Benchmarks.h"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+std::string getExampleFilePath(const std::string &FileName) {
+  return std::string(EXAMPLES_DIR) + "/" + FileName;
+}
+
+void reportResult(const std::string &Name, size_t Count, double Seconds) {
+  std::cout << std::left << std::setw(24) << Name << std::right
+            << std::setw(12) << Count << " in " << std::fixed
+            << std::setprecision(3) << Seconds << "s ("
+            << std::setprecision(1) << (Seconds * 1e9 / Count) << " ns each)\n";
+}
+
+int main(int argc, char **argv) {
+  unsigned Scale = 50000U;
+  if (argc > 1)
+    Scale = static_cast<unsigned>(std::strtoul(argv[1], nullptr, 10));
+  if (Scale == 0U) {
+    std::cerr << "Usage: benchmarks [scale]\n";
+    return 1;
+  }
+
+  bool Ok = benchmarkDieIteration(Scale);
+
+  return Ok ? 0 : 1;
+}
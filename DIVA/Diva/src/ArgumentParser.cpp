@@ -32,6 +32,7 @@
 #include <algorithm>
 #include <assert.h>
 #include <iterator>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 
@@ -206,6 +207,31 @@ const Argument Argument::stringArg(const char Shortcut, const std::string &Name,
       nullptr);
 }
 
+const Argument Argument::unsignedArg(const char Shortcut,
+                                     const std::string &Name,
+                                     const std::string &VarNameForHelp,
+                                     const std::string &Help,
+                                     const HelpLevel ArgHelpLevel,
+                                     unsigned &Value) {
+  std::string HelpSuffix("=<" + VarNameForHelp + ">");
+  auto ProcessFunc = [&Value, Name = LongArgumentPrefix + Name ](
+      const Parser &, const std::string &Opt) {
+    if (Opt.empty() || Opt.find_first_not_of("0123456789") != std::string::npos)
+      throw InvalidChoice(Name, Opt);
+    unsigned long long Parsed = 0;
+    try {
+      Parsed = std::stoull(Opt);
+    } catch (std::out_of_range &) {
+      throw InvalidChoice(Name, Opt);
+    }
+    if (Parsed > std::numeric_limits<unsigned>::max())
+      throw InvalidChoice(Name, Opt);
+    Value = static_cast<unsigned>(Parsed);
+  };
+  return Argument(Shortcut, Name, HelpSuffix, Help, ArgHelpLevel, nullptr,
+                  ProcessFunc, nullptr);
+}
+
 const Argument Argument::multiStringArg(const char Shortcut,
                                         const std::string &Name,
                                         const std::string &VarNameForHelp,
@@ -224,6 +224,20 @@ public:
                                   const HelpLevel ArgHelpLevel,
                                   std::string &Value);
 
+  /// \brief Create an Argument that sets an unsigned integer from the command
+  /// line.
+  ///
+  /// Passing a value that is not an unsigned integer results in an
+  /// InvalidChoice exception.
+  ///
+  /// e.g. --count=4
+  static const Argument unsignedArg(const char Shortcut,
+                                    const std::string &Name,
+                                    const std::string &VarNameForHelp,
+                                    const std::string &Help,
+                                    const HelpLevel ArgHelpLevel,
+                                    unsigned &Value);
+
   /// \brief Create an Argument that sets a vector of strings set from the
   /// command line.
   ///
@@ -31,6 +31,7 @@
 #include "ArgumentParser.h"
 #include "Error.h"
 #include "Platform.h"
+#include "PrintContext.h"
 
 namespace {
 
@@ -79,6 +80,8 @@ DivaOptions::DivaOptions(const std::vector<std::string> &CMDArgs,
                          std::ostream &) {
   // Set some initial defaults.
   QuietMode = false;
+  Jobs = 1;
+  OutputBufferSize = LibScopeView::PrintContext::DefaultBufferSize / 1024;
   ShowSummary = false;
   SplitOutput = false;
   SortKey = SortingKey::LINE;
@@ -107,6 +110,7 @@ DivaOptions::DivaOptions(const std::vector<std::string> &CMDArgs,
   ShowScopeAllocation = false;
   ShowStringPoolInfo = false;
   DumpStringPool = false;
+  Decoder = DwarfDecoder::LIBDWARF;
 
   // Parsing.
   try {
@@ -145,6 +149,12 @@ DivaOptions::DivaOptions(const std::vector<std::string> &CMDArgs,
     SortKey = SortingKey::OFFSET;
   if (SortKeyString == "name")
     SortKey = SortingKey::NAME;
+
+  // Set DWARF decoder.
+  if (DecoderString == "libdwarf")
+    Decoder = DwarfDecoder::LIBDWARF;
+  if (DecoderString == "native")
+    Decoder = DwarfDecoder::NATIVE;
 }
 
 void DivaOptions::parseArgs(const std::vector<std::string> &CMDArgs,
@@ -186,7 +196,10 @@ void DivaOptions::parseArgs(const std::vector<std::string> &CMDArgs,
                  HelpOrVersionPrinted = true;
                }),
       Argument::switchArg('q', "quiet", "Suppress output to stdout",
-                          GeneralHelp, QuietMode)
+                          GeneralHelp, QuietMode),
+      Argument::unsignedArg(NSC, "jobs", "N",
+                            "Number of threads used to read and print the "
+                            "input (0 uses all cores)", GeneralHelp, Jobs)
     }),
 
     ArgumentGroup("Output options", {
@@ -372,6 +385,15 @@ void DivaOptions::parseArgs(const std::vector<std::string> &CMDArgs,
       Argument::switchArg(NSC, "dump-string-pool",
                           "Print the entire string pool", DeveloperHelp,
                           DumpStringPool),
+      Argument::choiceArg(NSC, "dwarf-decoder",
+                          "Decoder used to read the DWARF debug information. "
+                          "By default the decoder is \"libdwarf\".",
+                          DeveloperHelp, {"libdwarf", "native"},
+                          DecoderString),
+      Argument::unsignedArg(NSC, "output-buffer-size", "KB",
+                            "Size of the buffer for the printed text (0 "
+                            "writes each line directly)", DeveloperHelp,
+                            OutputBufferSize),
     })
   });
   // clang-format on
@@ -526,6 +548,9 @@ DivaOptions::convertToViewSpecs() const {
     LibScopeView::ViewSpecification &Spec = Result.back();
     Spec.setID(std::to_string(++SpecID));
     Spec.setInputFile(InputFile);
+    Spec.setJobs(Jobs);
+    // The YAML output is printed from the whole tree.
+    Spec.setReadPruning(!OutputFormats.count(OutputFormat::YAML));
 
     if (SplitOutput) {
       if (OutputDirectory.empty())
@@ -546,6 +571,15 @@ DivaOptions::convertToViewSpecs() const {
       break;
     }
 
+    switch (Decoder) {
+    case DwarfDecoder::LIBDWARF:
+      Spec.setDecoderType(LibScopeView::DecoderType::dt_libdwarf);
+      break;
+    case DwarfDecoder::NATIVE:
+      Spec.setDecoderType(LibScopeView::DecoderType::dt_native);
+      break;
+    }
+
     for (const auto &Filter : Filters) {
       LibScopeView::Match FilterMatcher;
       FilterMatcher.Pattern = Filter;
@@ -582,6 +616,7 @@ DivaOptions::convertToViewSpecs() const {
       FilterMatcher.Mode = LibScopeView::MatchMode::mm_any;
       Spec.addTreePattern(FilterMatcher);
     }
+    Spec.compilePatterns();
   }
 
   return Result;
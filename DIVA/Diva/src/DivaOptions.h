@@ -41,6 +41,8 @@ enum class OutputFormat { TEXT, YAML };
 
 enum class SortingKey { LINE, OFFSET, NAME };
 
+enum class DwarfDecoder { LIBDWARF, NATIVE };
+
 /// \brief Class that parses command line arguments into DIVA's options (using
 /// ArgumentParser).
 ///
@@ -63,6 +65,8 @@ public:
 
   bool QuietMode;
   bool ShowSummary;
+  unsigned Jobs;
+  unsigned OutputBufferSize;
 
   bool SplitOutput;
   std::string OutputDirectory;
@@ -113,6 +117,7 @@ public:
   bool ShowScopeAllocation;
   bool ShowStringPoolInfo;
   bool DumpStringPool;
+  DwarfDecoder Decoder;
 
 private:
   void parseArgs(const std::vector<std::string> &CMDArgs, std::ostream &HelpOut,
@@ -127,6 +132,7 @@ private:
   // Some options need to be translated from input strings to enum values.
   std::set<std::string> OutputFormatStrings;
   std::string SortKeyString;
+  std::string DecoderString;
 };
 
 #endif // DIVAOPTIONS_H_
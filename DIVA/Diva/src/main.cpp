@@ -30,11 +30,14 @@
 #include "DivaOptions.h"
 #include "ElfDwarfReader.h"
 #include "Error.h"
+#include "PrintContext.h"
 #include "ScopeYAMLPrinter.h"
 #include "Utilities.h"
 #include "ViewSpecification.h"
 
+#include <iostream>
 #include <memory>
+#include <vector>
 
 namespace {
 
@@ -70,6 +73,10 @@ int main(int argc, char *argv[]) {
 
   auto ViewSpecs = Options.convertToViewSpecs();
 
+  // The output buffer size is given in KB.
+  LibScopeView::GlobalPrintContext->setBufferSize(
+      static_cast<size_t>(Options.OutputBufferSize) * 1024);
+
   std::map<std::string, std::unique_ptr<LibScopeView::Reader>> ReaderMap;
 
   // Create readers and load in the options.
@@ -95,28 +102,41 @@ int main(int argc, char *argv[]) {
                  MapPair.first, *AReader.getError());
   }
 
-  if (Options.ShowScopeAllocation)
+  if (Options.ShowScopeAllocation) {
     LibScopeView::printAllocationInfo();
+    for (auto &MapPair : ReaderMap)
+      MapPair.second->getArena().printAllocationInfo(
+          MapPair.second->getInputFile());
+  }
 
   // Print the scope views in the readers.
   for (auto &MapPair : ReaderMap) {
     LibScopeView::Reader &AReader = *MapPair.second;
+    // YAML_OUTPUT_VERSION_STR is defined by CMake.
+    LibScopeView::ScopeYAMLPrinter YAMLPrinter(AReader.getInputFile(),
+                                               YAML_OUTPUT_VERSION_STR);
+    YAMLPrinter.setJobs(AReader.getJobCount());
+    bool PrintYAML = Options.OutputFormats.count(OutputFormat::YAML) != 0;
+    // Split YAML output is printed in the same walk over the tree as the
+    // Logical View. On stdout the YAML follows all of the text, so it is
+    // printed after it rather than kept until then.
+    std::vector<LibScopeView::ScopePrinter *> Printers;
+    if (PrintYAML && AReader.getOptions().getViewSplit()) {
+      YAMLPrinter.setOutputDir(AReader.getPrintSplitDir());
+      Printers.push_back(&YAMLPrinter);
+      PrintYAML = false;
+    }
     // Print the Logical View.
     if (Options.OutputFormats.count(OutputFormat::TEXT)) {
-      AReader.print();
+      AReader.print(Printers);
+    } else {
+      LibScopeView::ScopePrinter::print(AReader.getScopesRoot(), Printers,
+                                        AReader.getJobCount());
     }
     // Print YAML.
-    if (Options.OutputFormats.count(OutputFormat::YAML)) {
-      // YAML_OUTPUT_VERSION_STR is defined by CMake.
-      LibScopeView::ScopeYAMLPrinter YAMLPrinter(AReader.getInputFile(),
-                                                 YAML_OUTPUT_VERSION_STR);
-      if (AReader.getOptions().getViewSplit()) {
-        YAMLPrinter.print(
-            static_cast<LibScopeView::ScopeRoot *>(AReader.getScopesRoot()),
-          AReader.getPrintSplitDir());
-      } else {
-        YAMLPrinter.print(AReader.getScopesRoot(), std::cout);
-      }
+    if (PrintYAML) {
+      LibScopeView::GlobalPrintContext->flush();
+      YAMLPrinter.print(AReader.getScopesRoot(), std::cout);
     }
   }
 
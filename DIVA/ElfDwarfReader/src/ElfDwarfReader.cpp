@@ -32,44 +32,36 @@
 #include "Error.h"
 #include "FileUtilities.h"
 #include "LibDwarfHelpers.h"
+#include "NativeDwarfDecoder.h"
+#include "StringPool.h"
 #include "Symbol.h"
 #include "Type.h"
-#include "Line.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <numeric>
 #include <sstream>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 
 using namespace ElfDwarfReader;
+using LibScopeView::cast;
+using LibScopeView::dyn_cast;
 
 namespace {
 
-// Create a mapping from DWARF file IDs to the file paths.
-std::vector<std::string> getSourceFileMapping(const DwarfDebugData &DebugData,
-                                              const DwarfDie &CUDie) {
-  std::vector<std::string> Mapping;
-  char **SourceFiles = nullptr;
-  Dwarf_Signed SourceFilesCount;
-
-  auto Ret = dwarf_srcfiles(*CUDie, &SourceFiles, &SourceFilesCount, nullptr);
-  if (Ret != DW_DLV_OK)
-    return Mapping;
-
-  // A file ID of 0 always means no file, so set [0] to empty string.
-  Mapping.emplace_back("");
-
-  for (Dwarf_Signed i = 0; i < SourceFilesCount; ++i) {
-    Mapping.emplace_back(SourceFiles[i]);
-    dwarf_dealloc(*DebugData, SourceFiles[i], DW_DLA_STRING);
-  }
-  dwarf_dealloc(*DebugData, SourceFiles, DW_DLA_LIST);
-
-  return Mapping;
-}
-
 // Get the access specifier (Public, Private, etc.).
-LibScopeView::AccessSpecifier getAccessSpecifier(const DwarfDie &Die) {
-  if (auto Access = Die.getAttrAsSigned(DW_AT_accessibility)) {
+template <typename AttrsTy>
+LibScopeView::AccessSpecifier getAccessSpecifier(const AttrsTy &Attrs) {
+  if (auto Access = Attrs.getAttrAsSigned(DW_AT_accessibility)) {
     switch (*Access) {
     case DW_ACCESS_private:
       return LibScopeView::AccessSpecifier::Private;
@@ -99,28 +91,284 @@ static void setSourceFile(LibScopeView::Object &Obj, const std::vector<std::stri
 // Set one Object to reference another, handling any type specifics.
 void addObjectReference(LibScopeView::Object *Obj,
                         LibScopeView::Object *Reference) {
-  if (auto Scp = dynamic_cast<LibScopeView::Scope *>(Obj)) {
+  if (auto Scp = dyn_cast<LibScopeView::Scope>(Obj)) {
     // Scope to Scope.
-    if (auto RefScp = dynamic_cast<LibScopeView::Scope *>(Reference))
+    if (auto RefScp = dyn_cast<LibScopeView::Scope>(Reference))
       Scp->setReference(RefScp);
-  } else if (auto Sym = dynamic_cast<LibScopeView::Symbol *>(Obj)) {
+  } else if (auto Sym = dyn_cast<LibScopeView::Symbol>(Obj)) {
     // Symbol to Symbol.
-    if (auto RefSym = dynamic_cast<LibScopeView::Symbol *>(Reference))
+    if (auto RefSym = dyn_cast<LibScopeView::Symbol>(Reference))
       Sym->setReference(RefSym);
   }
 }
 
+// Add an Object to a Scope, handling any type specifics. Returns false if the
+// Object is not a Scope, Type or Symbol.
+bool addObjectToScope(LibScopeView::Scope &ParentScope,
+                      LibScopeView::Object *Obj) {
+  if (auto Scp = dyn_cast<LibScopeView::Scope>(Obj))
+    ParentScope.addObject(Scp);
+  else if (auto Ty = dyn_cast<LibScopeView::Type>(Obj))
+    ParentScope.addObject(Ty);
+  else if (auto Sym = dyn_cast<LibScopeView::Symbol>(Obj))
+    ParentScope.addObject(Sym);
+  else
+    return false;
+  return true;
+}
+
+// Check if an offset is outside of a CU offset range.
+bool isOutsideRange(Dwarf_Off Offset,
+                    const std::pair<Dwarf_Off, Dwarf_Off> &Range) {
+  return Offset < Range.first || Offset > Range.second;
+}
+
+// Check if a DWARF tag is created as a Scope.
+bool isScopeTag(Dwarf_Half Tag) {
+  switch (Tag) {
+  case DW_TAG_array_type:
+  case DW_TAG_class_type:
+  case DW_TAG_entry_point:
+  case DW_TAG_enumeration_type:
+  case DW_TAG_label:
+  case DW_TAG_lexical_block:
+  case DW_TAG_compile_unit:
+  case DW_TAG_structure_type:
+  case DW_TAG_subroutine_type:
+  case DW_TAG_union_type:
+  case DW_TAG_inlined_subroutine:
+  case DW_TAG_catch_block:
+  case DW_TAG_subprogram:
+  case DW_TAG_try_block:
+  case DW_TAG_namespace:
+  case DW_TAG_template_alias:
+  case DW_TAG_GNU_template_parameter_pack:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Check if a DWARF tag is created as a Symbol.
+bool isSymbolTag(Dwarf_Half Tag) {
+  switch (Tag) {
+  case DW_TAG_formal_parameter:
+  case DW_TAG_member:
+  case DW_TAG_unspecified_parameters:
+  case DW_TAG_variable:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Check if a DWARF tag makes its parent a template.
+bool isTemplateParamTag(Dwarf_Half Tag) {
+  switch (Tag) {
+  case DW_TAG_template_type_parameter:
+  case DW_TAG_template_value_parameter:
+  case DW_TAG_GNU_template_template_parameter:
+  case DW_TAG_GNU_template_parameter_pack:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Check if a DWARF tag is for a type that objects refer to by DW_AT_type,
+// rather than a part of its parent.
+bool isReferencedTypeTag(Dwarf_Half Tag) {
+  switch (Tag) {
+  case DW_TAG_array_type:
+  case DW_TAG_base_type:
+  case DW_TAG_const_type:
+  case DW_TAG_pointer_type:
+  case DW_TAG_ptr_to_member_type:
+  case DW_TAG_reference_type:
+  case DW_TAG_restrict_type:
+  case DW_TAG_rvalue_reference_type:
+  case DW_TAG_subroutine_type:
+  case DW_TAG_typedef:
+  case DW_TAG_unspecified_type:
+  case DW_TAG_volatile_type:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Check if the name of an Object is built from its children or its type once
+// they have been created, rather than read from its DW_AT_name.
+bool hasBuiltName(Dwarf_Half Tag, bool HasType) {
+  switch (Tag) {
+  case DW_TAG_array_type:
+  case DW_TAG_subroutine_type:
+  case DW_TAG_subrange_type:
+  case DW_TAG_pointer_type:
+  case DW_TAG_reference_type:
+  case DW_TAG_rvalue_reference_type:
+  case DW_TAG_ptr_to_member_type:
+  case DW_TAG_const_type:
+  case DW_TAG_volatile_type:
+  case DW_TAG_restrict_type:
+    return true;
+  case DW_TAG_base_type:
+  case DW_TAG_enumerator:
+  case DW_TAG_inheritance:
+  case DW_TAG_unspecified_type:
+    return HasType;
+  default:
+    return false;
+  }
+}
+
+// Check if the name of an Object is built from its children, so they are
+// created with it.
+bool hasChildrenInName(Dwarf_Half Tag) {
+  return Tag == DW_TAG_array_type || Tag == DW_TAG_subroutine_type;
+}
+
+// Create the Objects for the DWARF tags from a table rather than a switch.
+namespace Factories {
+
+using namespace LibScopeView;
+
+// Create an ObjTy in the arena and call each of the attribute setters on it.
+template <typename ObjTy, typename BaseTy, void (BaseTy::*... Setters)()>
+Object *makeObject(ObjectArena &Arena, LevelType Level) {
+  ObjTy *Obj = Arena.create<ObjTy>(Level);
+  int Expand[] = {((Obj->*Setters)(), 0)...};
+  (void)Expand;
+  return Obj;
+}
+
+typedef Object *(*ObjectFactory)(ObjectArena &, LevelType);
+
+struct TagFactory {
+  Dwarf_Half Tag;
+  ObjectFactory Create;
+};
+
+// The Object class and attributes for each supported DWARF tag, sorted by tag.
+constexpr TagFactory TagFactories[] = {
+    {DW_TAG_array_type, &makeObject<ScopeArray, Scope, &Scope::setIsArrayType>},
+    {DW_TAG_class_type,
+     &makeObject<ScopeAggregate, Scope, &Scope::setIsClassType>},
+    {DW_TAG_entry_point,
+     &makeObject<ScopeFunction, Scope, &Scope::setIsEntryPoint>},
+    {DW_TAG_enumeration_type,
+     &makeObject<ScopeEnumeration, Scope, &Scope::setIsEnumerationType>},
+    {DW_TAG_formal_parameter,
+     &makeObject<Symbol, Symbol, &Symbol::setIsParameter>},
+    {DW_TAG_imported_declaration,
+     &makeObject<TypeImport, Type, &Type::setIsImportedDeclaration>},
+    {DW_TAG_label, &makeObject<ScopeFunction, Scope, &Scope::setIsLabel>},
+    {DW_TAG_lexical_block,
+     &makeObject<Scope, Scope, &Scope::setIsLexicalBlock>},
+    {DW_TAG_member, &makeObject<Symbol, Symbol, &Symbol::setIsMember>},
+    {DW_TAG_pointer_type, &makeObject<Type, Type, &Type::setIsPointerType>},
+    {DW_TAG_reference_type, &makeObject<Type, Type, &Type::setIsReferenceType>},
+    {DW_TAG_compile_unit,
+     &makeObject<ScopeCompileUnit, Scope, &Scope::setIsCompileUnit>},
+    {DW_TAG_structure_type,
+     &makeObject<ScopeAggregate, Scope, &Scope::setIsStructType>},
+    {DW_TAG_subroutine_type,
+     &makeObject<ScopeFunction, Scope, &Scope::setIsSubroutineType>},
+    {DW_TAG_typedef, &makeObject<TypeDefinition, Type, &Type::setIsTypedef>},
+    {DW_TAG_union_type,
+     &makeObject<ScopeAggregate, Scope, &Scope::setIsUnionType>},
+    {DW_TAG_unspecified_parameters,
+     &makeObject<Symbol, Symbol, &Symbol::setIsUnspecifiedParameter>},
+    {DW_TAG_inheritance,
+     &makeObject<TypeImport, Type, &Type::setIsInheritance>},
+    {DW_TAG_inlined_subroutine,
+     &makeObject<ScopeFunctionInlined, Scope, &Scope::setIsInlinedSubroutine>},
+    {DW_TAG_ptr_to_member_type,
+     &makeObject<Type, Type, &Type::setIsPointerMemberType>},
+    {DW_TAG_subrange_type,
+     &makeObject<TypeSubrange, Type, &Type::setIsSubrangeType>},
+    {DW_TAG_base_type, &makeObject<Type, Type, &Type::setIsBaseType>},
+    {DW_TAG_catch_block, &makeObject<Scope, Scope, &Scope::setIsCatchBlock>},
+    {DW_TAG_const_type, &makeObject<Type, Type, &Type::setIsConstType>},
+    {DW_TAG_enumerator,
+     &makeObject<TypeEnumerator, Type, &Type::setIsEnumerator>},
+    {DW_TAG_subprogram,
+     &makeObject<ScopeFunction, Scope, &Scope::setIsSubprogram>},
+    {DW_TAG_template_type_parameter,
+     &makeObject<TypeParam, Type, &Type::setIsTemplateType>},
+    {DW_TAG_template_value_parameter,
+     &makeObject<TypeParam, Type, &Type::setIsTemplateValue>},
+    {DW_TAG_try_block, &makeObject<Scope, Scope, &Scope::setIsTryBlock>},
+    {DW_TAG_variable, &makeObject<Symbol, Symbol, &Symbol::setIsVariable>},
+    {DW_TAG_volatile_type, &makeObject<Type, Type, &Type::setIsVolatileType>},
+    {DW_TAG_restrict_type, &makeObject<Type, Type, &Type::setIsRestrictType>},
+    {DW_TAG_namespace,
+     &makeObject<ScopeNamespace, Scope, &Scope::setIsNamespace>},
+    {DW_TAG_imported_module,
+     &makeObject<TypeImport, Type, &Type::setIsImportedModule>},
+    {DW_TAG_unspecified_type,
+     &makeObject<Type, Type, &Type::setIsUnspecifiedType>},
+    {DW_TAG_rvalue_reference_type,
+     &makeObject<Type, Type, &Type::setIsRvalueReferenceType>},
+    {DW_TAG_template_alias, &makeObject<ScopeAlias, Scope,
+         &Scope::setIsTemplateAlias, &Scope::setIsTemplate>},
+    {DW_TAG_GNU_template_template_parameter,
+     &makeObject<TypeParam, Type, &Type::setIsTemplateTemplate>},
+    {DW_TAG_GNU_template_parameter_pack,
+     &makeObject<ScopeTemplatePack, Scope, &Scope::setIsTemplatePack>},
+};
+
+constexpr bool isSortedByTag(const TagFactory *Begin, const TagFactory *End) {
+  for (auto It = Begin; It + 1 < End; ++It)
+    if (It[0].Tag >= It[1].Tag)
+      return false;
+  return true;
+}
+static_assert(isSortedByTag(std::begin(TagFactories), std::end(TagFactories)),
+              "TagFactories must be sorted by tag");
+
+// Get the factory for a DWARF tag, or nullptr if the tag isn't supported.
+const TagFactory *findTagFactory(Dwarf_Half Tag) {
+  auto Factory = std::lower_bound(
+      std::begin(TagFactories), std::end(TagFactories), Tag,
+      [](const TagFactory &Entry, Dwarf_Half Tag) { return Entry.Tag < Tag; });
+  if (Factory == std::end(TagFactories) || Factory->Tag != Tag)
+    return nullptr;
+  return Factory;
+}
+
+// The number of supported DWARF tags.
+constexpr size_t TagCount = std::extent<decltype(TagFactories)>::value;
+
+// Get the position of a factory in TagFactories.
+size_t getTagIndex(const TagFactory *Factory) {
+  return static_cast<size_t>(Factory - std::begin(TagFactories));
+}
+
+// Get the position in TagFactories of a supported DWARF tag.
+size_t getTagIndex(Dwarf_Half Tag) {
+  const TagFactory *Factory = findTagFactory(Tag);
+  assert(Factory && "The DWARF tag is not supported");
+  return getTagIndex(Factory);
+}
+
+} // namespace Factories
 } // end anonymous namespace
 
+DwarfReader::DwarfReader(LibScopeView::ViewSpecification *spec)
+    : LibScopeView::Reader(spec) {}
+
+DwarfReader::~DwarfReader() {}
+
 bool DwarfReader::createScopes() {
-  auto *Root = new LibScopeView::ScopeRoot(0U);
+  auto *Root = Arena.create<LibScopeView::ScopeRoot>(0U);
   Root->setIsRoot();
   Root->setName(getInputFile().c_str());
   Scopes = Root;
 
   try {
     LibScopeView::FileDescriptor FD(getInputFile());
-    const DwarfDebugData DebugData(FD.get());
+    DwarfDebugData DebugData(FD.get());
     createCompileUnits(DebugData, *Root);
   } catch (LibDwarfError &Err) {
 #ifndef NDEBUG
@@ -135,277 +383,722 @@ bool DwarfReader::createScopes() {
   return true;
 }
 
-void DwarfReader::createCompileUnits(const DwarfDebugData &DebugData,
+void DwarfReader::createCompileUnits(DwarfDebugData &DebugData,
                                      LibScopeView::ScopeRoot &Root) {
-  for (const auto &CU : DebugData.getCompileUnits()) {
-    CurrentCURange = std::make_pair(CU.HeaderOffset, CU.NextHeaderOffset);
-    SourceFileMapping = getSourceFileMapping(DebugData, CU.CUDie);
+  std::vector<DwarfCompileUnit> CUs = DebugData.getCompileUnits();
 
-    // Recursively create the tree of Objects from the CU and down.
-    createObject(DebugData, CU.CUDie, Root, 0U);
+  // The native decoder falls back to libdwarf if it can't read the file. It
+  // also decodes the line tables.
+  if (Spec.getDecoderType() == LibScopeView::dt_native)
+    NativeData = NativeDebugData::create(getInputFile());
+  const NativeDebugData *Native = NativeData.get();
+  DebugData.setNativeData(Native);
+
+  unsigned Jobs = Spec.getJobs();
+  if (Jobs == 0)
+    Jobs = std::max(std::thread::hardware_concurrency(), 1U);
+  if (Jobs > 1 && CUs.size() > 1) {
+    createCompileUnitsInParallel(
+        CUs, static_cast<unsigned>(std::min<size_t>(Jobs, CUs.size())),
+        DebugData, Native, Root);
+    return;
   }
 
-  assert(TypesToBeSet.empty() &&
-         "Some objects had a type that was not created");
+  DwarfStringCache Strings;
+  std::vector<CreationContext> Contexts(1);
+  CreationContext &Ctx = Contexts.front();
+  Ctx.Arena = &Arena;
+  Ctx.Strings = &Strings;
+  compileNeededTags();
+  Ctx.MatchPatterns = getPatternPushdown();
+  Ctx.Pushdown = Ctx.MatchPatterns || !NeededTags.empty();
+  for (const auto &CU : CUs) {
+    Ctx.CURange = std::make_pair(CU.HeaderOffset, CU.NextHeaderOffset);
+    createCompileUnit(Ctx, DebugData, CU.CUDie, Native, &Root);
+    reportUnknownTags(Ctx);
+  }
 
-  assert(ReferencesToBeSet.empty() &&
-         "Some objects had a reference that was not created");
+  if (Ctx.Pushdown) {
+    createReferencedObjects(DebugData, Native, Contexts);
+    countUncreatedObjects(Contexts);
+  }
+  resolveReferences(Contexts);
 }
 
-void DwarfReader::createObject(const DwarfDebugData &DebugData,
-                               const DwarfDie &Die,
-                               LibScopeView::Object &ParentObj,
-                               LibScopeView::LevelType Level) {
-  // For now do nothing if the parent is not a scope.
-  if (!ParentObj.getIsScope())
-    return;
-  auto &ParentScope = dynamic_cast<LibScopeView::Scope &>(ParentObj);
+void DwarfReader::createCompileUnitsInParallel(
+    const std::vector<DwarfCompileUnit> &CUs, unsigned Jobs,
+    DwarfDebugData &DebugData, const NativeDebugData *Native,
+    LibScopeView::ScopeRoot &Root) {
+  // Each CU gets its own context, so the workers never touch objects from
+  // another CU. The references are resolved once all the CUs have been
+  // created.
+  std::vector<CreationContext> Contexts(CUs.size());
+  std::vector<Dwarf_Off> CUDieOffsets;
+  CUDieOffsets.reserve(CUs.size());
+  compileNeededTags();
+  bool MatchPatterns = getPatternPushdown();
+  bool Pushdown = MatchPatterns || !NeededTags.empty();
+  for (size_t Index = 0; Index < CUs.size(); ++Index) {
+    Contexts[Index].CURange =
+        std::make_pair(CUs[Index].HeaderOffset, CUs[Index].NextHeaderOffset);
+    Contexts[Index].Pushdown = Pushdown;
+    Contexts[Index].MatchPatterns = MatchPatterns;
+    CUDieOffsets.push_back(CUs[Index].CUDie.getGlobalOffset());
+  }
 
-  auto ObjOffset = Die.getGlobalOffset();
-  auto ObjTag = Die.getTag();
+  // Hand out the largest CUs first to keep the workers evenly loaded.
+  std::vector<size_t> Schedule(CUs.size());
+  std::iota(Schedule.begin(), Schedule.end(), 0U);
+  std::stable_sort(Schedule.begin(), Schedule.end(),
+                   [&CUs](size_t A, size_t B) {
+                     return CUs[A].NextHeaderOffset - CUs[A].HeaderOffset >
+                            CUs[B].NextHeaderOffset - CUs[B].HeaderOffset;
+                   });
 
-  // Create the object from the DWARF tag.
-  LibScopeView::Object *Obj = createObjectByTag(ObjTag, Level);
-  if (!Obj)
-    return;
+  // Arenas aren't thread safe, so each worker has its own until they are
+  // merged into the reader's arena.
+  std::vector<std::unique_ptr<LibScopeView::ObjectArena>> WorkerArenas;
+  for (unsigned WorkerIndex = 0; WorkerIndex < Jobs; ++WorkerIndex)
+    WorkerArenas.emplace_back(new LibScopeView::ObjectArena());
 
-  // Add to the parent.
-  if (auto Scp = dynamic_cast<LibScopeView::Scope *>(Obj))
-    ParentScope.addObject(Scp);
-  else if (auto Ty = dynamic_cast<LibScopeView::Type *>(Obj))
-    ParentScope.addObject(Ty);
-  else if (auto Sym = dynamic_cast<LibScopeView::Symbol *>(Obj))
-    ParentScope.addObject(Sym);
-  else {
-    assert(false && "Obj is not a Scope, Type or Symbol");
-    delete Obj;
-    return;
-  }
+  std::vector<LibScopeView::Object *> CUObjects(CUs.size(), nullptr);
+  std::vector<std::exception_ptr> Errors(Jobs);
+  std::atomic<size_t> NextCU(0U);
+  std::mutex DwarfInitMutex;
 
-  // Check this object hasn't been created before.
-  assert(CreatedObjects.count(ObjOffset) == 0U && "DWARF offset seen twice");
-
-  // Record the Object by offset for lookup when creating other objects.
-  CreatedObjects[ObjOffset] = Obj;
+  auto Worker = [&](unsigned WorkerIndex) {
+    // libdwarf handles can't be shared between threads, so each worker opens
+    // the file itself. Setting up and tearing down libdwarf and libelf is not
+    // thread safe, so it is serialized.
+    std::unique_ptr<LibScopeView::FileDescriptor> FD;
+    std::unique_ptr<DwarfDebugData> WorkerData;
+    // The cache is keyed by addresses in this worker's debug data.
+    DwarfStringCache Strings;
+    try {
+      {
+        std::lock_guard<std::mutex> Lock(DwarfInitMutex);
+        FD.reset(new LibScopeView::FileDescriptor(getInputFile()));
+        WorkerData.reset(new DwarfDebugData(FD->get()));
+      }
+      WorkerData->setNativeData(Native);
+      for (size_t Next = NextCU++; Next < CUs.size(); Next = NextCU++) {
+        size_t Index = Schedule[Next];
+        CreationContext &Ctx = Contexts[Index];
+        Ctx.Arena = WorkerArenas[WorkerIndex].get();
+        Ctx.Strings = &Strings;
+        DwarfDie CUDie = WorkerData->getDie(CUDieOffsets[Index]);
+        if (!*CUDie)
+          continue;
+        CUObjects[Index] =
+            createCompileUnit(Ctx, *WorkerData, CUDie, Native, nullptr);
+      }
+    } catch (...) {
+      Errors[WorkerIndex] = std::current_exception();
+      // Stop the other workers from starting any more CUs.
+      NextCU = CUs.size();
+    }
+    std::lock_guard<std::mutex> Lock(DwarfInitMutex);
+    WorkerData.reset();
+    FD.reset();
+  };
 
-  // Set attributes.
-  initObjectFromAttrs(*Obj, Die, ObjOffset, ObjTag);
+  std::vector<std::thread> Workers;
+  for (unsigned WorkerIndex = 1; WorkerIndex < Jobs; ++WorkerIndex)
+    Workers.emplace_back(Worker, WorkerIndex);
+  Worker(0U);
+  for (auto &Thread : Workers)
+    Thread.join();
 
-  // Set any references.
-  initObjectReferences(*Obj, Die);
+  // The objects are released with the worker arenas if there was an error.
+  for (const auto &Error : Errors)
+    if (Error)
+      std::rethrow_exception(Error);
 
-  // Update any references to this object.
-  updateReferencesToObject(*Obj, ObjOffset);
+  for (auto &WorkerArena : WorkerArenas)
+    Arena.merge(*WorkerArena);
 
-  // Recurse on the DIE children.
-  for (auto IT = Die.childrenBegin(), End = Die.childrenEnd(); IT != End; ++IT)
-    createObject(DebugData, *IT, *Obj, Level + 1);
-}
+  // Add the CUs to the root in their original order.
+  for (size_t Index = 0; Index < CUs.size(); ++Index) {
+    reportUnknownTags(Contexts[Index]);
 
-LibScopeView::Object *
-DwarfReader::createObjectByTag(Dwarf_Half Tag,
-                               LibScopeView::LevelType Level) {
-  switch (Tag) {
-  // Types.
-  case DW_TAG_base_type: {
-    auto Obj = new LibScopeView::Type(Level);
-    Obj->setIsBaseType();
-    return Obj;
-  }
-  case DW_TAG_const_type: {
-    auto Obj = new LibScopeView::Type(Level);
-    Obj->setIsConstType();
-    return Obj;
-  }
-  case DW_TAG_enumerator: {
-    auto Obj = new LibScopeView::TypeEnumerator(Level);
-    Obj->setIsEnumerator();
-    return Obj;
-  }
-  case DW_TAG_imported_declaration: {
-    auto Obj = new LibScopeView::TypeImport(Level);
-    Obj->setIsImportedDeclaration();
-    return Obj;
-  }
-  case DW_TAG_imported_module: {
-    auto Obj = new LibScopeView::TypeImport(Level);
-    Obj->setIsImportedModule();
-    return Obj;
-  }
-  case DW_TAG_inheritance: {
-    auto Obj = new LibScopeView::TypeImport(Level);
-    Obj->setIsInheritance();
-    return Obj;
-  }
-  case DW_TAG_pointer_type: {
-    auto Obj = new LibScopeView::Type(Level);
-    Obj->setIsPointerType();
-    return Obj;
-  }
-  case DW_TAG_ptr_to_member_type: {
-    auto Obj = new LibScopeView::Type(Level);
-    Obj->setIsPointerMemberType();
-    return Obj;
-  }
-  case DW_TAG_reference_type: {
-    auto Obj = new LibScopeView::Type(Level);
-    Obj->setIsReferenceType();
-    return Obj;
-  }
-  case DW_TAG_restrict_type: {
-    auto Obj = new LibScopeView::Type(Level);
-    Obj->setIsRestrictType();
-    return Obj;
-  }
-  case DW_TAG_rvalue_reference_type: {
-    auto Obj = new LibScopeView::Type(Level);
-    Obj->setIsRvalueReferenceType();
-    return Obj;
-  }
-  case DW_TAG_subrange_type: {
-    auto Obj = new LibScopeView::TypeSubrange(Level);
-    Obj->setIsSubrangeType();
-    return Obj;
-  }
-  case DW_TAG_template_value_parameter: {
-    auto Obj = new LibScopeView::TypeParam(Level);
-    Obj->setIsTemplateValue();
-    return Obj;
-  }
-  case DW_TAG_template_type_parameter: {
-    auto Obj = new LibScopeView::TypeParam(Level);
-    Obj->setIsTemplateType();
-    return Obj;
-  }
-  case DW_TAG_GNU_template_template_parameter: {
-    auto Obj = new LibScopeView::TypeParam(Level);
-    Obj->setIsTemplateTemplate();
-    return Obj;
-  }
-  case DW_TAG_typedef: {
-    auto Obj = new LibScopeView::TypeDefinition(Level);
-    Obj->setIsTypedef();
-    return Obj;
-  }
-  case DW_TAG_unspecified_type: {
-    auto Obj = new LibScopeView::Type(Level);
-    Obj->setIsUnspecifiedType();
-    return Obj;
-  }
-  case DW_TAG_volatile_type: {
-    auto Obj = new LibScopeView::Type(Level);
-    Obj->setIsVolatileType();
-    return Obj;
-  }
-  // Symbols.
-  case DW_TAG_formal_parameter: {
-    auto Obj = new LibScopeView::Symbol(Level);
-    Obj->setIsParameter();
-    return Obj;
-  }
-  case DW_TAG_unspecified_parameters: {
-    auto Obj = new LibScopeView::Symbol(Level);
-    Obj->setIsUnspecifiedParameter();
-    return Obj;
-  }
-  case DW_TAG_member: {
-    auto Obj = new LibScopeView::Symbol(Level);
-    Obj->setIsMember();
-    return Obj;
-  }
-  case DW_TAG_variable: {
-    auto Obj = new LibScopeView::Symbol(Level);
-    Obj->setIsVariable();
-    return Obj;
-  }
-  // Scopes.
-  case DW_TAG_catch_block: {
-    auto Obj = new LibScopeView::Scope(Level);
-    Obj->setIsCatchBlock();
-    return Obj;
+    LibScopeView::Object *Obj = CUObjects[Index];
+    if (!Obj)
+      continue;
+    if (!addObjectToScope(Root, Obj))
+      assert(false && "Obj is not a Scope, Type or Symbol");
   }
-  case DW_TAG_lexical_block: {
-    auto Obj = new LibScopeView::Scope(Level);
-    Obj->setIsLexicalBlock();
-    return Obj;
+
+  if (Pushdown) {
+    createReferencedObjects(DebugData, Native, Contexts);
+    countUncreatedObjects(Contexts);
   }
-  case DW_TAG_try_block: {
-    auto Obj = new LibScopeView::Scope(Level);
-    Obj->setIsTryBlock();
-    return Obj;
+  resolveReferences(Contexts);
+}
+
+void DwarfReader::compileNeededTags() {
+  NeededTags.clear();
+  if (!getKindPruning())
+    return;
+
+  // Without pushdown, the pattern matches are found among the created
+  // objects. Any --filter match prints the header, whatever its kind, and a
+  // --tree match is printed with its children.
+  bool MatchPatterns = getPatternPushdown();
+  if (Spec.getAnyFilterPattern() && !MatchPatterns)
+    return;
+
+  // When the scopes aren't all printed, those with types or symbols under
+  // them may be, so then all of those are needed. The types that objects
+  // refer to are mostly needed by the printed objects, and are cheaper to
+  // create with the rest than once the references are known.
+  const LibScopeView::CmdOptions &Options = getOptions();
+  bool AllScopes = Spec.getAnyTreePattern() && !MatchPatterns;
+  bool AllTypes = !Options.getPrintScopes() && Options.getPrintTypes();
+  bool AllSymbols = !Options.getPrintScopes() && Options.getPrintSymbols();
+
+  // The kind of an object is set by its tag, so the view is asked about a
+  // prototype object of each tag. They aren't counted as allocated.
+  LibScopeView::UncountedObjects Uncounted;
+  LibScopeView::ObjectArena Prototypes;
+  bool AllNeeded = true;
+  for (const auto &Factory : Factories::TagFactories) {
+    LibScopeView::Object *Obj = Factory.Create(Prototypes, 0U);
+    bool Needed = isReferencedTypeTag(Factory.Tag);
+    if (auto Scp = dyn_cast<LibScopeView::Scope>(Obj)) {
+      Needed = Needed || AllScopes || Spec.printObject(Scp);
+      // A template parameter makes its parent print as a template.
+      Scp->setIsTemplate();
+      Needed = Needed || Spec.printObject(Scp);
+    } else if (auto Ty = dyn_cast<LibScopeView::Type>(Obj)) {
+      Needed = Needed || AllTypes || Spec.printObject(Ty) ||
+               (Ty->getIsTemplateParam() &&
+                Options.getFormatTemplatesEncoded());
+    } else if (auto Sym = dyn_cast<LibScopeView::Symbol>(Obj)) {
+      Needed = Needed || AllSymbols || Spec.printObject(Sym);
+    }
+    NeededTags.push_back(Needed);
+    AllNeeded = AllNeeded && Needed;
   }
-  case DW_TAG_compile_unit: {
-    auto Obj = new LibScopeView::ScopeCompileUnit(0);
-    Obj->setIsCompileUnit();
-    return Obj;
+  if (AllNeeded)
+    NeededTags.clear();
+}
+
+void DwarfReader::countUncreatedObjects(
+    const std::vector<CreationContext> &Contexts) {
+  if (!getOptions().getPrintSummary())
+    return;
+
+  LibScopeView::UncountedObjects Uncounted;
+  LibScopeView::ObjectArena Prototypes;
+  for (size_t TagIndex = 0; TagIndex < Factories::TagCount; ++TagIndex) {
+    int64_t Count = 0;
+    for (const auto &Ctx : Contexts)
+      if (!Ctx.UncreatedTags.empty())
+        Count += Ctx.UncreatedTags[TagIndex];
+    assert(Count >= 0 && "More objects were created than Dies read");
+    if (Count > 0)
+      incrementFound(
+          Factories::TagFactories[TagIndex].Create(Prototypes, 0U),
+          static_cast<uint32_t>(Count));
   }
-  case DW_TAG_inlined_subroutine: {
-    auto Obj = new LibScopeView::ScopeFunctionInlined(Level);
-    Obj->setIsInlinedSubroutine();
-    return Obj;
+}
+
+void DwarfReader::resolveReferences(std::vector<CreationContext> &Contexts) {
+  std::vector<PendingReference> Pending;
+  for (auto &Ctx : Contexts) {
+    if (Pending.empty())
+      Pending.swap(Ctx.PendingReferences);
+    else
+      Pending.insert(Pending.end(), Ctx.PendingReferences.begin(),
+                     Ctx.PendingReferences.end());
+    Ctx.PendingReferences = std::vector<PendingReference>();
   }
-  case DW_TAG_namespace: {
-    auto Obj = new LibScopeView::ScopeNamespace(Level);
-    Obj->setIsNamespace();
-    return Obj;
+
+  // With the references in target order, the targets are found by walking
+  // forward through the created objects, which are in offset order.
+  std::stable_sort(Pending.begin(), Pending.end(),
+                   [](const PendingReference &A, const PendingReference &B) {
+                     return A.Target < B.Target;
+                   });
+  auto CtxIT = Contexts.begin();
+  size_t Position = 0;
+  size_t Unresolved = 0;
+  for (const PendingReference &Ref : Pending) {
+    LibScopeView::Object *Target = nullptr;
+    while (CtxIT != Contexts.end()) {
+      if (Position == CtxIT->CreatedObjects.size()) {
+        ++CtxIT;
+        Position = 0;
+        continue;
+      }
+      const auto &Created = CtxIT->CreatedObjects[Position];
+      if (Created.first < Ref.Target) {
+        ++Position;
+        continue;
+      }
+      if (Created.first == Ref.Target)
+        Target = Created.second;
+      break;
+    }
+    if (!Target) {
+      ++Unresolved;
+      continue;
+    }
+
+    // An object referenced from another CU is marked as global, except that a
+    // DW_AT_specification, DW_AT_abstract_origin or DW_AT_extension to a later
+    // Die marks the referencing object instead.
+    LibScopeView::Object *Obj = Ref.Obj;
+    if (Ref.IsType) {
+      Obj->setType(Target);
+      if (Ref.IsCrossUnit)
+        Target->setIsGlobalReference();
+    } else {
+      addObjectReference(Obj, Target);
+      if (Ref.IsCrossUnit)
+        (Ref.Target < Obj->getDieOffset() ? Target : Obj)
+            ->setIsGlobalReference();
+    }
+    if (Ref.IsCrossUnit)
+      addCrossUnitLink(Obj, Target);
   }
-  case DW_TAG_template_alias: {
-    auto Obj = new LibScopeView::ScopeAlias(Level);
-    Obj->setIsTemplateAlias();
-    Obj->setIsTemplate();
-    return Obj;
+
+  assert(Unresolved == 0U &&
+         "Some objects had a type or reference that was not created");
+  static_cast<void>(Unresolved);
+}
+
+void DwarfReader::createReferencedObjects(
+    const DwarfDebugData &DebugData, const NativeDebugData *Native,
+    std::vector<CreationContext> &Contexts) {
+  // The contexts are in offset order, and so are their objects and units.
+  std::vector<std::pair<Dwarf_Off, LibScopeView::Object *>> Created;
+  std::vector<const WalkedUnit *> Units;
+  for (const auto &Ctx : Contexts) {
+    Created.insert(Created.end(), Ctx.CreatedObjects.begin(),
+                   Ctx.CreatedObjects.end());
+    for (const auto &Unit : Ctx.WalkedUnits)
+      Units.push_back(&Unit);
   }
-  case DW_TAG_array_type: {
-    auto Obj = new LibScopeView::ScopeArray(Level);
-    Obj->setIsArrayType();
+
+  DwarfStringCache Strings;
+  CreationContext MatCtx;
+  MatCtx.Arena = &Arena;
+  MatCtx.Strings = &Strings;
+  MatCtx.InOffsetOrder = false;
+  MatCtx.UncreatedTags.assign(Factories::TagCount, 0);
+  std::unordered_map<Dwarf_Off, LibScopeView::Object *> Materialized;
+  std::unordered_map<const WalkedUnit *, std::vector<std::string>> Mappings;
+  const WalkedUnit *MappedUnit = nullptr;
+
+  // Get the object of a Die, creating it and its parents if they haven't
+  // been. Returns nullptr if the Die wasn't read, as its tag is unknown.
+  std::function<LibScopeView::Object *(Dwarf_Off)> getObject =
+      [&](Dwarf_Off Offset) -> LibScopeView::Object * {
+    auto CreatedIt = std::lower_bound(
+        Created.begin(), Created.end(), Offset,
+        [](const std::pair<Dwarf_Off, LibScopeView::Object *> &Entry,
+           Dwarf_Off Offset) { return Entry.first < Offset; });
+    if (CreatedIt != Created.end() && CreatedIt->first == Offset)
+      return CreatedIt->second;
+    auto MaterializedIt = Materialized.find(Offset);
+    if (MaterializedIt != Materialized.end())
+      return MaterializedIt->second;
+
+    auto UnitIt = std::upper_bound(Units.begin(), Units.end(), Offset,
+                                   [](Dwarf_Off Offset, const WalkedUnit *Unit) {
+                                     return Offset < Unit->CURange.first;
+                                   });
+    if (UnitIt == Units.begin())
+      return nullptr;
+    const WalkedUnit &Unit = **--UnitIt;
+    if (Offset >= Unit.CURange.second)
+      return nullptr;
+    auto Relative = static_cast<uint32_t>(Offset - Unit.CURange.first);
+    auto DieIt = std::lower_bound(Unit.Dies.begin(), Unit.Dies.end(), Relative,
+                                  [](const WalkedDie &Die, uint32_t Offset) {
+                                    return Die.Offset < Offset;
+                                  });
+    // The compile unit itself is always created.
+    if (DieIt == Unit.Dies.end() || DieIt->Offset != Relative ||
+        DieIt == Unit.Dies.begin())
+      return nullptr;
+    const WalkedDie Walked = *DieIt;
+
+    LibScopeView::Object *Parent =
+        getObject(Unit.CURange.first + Unit.Dies[Walked.Parent].Offset);
+    if (!Parent)
+      return nullptr;
+    auto &ParentScope = cast<LibScopeView::Scope>(*Parent);
+    auto Level = static_cast<LibScopeView::LevelType>(Parent->getLevel() + 1);
+
+    if (&Unit != MappedUnit) {
+      auto &Mapping = Mappings[&Unit];
+      if (Mapping.empty())
+        Mapping = DebugData.getDie(Unit.CUDieOffset).getSourceFiles();
+      MatCtx.CURange = Unit.CURange;
+      MatCtx.SourceFileMapping = Mapping;
+      MappedUnit = &Unit;
+    }
+
+    // The children that give an object its name are created with it.
+    size_t FirstCreated = MatCtx.CreatedObjects.size();
+    auto create = [&](const auto &Die) {
+      if (hasChildrenInName(Die.getTag()))
+        return createObject(MatCtx, Die, &ParentScope, Level);
+      return createObjectFromAttrs(MatCtx, Offset, Die.getTag(),
+                                   Die.decodeAttributes(), &ParentScope, Level);
+    };
+    LibScopeView::Object *Obj = nullptr;
+    NativeDie NativeObjDie;
+    if (Native)
+      NativeObjDie = Native->getDie(Offset);
+    if (!NativeObjDie.isNull()) {
+      Obj = create(NativeObjDie);
+    } else {
+      DwarfDie ObjDie = DebugData.getDie(Offset);
+      if (*ObjDie)
+        Obj = create(ObjDie);
+    }
+    for (size_t Index = FirstCreated; Index < MatCtx.CreatedObjects.size();
+         ++Index) {
+      Materialized.insert(MatCtx.CreatedObjects[Index]);
+      --MatCtx.UncreatedTags[Factories::getTagIndex(
+          MatCtx.CreatedObjects[Index].second->getDieTag())];
+    }
+
+    if (Obj && Walked.IsTemplate)
+      cast<LibScopeView::Scope>(*Obj).setIsTemplate();
     return Obj;
+  };
+
+  // Creating the targets adds the references of the new objects, whose
+  // targets are created in turn.
+  for (const auto &Ctx : Contexts)
+    for (const PendingReference &Ref : Ctx.PendingReferences)
+      getObject(Ref.Target);
+  for (size_t Index = 0; Index < MatCtx.PendingReferences.size(); ++Index)
+    getObject(MatCtx.PendingReferences[Index].Target);
+  reportUnknownTags(MatCtx);
+  if (MatCtx.CreatedObjects.empty())
+    return;
+
+  auto &UncreatedTags = Contexts.front().UncreatedTags;
+  for (size_t TagIndex = 0; TagIndex < Factories::TagCount; ++TagIndex)
+    UncreatedTags[TagIndex] += MatCtx.UncreatedTags[TagIndex];
+
+  // Keep each context's objects in offset order for resolveReferences, by
+  // giving each new object to the context of the compile unit before it.
+  std::vector<std::pair<Dwarf_Off, LibScopeView::Object *>> &New =
+      MatCtx.CreatedObjects;
+  std::sort(New.begin(), New.end());
+  auto NewIt = New.begin();
+  for (size_t Index = 0; Index < Contexts.size(); ++Index) {
+    auto &Objects = Contexts[Index].CreatedObjects;
+    auto NewEnd = New.end();
+    for (size_t Next = Index + 1; Next < Contexts.size(); ++Next)
+      if (!Contexts[Next].CreatedObjects.empty()) {
+        NewEnd = std::lower_bound(
+            NewIt, New.end(), Contexts[Next].CreatedObjects.front());
+        break;
+      }
+    size_t Middle = Objects.size();
+    Objects.insert(Objects.end(), NewIt, NewEnd);
+    std::inplace_merge(Objects.begin(), Objects.begin() + Middle,
+                       Objects.end());
+    NewIt = NewEnd;
   }
-  case DW_TAG_entry_point: {
-    auto Obj = new LibScopeView::ScopeFunction(Level);
-    Obj->setIsEntryPoint();
-    return Obj;
+  Contexts.front().PendingReferences.insert(
+      Contexts.front().PendingReferences.end(),
+      MatCtx.PendingReferences.begin(), MatCtx.PendingReferences.end());
+
+  // The new objects were added after their siblings.
+  std::vector<LibScopeView::Scope *> Parents;
+  for (const auto &Entry : New)
+    Parents.push_back(Entry.second->getParent());
+  std::sort(Parents.begin(), Parents.end());
+  Parents.erase(std::unique(Parents.begin(), Parents.end()), Parents.end());
+  LibScopeView::ObjectSorter Sorter(LibScopeView::sr_offset);
+  for (LibScopeView::Scope *Parent : Parents)
+    Parent->sortChildren(Sorter);
+}
+
+LibScopeView::Object *DwarfReader::createCompileUnit(
+    CreationContext &Ctx, const DwarfDebugData &DebugData,
+    const DwarfDie &CUDie, const NativeDebugData *Native,
+    LibScopeView::Scope *ParentScope) {
+  Ctx.SourceFileMapping = CUDie.getSourceFiles();
+  Ctx.CUDie = &CUDie;
+  if (Ctx.Pushdown) {
+    Ctx.WalkedUnits.push_back(WalkedUnit());
+    Ctx.WalkedUnits.back().CURange = Ctx.CURange;
+    Ctx.WalkedUnits.back().CUDieOffset = CUDie.getGlobalOffset();
+    Ctx.WalkedNames.clear();
+    Ctx.UncreatedTags.resize(Factories::TagCount);
   }
-  case DW_TAG_subprogram: {
-    auto Obj = new LibScopeView::ScopeFunction(Level);
-    Obj->setIsSubprogram();
+
+  // Recursively create the tree of Objects from the CU and down.
+  LibScopeView::Object *Obj;
+  NativeDie NativeCUDie;
+  if (Native)
+    NativeCUDie = Native->getDie(CUDie.getGlobalOffset());
+  if (!NativeCUDie.isNull())
+    Obj = Ctx.Pushdown ? createMatchedObject<NativeDie>(Ctx, NativeCUDie,
+                                                        nullptr, ParentScope, 0U)
+                       : createObject(Ctx, NativeCUDie, ParentScope, 0U);
+  else
+    Obj = Ctx.Pushdown ? createMatchedObject<DwarfDie>(Ctx, CUDie, nullptr,
+                                                       ParentScope, 0U)
+                       : createObject(Ctx, CUDie, ParentScope, 0U);
+
+  Ctx.CUDie = nullptr;
+  return Obj;
+}
+
+template <typename DieTy>
+LibScopeView::Object *DwarfReader::createObject(
+    CreationContext &Ctx, const DieTy &Die, LibScopeView::Scope *ParentScope,
+    LibScopeView::LevelType Level) {
+  LibScopeView::Object *Obj =
+      createObjectFromAttrs(Ctx, Die.getGlobalOffset(), Die.getTag(),
+                            Die.decodeAttributes(), ParentScope, Level);
+
+  // For now do nothing with the children if the object is not a scope.
+  if (!Obj || !Obj->getIsScope())
     return Obj;
+  auto &Scp = cast<LibScopeView::Scope>(*Obj);
+
+  // Recurse on the DIE children.
+  for (typename DieTy::ChildCursor Child(Die); !Child.atEnd(); Child.next())
+    createObject(Ctx, *Child, &Scp, Level + 1);
+
+  return Obj;
+}
+
+template <typename DieTy> struct DwarfReader::PendingObject {
+  typedef decltype(std::declval<const DieTy &>().decodeAttributes()) AttrsTy;
+
+  PendingObject(Dwarf_Off Offset, Dwarf_Half Tag, AttrsTy &&Attrs,
+                PendingObject *Parent, LibScopeView::Scope *ParentScope,
+                LibScopeView::LevelType Level, size_t Walked)
+      : Offset(Offset), Tag(Tag), Attrs(std::move(Attrs)), Parent(Parent),
+        ParentScope(ParentScope), Level(Level), Walked(Walked),
+        InTree(Parent && Parent->InTree), Obj(nullptr) {}
+
+  Dwarf_Off Offset;
+  Dwarf_Half Tag;
+  AttrsTy Attrs;
+  // The pending parent, or null for a compile unit, which is added to
+  // ParentScope instead.
+  PendingObject *Parent;
+  LibScopeView::Scope *ParentScope;
+  LibScopeView::LevelType Level;
+  // The index of the Die in the WalkedUnit.
+  size_t Walked;
+  // The Die is a --tree match or under one.
+  bool InTree;
+  // The object, once it has been created.
+  LibScopeView::Object *Obj;
+};
+
+template <typename DieTy>
+LibScopeView::Object *DwarfReader::createMatchedObject(
+    CreationContext &Ctx, const DieTy &Die, PendingObject<DieTy> *Parent,
+    LibScopeView::Scope *ParentScope, LibScopeView::LevelType Level) {
+  auto ObjOffset = Die.getGlobalOffset();
+  auto ObjTag = Die.getTag();
+  auto Factory = Factories::findTagFactory(ObjTag);
+  if (!Factory) {
+    Ctx.UnknownTags.push_back(ObjTag);
+    return nullptr;
   }
-  case DW_TAG_subroutine_type: {
-    auto Obj = new LibScopeView::ScopeFunction(Level);
-    Obj->setIsSubroutineType();
-    return Obj;
+  size_t TagIndex = Factories::getTagIndex(Factory);
+  ++Ctx.UncreatedTags[TagIndex];
+
+  // Record the Die, so its object can be created later if it is needed.
+  WalkedUnit &Unit = Ctx.WalkedUnits.back();
+  size_t Walked = Unit.Dies.size();
+  WalkedDie Record;
+  Record.Offset = static_cast<uint32_t>(ObjOffset - Unit.CURange.first);
+  Record.Parent = Parent ? static_cast<uint32_t>(Parent->Walked) : 0U;
+  Record.IsTemplate = 0U;
+  Unit.Dies.push_back(Record);
+
+  // A template parameter makes its parent a template even if it is not
+  // created itself.
+  if (Parent && isTemplateParamTag(ObjTag)) {
+    Unit.Dies[Parent->Walked].IsTemplate = 1U;
+    if (Parent->Obj)
+      cast<LibScopeView::Scope>(*Parent->Obj).setIsTemplate();
   }
-  case DW_TAG_label: {
-    auto Obj = new LibScopeView::ScopeFunction(Level);
-    Obj->setIsLabel();
-    return Obj;
+
+  PendingObject<DieTy> Pending(ObjOffset, ObjTag, Die.decodeAttributes(),
+                               Parent, ParentScope, Level, Walked);
+  // A --filter match is created whatever its tag, as the header is printed
+  // for any match, and so is a --tree match, to print its children under it.
+  bool Needed = NeededTags.empty() || NeededTags[TagIndex];
+  if (Ctx.MatchPatterns) {
+    bool MayMatch = mayMatchPatterns(Ctx, ObjOffset, ObjTag, Pending.Attrs);
+    if (Spec.getAnyFilterPattern()) {
+      Needed = MayMatch;
+    } else {
+      Needed = MayMatch || (Needed && Pending.InTree);
+      Pending.InTree = Pending.InTree || MayMatch;
+    }
   }
-  case DW_TAG_class_type: {
-    auto Obj = new LibScopeView::ScopeAggregate(Level);
-    Obj->setIsClassType();
-    return Obj;
+  if (Needed || !Parent)
+    createPendingObject(Ctx, Pending);
+  if (!isScopeTag(ObjTag))
+    return Pending.Obj;
+
+  // The children that give an object its name are created with it, and so
+  // are all those of a --tree match when all the kinds are needed.
+  bool CreateChildren =
+      Pending.Obj && (hasChildrenInName(ObjTag) ||
+                      (Pending.InTree && NeededTags.empty()));
+  if (CreateChildren) {
+    auto &Scp = cast<LibScopeView::Scope>(*Pending.Obj);
+    for (typename DieTy::ChildCursor Child(Die); !Child.atEnd(); Child.next())
+      createObject(Ctx, *Child, &Scp, Level + 1);
+  } else {
+    for (typename DieTy::ChildCursor Child(Die); !Child.atEnd(); Child.next())
+      createMatchedObject(Ctx, *Child, &Pending, nullptr, Level + 1);
   }
-  case DW_TAG_structure_type: {
-    auto Obj = new LibScopeView::ScopeAggregate(Level);
-    Obj->setIsStructType();
-    return Obj;
+
+  return Pending.Obj;
+}
+
+template <typename DieTy>
+LibScopeView::Object *
+DwarfReader::createPendingObject(CreationContext &Ctx,
+                                 PendingObject<DieTy> &Pending) {
+  if (Pending.Obj)
+    return Pending.Obj;
+
+  LibScopeView::Scope *ParentScope = Pending.ParentScope;
+  if (Pending.Parent)
+    ParentScope = &cast<LibScopeView::Scope>(
+        *createPendingObject(Ctx, *Pending.Parent));
+  Pending.Obj = createObjectFromAttrs(Ctx, Pending.Offset, Pending.Tag,
+                                     Pending.Attrs, ParentScope, Pending.Level);
+  --Ctx.UncreatedTags[Factories::getTagIndex(Pending.Tag)];
+  if (Ctx.WalkedUnits.back().Dies[Pending.Walked].IsTemplate)
+    cast<LibScopeView::Scope>(*Pending.Obj).setIsTemplate();
+  return Pending.Obj;
+}
+
+template <typename AttrsTy>
+bool DwarfReader::mayMatchPatterns(CreationContext &Ctx, Dwarf_Off ObjOffset,
+                                   Dwarf_Half ObjTag, const AttrsTy &Attrs) {
+  // The name is found the way NamePass and ReferencePass will set it. A name
+  // that can't be known before the objects are created may match anything.
+  size_t NameIndex = Attrs.getAttrAsStringIndex(DW_AT_name, *Ctx.Strings);
+  bool IsUnknown = false;
+  bool IsScope = isScopeTag(ObjTag);
+  if (!IsScope && !isSymbolTag(ObjTag)) {
+    // setFullName also removes any double spaces.
+    IsUnknown = hasBuiltName(ObjTag, Attrs.hasAttr(DW_AT_type)) ||
+                (NameIndex && strstr(LibScopeView::StringPool::getStringValue(
+                                         NameIndex),
+                                     "  "));
+  } else if (hasBuiltName(ObjTag, /*HasType=*/false)) {
+    IsUnknown = true;
+  } else {
+    // A Scope or Symbol takes the name of the Scope or Symbol it references.
+    auto ReferenceOffset = Attrs.getAttrAsRef(DW_AT_specification);
+    if (!ReferenceOffset)
+      ReferenceOffset = Attrs.getAttrAsRef(DW_AT_abstract_origin);
+    if (!ReferenceOffset)
+      ReferenceOffset = Attrs.getAttrAsRef(DW_AT_extension);
+    if (ReferenceOffset) {
+      // Only the Dies read before this one in its compile unit are known.
+      const WalkedUnit &Unit = Ctx.WalkedUnits.back();
+      const WalkedName *Target = nullptr;
+      if (*ReferenceOffset >= Unit.CURange.first &&
+          *ReferenceOffset < ObjOffset) {
+        auto Offset =
+            static_cast<uint32_t>(*ReferenceOffset - Unit.CURange.first);
+        auto It = std::lower_bound(
+            Unit.Dies.begin(), Unit.Dies.end(), Offset,
+            [](const WalkedDie &Die, uint32_t Offset) {
+              return Die.Offset < Offset;
+            });
+        if (It != Unit.Dies.end() && It->Offset == Offset)
+          Target = &Ctx.WalkedNames[It - Unit.Dies.begin()];
+      }
+      if (!Target)
+        IsUnknown = true;
+      else if (IsScope ? isScopeTag(Target->Tag) : isSymbolTag(Target->Tag)) {
+        NameIndex = Target->NameIndex;
+        IsUnknown = Target->IsUnknown;
+      }
+    }
   }
-  case DW_TAG_union_type: {
-    auto Obj = new LibScopeView::ScopeAggregate(Level);
-    Obj->setIsUnionType();
-    return Obj;
+  Ctx.WalkedNames.push_back({NameIndex, ObjTag, IsUnknown});
+
+  // Only scopes are matched by the --tree patterns.
+  if (Spec.getAnyFilterPattern()) {
+    if (IsUnknown)
+      return true;
+    return NameIndex && Spec.matchFilterPattern(NameIndex);
   }
-  case DW_TAG_enumeration_type: {
-    auto Obj = new LibScopeView::ScopeEnumeration(Level);
-    Obj->setIsEnumerationType();
-    return Obj;
+  if (!IsScope)
+    return false;
+  if (IsUnknown)
+    return true;
+  return NameIndex && Spec.matchTreePattern(NameIndex);
+}
+
+template <typename AttrsTy>
+LibScopeView::Object *DwarfReader::createObjectFromAttrs(
+    CreationContext &Ctx, Dwarf_Off ObjOffset, Dwarf_Half ObjTag,
+    const AttrsTy &Attrs, LibScopeView::Scope *ParentScope,
+    LibScopeView::LevelType Level) {
+  // Create the object from the DWARF tag.
+  LibScopeView::Object *Obj = createObjectByTag(Ctx, ObjTag, Level);
+  if (!Obj)
+    return nullptr;
+
+  // Add to the parent.
+  if (ParentScope && !addObjectToScope(*ParentScope, Obj)) {
+    // The object is released with the arena.
+    assert(false && "Obj is not a Scope, Type or Symbol");
+    return nullptr;
   }
-  case DW_TAG_GNU_template_parameter_pack: {
-    auto Obj = new LibScopeView::ScopeTemplatePack(Level);
-    Obj->setIsTemplatePack();
-    return Obj;
+
+  // Record the Object by offset for resolving references to it. This also
+  // checks the object hasn't been created before.
+  assert((!Ctx.InOffsetOrder || Ctx.CreatedObjects.empty() ||
+          Ctx.CreatedObjects.back().first < ObjOffset) &&
+         "DWARF offset seen twice or out of order");
+  Ctx.CreatedObjects.emplace_back(ObjOffset, Obj);
+
+  // Set attributes.
+  initObjectFromAttrs(Ctx, *Obj, Attrs, ObjOffset, ObjTag);
+
+  // Record any references.
+  initObjectReferences(Ctx, *Obj, Attrs);
+
+  return Obj;
+}
+
+LibScopeView::Object *
+DwarfReader::createObjectByTag(CreationContext &Ctx, Dwarf_Half Tag,
+                               LibScopeView::LevelType Level) {
+  auto Factory = Factories::findTagFactory(Tag);
+  if (!Factory) {
+    Ctx.UnknownTags.push_back(Tag);
+    return nullptr;
   }
-  default:
+  LibScopeView::Object *Obj = Factory->Create(*Ctx.Arena, Level);
+  assert(Obj->getIsScope() == isScopeTag(Tag) &&
+         Obj->getIsSymbol() == isSymbolTag(Tag) &&
+         "isScopeTag or isSymbolTag is missing a tag");
+  return Obj;
+}
+
+void DwarfReader::reportUnknownTags(CreationContext &Ctx) {
+  for (auto Tag : Ctx.UnknownTags) {
     if (!UnknownDWTags.count(Tag)) {
       UnknownDWTags.insert(Tag);
       std::stringstream Msg;
@@ -413,85 +1106,94 @@ DwarfReader::createObjectByTag(Dwarf_Half Tag,
           << std::setfill('0') << std::hex << Tag << ".";
       LibScopeError::warning(Msg.str());
     }
-    return nullptr;
   }
+  Ctx.UnknownTags.clear();
 }
 
-void DwarfReader::initObjectFromAttrs(LibScopeView::Object &Obj,
-                                      const DwarfDie &Die, Dwarf_Off ObjOffset,
+template <typename AttrsTy>
+void DwarfReader::initObjectFromAttrs(CreationContext &Ctx,
+                                      LibScopeView::Object &Obj,
+                                      const AttrsTy &Attrs, Dwarf_Off ObjOffset,
                                       Dwarf_Half ObjTag) {
   Obj.setDieOffset(ObjOffset);
   Obj.setDieTag(ObjTag);
-  Obj.setName(Die.getName().c_str());
-  Obj.setLineNumber(Die.getAttrAsUnsigned(DW_AT_decl_line, 0U));
+  Obj.setNameIndex(Attrs.getAttrAsStringIndex(DW_AT_name, *Ctx.Strings));
+  Obj.setLineNumber(Attrs.getAttrAsUnsigned(DW_AT_decl_line, 0U));
 
-  auto DeclFileID = Die.getAttrAsUnsigned(DW_AT_decl_file);
+  auto DeclFileID = Attrs.getAttrAsUnsigned(DW_AT_decl_file);
   if (DeclFileID)
-    setSourceFile(Obj, SourceFileMapping, *DeclFileID);
+    setSourceFile(Obj, Ctx.SourceFileMapping, *DeclFileID);
 
-  if (auto Scp = dynamic_cast<LibScopeView::Scope *>(&Obj))
-    initScopeFromAttrs(*Scp, Die);
-  else if (auto Ty = dynamic_cast<LibScopeView::Type *>(&Obj))
-    initTypeFromAttrs(*Ty, Die);
-  else if (auto Sym = dynamic_cast<LibScopeView::Symbol *>(&Obj))
-    initSymbolFromAttrs(*Sym, Die);
+  if (auto Scp = dyn_cast<LibScopeView::Scope>(&Obj))
+    initScopeFromAttrs(Ctx, *Scp, Attrs);
+  else if (auto Ty = dyn_cast<LibScopeView::Type>(&Obj))
+    initTypeFromAttrs(*Ty, Attrs);
+  else if (auto Sym = dyn_cast<LibScopeView::Symbol>(&Obj))
+    initSymbolFromAttrs(*Sym, Attrs);
 }
 
-void DwarfReader::initScopeFromAttrs(LibScopeView::Scope &Scp,
-                                     const DwarfDie &Die) {
+template <typename AttrsTy>
+void DwarfReader::initScopeFromAttrs(CreationContext &Ctx,
+                                     LibScopeView::Scope &Scp,
+                                     const AttrsTy &Attrs) {
   Scp.resolveQualifiedName();
 
   // Parents of template packs are templates.
   if (Scp.getIsTemplatePack())
-    if (auto ScpParent = dynamic_cast<LibScopeView::Scope *>(Scp.getParent()))
+    if (auto ScpParent = Scp.getParent())
       ScpParent->setIsTemplate();
 
-  // CU lines.
-  if (auto CU = dynamic_cast<LibScopeView::ScopeCompileUnit *>(&Scp))
-    createLines(Die, *CU);
+  // CU lines, which are only read now if the view needs them.
+  if (auto CU = dyn_cast<LibScopeView::ScopeCompileUnit>(&Scp)) {
+    if (getLinesNeeded())
+      createLines(Ctx, *Ctx.CUDie, *CU);
+    else if (Ctx.CUDie->hasAttr(DW_AT_stmt_list))
+      CU->setLineTablePending(*this);
+  }
   // Enum class.
-  else if (auto ScpEnum =
-               dynamic_cast<LibScopeView::ScopeEnumeration *>(&Scp)) {
-    if (Die.getAttrAsFlag(DW_AT_enum_class))
+  else if (auto ScpEnum = dyn_cast<LibScopeView::ScopeEnumeration>(&Scp)) {
+    if (Attrs.getAttrAsFlag(DW_AT_enum_class))
       ScpEnum->setIsClass();
   }
   // Functions.
-  else if (auto Func = dynamic_cast<LibScopeView::ScopeFunction *>(&Scp)) {
-    if (Die.getAttrAsFlag(DW_AT_declaration))
+  else if (auto Func = dyn_cast<LibScopeView::ScopeFunction>(&Scp)) {
+    if (Attrs.getAttrAsFlag(DW_AT_declaration))
       Func->setIsDeclaration();
 
     // A function is static if it is missing DW_AT_external and its declaration
     // (if it exists) is missing DW_AT_external.
-    if (!Die.hasAttr(DW_AT_specification) && !Die.getAttrAsFlag(DW_AT_external))
+    if (!Attrs.hasAttr(DW_AT_specification) &&
+        !Attrs.getAttrAsFlag(DW_AT_external))
       Func->setIsStatic();
     // The references aren't set up yet, so addObjectReference checks if the
     // declaration is static.
 
-    if (auto Inline = Die.getAttrAsUnsigned(DW_AT_inline))
+    if (auto Inline = Attrs.getAttrAsUnsigned(DW_AT_inline))
       if (*Inline == DW_INL_declared_inlined ||
           *Inline == DW_INL_declared_not_inlined)
         Func->setIsDeclaredInline();
   }
 }
 
+template <typename AttrsTy>
 void DwarfReader::initTypeFromAttrs(LibScopeView::Type &Ty,
-                                    const DwarfDie &Die) const {
+                                    const AttrsTy &Attrs) const {
   Ty.resolveQualifiedName();
 
   // Parents of template parameters are templates.
-  if (Ty.getIsTemplateParam() && Ty.getParent()->getIsScope())
-    if (auto ScpParent = dynamic_cast<LibScopeView::Scope *>(Ty.getParent()))
+  if (Ty.getIsTemplateParam())
+    if (auto ScpParent = Ty.getParent())
       ScpParent->setIsTemplate();
 
   // PrimitiveType byte size.
   if (Ty.getIsBaseType()) {
-    Dwarf_Unsigned ByteSize = Die.getAttrAsUnsigned(DW_AT_byte_size, 0U);
+    Dwarf_Unsigned ByteSize = Attrs.getAttrAsUnsigned(DW_AT_byte_size, 0U);
     assert(ByteSize < std::numeric_limits<unsigned>::max());
     Ty.setByteSize(static_cast<unsigned>(ByteSize));
   }
   // Enum values and template values.
   else if (Ty.getIsEnumerator() || Ty.getIsTemplateValue()) {
-    if (auto Val = Die.getAttrAsSignedOrUnsigned(DW_AT_const_value)) {
+    if (auto Val = Attrs.getAttrAsSignedOrUnsigned(DW_AT_const_value)) {
       if (Val->IsSigned)
         Ty.setValue(std::to_string(Val->SignedValue).c_str());
       else
@@ -500,7 +1202,7 @@ void DwarfReader::initTypeFromAttrs(LibScopeView::Type &Ty,
   }
   // Template template value.
   else if (Ty.getIsTemplateTemplate()) {
-    if (auto TemplateName = Die.getAttrAsString(DW_AT_GNU_template_name))
+    if (auto TemplateName = Attrs.getAttrAsString(DW_AT_GNU_template_name))
       Ty.setValue(TemplateName.getValue().c_str());
   }
   // Subranges.
@@ -509,11 +1211,11 @@ void DwarfReader::initTypeFromAttrs(LibScopeView::Type &Ty,
     SubrangeName << "[";
 
     // Default lower bound for C++ is 0.
-    Dwarf_Unsigned Lower = Die.getAttrAsUnsigned(DW_AT_lower_bound, 0U);
+    Dwarf_Unsigned Lower = Attrs.getAttrAsUnsigned(DW_AT_lower_bound, 0U);
     try {
-      if (auto Count = Die.getAttrAsUnsigned(DW_AT_count))
+      if (auto Count = Attrs.getAttrAsUnsigned(DW_AT_count))
         SubrangeName << (Lower + *Count);
-      else if (auto Upper = Die.getAttrAsUnsigned(DW_AT_upper_bound)) {
+      else if (auto Upper = Attrs.getAttrAsUnsigned(DW_AT_upper_bound)) {
         if (Lower != 0)
           SubrangeName << Lower << ".." << *Upper;
         else
@@ -533,116 +1235,114 @@ void DwarfReader::initTypeFromAttrs(LibScopeView::Type &Ty,
   }
   // Inheritance.
   else if (Ty.getIsInheritance()) {
-    auto &Inheritance = dynamic_cast<LibScopeView::TypeImport &>(Ty);
-    Inheritance.setInheritanceAccess(getAccessSpecifier(Die));
+    auto &Inheritance = cast<LibScopeView::TypeImport>(Ty);
+    Inheritance.setInheritanceAccess(getAccessSpecifier(Attrs));
   }
 }
 
+template <typename AttrsTy>
 void DwarfReader::initSymbolFromAttrs(LibScopeView::Symbol &Sym,
-                                      const DwarfDie &Die) {
+                                      const AttrsTy &Attrs) {
   if (Sym.getIsMember())
-    Sym.setAccessSpecifier(getAccessSpecifier(Die));
+    Sym.setAccessSpecifier(getAccessSpecifier(Attrs));
 }
 
-void DwarfReader::createLines(const DwarfDie &CUDie,
+void DwarfReader::createLines(CreationContext &Ctx, const DwarfDie &CUDie,
                               LibScopeView::ScopeCompileUnit &CUObj) {
-  auto LineTable = CUDie.getLineTable();
-
-  for (size_t LineIndex = 0; LineIndex < LineTable.size(); ++LineIndex) {
-    auto DwarfLine = LineTable[LineIndex];
-    auto *Ln = new LibScopeView::Line(1U);
+  auto DwarfLines = CUDie.getLineTable();
 
-    Ln->setIsLineRecord();
-    CUObj.addObject(Ln);
-    Ln->setLineNumber(DwarfLine.LineNo);
-    Ln->setAddress(DwarfLine.LineAddr);
-    Ln->setDieOffset(static_cast<Dwarf_Off>(DwarfLine.LineAddr));
+  // Look up each source file in the string pool once, not once per line.
+  std::vector<size_t> FileNameIndexes;
+  FileNameIndexes.reserve(Ctx.SourceFileMapping.size());
+  for (const std::string &FileName : Ctx.SourceFileMapping)
+    FileNameIndexes.push_back(LibScopeView::StringPool::getStringIndex(
+        LibScopeView::unifyFilePath(FileName)));
 
-    setSourceFile(*Ln, SourceFileMapping, DwarfLine.SrcFileID);
+  LibScopeView::LineTable Lines;
+  Lines.reserve(DwarfLines.size());
+  for (size_t LineIndex = 0; LineIndex < DwarfLines.size(); ++LineIndex) {
+    const DwarfLineEntry &DwarfLine = DwarfLines[LineIndex];
 
     // set DWARF qualifiers.
-    Ln->setDiscriminator(static_cast<Dwarf_Half>(DwarfLine.Discriminator));
+    uint8_t Flags = LibScopeView::lf_has_discriminator;
     if (DwarfLine.IsBeginStatement)
-      Ln->setIsNewStatement();
+      Flags |= LibScopeView::lf_new_statement;
     if (DwarfLine.IsBeginBlock)
-      Ln->setIsNewBasicBlock();
+      Flags |= LibScopeView::lf_basic_block;
     if (DwarfLine.IsEndSequence)
-      Ln->setIsLineEndSequence();
+      Flags |= LibScopeView::lf_end_sequence;
     if (DwarfLine.IsEpilogueBegin)
-      Ln->setIsEpilogueBegin();
+      Flags |= LibScopeView::lf_epilogue_begin;
     if (DwarfLine.IsPrologEnd)
-      Ln->setIsPrologueEnd();
+      Flags |= LibScopeView::lf_prologue_end;
+
+    // An unknown file keeps its ID as the index, see setSourceFile.
+    size_t FileNameIndex = static_cast<size_t>(DwarfLine.SrcFileID);
+    if (DwarfLine.SrcFileID < FileNameIndexes.size())
+      FileNameIndex = FileNameIndexes[FileNameIndex];
+    else
+      Flags |= LibScopeView::lf_invalid_filename;
+
+    Lines.addRow(DwarfLine.LineAddr, DwarfLine.LineNo, FileNameIndex,
+                 static_cast<Dwarf_Half>(DwarfLine.Discriminator), Flags);
   }
+  CUObj.setLineTable(std::move(Lines));
 }
 
-void DwarfReader::initObjectReferences(LibScopeView::Object &Obj,
-                                       const DwarfDie &Die) {
-  // Set type or add to missing list to be resolved later.
-  auto TypeOffset = Die.getAttrAsRef(DW_AT_type);
-  // DW_AT_import is treated as a type by LibScopeView.
-  if (!TypeOffset)
-    TypeOffset = Die.getAttrAsRef(DW_AT_import);
-
-  if (TypeOffset) {
-    auto IT = CreatedObjects.find(*TypeOffset);
-    if (IT != CreatedObjects.end()) {
-      Obj.setType(IT->second);
-      // If the type is in another CU mark it as global.
-      if (*TypeOffset < CurrentCURange.first ||
-          *TypeOffset > CurrentCURange.second)
-        IT->second->setIsGlobalReference();
-    } else
-      // Set the type for this Object when we encounter TypeOffset.
-      TypesToBeSet.emplace(*TypeOffset, &Obj);
-  }
-
-  // Set reference from a DW_AT_specification / DW_AT_abstract_origin /
-  // DW_AT_extension or add to list to be resolved later.
-  auto ReferenceOffset = Die.getAttrAsRef(DW_AT_specification);
-  if (!ReferenceOffset)
-    ReferenceOffset = Die.getAttrAsRef(DW_AT_abstract_origin);
-  if (!ReferenceOffset)
-    ReferenceOffset = Die.getAttrAsRef(DW_AT_extension);
-
-  if (ReferenceOffset) {
-    auto IT = CreatedObjects.find(*ReferenceOffset);
-    // If the referenced function hasn't been created yet, add to
-    // ReferencesToBeSet for later.
-    if (IT == CreatedObjects.end())
-      ReferencesToBeSet.emplace(*ReferenceOffset, &Obj);
-    else {
-      addObjectReference(&Obj, IT->second);
-      // If the reference is in another CU mark it as global.
-      if (*ReferenceOffset < CurrentCURange.first ||
-          *ReferenceOffset > CurrentCURange.second)
-        IT->second->setIsGlobalReference();
+void DwarfReader::loadLineTable(LibScopeView::ScopeCompileUnit &CU) {
+  std::lock_guard<std::mutex> Lock(LinesMutex);
+  // Another thread may have read the lines while this one was waiting.
+  if (!CU.getLineTablePending())
+    return;
+
+  try {
+    if (!LinesDebugData) {
+      LinesFile.reset(new LibScopeView::FileDescriptor(getInputFile()));
+      LinesDebugData.reset(new DwarfDebugData(LinesFile->get()));
+      LinesDebugData->setNativeData(NativeData.get());
+    }
+    DwarfDie CUDie = LinesDebugData->getDie(CU.getDieOffset());
+    if (!*CUDie) {
+      CU.setLineTable(LibScopeView::LineTable());
+      return;
     }
+    CreationContext Ctx;
+    Ctx.SourceFileMapping = CUDie.getSourceFiles();
+    createLines(Ctx, CUDie, CU);
+  } catch (LibDwarfError &Err) {
+#ifndef NDEBUG
+    std::cerr << Err.getErrorMessage();
+#else
+    static_cast<void>(Err);
+#endif
+    LibScopeError::fatalError(LibScopeError::ErrorCode::ERR_INVALID_DWARF,
+                              getInputFile());
   }
 }
 
-void DwarfReader::updateReferencesToObject(LibScopeView::Object &Obj,
-                                           Dwarf_Off ObjOffset) {
-  // If there are other Objects that have this Object as their type, then update
-  // them.
-  auto TyFoundRange = TypesToBeSet.equal_range(ObjOffset);
-  for (auto IT = TyFoundRange.first; IT != TyFoundRange.second; ++IT) {
-    IT->second->setType(&Obj);
-    // If the other Object is in another CU mark this Object as global.
-    if (IT->second->getDieOffset() < CurrentCURange.first ||
-        IT->second->getDieOffset() > CurrentCURange.second)
-      Obj.setIsGlobalReference();
-  }
-  TypesToBeSet.erase(TyFoundRange.first, TyFoundRange.second);
-
-  // If there are other Objects that have this Object as a reference then update
-  // them.
-  auto RefFoundRange = ReferencesToBeSet.equal_range(ObjOffset);
-  for (auto IT = RefFoundRange.first; IT != RefFoundRange.second; ++IT) {
-    addObjectReference(IT->second, &Obj);
-    // If the other Object is in another CU mark this Object as global.
-    if (IT->second->getDieOffset() < CurrentCURange.first ||
-        IT->second->getDieOffset() > CurrentCURange.second)
-      IT->second->setIsGlobalReference();
-  }
-  ReferencesToBeSet.erase(RefFoundRange.first, RefFoundRange.second);
+template <typename AttrsTy>
+void DwarfReader::initObjectReferences(CreationContext &Ctx,
+                                       LibScopeView::Object &Obj,
+                                       const AttrsTy &Attrs) {
+  auto addPending = [&Ctx, &Obj](Dwarf_Off Target, bool IsType) {
+    Ctx.PendingReferences.push_back(
+        {Target, &Obj, IsType, isOutsideRange(Target, Ctx.CURange)});
+  };
+
+  // DW_AT_import is treated as a type by LibScopeView.
+  auto TypeOffset = Attrs.getAttrAsRef(DW_AT_type);
+  if (!TypeOffset)
+    TypeOffset = Attrs.getAttrAsRef(DW_AT_import);
+  if (TypeOffset)
+    addPending(*TypeOffset, /*IsType=*/true);
+
+  // A reference from a DW_AT_specification / DW_AT_abstract_origin /
+  // DW_AT_extension.
+  auto ReferenceOffset = Attrs.getAttrAsRef(DW_AT_specification);
+  if (!ReferenceOffset)
+    ReferenceOffset = Attrs.getAttrAsRef(DW_AT_abstract_origin);
+  if (!ReferenceOffset)
+    ReferenceOffset = Attrs.getAttrAsRef(DW_AT_extension);
+  if (ReferenceOffset)
+    addPending(*ReferenceOffset, /*IsType=*/false);
 }
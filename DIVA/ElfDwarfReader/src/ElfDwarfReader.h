@@ -34,87 +34,277 @@
 
 #include "Reader.h"
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <set>
-#include <unordered_map>
-#include <unordered_set>
+#include <string>
+#include <vector>
+
+namespace LibScopeView {
+class FileDescriptor;
+} // end namespace LibScopeView
 
 namespace ElfDwarfReader {
 
+struct DwarfCompileUnit;
 class DwarfDebugData;
 class DwarfDie;
+class DwarfStringCache;
+class NativeDebugData;
 
 class DwarfReader : public LibScopeView::Reader {
 public:
-  explicit DwarfReader(LibScopeView::ViewSpecification *spec)
-      : LibScopeView::Reader(spec) {}
+  explicit DwarfReader(LibScopeView::ViewSpecification *spec);
 
-  ~DwarfReader() override {}
+  ~DwarfReader() override;
 
   DwarfReader(const DwarfReader &) = delete;
   DwarfReader &operator=(const DwarfReader &) = delete;
 
 private:
+  /// A type or reference from an object to the Die at Target, which is set
+  /// once all the objects have been created.
+  struct PendingReference {
+    Dwarf_Off Target;
+    LibScopeView::Object *Obj;
+    // A DW_AT_type or DW_AT_import, rather than a DW_AT_specification,
+    // DW_AT_abstract_origin or DW_AT_extension.
+    bool IsType;
+    // Target is not in the compile unit of Obj.
+    bool IsCrossUnit;
+  };
+
+  /// A Die read in pushdown mode, whose object may not have been created.
+  /// The offset is from the start of its compile unit, and the parent is the
+  /// index of the parent Die in the same compile unit.
+  struct WalkedDie {
+    uint32_t Offset;
+    uint32_t Parent : 31;
+    // A child is a template parameter, which makes this a template.
+    uint32_t IsTemplate : 1;
+  };
+
+  /// The Dies of a compile unit read in pushdown mode, in offset order, so an
+  /// object that is needed after all have been read can be created then.
+  struct WalkedUnit {
+    std::pair<Dwarf_Off, Dwarf_Off> CURange;
+    Dwarf_Off CUDieOffset;
+    std::vector<WalkedDie> Dies;
+  };
+
+  /// The name a pattern is matched against, once the references are set, of
+  /// a Die in the compile unit being read in pushdown mode.
+  struct WalkedName {
+    size_t NameIndex;
+    Dwarf_Half Tag;
+    // The name is not known until the objects have been created.
+    bool IsUnknown;
+  };
+
+  /// A Die whose children are being read in pushdown mode, see
+  /// createMatchedObject().
+  template <typename DieTy> struct PendingObject;
+
+  /// State used while creating the objects of one or more compile units.
+  struct CreationContext {
+    CreationContext()
+        : CUDie(nullptr), Arena(nullptr), Strings(nullptr), Pushdown(false),
+          MatchPatterns(false), InOffsetOrder(true) {}
+
+    // Offset range of the current CU.
+    std::pair<Dwarf_Off, Dwarf_Off> CURange;
+
+    // Mapping from DWARF file IDs to the file paths in the current CU.
+    std::vector<std::string> SourceFileMapping;
+
+    // The libdwarf Die of the current CU, which is used to read the lines
+    // whichever decoder is creating the objects.
+    const DwarfDie *CUDie;
+
+    // The arena the objects are created in.
+    LibScopeView::ObjectArena *Arena;
+
+    // The StringPool indexes of the names in the string sections.
+    DwarfStringCache *Strings;
+
+    // The created Objects and their DWARF offsets. The Dies are read in the
+    // order they appear in .debug_info, so this is sorted by offset.
+    std::vector<std::pair<Dwarf_Off, LibScopeView::Object *>> CreatedObjects;
+
+    // The types and references of the created Objects.
+    std::vector<PendingReference> PendingReferences;
+
+    // Unknown DWARF tags in the order they were seen, waiting to be reported.
+    std::vector<Dwarf_Half> UnknownTags;
+
+    // Only the objects needed to print the view are created.
+    bool Pushdown;
+
+    // In pushdown mode, the objects are only created if they may match the
+    // --filter or --tree patterns, or are needed to print the matches.
+    bool MatchPatterns;
+
+    // The objects are created in the order of their Dies, which is not so
+    // for those created by createReferencedObjects().
+    bool InOffsetOrder;
+
+    // The compile units read in pushdown mode, and the names of the Dies of
+    // the last one.
+    std::vector<WalkedUnit> WalkedUnits;
+    std::vector<WalkedName> WalkedNames;
+
+    // The number of Dies of each tag in the tag table that were read in
+    // pushdown mode without creating their objects, for the summary. A
+    // context that only creates the left out objects has negative counts.
+    std::vector<int64_t> UncreatedTags;
+  };
+
+  /// For each tag in the tag table, if the objects of the tag may be printed
+  /// by the view or needed by those that are. It is empty if all the objects
+  /// are needed.
+  std::vector<bool> NeededTags;
+
   /// Create the full scope tree.
   bool createScopes() override;
 
   /// Create each compile unit.
-  void createCompileUnits(const DwarfDebugData &DebugData,
+  void createCompileUnits(DwarfDebugData &DebugData,
                           LibScopeView::ScopeRoot &Root);
 
+  /// Create the compile units using several threads, each with its own
+  /// libdwarf instance, and then add them to the root in their DWARF order.
+  void createCompileUnitsInParallel(const std::vector<DwarfCompileUnit> &CUs,
+                                    unsigned Jobs, DwarfDebugData &DebugData,
+                                    const NativeDebugData *Native,
+                                    LibScopeView::ScopeRoot &Root);
+
+  /// Create a compile unit and its children. The Dies are read with the
+  /// native decoder when Native is not null, otherwise with libdwarf.
+  LibScopeView::Object *createCompileUnit(CreationContext &Ctx,
+                                          const DwarfDebugData &DebugData,
+                                          const DwarfDie &CUDie,
+                                          const NativeDebugData *Native,
+                                          LibScopeView::Scope *ParentScope);
+
+  /// Compile the print options into NeededTags.
+  void compileNeededTags();
+
+  /// Add the objects that were left out in pushdown mode to the summary, by
+  /// the kind they would have been created as.
+  void countUncreatedObjects(const std::vector<CreationContext> &Contexts);
+
+  /// Set the types and references of all the created objects, in one pass
+  /// over the objects in offset order. The contexts must be in offset order.
+  void resolveReferences(std::vector<CreationContext> &Contexts);
+
+  /// Create the objects that were left out in pushdown mode but are the
+  /// types or references of created objects, along with their parents, until
+  /// every reference can be resolved.
+  void createReferencedObjects(const DwarfDebugData &DebugData,
+                               const NativeDebugData *Native,
+                               std::vector<CreationContext> &Contexts);
+
   /// Create a LibScopeView::Object from a Die and then recursivly create its
-  /// children.
-  void createObject(const DwarfDebugData &DebugData, const DwarfDie &Die,
-                    LibScopeView::Object &ParentObj,
-                    LibScopeView::LevelType Level);
+  /// children. The object is added to ParentScope, unless it is null.
+  ///
+  /// DieTy is either a DwarfDie or a NativeDie, depending on the decoder.
+  template <typename DieTy>
+  LibScopeView::Object *createObject(CreationContext &Ctx, const DieTy &Die,
+                                     LibScopeView::Scope *ParentScope,
+                                     LibScopeView::LevelType Level);
+
+  /// Create a LibScopeView::Object from a Die in pushdown mode. The objects
+  /// are only created for the Dies of the NeededTags and their parents. The
+  /// --filter or --tree patterns are matched against the name the Die's
+  /// object will have, as far as it is known from the Dies read so far, and
+  /// then a Die must also be a match or under a --tree match. A --tree match
+  /// is created whatever its tag. The children that give an array or
+  /// subroutine type its name are all created.
+  ///
+  /// Parent is the pending parent Die, which is null for a compile unit.
+  template <typename DieTy>
+  LibScopeView::Object *createMatchedObject(CreationContext &Ctx,
+                                            const DieTy &Die,
+                                            PendingObject<DieTy> *Parent,
+                                            LibScopeView::Scope *ParentScope,
+                                            LibScopeView::LevelType Level);
+
+  /// Create the object of a pending Die, and those of its parents first.
+  template <typename DieTy>
+  LibScopeView::Object *createPendingObject(CreationContext &Ctx,
+                                            PendingObject<DieTy> &Pending);
+
+  /// Check if the object of a Die read in pushdown mode may match the
+  /// patterns, and record the name it is matched against.
+  template <typename AttrsTy>
+  bool mayMatchPatterns(CreationContext &Ctx, Dwarf_Off ObjOffset,
+                        Dwarf_Half ObjTag, const AttrsTy &Attrs);
+
+  /// Create a LibScopeView::Object from a Die's decoded attributes, without
+  /// its children. The object is added to ParentScope, unless it is null.
+  template <typename AttrsTy>
+  LibScopeView::Object *
+  createObjectFromAttrs(CreationContext &Ctx, Dwarf_Off ObjOffset,
+                        Dwarf_Half ObjTag, const AttrsTy &Attrs,
+                        LibScopeView::Scope *ParentScope,
+                        LibScopeView::LevelType Level);
 
   /// Create the appropriate subclass of LibScopeView::Object for the given
   /// DWARF tag.
-  LibScopeView::Object *createObjectByTag(Dwarf_Half Tag,
-                                          LibScopeView::LevelType Level);
+  static LibScopeView::Object *createObjectByTag(CreationContext &Ctx,
+                                                 Dwarf_Half Tag,
+                                                 LibScopeView::LevelType Level);
+
+  /// Warn about the unknown DWARF tags that have not been reported yet.
+  void reportUnknownTags(CreationContext &Ctx);
 
   /// setup the objects state from attributes on the DWARF Die.
-  void initObjectFromAttrs(LibScopeView::Object &Obj, const DwarfDie &Die,
-                           Dwarf_Off ObjOffset, Dwarf_Half ObjTag);
+  ///
+  /// AttrsTy is the result of decodeAttributes() on the Die, so each init
+  /// function reads from the same single pass over the Die's attributes.
+  template <typename AttrsTy>
+  void initObjectFromAttrs(CreationContext &Ctx, LibScopeView::Object &Obj,
+                           const AttrsTy &Attrs, Dwarf_Off ObjOffset,
+                           Dwarf_Half ObjTag);
 
-  void initScopeFromAttrs(LibScopeView::Scope &Scp, const DwarfDie &Die);
-  void initTypeFromAttrs(LibScopeView::Type &Ty, const DwarfDie &Die) const;
+  template <typename AttrsTy>
+  void initScopeFromAttrs(CreationContext &Ctx, LibScopeView::Scope &Scp,
+                          const AttrsTy &Attrs);
+  template <typename AttrsTy>
+  void initTypeFromAttrs(LibScopeView::Type &Ty, const AttrsTy &Attrs) const;
+  template <typename AttrsTy>
   static void initSymbolFromAttrs(LibScopeView::Symbol &Sym,
-                                  const DwarfDie &Die);
+                                  const AttrsTy &Attrs);
 
   /// Create all the lines in a compile unit.
-  void createLines(const DwarfDie &CUDie,
+  void createLines(CreationContext &Ctx, const DwarfDie &CUDie,
                    LibScopeView::ScopeCompileUnit &CUObj);
 
-  /// setup any references from this object to other objects.
-  ///
-  /// If the other object doesn't exist yet, then record that this reference
-  /// needs to be updated when the other object is created.
-  void initObjectReferences(LibScopeView::Object &Obj, const DwarfDie &Die);
-
-  /// set any references from other objects to this object now that it exists.
-  void updateReferencesToObject(LibScopeView::Object &Obj, Dwarf_Off ObjOffset);
-
-  // Offset range of the current CU.
-  std::pair<Dwarf_Off, Dwarf_Off> CurrentCURange;
+  /// Read the lines of a compile unit that were left pending because the view
+  /// doesn't print them. The file is opened again the first time this is
+  /// called, and kept open for the other compile units.
+  void loadLineTable(LibScopeView::ScopeCompileUnit &CU) override;
 
-  // Mapping from DWARF file IDs to the file paths in the current CU.
-  std::vector<std::string> SourceFileMapping;
-
-  // Mapping from DWARF offsets to already created Objects.
-  std::unordered_map<Dwarf_Off, LibScopeView::Object *> CreatedObjects;
-
-  // Map of DWARF offsets to multiple Objects, where the offset is of Die that
-  // hasn't been read yet, and each of the mapped objects needs to have its
-  // type set to the Object that will be created from that Die.
-  std::unordered_multimap<Dwarf_Off, LibScopeView::Object *> TypesToBeSet;
-
-  // Map of DWARF offsets to multiple Objects, where the offset is of Die that
-  // hasn't been read yet, and each of the mapped objects needs to have its
-  // reference set to the Object that will be created from that Die.
-  std::unordered_multimap<Dwarf_Off, LibScopeView::Object *> ReferencesToBeSet;
+  /// Record the references from this object to other objects, to be set by
+  /// resolveReferences().
+  template <typename AttrsTy>
+  static void initObjectReferences(CreationContext &Ctx,
+                                   LibScopeView::Object &Obj,
+                                   const AttrsTy &Attrs);
 
   // Unknown DWARF tags that have already been seen (avoids duplicate warnings).
   std::set<Dwarf_Half> UnknownDWTags;
+
+  // The native decoder's data, if it is used. It is kept for reading the
+  // pending lines.
+  std::unique_ptr<NativeDebugData> NativeData;
+
+  // The libdwarf instance used to read pending lines, and a lock so they can
+  // be read from several threads.
+  std::unique_ptr<LibScopeView::FileDescriptor> LinesFile;
+  std::unique_ptr<DwarfDebugData> LinesDebugData;
+  std::mutex LinesMutex;
 };
 
 } // end namespace ElfDwarfReader
@@ -29,6 +29,8 @@
 //===----------------------------------------------------------------------===//
 
 #include "LibDwarfHelpers.h"
+#include "NativeDwarfDecoder.h"
+#include "StringPool.h"
 
 #include <cstdlib>
 
@@ -43,6 +45,21 @@ const bool IsInfo = true;
   throw LibDwarfError(Error, Dbg);
 }
 
+// get the value of an attribute that is either signed or unsigned.
+DwarfDie::SignedUnsigned formSignedOrUnsigned(Dwarf_Attribute Attribute) {
+  DwarfDie::SignedUnsigned Result;
+  // Check sign.
+  Dwarf_Bool IsSigned;
+  dwarf_hasform(Attribute, DW_FORM_sdata, &IsSigned, nullptr);
+  Result.IsSigned = (IsSigned != 0);
+  // Get value.
+  if (Result.IsSigned)
+    dwarf_formsdata(Attribute, &Result.SignedValue, nullptr);
+  else
+    dwarf_formudata(Attribute, &Result.UnsignedValue, nullptr);
+  return Result;
+}
+
 } // end anonymous namespace.
 
 LibDwarfError::LibDwarfError(Dwarf_Error Err, Dwarf_Debug Dbg)
@@ -75,7 +92,8 @@ std::string ElfDwarfReader::getDwarfTagAsString(Dwarf_Half Tag) {
 
 // DwarfDebugData methods.
 
-DwarfDebugData::DwarfDebugData(int FileDescriptor) : Dbg(nullptr) {
+DwarfDebugData::DwarfDebugData(int FileDescriptor)
+    : Dbg(nullptr), Native(nullptr) {
   // Errors in dwarf_init occur before the handler is setup, so use the error
   // pointer interface here, and then throw the exception 'manually'.
   Dwarf_Error Err;
@@ -88,7 +106,8 @@ DwarfDebugData::DwarfDebugData(int FileDescriptor) : Dbg(nullptr) {
   }
 }
 
-DwarfDebugData::DwarfDebugData(DwarfDebugData &&Other) : Dbg(nullptr) {
+DwarfDebugData::DwarfDebugData(DwarfDebugData &&Other)
+    : Dbg(nullptr), Native(Other.Native) {
   std::swap(Dbg, Other.Dbg);
 }
 
@@ -97,6 +116,7 @@ DwarfDebugData &DwarfDebugData::operator=(DwarfDebugData &&Other) {
     freeDbg();
     std::swap(Dbg, Other.Dbg);
   }
+  Native = Other.Native;
   return *this;
 }
 
@@ -139,12 +159,33 @@ std::vector<DwarfCompileUnit> DwarfDebugData::getCompileUnits() const {
   return Result;
 }
 
+DwarfDie DwarfDebugData::getDie(Dwarf_Off Offset) const {
+  Dwarf_Die RawDie = nullptr;
+  if (dwarf_offdie_b(Dbg, Offset, IsInfo, &RawDie, nullptr) != DW_DLV_OK)
+    RawDie = nullptr;
+  return DwarfDie(*this, RawDie);
+}
+
 std::string DwarfDebugData::copyAndFreeDwarfString(char *DwarfStr) const {
   std::string Result(DwarfStr);
   dwarf_dealloc(Dbg, DwarfStr, DW_DLA_STRING);
   return Result;
 }
 
+// DwarfStringCache methods.
+
+size_t DwarfStringCache::getStringIndex(const char *Str, Dwarf_Half Form) {
+  if (!isStringSectionForm(Form))
+    return LibScopeView::StringPool::getStringIndex(Str);
+
+  auto Inserted = Indexes.emplace(Str, 0U);
+  if (Inserted.second)
+    Inserted.first->second = LibScopeView::StringPool::getStringIndex(Str);
+  else
+    ++Hits;
+  return Inserted.first->second;
+}
+
 // DwarfDie methods.
 
 DwarfDie::DwarfDie(DwarfDie &&Other)
@@ -194,7 +235,39 @@ std::string DwarfDie::getTagName() const {
   return (ret == DW_DLV_OK) ? TagName : "";
 }
 
-DwarfLineTable DwarfDie::getLineTable() const { return DwarfLineTable(*this); }
+DwarfDieAttributes DwarfDie::decodeAttributes() const {
+  return DwarfDieAttributes(DebugData, Die);
+}
+
+DwarfLineTable DwarfDie::getLineTable() const {
+  if (const NativeDebugData *Native = DebugData.getNativeData())
+    return DwarfLineTable(Native->getLineTable(getGlobalOffset()).Rows);
+  return DwarfLineTable(*this);
+}
+
+std::vector<std::string> DwarfDie::getSourceFiles() const {
+  if (const NativeDebugData *Native = DebugData.getNativeData())
+    return Native->getLineTable(getGlobalOffset(), /*FilesOnly=*/true)
+        .FileNames;
+
+  std::vector<std::string> Files;
+  char **SourceFiles = nullptr;
+  Dwarf_Signed SourceFilesCount;
+  auto Ret = dwarf_srcfiles(Die, &SourceFiles, &SourceFilesCount, nullptr);
+  if (Ret != DW_DLV_OK)
+    return Files;
+
+  // A file ID of 0 always means no file, so set [0] to empty string.
+  Files.emplace_back("");
+
+  for (Dwarf_Signed i = 0; i < SourceFilesCount; ++i) {
+    Files.emplace_back(SourceFiles[i]);
+    dwarf_dealloc(*DebugData, SourceFiles[i], DW_DLA_STRING);
+  }
+  dwarf_dealloc(*DebugData, SourceFiles, DW_DLA_LIST);
+
+  return Files;
+}
 
 void DwarfDie::freeDie() {
   if (Die) {
@@ -250,16 +323,7 @@ DwarfDie::getAttrAsSignedOrUnsigned(Dwarf_Half Attr) const {
   int ret = dwarf_attr(Die, Attr, &Attribute, nullptr);
   if (ret != DW_DLV_OK)
     return OptionalAttrValue<SignedUnsigned>();
-  SignedUnsigned Result;
-  // Check sign.
-  Dwarf_Bool IsSigned;
-  dwarf_hasform(Attribute, DW_FORM_sdata, &IsSigned, nullptr);
-  Result.IsSigned = (IsSigned != 0);
-  // Get value.
-  if (Result.IsSigned)
-    dwarf_formsdata(Attribute, &Result.SignedValue, nullptr);
-  else
-    dwarf_formudata(Attribute, &Result.UnsignedValue, nullptr);
+  SignedUnsigned Result = formSignedOrUnsigned(Attribute);
   dwarf_dealloc(*DebugData, Attribute, DW_DLA_ATTR);
   return OptionalAttrValue<SignedUnsigned>(Result);
 }
@@ -318,6 +382,143 @@ DwarfDie::OptionalAttrValue<ValTy> DwarfDie::getAttr(Dwarf_Half Attr,
   return OptionalAttrValue<ValTy>(Result);
 }
 
+// DwarfDieAttributes methods.
+
+DwarfDieAttributes::DwarfDieAttributes(const DwarfDebugData &DbgData,
+                                       Dwarf_Die RawDie)
+    : DebugData(DbgData), Attrs() {
+  Dwarf_Attribute *AttrList;
+  Dwarf_Signed AttrCount;
+  if (dwarf_attrlist(RawDie, &AttrList, &AttrCount, nullptr) != DW_DLV_OK)
+    return;
+
+  // Keep the first of each attribute that is used (as dwarf_attr would find),
+  // and free the rest.
+  for (Dwarf_Signed Index = 0; Index < AttrCount; ++Index) {
+    Dwarf_Half Attr;
+    dwarf_whatattr(AttrList[Index], &Attr, nullptr);
+    size_t Slot = getDecodedAttrSlot(Attr);
+    if (Slot < NumDecodedAttrs && !Attrs[Slot])
+      Attrs[Slot] = AttrList[Index];
+    else
+      dwarf_dealloc(*DebugData, AttrList[Index], DW_DLA_ATTR);
+  }
+  dwarf_dealloc(*DebugData, AttrList, DW_DLA_LIST);
+}
+
+DwarfDieAttributes::DwarfDieAttributes(DwarfDieAttributes &&Other)
+    : DebugData(Other.DebugData), Attrs() {
+  std::swap(Attrs, Other.Attrs);
+}
+
+void DwarfDieAttributes::freeAttrs() {
+  for (auto &Attribute : Attrs) {
+    if (Attribute)
+      dwarf_dealloc(*DebugData, Attribute, DW_DLA_ATTR);
+    Attribute = nullptr;
+  }
+}
+
+Dwarf_Attribute DwarfDieAttributes::findAttr(Dwarf_Half Attr) const {
+  size_t Slot = getDecodedAttrSlot(Attr);
+  assert(Slot < NumDecodedAttrs && "Attribute is not decoded");
+  return Slot < NumDecodedAttrs ? Attrs[Slot] : nullptr;
+}
+
+bool DwarfDieAttributes::hasAttr(Dwarf_Half Attr) const {
+  return findAttr(Attr) != nullptr;
+}
+
+#define GET_ATTR(TYPE, GETTER_FUNC, ATTR)                                      \
+  getAttr<TYPE, decltype(GETTER_FUNC)>(ATTR, GETTER_FUNC)
+
+bool DwarfDieAttributes::getAttrAsFlag(Dwarf_Half Attr) const {
+  auto Ret = GET_ATTR(Dwarf_Bool, dwarf_formflag, Attr);
+  return Ret.hasValue() && Ret.getValue() != 0;
+}
+const DwarfDieAttributes::OptionalAttrValue<Dwarf_Off>
+DwarfDieAttributes::getAttrAsRef(Dwarf_Half Attr) const {
+  return GET_ATTR(Dwarf_Off, dwarf_global_formref, Attr);
+}
+const DwarfDieAttributes::OptionalAttrValue<Dwarf_Unsigned>
+DwarfDieAttributes::getAttrAsUnsigned(Dwarf_Half Attr) const {
+  return GET_ATTR(Dwarf_Unsigned, dwarf_formudata, Attr);
+}
+const DwarfDieAttributes::OptionalAttrValue<Dwarf_Signed>
+DwarfDieAttributes::getAttrAsSigned(Dwarf_Half Attr) const {
+  return GET_ATTR(Dwarf_Signed, dwarf_formsdata, Attr);
+}
+const DwarfDieAttributes::OptionalAttrValue<std::string>
+DwarfDieAttributes::getAttrAsString(Dwarf_Half Attr) const {
+  if (auto Ret = GET_ATTR(char *, dwarf_formstring, Attr))
+    return OptionalAttrValue<std::string>(
+        DebugData.copyAndFreeDwarfString(*Ret));
+  return OptionalAttrValue<std::string>();
+}
+
+#undef GET_ATTR
+
+size_t DwarfDieAttributes::getAttrAsStringIndex(Dwarf_Half Attr,
+                                                DwarfStringCache &Cache) const {
+  Dwarf_Attribute Attribute = findAttr(Attr);
+  if (!Attribute)
+    return 0U;
+  Dwarf_Half Form = 0;
+  dwarf_whatform(Attribute, &Form, nullptr);
+  // dwarf_formstring returns a pointer into the section data, which isn't
+  // freed.
+  char *Str = nullptr;
+  dwarf_formstring(Attribute, &Str, nullptr);
+  return Cache.getStringIndex(Str, Form);
+}
+
+const DwarfDieAttributes::OptionalAttrValue<DwarfDie::SignedUnsigned>
+DwarfDieAttributes::getAttrAsSignedOrUnsigned(Dwarf_Half Attr) const {
+  Dwarf_Attribute Attribute = findAttr(Attr);
+  if (!Attribute)
+    return OptionalAttrValue<SignedUnsigned>();
+  return OptionalAttrValue<SignedUnsigned>(formSignedOrUnsigned(Attribute));
+}
+
+Dwarf_Off DwarfDieAttributes::getAttrAsRef(Dwarf_Half Attr,
+                                           Dwarf_Off Default) const {
+  if (auto Ret = getAttrAsRef(Attr))
+    return *Ret;
+  return Default;
+}
+Dwarf_Unsigned
+DwarfDieAttributes::getAttrAsUnsigned(Dwarf_Half Attr,
+                                      Dwarf_Unsigned Default) const {
+  if (auto Ret = getAttrAsUnsigned(Attr))
+    return *Ret;
+  return Default;
+}
+Dwarf_Signed DwarfDieAttributes::getAttrAsSigned(Dwarf_Half Attr,
+                                                 Dwarf_Signed Default) const {
+  if (auto Ret = getAttrAsSigned(Attr))
+    return *Ret;
+  return Default;
+}
+std::string DwarfDieAttributes::getAttrAsString(
+    Dwarf_Half Attr, const std::string &Default) const {
+  if (auto Ret = getAttrAsString(Attr))
+    return *Ret;
+  return Default;
+}
+
+// As DwarfDie::getAttr, but the attribute has already been found and is owned
+// by this object.
+template <typename ValTy, typename getterFunc>
+DwarfDieAttributes::OptionalAttrValue<ValTy>
+DwarfDieAttributes::getAttr(Dwarf_Half Attr, getterFunc getter) const {
+  Dwarf_Attribute Attribute = findAttr(Attr);
+  if (!Attribute)
+    return OptionalAttrValue<ValTy>();
+  ValTy Result;
+  getter(Attribute, &Result, nullptr);
+  return OptionalAttrValue<ValTy>(Result);
+}
+
 // DwarfDieChildIterator methods.
 
 DwarfDieChildIterator::DwarfDieChildIterator(const DwarfDie &Parent) {
@@ -341,6 +542,24 @@ DwarfDieChildIterator &DwarfDieChildIterator::operator++() {
   return *this;
 }
 
+// DwarfDieChildCursor methods.
+
+DwarfDieChildCursor::DwarfDieChildCursor(const DwarfDie &Parent)
+    : Child(Parent.DebugData, nullptr) {
+  Dwarf_Die RawChildDie;
+  if (dwarf_child(*Parent, &RawChildDie, nullptr) == DW_DLV_OK)
+    Child = DwarfDie(Parent.DebugData, RawChildDie);
+}
+
+void DwarfDieChildCursor::next() {
+  assert(!atEnd() && "Incremented end DwarfDieChildCursor");
+  Dwarf_Die RawChildDie = nullptr;
+  int ret = dwarf_siblingof_b(Child.DebugData.get(), *Child, IsInfo,
+                              &RawChildDie, nullptr);
+  // Replace the current child, which frees it.
+  Child = DwarfDie(Child.DebugData, ret == DW_DLV_OK ? RawChildDie : nullptr);
+}
+
 // DwarfLineTable methods.
 
 DwarfLineTable::DwarfLineTable(const DwarfDie &CU) {
@@ -349,59 +568,38 @@ DwarfLineTable::DwarfLineTable(const DwarfDie &CU) {
 
   Dwarf_Unsigned Version;
   Dwarf_Small TableCount;
+  Dwarf_Line_Context Context;
   auto Ret = dwarf_srclines_b(*CU, &Version, &TableCount, &Context, nullptr);
-
-  assert(TableCount <= 1 && "Multiline table is not supported");
-  if (Ret != DW_DLV_OK || TableCount != 1) {
-    freeLines();
-    return;
-  }
-
-  Dwarf_Signed SLineCount;
-  Ret = dwarf_srclines_from_linecontext(Context, &Lines, &SLineCount, nullptr);
-  if (Ret != DW_DLV_OK) {
-    freeLines();
+  if (Ret != DW_DLV_OK)
     return;
-  }
-
-  LineCount = SLineCount < 0 ? 0U : static_cast<size_t>(SLineCount);
-}
 
-DwarfLineTable::DwarfLineTable(DwarfLineTable &&Other)
-    : Context(nullptr), Lines(nullptr), LineCount(0U) {
-  swap(*this, Other);
-}
-
-DwarfLineTable &DwarfLineTable::operator=(DwarfLineTable &&Other) {
-  if (this != &Other) {
-    freeLines();
-    swap(*this, Other);
+  // Two-level tables also have an actuals table, only the logical rows are
+  // used.
+  Dwarf_Line *Lines = nullptr;
+  Dwarf_Signed LineCount = 0;
+  Dwarf_Line *Actuals = nullptr;
+  Dwarf_Signed ActualsCount = 0;
+  if (TableCount == 2)
+    Ret = dwarf_srclines_two_level_from_linecontext(
+        Context, &Lines, &LineCount, &Actuals, &ActualsCount, nullptr);
+  else if (TableCount == 1)
+    Ret = dwarf_srclines_from_linecontext(Context, &Lines, &LineCount,
+                                          nullptr);
+  if (Ret == DW_DLV_OK && Lines && LineCount > 0) {
+    Rows.resize(static_cast<size_t>(LineCount));
+    for (size_t LineIndex = 0; LineIndex < Rows.size(); ++LineIndex) {
+      Dwarf_Line Line = Lines[LineIndex];
+      DwarfLineEntry &Row = Rows[LineIndex];
+      dwarf_lineno(Line, &Row.LineNo, nullptr);
+      dwarf_line_srcfileno(Line, &Row.SrcFileID, nullptr);
+      dwarf_lineaddr(Line, &Row.LineAddr, nullptr);
+
+      dwarf_linebeginstatement(Line, &Row.IsBeginStatement, nullptr);
+      dwarf_lineendsequence(Line, &Row.IsEndSequence, nullptr);
+      dwarf_lineblock(Line, &Row.IsBeginBlock, nullptr);
+      dwarf_prologue_end_etc(Line, &Row.IsPrologEnd, &Row.IsEpilogueBegin,
+                             &Row.ISA, &Row.Discriminator, nullptr);
+    }
   }
-  return *this;
-}
-
-DwarfLineEntry DwarfLineTable::getLine(size_t LineIndex) const {
-  assert(LineIndex < size() && "Index out of range");
-  Dwarf_Line Line = Lines[LineIndex];
-
-  DwarfLineEntry Result;
-  dwarf_lineno(Line, &Result.LineNo, nullptr);
-  dwarf_line_srcfileno(Line, &Result.SrcFileID, nullptr);
-  dwarf_lineaddr(Line, &Result.LineAddr, nullptr);
-
-  dwarf_linebeginstatement(Line, &Result.IsBeginStatement, nullptr);
-  dwarf_lineendsequence(Line, &Result.IsEndSequence, nullptr);
-  dwarf_lineblock(Line, &Result.IsBeginBlock, nullptr);
-  dwarf_prologue_end_etc(Line, &Result.IsPrologEnd, &Result.IsEpilogueBegin,
-                         &Result.ISA, &Result.Discriminator, nullptr);
-
-  return Result;
-}
-
-void DwarfLineTable::freeLines() {
-  if (Context)
-    dwarf_srclines_dealloc_b(Context);
-  Context = nullptr;
-  Lines = nullptr;
-  LineCount = 0U;
+  dwarf_srclines_dealloc_b(Context);
 }
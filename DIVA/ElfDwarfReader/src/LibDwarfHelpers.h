@@ -49,6 +49,7 @@
 #include <exception>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace ElfDwarfReader {
@@ -57,13 +58,20 @@ std::string getDwarfTagAsString(Dwarf_Half Tag);
 
 struct DwarfCompileUnit;
 class DwarfDie;
+class DwarfDieAttributes;
+class DwarfDieChildCursor;
 class DwarfDieChildIterator;
 class DwarfLineTable;
+class DwarfStringCache;
+class NativeDebugData;
 
 /// \brief Exception wrapping a LibDwarf error code.
 class LibDwarfError : public std::exception {
 public:
   LibDwarfError(Dwarf_Error Err, Dwarf_Debug Dbg);
+  /// \brief Create an error outside of libdwarf using a libdwarf error number.
+  LibDwarfError(Dwarf_Unsigned ErrNo, const std::string &Message)
+      : ErrorNumber(ErrNo), ErrorMessage(Message) {}
 
   Dwarf_Unsigned getErrorNumber() const { return ErrorNumber; }
   const std::string &getErrorMessage() const { return ErrorMessage; }
@@ -78,7 +86,7 @@ private:
 /// \brief Wrapper around a Dwarf_Debug with resource management.
 class DwarfDebugData {
 public:
-  DwarfDebugData() : Dbg(nullptr) {}
+  DwarfDebugData() : Dbg(nullptr), Native(nullptr) {}
   explicit DwarfDebugData(int FileDescriptor);
   explicit DwarfDebugData(DwarfDebugData &&Other);
   ~DwarfDebugData() { freeDbg(); }
@@ -96,22 +104,127 @@ public:
   /// \brief get all the compile units in the debug data.
   std::vector<DwarfCompileUnit> getCompileUnits() const;
 
+  /// \brief get the Die at a global offset in the .debug_info section. The
+  /// returned Die wraps nullptr if there is no Die at the offset.
+  DwarfDie getDie(Dwarf_Off Offset) const;
+
   /// \brief Return a copy of a libdwarf c string and then free the libdwarf
   /// memory.
   std::string copyAndFreeDwarfString(char *DwarfStr) const;
 
+  /// \brief Decode the line tables and source files with the native decoder
+  /// instead of libdwarf. The native data must outlive this object.
+  void setNativeData(const NativeDebugData *Data) { Native = Data; }
+  const NativeDebugData *getNativeData() const { return Native; }
+
 private:
   // Free Dbg and set it to nullptr.
   void freeDbg();
 
   Dwarf_Debug Dbg;
+  const NativeDebugData *Native;
+};
+
+/// \brief The number of attributes read by decodeAttributes().
+const size_t NumDecodedAttrs = 19U;
+
+/// \brief get the slot of an attribute in the decoded attributes, or
+/// NumDecodedAttrs if the attribute isn't read by decodeAttributes().
+///
+/// These are all the attributes that the reader uses to create objects.
+inline size_t getDecodedAttrSlot(Dwarf_Half Attr) {
+  switch (Attr) {
+  case DW_AT_name:
+    return 0U;
+  case DW_AT_decl_line:
+    return 1U;
+  case DW_AT_decl_file:
+    return 2U;
+  case DW_AT_type:
+    return 3U;
+  case DW_AT_import:
+    return 4U;
+  case DW_AT_specification:
+    return 5U;
+  case DW_AT_abstract_origin:
+    return 6U;
+  case DW_AT_extension:
+    return 7U;
+  case DW_AT_external:
+    return 8U;
+  case DW_AT_declaration:
+    return 9U;
+  case DW_AT_inline:
+    return 10U;
+  case DW_AT_accessibility:
+    return 11U;
+  case DW_AT_byte_size:
+    return 12U;
+  case DW_AT_const_value:
+    return 13U;
+  case DW_AT_lower_bound:
+    return 14U;
+  case DW_AT_upper_bound:
+    return 15U;
+  case DW_AT_count:
+    return 16U;
+  case DW_AT_enum_class:
+    return 17U;
+  case DW_AT_GNU_template_name:
+    return 18U;
+  default:
+    return NumDecodedAttrs;
+  }
+}
+
+/// \brief Check if a string form refers to a string section (.debug_str or
+/// .debug_line_str), rather than holding the string inline.
+inline bool isStringSectionForm(Dwarf_Half Form) {
+  switch (Form) {
+  case DW_FORM_strp:
+  case DW_FORM_line_strp:
+  case DW_FORM_strx:
+  case DW_FORM_GNU_str_index:
+  case 0x25: // DW_FORM_strx1
+  case 0x26: // DW_FORM_strx2
+  case 0x27: // DW_FORM_strx3
+  case 0x28: // DW_FORM_strx4
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// \brief Maps strings in the DWARF string sections to their StringPool
+/// indexes.
+///
+/// The same .debug_str entry is usually used by many Dies, so this means each
+/// is only hashed and compared in the StringPool once. The strings are keyed by
+/// their address in the section data, which is the same for every use of an
+/// offset, so the cache must not outlive the debug data it is used with. It is
+/// not thread safe.
+class DwarfStringCache {
+public:
+  /// \brief get the StringPool index of a string read with Form.
+  size_t getStringIndex(const char *Str, Dwarf_Half Form);
+
+  size_t getHits() const { return Hits; }
+  size_t size() const { return Indexes.size(); }
+
+private:
+  std::unordered_map<const char *, size_t> Indexes;
+  size_t Hits = 0;
 };
 
 /// \brief Wrapper around a Dwarf_Die with resource management.
 class DwarfDie {
 public:
+  friend class DwarfDieChildCursor;
   friend class DwarfDieChildIterator;
 
+  /// \brief Type for visiting the children without allocating.
+  using ChildCursor = DwarfDieChildCursor;
+
   explicit DwarfDie(const DwarfDebugData &DbgData, Dwarf_Die RawDie)
       : DebugData(DbgData), Die(RawDie) {}
   DwarfDie(DwarfDie &&Other);
@@ -197,9 +310,17 @@ public:
   std::string getAttrAsString(Dwarf_Half Attr,
                               const std::string &Default) const;
 
+  /// \brief Read the attributes used by the reader in a single pass over the
+  /// Die's attribute list.
+  DwarfDieAttributes decodeAttributes() const;
+
   /// \brief get the line table. Only valid for compile units.
   DwarfLineTable getLineTable() const;
 
+  /// \brief get the source file names, indexed by the file numbers used in
+  /// the line table and DW_AT_decl_file. Only valid for compile units.
+  std::vector<std::string> getSourceFiles() const;
+
 private:
   // Free Die and set it to nullptr.
   void freeDie();
@@ -212,6 +333,66 @@ private:
   OptionalAttrValue<ValTy> getAttr(Dwarf_Half Attr, getterFunc getter) const;
 };
 
+/// \brief The attributes of a Die that are used by the reader, see
+/// getDecodedAttrSlot().
+///
+/// The attributes are all found with one call to dwarf_attrlist, but their
+/// values are only converted when they are requested. So, as with the DwarfDie
+/// getters, a bad form is only an error for the attributes that are used.
+/// Requesting any other attribute is an error.
+class DwarfDieAttributes {
+public:
+  template <typename ValTy>
+  using OptionalAttrValue = DwarfDie::OptionalAttrValue<ValTy>;
+  using SignedUnsigned = DwarfDie::SignedUnsigned;
+
+  DwarfDieAttributes(const DwarfDebugData &DbgData, Dwarf_Die RawDie);
+  DwarfDieAttributes(DwarfDieAttributes &&Other);
+  ~DwarfDieAttributes() { freeAttrs(); }
+
+  DwarfDieAttributes(const DwarfDieAttributes &) = delete;
+  DwarfDieAttributes &operator=(const DwarfDieAttributes &) = delete;
+
+  // Attribute getters.
+  bool hasAttr(Dwarf_Half Attr) const;
+  bool getAttrAsFlag(Dwarf_Half Attr) const;
+  const OptionalAttrValue<Dwarf_Off> getAttrAsRef(Dwarf_Half Attr) const;
+  const OptionalAttrValue<Dwarf_Unsigned>
+  getAttrAsUnsigned(Dwarf_Half Attr) const;
+  const OptionalAttrValue<Dwarf_Signed> getAttrAsSigned(Dwarf_Half Attr) const;
+  const OptionalAttrValue<std::string> getAttrAsString(Dwarf_Half Attr) const;
+
+  /// \brief get an attribute as either a signed or unsigned value.
+  const OptionalAttrValue<SignedUnsigned>
+  getAttrAsSignedOrUnsigned(Dwarf_Half Attr) const;
+
+  // Attribute getters with defaults.
+  Dwarf_Off getAttrAsRef(Dwarf_Half Attr, Dwarf_Off Default) const;
+  Dwarf_Unsigned getAttrAsUnsigned(Dwarf_Half Attr,
+                                   Dwarf_Unsigned Default) const;
+  Dwarf_Signed getAttrAsSigned(Dwarf_Half Attr, Dwarf_Signed Default) const;
+  std::string getAttrAsString(Dwarf_Half Attr,
+                              const std::string &Default) const;
+
+  /// \brief get a string attribute's StringPool index, or 0 if the Die doesn't
+  /// have it.
+  size_t getAttrAsStringIndex(Dwarf_Half Attr, DwarfStringCache &Cache) const;
+
+private:
+  // Free the attributes and set them to nullptr.
+  void freeAttrs();
+
+  // get the attribute in Attr's slot, or nullptr if the Die doesn't have it.
+  Dwarf_Attribute findAttr(Dwarf_Half Attr) const;
+
+  // Common functionality for attribute getters.
+  template <typename ValTy, typename getterFunc>
+  OptionalAttrValue<ValTy> getAttr(Dwarf_Half Attr, getterFunc getter) const;
+
+  const DwarfDebugData &DebugData;
+  Dwarf_Attribute Attrs[NumDecodedAttrs];
+};
+
 /// \brief Container for the CU Die and its metadata.
 struct DwarfCompileUnit {
   DwarfCompileUnit(DwarfDie &&CompileUnitDie)
@@ -258,6 +439,39 @@ private:
   std::shared_ptr<DwarfDie> Child;
 };
 
+/// \brief Visit a DIE's children in sequence, reusing a single DwarfDie.
+///
+/// Unlike DwarfDieChildIterator, moving to the next sibling replaces the
+/// current child in place, freeing it straight away, instead of allocating a
+/// new shared DwarfDie. A recursive walk of the tree only holds one child per
+/// depth.
+///
+/// Typical usage:
+/// \code
+///   for (DwarfDieChildCursor Child(Die); !Child.atEnd(); Child.next()) {
+///     auto Tag = Child->getTag();
+///     // ...
+///   }
+/// \endcode
+class DwarfDieChildCursor {
+public:
+  explicit DwarfDieChildCursor(const DwarfDie &Parent);
+
+  DwarfDieChildCursor(const DwarfDieChildCursor &) = delete;
+  DwarfDieChildCursor &operator=(const DwarfDieChildCursor &) = delete;
+
+  const DwarfDie &operator*() const { return Child; }
+  const DwarfDie *operator->() const { return &Child; }
+
+  /// \brief Move to the next sibling, the current child is freed.
+  void next();
+
+  bool atEnd() const { return Child.get() == nullptr; }
+
+private:
+  DwarfDie Child;
+};
+
 struct DwarfLineEntry {
   Dwarf_Unsigned LineNo;
   Dwarf_Unsigned SrcFileID;
@@ -272,39 +486,33 @@ struct DwarfLineEntry {
   Dwarf_Unsigned Discriminator;
 };
 
-/// Wrapper around a line table with memory management.
+/// \brief The rows of a compile unit's line table.
+///
+/// All the rows are extracted when the table is created, either by the native
+/// line-number program decoder or in one pass over the libdwarf lines, so the
+/// libdwarf line data is freed straight away. For two-level line tables the
+/// rows are the logical rows.
 class DwarfLineTable {
 public:
+  DwarfLineTable() = default;
+  /// \brief Read the line table of a compile unit through libdwarf.
   explicit DwarfLineTable(const DwarfDie &CU);
-  DwarfLineTable(DwarfLineTable &&Other);
-  ~DwarfLineTable() { freeLines(); }
+  explicit DwarfLineTable(std::vector<DwarfLineEntry> &&LineRows)
+      : Rows(std::move(LineRows)) {}
 
-  DwarfLineTable(const DwarfLineTable &) = delete;
-  DwarfLineTable &operator=(const DwarfLineTable &) = delete;
+  bool empty() const { return Rows.empty(); }
+  size_t size() const { return Rows.size(); }
 
-  DwarfLineTable &operator=(DwarfLineTable &&Other);
-
-  friend void swap(DwarfLineTable &A, DwarfLineTable &B) {
-    std::swap(A.Context, B.Context);
-    std::swap(A.Lines, B.Lines);
-    std::swap(A.LineCount, B.LineCount);
+  const DwarfLineEntry &getLine(size_t LineIndex) const {
+    assert(LineIndex < size() && "Index out of range");
+    return Rows[LineIndex];
   }
-
-  bool empty() const { return LineCount == 0; }
-  size_t size() const { return LineCount; }
-
-  DwarfLineEntry getLine(size_t LineIndex) const;
-  DwarfLineEntry operator[](size_t LineIndex) const {
+  const DwarfLineEntry &operator[](size_t LineIndex) const {
     return getLine(LineIndex);
   }
 
 private:
-  // Free lines and reset values to null/zero.
-  void freeLines();
-
-  Dwarf_Line_Context Context;
-  Dwarf_Line *Lines;
-  size_t LineCount;
+  std::vector<DwarfLineEntry> Rows;
 };
 
 } // end namespace ElfDwarfReader
@@ -0,0 +1,1644 @@
+//===-- ElfDwarfReader/NativeDwarfDecoder.cpp -------------------*- C++ -*-===//
+///
+/// Copyright (c) Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the implementation of the native DWARF decoder.
+///
+//===----------------------------------------------------------------------===//
+
+#include "NativeDwarfDecoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+using namespace ElfDwarfReader;
+
+namespace {
+
+// DWARF 5 values that are missing from the libdwarf headers.
+const Dwarf_Half FormStrx1 = 0x25;
+const Dwarf_Half FormStrx2 = 0x26;
+const Dwarf_Half FormStrx3 = 0x27;
+const Dwarf_Half FormStrx4 = 0x28;
+const Dwarf_Half FormAddrx1 = 0x29;
+const Dwarf_Half FormAddrx2 = 0x2a;
+const Dwarf_Half FormAddrx3 = 0x2b;
+const Dwarf_Half FormAddrx4 = 0x2c;
+const Dwarf_Small UnitTypeSkeleton = 0x04;
+const Dwarf_Small UnitTypeSplitCompile = 0x05;
+const Dwarf_Small UnitTypeSplitType = 0x06;
+// The version of the experimental two-level line tables.
+const Dwarf_Half LineVersionTwoLevel = 0xf006;
+
+// ELF values.
+const unsigned char ElfClass32 = 1;
+const unsigned char ElfClass64 = 2;
+const unsigned char ElfData2LSB = 1;
+const unsigned char ElfData2MSB = 2;
+const Dwarf_Half ElfTypeRel = 1;
+const Dwarf_Half ElfMachine386 = 3;
+const Dwarf_Half ElfMachineARM = 40;
+const Dwarf_Half ElfMachineX86_64 = 62;
+const Dwarf_Half ElfMachineAArch64 = 183;
+const Dwarf_Unsigned ElfSectionSymTab = 2;
+const Dwarf_Unsigned ElfSectionRela = 4;
+const Dwarf_Unsigned ElfSectionNoBits = 8;
+const Dwarf_Unsigned ElfSectionRel = 9;
+const Dwarf_Unsigned ElfSectionCompressed = 0x800;
+const Dwarf_Unsigned ElfSectionIndexExtended = 0xffff;
+
+[[noreturn]] void throwError(Dwarf_Unsigned ErrNo, const char *ErrName) {
+  throw LibDwarfError(ErrNo, std::string(ErrName) + " (" +
+                                 std::to_string(ErrNo) + ")");
+}
+
+#define THROW_DWARF_ERROR(ERR) throwError(ERR, #ERR)
+
+/// Reads values from a section, checking that they are in bounds.
+class DataCursor {
+public:
+  DataCursor(const char *SectionData, size_t SectionSize, Dwarf_Off Offset,
+             bool IsLittleEndian)
+      : Data(SectionData), Size(SectionSize), Offset(Offset),
+        IsLittleEndian(IsLittleEndian) {}
+
+  Dwarf_Off getOffset() const { return Offset; }
+  void setOffset(Dwarf_Off NewOffset) { Offset = NewOffset; }
+  bool atEnd() const { return Offset >= Size; }
+
+  void skip(Dwarf_Unsigned Bytes) {
+    check(Bytes);
+    Offset += Bytes;
+  }
+
+  Dwarf_Unsigned readUnsigned(unsigned Bytes) {
+    check(Bytes);
+    const auto *Ptr = reinterpret_cast<const unsigned char *>(Data + Offset);
+    Dwarf_Unsigned Result = 0U;
+    for (unsigned Index = 0; Index < Bytes; ++Index) {
+      unsigned Shift = IsLittleEndian ? Index : Bytes - 1 - Index;
+      Result |= static_cast<Dwarf_Unsigned>(Ptr[Index]) << (Shift * 8);
+    }
+    Offset += Bytes;
+    return Result;
+  }
+
+  Dwarf_Signed readSigned(unsigned Bytes) {
+    Dwarf_Unsigned Value = readUnsigned(Bytes);
+    if (Bytes < sizeof(Dwarf_Unsigned)) {
+      Dwarf_Unsigned SignBit = Dwarf_Unsigned(1U) << (Bytes * 8 - 1);
+      Value = (Value ^ SignBit) - SignBit;
+    }
+    return static_cast<Dwarf_Signed>(Value);
+  }
+
+  Dwarf_Unsigned readULEB() {
+    Dwarf_Unsigned Result = 0U;
+    unsigned Shift = 0U;
+    for (;;) {
+      if (atEnd())
+        THROW_DWARF_ERROR(DW_DLE_LEB_IMPROPER);
+      auto Byte = static_cast<unsigned char>(Data[Offset++]);
+      if (Shift < 64)
+        Result |= static_cast<Dwarf_Unsigned>(Byte & 0x7f) << Shift;
+      Shift += 7;
+      if ((Byte & 0x80) == 0)
+        return Result;
+    }
+  }
+
+  Dwarf_Signed readSLEB() {
+    Dwarf_Unsigned Result = 0U;
+    unsigned Shift = 0U;
+    unsigned char Byte;
+    do {
+      if (atEnd())
+        THROW_DWARF_ERROR(DW_DLE_LEB_IMPROPER);
+      Byte = static_cast<unsigned char>(Data[Offset++]);
+      if (Shift < 64)
+        Result |= static_cast<Dwarf_Unsigned>(Byte & 0x7f) << Shift;
+      Shift += 7;
+    } while (Byte & 0x80);
+    if (Shift < 64 && (Byte & 0x40))
+      Result |= ~Dwarf_Unsigned(0U) << Shift;
+    return static_cast<Dwarf_Signed>(Result);
+  }
+
+  const char *readCString() {
+    const char *Begin = Data + Offset;
+    const void *End = atEnd() ? nullptr : memchr(Begin, 0, Size - Offset);
+    if (!End)
+      THROW_DWARF_ERROR(DW_DLE_ATTR_OUTSIDE_SECTION);
+    Offset += static_cast<const char *>(End) - Begin + 1;
+    return Begin;
+  }
+
+private:
+  void check(Dwarf_Unsigned Bytes) const {
+    if (Offset > Size || Bytes > Size - Offset)
+      THROW_DWARF_ERROR(DW_DLE_ATTR_OUTSIDE_SECTION);
+  }
+
+  const char *Data;
+  size_t Size;
+  Dwarf_Off Offset;
+  bool IsLittleEndian;
+};
+
+// Get the size of a form's value if it is fixed for the unit, otherwise 0.
+// Forms without any value (DW_FORM_flag_present, DW_FORM_implicit_const) also
+// give 0.
+unsigned getFixedFormSize(Dwarf_Half Form, const NativeUnit &Unit) {
+  switch (Form) {
+  case DW_FORM_addr:
+    return Unit.AddressSize;
+  case DW_FORM_data1:
+  case DW_FORM_ref1:
+  case DW_FORM_flag:
+  case FormStrx1:
+  case FormAddrx1:
+    return 1;
+  case DW_FORM_data2:
+  case DW_FORM_ref2:
+  case FormStrx2:
+  case FormAddrx2:
+    return 2;
+  case FormStrx3:
+  case FormAddrx3:
+    return 3;
+  case DW_FORM_data4:
+  case DW_FORM_ref4:
+  case FormStrx4:
+  case FormAddrx4:
+    return 4;
+  case DW_FORM_data8:
+  case DW_FORM_ref8:
+  case DW_FORM_ref_sig8:
+    return 8;
+  case DW_FORM_data16:
+    return 16;
+  case DW_FORM_strp:
+  case DW_FORM_line_strp:
+  case DW_FORM_sec_offset:
+  case DW_FORM_strp_sup:
+  case DW_FORM_ref_sup:
+  case DW_FORM_GNU_ref_alt:
+  case DW_FORM_GNU_strp_alt:
+    return Unit.OffsetSize;
+  case DW_FORM_ref_addr:
+    return Unit.Version == 2 ? Unit.AddressSize : Unit.OffsetSize;
+  default:
+    return 0;
+  }
+}
+
+// Check if the decoder knows how to skip over a form.
+bool isKnownForm(Dwarf_Half Form) {
+  switch (Form) {
+  case DW_FORM_addr:
+  case DW_FORM_block2:
+  case DW_FORM_block4:
+  case DW_FORM_data2:
+  case DW_FORM_data4:
+  case DW_FORM_data8:
+  case DW_FORM_string:
+  case DW_FORM_block:
+  case DW_FORM_block1:
+  case DW_FORM_data1:
+  case DW_FORM_flag:
+  case DW_FORM_sdata:
+  case DW_FORM_strp:
+  case DW_FORM_udata:
+  case DW_FORM_ref_addr:
+  case DW_FORM_ref1:
+  case DW_FORM_ref2:
+  case DW_FORM_ref4:
+  case DW_FORM_ref8:
+  case DW_FORM_ref_udata:
+  case DW_FORM_indirect:
+  case DW_FORM_sec_offset:
+  case DW_FORM_exprloc:
+  case DW_FORM_flag_present:
+  case DW_FORM_strx:
+  case DW_FORM_addrx:
+  case DW_FORM_ref_sup:
+  case DW_FORM_strp_sup:
+  case DW_FORM_data16:
+  case DW_FORM_line_strp:
+  case DW_FORM_ref_sig8:
+  case DW_FORM_implicit_const:
+  case DW_FORM_loclistx:
+  case DW_FORM_rnglistx:
+  case FormStrx1:
+  case FormStrx2:
+  case FormStrx3:
+  case FormStrx4:
+  case FormAddrx1:
+  case FormAddrx2:
+  case FormAddrx3:
+  case FormAddrx4:
+  case DW_FORM_GNU_addr_index:
+  case DW_FORM_GNU_str_index:
+  case DW_FORM_GNU_ref_alt:
+  case DW_FORM_GNU_strp_alt:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Skip over an attribute value, returns the actual form of the value (which
+// is only different for DW_FORM_indirect).
+Dwarf_Half skipForm(DataCursor &Cursor, Dwarf_Half Form,
+                    const NativeUnit &Unit) {
+  if (unsigned Size = getFixedFormSize(Form, Unit)) {
+    Cursor.skip(Size);
+    return Form;
+  }
+  switch (Form) {
+  case DW_FORM_flag_present:
+  case DW_FORM_implicit_const:
+    break;
+  case DW_FORM_sdata:
+    Cursor.readSLEB();
+    break;
+  case DW_FORM_udata:
+  case DW_FORM_ref_udata:
+  case DW_FORM_strx:
+  case DW_FORM_addrx:
+  case DW_FORM_loclistx:
+  case DW_FORM_rnglistx:
+  case DW_FORM_GNU_addr_index:
+  case DW_FORM_GNU_str_index:
+    Cursor.readULEB();
+    break;
+  case DW_FORM_string:
+    Cursor.readCString();
+    break;
+  case DW_FORM_block1:
+    Cursor.skip(Cursor.readUnsigned(1));
+    break;
+  case DW_FORM_block2:
+    Cursor.skip(Cursor.readUnsigned(2));
+    break;
+  case DW_FORM_block4:
+    Cursor.skip(Cursor.readUnsigned(4));
+    break;
+  case DW_FORM_block:
+  case DW_FORM_exprloc:
+    Cursor.skip(Cursor.readULEB());
+    break;
+  case DW_FORM_indirect: {
+    auto ActualForm = static_cast<Dwarf_Half>(Cursor.readULEB());
+    if (ActualForm == DW_FORM_indirect || !isKnownForm(ActualForm))
+      THROW_DWARF_ERROR(DW_DLE_UNKNOWN_FORM);
+    return skipForm(Cursor, ActualForm, Unit);
+  }
+  default:
+    THROW_DWARF_ERROR(DW_DLE_UNKNOWN_FORM);
+  }
+  return Form;
+}
+
+// Parse the abbreviation table at the cursor. Returns false if it uses
+// anything unknown.
+bool parseAbbrevTable(DataCursor &Cursor, NativeAbbrevTable &Table) {
+  while (!Cursor.atEnd()) {
+    Dwarf_Unsigned Code = Cursor.readULEB();
+    if (Code == 0U)
+      break;
+
+    NativeAbbrev Abbrev;
+    Abbrev.Tag = static_cast<Dwarf_Half>(Cursor.readULEB());
+    Abbrev.HasChildren = Cursor.readUnsigned(1) != DW_CHILDREN_no;
+    for (;;) {
+      NativeAbbrev::AttrSpec Spec;
+      Spec.Attr = static_cast<Dwarf_Half>(Cursor.readULEB());
+      Spec.Form = static_cast<Dwarf_Half>(Cursor.readULEB());
+      Spec.ImplicitConst = 0;
+      if (Spec.Attr == 0 && Spec.Form == 0)
+        break;
+      if (!isKnownForm(Spec.Form))
+        return false;
+      if (Spec.Form == DW_FORM_implicit_const)
+        Spec.ImplicitConst = Cursor.readSLEB();
+      Abbrev.Attrs.push_back(Spec);
+    }
+
+    if (!Table.add(Code, std::move(Abbrev)))
+      return false;
+  }
+  return true;
+}
+
+/// The parts of an ELF section header used by the decoder.
+struct ElfSection {
+  Dwarf_Unsigned NameOffset;
+  std::string Name;
+  Dwarf_Unsigned Type;
+  Dwarf_Unsigned Flags;
+  Dwarf_Off Offset;
+  Dwarf_Unsigned Size;
+  Dwarf_Unsigned Link;
+  Dwarf_Unsigned Info;
+  Dwarf_Unsigned EntrySize;
+};
+
+// Get the size (in bytes) of the value a relocation type writes, or 0 if the
+// relocation type is not supported. Every supported type is an absolute
+// relocation (S + A).
+unsigned getRelocationSize(Dwarf_Half Machine, Dwarf_Unsigned Type) {
+  switch (Machine) {
+  case ElfMachineX86_64:
+    switch (Type) {
+    case 1:  // R_X86_64_64
+    case 17: // R_X86_64_DTPOFF64
+      return 8;
+    case 10: // R_X86_64_32
+    case 11: // R_X86_64_32S
+    case 21: // R_X86_64_DTPOFF32
+      return 4;
+    }
+    break;
+  case ElfMachine386:
+    if (Type == 1) // R_386_32
+      return 4;
+    break;
+  case ElfMachineARM:
+    if (Type == 2) // R_ARM_ABS32
+      return 4;
+    break;
+  case ElfMachineAArch64:
+    if (Type == 257) // R_AARCH64_ABS64
+      return 8;
+    if (Type == 258) // R_AARCH64_ABS32
+      return 4;
+    break;
+  }
+  return 0;
+}
+
+
+// Check if a file or directory name is a full path, the same way as libdwarf
+// (which also accepts Windows drive letters).
+bool isFullPath(const char *Name) {
+  if (Name[0] == '/')
+    return true;
+  return ((Name[0] >= 'A' && Name[0] <= 'Z') ||
+          (Name[0] >= 'a' && Name[0] <= 'z')) &&
+         Name[1] == ':';
+}
+
+// The content type and form of each field of a DWARF 5 line table directory
+// or file entry.
+using LineEntryFormat = std::vector<std::pair<Dwarf_Unsigned, Dwarf_Half>>;
+
+LineEntryFormat readLineEntryFormat(DataCursor &Cursor) {
+  LineEntryFormat Format(static_cast<size_t>(Cursor.readUnsigned(1)));
+  for (auto &Field : Format) {
+    Field.first = Cursor.readULEB();
+    Field.second = static_cast<Dwarf_Half>(Cursor.readULEB());
+  }
+  return Format;
+}
+
+// Read a DW_LNCT_path value.
+const char *readLineString(DataCursor &Cursor, Dwarf_Half Form,
+                           const NativeUnit &FormUnit,
+                           const NativeLineSections &Sections) {
+  const NativeSection *Strings = &Sections.Str;
+  switch (Form) {
+  case DW_FORM_string:
+    return Cursor.readCString();
+  case DW_FORM_strp:
+    break;
+  case DW_FORM_line_strp:
+    Strings = &Sections.LineStr;
+    break;
+  default:
+    THROW_DWARF_ERROR(DW_DLE_LINE_NUMBER_HEADER_ERROR);
+  }
+  Dwarf_Off StrOffset = Cursor.readUnsigned(FormUnit.OffsetSize);
+  if (StrOffset >= Strings->Size)
+    THROW_DWARF_ERROR(DW_DLE_STRP_OFFSET_BAD);
+  return DataCursor(Strings->Data, Strings->Size, StrOffset,
+                    Sections.IsLittleEndian)
+      .readCString();
+}
+
+// Read a DW_LNCT_directory_index value.
+Dwarf_Unsigned readLineUnsigned(DataCursor &Cursor, Dwarf_Half Form,
+                                const NativeUnit &FormUnit) {
+  switch (Form) {
+  case DW_FORM_data1:
+  case DW_FORM_data2:
+  case DW_FORM_data4:
+  case DW_FORM_data8:
+    return Cursor.readUnsigned(getFixedFormSize(Form, FormUnit));
+  case DW_FORM_udata:
+    return Cursor.readULEB();
+  default:
+    THROW_DWARF_ERROR(DW_DLE_LINE_NUMBER_HEADER_ERROR);
+  }
+}
+
+} // end anonymous namespace.
+
+// NativeAbbrevTable methods.
+
+const NativeAbbrev *NativeAbbrevTable::lookup(Dwarf_Unsigned Code) const {
+  if (Code != 0U && Code <= Dense.size()) {
+    const NativeAbbrev &Abbrev = Dense[static_cast<size_t>(Code - 1)];
+    if (Abbrev.Tag != 0)
+      return &Abbrev;
+  }
+  auto IT = Sparse.find(Code);
+  return IT == Sparse.end() ? nullptr : &IT->second;
+}
+
+bool NativeAbbrevTable::add(Dwarf_Unsigned Code, NativeAbbrev &&Abbrev) {
+  if (lookup(Code) || Abbrev.Tag == 0)
+    return false;
+  if (Code == Dense.size() + 1)
+    Dense.push_back(std::move(Abbrev));
+  else
+    Sparse.emplace(Code, std::move(Abbrev));
+  return true;
+}
+
+// NativeDebugData methods.
+
+std::unique_ptr<NativeDebugData>
+NativeDebugData::create(const std::string &UnifiedPath) {
+  std::unique_ptr<NativeDebugData> Result(new NativeDebugData());
+  Result->File = LibScopeView::MappedFile(UnifiedPath);
+  try {
+    if (Result->loadSections() && Result->loadUnits())
+      return Result;
+  } catch (LibDwarfError &) {
+    // Anything malformed is left for libdwarf to report.
+  }
+  return nullptr;
+}
+
+bool NativeDebugData::loadSections() {
+  const char *FileData = File.data();
+  size_t FileSize = File.size();
+  static const char ElfMagic[] = {0x7f, 'E', 'L', 'F'};
+  if (FileSize < 16U || memcmp(FileData, ElfMagic, sizeof(ElfMagic)) != 0)
+    return false;
+
+  unsigned char Class = static_cast<unsigned char>(FileData[4]);
+  unsigned char Encoding = static_cast<unsigned char>(FileData[5]);
+  if ((Class != ElfClass32 && Class != ElfClass64) ||
+      (Encoding != ElfData2LSB && Encoding != ElfData2MSB))
+    return false;
+  bool Is64 = Class == ElfClass64;
+  IsLittleEndian = Encoding == ElfData2LSB;
+  // Size of the address sized fields.
+  unsigned AddrSize = Is64 ? 8U : 4U;
+
+  // ELF header.
+  DataCursor Cursor(FileData, FileSize, 16U, IsLittleEndian);
+  auto FileType = static_cast<Dwarf_Half>(Cursor.readUnsigned(2));
+  auto Machine = static_cast<Dwarf_Half>(Cursor.readUnsigned(2));
+  Cursor.skip(4U + AddrSize * 2U); // e_version, e_entry, e_phoff.
+  Dwarf_Off SectionHeaderOffset = Cursor.readUnsigned(AddrSize);
+  Cursor.skip(4U + 2U + 2U + 2U); // e_flags, e_ehsize, e_phentsize, e_phnum.
+  Dwarf_Unsigned SectionHeaderSize = Cursor.readUnsigned(2);
+  Dwarf_Unsigned SectionCount = Cursor.readUnsigned(2);
+  Dwarf_Unsigned NamesIndex = Cursor.readUnsigned(2);
+  if (SectionHeaderOffset == 0U ||
+      SectionHeaderSize < (Is64 ? 64U : 40U))
+    return false;
+
+  // Section headers.
+  auto readSectionHeader = [&](Dwarf_Unsigned Index) {
+    ElfSection Section;
+    Cursor.setOffset(SectionHeaderOffset);
+    Cursor.skip(Index * SectionHeaderSize);
+    Section.NameOffset = Cursor.readUnsigned(4);
+    Section.Type = Cursor.readUnsigned(4);
+    Section.Flags = Cursor.readUnsigned(AddrSize);
+    Cursor.skip(AddrSize); // sh_addr.
+    Section.Offset = Cursor.readUnsigned(AddrSize);
+    Section.Size = Cursor.readUnsigned(AddrSize);
+    Section.Link = Cursor.readUnsigned(4);
+    Section.Info = Cursor.readUnsigned(4);
+    Cursor.skip(AddrSize); // sh_addralign.
+    Section.EntrySize = Cursor.readUnsigned(AddrSize);
+    return Section;
+  };
+
+  // Large section counts and indexes are stored in the first section header.
+  ElfSection First = readSectionHeader(0U);
+  if (SectionCount == 0U)
+    SectionCount = First.Size;
+  if (NamesIndex == ElfSectionIndexExtended)
+    NamesIndex = First.Link;
+  if (NamesIndex >= SectionCount)
+    return false;
+
+  std::vector<ElfSection> Sections;
+  Sections.reserve(static_cast<size_t>(SectionCount));
+  for (Dwarf_Unsigned Index = 0U; Index < SectionCount; ++Index) {
+    Sections.push_back(readSectionHeader(Index));
+    const ElfSection &Section = Sections.back();
+    if (Section.Type != ElfSectionNoBits &&
+        (Section.Offset > FileSize || Section.Size > FileSize - Section.Offset))
+      return false;
+  }
+
+  const ElfSection &Names = Sections[static_cast<size_t>(NamesIndex)];
+  for (auto &Section : Sections) {
+    DataCursor NameCursor(FileData + Names.Offset,
+                          static_cast<size_t>(Names.Size),
+                          Section.NameOffset, IsLittleEndian);
+    Section.Name = NameCursor.readCString();
+  }
+
+  // Find the debug sections.
+  struct DebugSection {
+    const char *Name;
+    Section *Target;
+    size_t Index;
+  };
+  DebugSection DebugSections[] = {
+      {".debug_info", &Info, 0U},
+      {".debug_abbrev", &Abbrev, 0U},
+      {".debug_str", &Str, 0U},
+      {".debug_line_str", &LineStr, 0U},
+      {".debug_line", &Line, 0U},
+      {".debug_str_offsets", &StrOffsets, 0U},
+      {".debug_addr", &Addr, 0U}};
+  for (size_t Index = 0U; Index < Sections.size(); ++Index) {
+    const ElfSection &Section = Sections[Index];
+    // Compressed debug sections are not supported.
+    if (Section.Name.compare(0, 8, ".zdebug_") == 0)
+      return false;
+    for (auto &Debug : DebugSections) {
+      if (Section.Name != Debug.Name)
+        continue;
+      if (Section.Flags & ElfSectionCompressed)
+        return false;
+      if (Section.Type != ElfSectionNoBits) {
+        Debug.Target->Data = FileData + Section.Offset;
+        Debug.Target->Size = static_cast<size_t>(Section.Size);
+      }
+      Debug.Index = Index;
+    }
+  }
+  if (!Info.Data || !Abbrev.Data)
+    return false;
+
+  // Relocatable objects need their relocations applied to the debug sections,
+  // which is done on a copy of the section.
+  if (FileType != ElfTypeRel)
+    return true;
+
+  for (const auto &RelSection : Sections) {
+    if (RelSection.Type != ElfSectionRela && RelSection.Type != ElfSectionRel)
+      continue;
+    auto Debug = std::find_if(
+        std::begin(DebugSections), std::end(DebugSections),
+        [&RelSection](const DebugSection &Debug) {
+          return Debug.Index != 0U && Debug.Index == RelSection.Info;
+        });
+    if (Debug == std::end(DebugSections) || !Debug->Target->Data)
+      continue;
+    if (RelSection.Link >= Sections.size())
+      return false;
+    const ElfSection &SymTab = Sections[static_cast<size_t>(RelSection.Link)];
+    if (SymTab.Type != ElfSectionSymTab)
+      return false;
+
+    // Copy the section, unless it has been copied already.
+    Section &Target = *Debug->Target;
+    const char *Original = FileData + Sections[Debug->Index].Offset;
+    if (Target.Data == Original) {
+      std::unique_ptr<char[]> Copy(new char[Target.Size]);
+      memcpy(Copy.get(), Original, Target.Size);
+      Target.Data = Copy.get();
+      RelocatedSections.push_back(std::move(Copy));
+    }
+    char *TargetData = const_cast<char *>(Target.Data);
+
+    bool IsRela = RelSection.Type == ElfSectionRela;
+    Dwarf_Unsigned EntrySize = (IsRela ? 3U : 2U) * AddrSize;
+    if (RelSection.EntrySize != 0U && RelSection.EntrySize < EntrySize)
+      return false;
+    if (RelSection.EntrySize != 0U)
+      EntrySize = RelSection.EntrySize;
+    Dwarf_Unsigned SymbolSize = Is64 ? 24U : 16U;
+
+    DataCursor RelCursor(FileData + RelSection.Offset,
+                         static_cast<size_t>(RelSection.Size), 0U,
+                         IsLittleEndian);
+    DataCursor SymCursor(FileData + SymTab.Offset,
+                         static_cast<size_t>(SymTab.Size), 0U,
+                         IsLittleEndian);
+    for (Dwarf_Unsigned Index = 0U; Index < RelSection.Size / EntrySize;
+         ++Index) {
+      RelCursor.setOffset(Index * EntrySize);
+      Dwarf_Off Offset = RelCursor.readUnsigned(AddrSize);
+      Dwarf_Unsigned RelInfo = RelCursor.readUnsigned(AddrSize);
+      Dwarf_Unsigned Symbol = Is64 ? RelInfo >> 32 : RelInfo >> 8;
+      Dwarf_Unsigned Type = Is64 ? RelInfo & 0xffffffff : RelInfo & 0xff;
+      if (Type == 0U) // R_*_NONE.
+        continue;
+      unsigned Size = getRelocationSize(Machine, Type);
+      if (Size == 0U || Offset > Target.Size || Size > Target.Size - Offset)
+        return false;
+
+      DataCursor TargetCursor(TargetData, Target.Size, Offset,
+                              IsLittleEndian);
+      Dwarf_Unsigned Addend = IsRela ? RelCursor.readUnsigned(AddrSize)
+                                     : TargetCursor.readUnsigned(Size);
+
+      // st_value is after st_name in 32 bit ELF, and after st_name, st_info,
+      // st_other and st_shndx in 64 bit ELF.
+      SymCursor.setOffset(Symbol * SymbolSize + (Is64 ? 8U : 4U));
+      Dwarf_Unsigned Value = SymCursor.readUnsigned(AddrSize) + Addend;
+
+      for (unsigned Byte = 0U; Byte < Size; ++Byte) {
+        unsigned Shift = IsLittleEndian ? Byte : Size - 1 - Byte;
+        TargetData[Offset + Byte] = static_cast<char>(Value >> (Shift * 8));
+      }
+    }
+  }
+  return true;
+}
+
+bool NativeDebugData::loadUnits() {
+  DataCursor Cursor(Info.Data, Info.Size, 0U, IsLittleEndian);
+  while (!Cursor.atEnd()) {
+    NativeUnit Unit;
+    Unit.HeaderOffset = Cursor.getOffset();
+    Unit.StrOffsetsBase = 0U;
+    Unit.AddrBase = 0U;
+
+    Dwarf_Unsigned Length = Cursor.readUnsigned(4);
+    Unit.OffsetSize = 4;
+    if (Length == 0xffffffff) {
+      Length = Cursor.readUnsigned(8);
+      Unit.OffsetSize = 8;
+    } else if (Length >= 0xfffffff0)
+      return false;
+    if (Length > Info.Size - Cursor.getOffset())
+      return false;
+    Unit.NextHeaderOffset = Cursor.getOffset() + Length;
+
+    Unit.Version = static_cast<Dwarf_Half>(Cursor.readUnsigned(2));
+    if (Unit.Version < 2 || Unit.Version > 5)
+      return false;
+    Dwarf_Off AbbrevOffset;
+    if (Unit.Version >= 5) {
+      auto UnitType = static_cast<Dwarf_Small>(Cursor.readUnsigned(1));
+      Unit.AddressSize = static_cast<Dwarf_Small>(Cursor.readUnsigned(1));
+      AbbrevOffset = Cursor.readUnsigned(Unit.OffsetSize);
+      switch (UnitType) {
+      case DW_UT_compile:
+      case DW_UT_partial:
+        break;
+      case UnitTypeSkeleton:
+      case UnitTypeSplitCompile:
+        Cursor.skip(8U); // dwo_id.
+        break;
+      case DW_UT_type:
+      case UnitTypeSplitType:
+        Cursor.skip(8U + Unit.OffsetSize); // signature and type_offset.
+        break;
+      default:
+        return false;
+      }
+    } else {
+      AbbrevOffset = Cursor.readUnsigned(Unit.OffsetSize);
+      Unit.AddressSize = static_cast<Dwarf_Small>(Cursor.readUnsigned(1));
+    }
+    if (Unit.AddressSize != 4 && Unit.AddressSize != 8)
+      return false;
+    Unit.FirstDieOffset = Cursor.getOffset();
+    if (Unit.FirstDieOffset > Unit.NextHeaderOffset)
+      return false;
+
+    // Units often share their abbreviation tables.
+    auto IT = AbbrevTables.find(AbbrevOffset);
+    if (IT == AbbrevTables.end()) {
+      if (AbbrevOffset >= Abbrev.Size)
+        return false;
+      IT = AbbrevTables.emplace(AbbrevOffset, NativeAbbrevTable()).first;
+      DataCursor AbbrevCursor(Abbrev.Data, Abbrev.Size, AbbrevOffset,
+                              IsLittleEndian);
+      if (!parseAbbrevTable(AbbrevCursor, IT->second))
+        return false;
+    }
+    Unit.Abbrevs = &IT->second;
+
+    Units.push_back(Unit);
+    Cursor.setOffset(Unit.NextHeaderOffset);
+  }
+
+  // The string offsets and address bases are attributes of the unit DIE. The
+  // units can't move once there are Dies pointing at them, so this is done
+  // after all of them have been read.
+  for (auto &Unit : Units) {
+    NativeDie UnitDie(*this, Unit, Unit.FirstDieOffset);
+    auto readBase = [&](const NativeDie::AttrValue &Value) -> Dwarf_Unsigned {
+      if (Value.Form != DW_FORM_sec_offset)
+        return UnitDie.formUnsigned(Value);
+      DataCursor Cursor(Info.Data, Info.Size, Value.Offset, IsLittleEndian);
+      return Cursor.readUnsigned(Unit.OffsetSize);
+    };
+    NativeDie::AttrValue Value;
+    if (UnitDie.findAttr(DW_AT_str_offsets_base, Value))
+      Unit.StrOffsetsBase = readBase(Value);
+    if (UnitDie.findAttr(DW_AT_addr_base, Value) ||
+        UnitDie.findAttr(DW_AT_GNU_addr_base, Value))
+      Unit.AddrBase = readBase(Value);
+  }
+
+  return true;
+}
+
+const NativeUnit *NativeDebugData::findUnit(Dwarf_Off Offset) const {
+  auto IT = std::upper_bound(Units.begin(), Units.end(), Offset,
+                             [](Dwarf_Off Off, const NativeUnit &Unit) {
+                               return Off < Unit.HeaderOffset;
+                             });
+  if (IT == Units.begin())
+    return nullptr;
+  --IT;
+  return Offset < IT->NextHeaderOffset ? &*IT : nullptr;
+}
+
+NativeDie NativeDebugData::getDie(Dwarf_Off Offset) const {
+  const NativeUnit *Unit = findUnit(Offset);
+  if (!Unit || Offset < Unit->FirstDieOffset)
+    return NativeDie();
+  return NativeDie(*this, *Unit, Offset);
+}
+
+NativeLineTable NativeDebugData::getLineTable(Dwarf_Off CUOffset,
+                                              bool FilesOnly) const {
+  NativeDie CUDie = getDie(CUOffset);
+  NativeDie::AttrValue Value;
+  if (CUDie.isNull() || !CUDie.findAttr(DW_AT_stmt_list, Value))
+    return NativeLineTable();
+  if (Value.Form != DW_FORM_data4 && Value.Form != DW_FORM_data8 &&
+      Value.Form != DW_FORM_sec_offset)
+    THROW_DWARF_ERROR(DW_DLE_LINE_OFFSET_WRONG_FORM);
+  DataCursor Cursor(Info.Data, Info.Size, Value.Offset, IsLittleEndian);
+  Dwarf_Off StmtList =
+      Cursor.readUnsigned(getFixedFormSize(Value.Form, *CUDie.getUnit()));
+
+  NativeLineSections Sections;
+  Sections.Line = Line;
+  Sections.Str = Str;
+  Sections.LineStr = LineStr;
+  Sections.IsLittleEndian = IsLittleEndian;
+  return decodeLineProgram(Sections, StmtList, CUDie.getUnit()->AddressSize,
+                           CUDie.getAttrAsString(DW_AT_comp_dir, ""),
+                           FilesOnly);
+}
+
+// Line-number programs.
+
+NativeLineTable ElfDwarfReader::decodeLineProgram(
+    const NativeLineSections &Sections, Dwarf_Off Offset,
+    Dwarf_Small AddressSize, const std::string &CompDir, bool FilesOnly) {
+  NativeLineTable Table;
+  if (Offset >= Sections.Line.Size)
+    THROW_DWARF_ERROR(DW_DLE_LINE_OFFSET_BAD);
+  DataCursor Cursor(Sections.Line.Data, Sections.Line.Size, Offset,
+                    Sections.IsLittleEndian);
+
+  // The header.
+  Dwarf_Unsigned Length = Cursor.readUnsigned(4);
+  unsigned OffsetSize = 4U;
+  if (Length == 0xffffffff) {
+    Length = Cursor.readUnsigned(8);
+    OffsetSize = 8U;
+  }
+  if (Length > Sections.Line.Size - Cursor.getOffset())
+    THROW_DWARF_ERROR(DW_DLE_DEBUG_LINE_LENGTH_BAD);
+  // Reading past the end of the program is an error from here on.
+  Dwarf_Off End = Cursor.getOffset() + Length;
+  Cursor = DataCursor(Sections.Line.Data, static_cast<size_t>(End),
+                      Cursor.getOffset(), Sections.IsLittleEndian);
+
+  Table.Version = static_cast<Dwarf_Half>(Cursor.readUnsigned(2));
+  bool IsTwoLevel = Table.Version == LineVersionTwoLevel;
+  if ((Table.Version < 2 || Table.Version > 5) && !IsTwoLevel)
+    THROW_DWARF_ERROR(DW_DLE_VERSION_STAMP_ERROR);
+  bool IsVersion5 = Table.Version == 5;
+  if (IsVersion5) {
+    AddressSize = static_cast<Dwarf_Small>(Cursor.readUnsigned(1));
+    Cursor.skip(1U); // segment_selector_size.
+  }
+  Dwarf_Unsigned HeaderLength = Cursor.readUnsigned(OffsetSize);
+  Dwarf_Off HeaderStart = Cursor.getOffset();
+  auto MinInstLength = Cursor.readUnsigned(1);
+  Dwarf_Unsigned MaxOpsPerInst = 1U;
+  if (Table.Version >= 4)
+    MaxOpsPerInst = std::max<Dwarf_Unsigned>(Cursor.readUnsigned(1), 1U);
+  bool DefaultIsStmt = Cursor.readUnsigned(1) != 0;
+  Dwarf_Signed LineBase = Cursor.readSigned(1);
+  Dwarf_Unsigned LineRange = Cursor.readUnsigned(1);
+  if (LineRange == 0U)
+    THROW_DWARF_ERROR(DW_DLE_DEBUG_LINE_RANGE_ZERO);
+  auto OpcodeBase = static_cast<unsigned>(Cursor.readUnsigned(1));
+  std::vector<Dwarf_Unsigned> OpcodeLengths;
+  for (unsigned Opcode = 1U; Opcode < OpcodeBase; ++Opcode)
+    OpcodeLengths.push_back(Cursor.readUnsigned(1));
+
+  // Directories and files.
+  struct FileEntry {
+    const char *Name;
+    Dwarf_Unsigned DirIndex;
+  };
+  std::vector<const char *> Dirs;
+  std::vector<FileEntry> Files;
+  Dwarf_Unsigned LogicalsOffset = 0U;
+  Dwarf_Unsigned ActualsOffset = 0U;
+  if (!IsVersion5 && !IsTwoLevel) {
+    for (const char *Dir = Cursor.readCString(); *Dir;
+         Dir = Cursor.readCString())
+      Dirs.push_back(Dir);
+    for (const char *Name = Cursor.readCString(); *Name;
+         Name = Cursor.readCString()) {
+      FileEntry File = {Name, Cursor.readULEB()};
+      if (File.DirIndex > Dirs.size())
+        THROW_DWARF_ERROR(DW_DLE_DIR_INDEX_BAD);
+      Cursor.readULEB(); // Modification time.
+      Cursor.readULEB(); // File length.
+      Files.push_back(File);
+    }
+  } else {
+    // Two-level tables have empty version 4 lists, a marker and the offsets
+    // of their two programs before the version 5 style lists.
+    if (IsTwoLevel) {
+      static const unsigned char Marker[] = {0, 0, 0, 0xff, 0xff, 0x7f, 0x7f};
+      for (unsigned char Expected : Marker)
+        if (Cursor.readUnsigned(1) != Expected)
+          THROW_DWARF_ERROR(DW_DLE_LINE_NUMBER_HEADER_ERROR);
+      LogicalsOffset = Cursor.readUnsigned(OffsetSize);
+      ActualsOffset = Cursor.readUnsigned(OffsetSize);
+    }
+
+    // The fields are read with the forms of a version 5 unit.
+    NativeUnit FormUnit = NativeUnit();
+    FormUnit.Version = 5;
+    FormUnit.AddressSize = AddressSize;
+    FormUnit.OffsetSize = static_cast<Dwarf_Small>(OffsetSize);
+
+    LineEntryFormat DirFormat = readLineEntryFormat(Cursor);
+    for (Dwarf_Unsigned Count = Cursor.readULEB(); Count > 0U; --Count) {
+      const char *Dir = "";
+      for (const auto &Field : DirFormat) {
+        if (Field.first == DW_LNCT_path)
+          Dir = readLineString(Cursor, Field.second, FormUnit, Sections);
+        else
+          skipForm(Cursor, Field.second, FormUnit);
+      }
+      Dirs.push_back(Dir);
+    }
+    LineEntryFormat FileFormat = readLineEntryFormat(Cursor);
+    for (Dwarf_Unsigned Count = Cursor.readULEB(); Count > 0U; --Count) {
+      FileEntry File = {"", 0U};
+      for (const auto &Field : FileFormat) {
+        if (Field.first == DW_LNCT_path)
+          File.Name = readLineString(Cursor, Field.second, FormUnit, Sections);
+        else if (Field.first == DW_LNCT_directory_index)
+          File.DirIndex = readLineUnsigned(Cursor, Field.second, FormUnit);
+        else
+          skipForm(Cursor, Field.second, FormUnit);
+      }
+      Files.push_back(File);
+    }
+    // The subprogram table, which isn't used.
+    if (IsTwoLevel) {
+      LineEntryFormat SubprogramFormat = readLineEntryFormat(Cursor);
+      for (Dwarf_Unsigned Count = Cursor.readULEB(); Count > 0U; --Count)
+        for (const auto &Field : SubprogramFormat)
+          skipForm(Cursor, Field.second, FormUnit);
+    }
+  }
+
+  // The full path of each file is built the same way as dwarf_srcfiles. Before
+  // version 5, directory 0 is the compilation directory and the others are
+  // numbered from one. File numbers also start from one, so the first name is
+  // left empty (file 0 means no file).
+  if (!Files.empty()) {
+    bool IsZeroBased = IsVersion5;
+    if (!IsZeroBased)
+      Table.FileNames.emplace_back("");
+    for (const FileEntry &File : Files) {
+      if (isFullPath(File.Name)) {
+        Table.FileNames.emplace_back(File.Name);
+        continue;
+      }
+      const char *Dir = "";
+      if (IsZeroBased || File.DirIndex > 0U) {
+        Dwarf_Unsigned DirNumber = File.DirIndex - (IsZeroBased ? 0U : 1U);
+        if (DirNumber >= Dirs.size())
+          THROW_DWARF_ERROR(DW_DLE_INCL_DIR_NUM_BAD);
+        Dir = Dirs[static_cast<size_t>(DirNumber)];
+      }
+
+      std::string FullPath;
+      if (!*Dir || !isFullPath(Dir)) {
+        if (!CompDir.empty())
+          FullPath.append(CompDir).append("/");
+      }
+      if (*Dir)
+        FullPath.append(Dir).append("/");
+      FullPath.append(File.Name);
+      Table.FileNames.push_back(std::move(FullPath));
+    }
+  }
+  if (FilesOnly)
+    return Table;
+
+  // The program starts after the header. Like libdwarf, a header_length that
+  // is too large is ignored, as some compilers got it wrong.
+  Dwarf_Off ProgramBegin =
+      HeaderStart + (IsTwoLevel ? LogicalsOffset : HeaderLength);
+  if (Cursor.getOffset() > ProgramBegin)
+    THROW_DWARF_ERROR(DW_DLE_LINE_PROLOG_LENGTH_BAD);
+  // Only the logicals program of a two-level table is read.
+  Dwarf_Off ProgramEnd = End;
+  if (IsTwoLevel && ActualsOffset != 0U)
+    ProgramEnd = std::min<Dwarf_Off>(HeaderStart + ActualsOffset, End);
+  Cursor = DataCursor(Sections.Line.Data, static_cast<size_t>(ProgramEnd),
+                      Cursor.getOffset(), Sections.IsLittleEndian);
+
+  // The state machine registers. The row being built holds most of them.
+  DwarfLineEntry Row = DwarfLineEntry();
+  Dwarf_Unsigned OpIndex = 0U;
+  // Only used by two-level tables.
+  Dwarf_Unsigned CallContext = 0U;
+  Dwarf_Unsigned Subprogram = 0U;
+  std::vector<std::pair<Dwarf_Unsigned, Dwarf_Unsigned>> RowContexts;
+  auto resetRegisters = [&]() {
+    Row.LineAddr = 0U;
+    Row.SrcFileID = 1U;
+    Row.LineNo = 1U;
+    Row.IsBeginStatement = DefaultIsStmt;
+    Row.IsBeginBlock = false;
+    Row.IsEndSequence = false;
+    Row.IsPrologEnd = false;
+    Row.IsEpilogueBegin = false;
+    Row.ISA = 0U;
+    Row.Discriminator = 0U;
+    OpIndex = 0U;
+    CallContext = 0U;
+    Subprogram = 0U;
+  };
+  auto appendRow = [&]() {
+    Table.Rows.push_back(Row);
+    if (IsTwoLevel)
+      RowContexts.emplace_back(CallContext, Subprogram);
+    Row.IsBeginBlock = false;
+    Row.IsPrologEnd = false;
+    Row.IsEpilogueBegin = false;
+    Row.Discriminator = 0U;
+  };
+  auto advance = [&](Dwarf_Unsigned OperationAdvance) {
+    if (MaxOpsPerInst == 1U) {
+      Row.LineAddr += MinInstLength * OperationAdvance;
+      return;
+    }
+    Row.LineAddr +=
+        MinInstLength * ((OpIndex + OperationAdvance) / MaxOpsPerInst);
+    OpIndex = (OpIndex + OperationAdvance) % MaxOpsPerInst;
+  };
+
+  // Compilers' line programs average a few bytes per row.
+  Table.Rows.reserve(static_cast<size_t>((ProgramEnd - ProgramBegin) / 4U));
+  resetRegisters();
+  while (!Cursor.atEnd()) {
+    auto Opcode = static_cast<unsigned>(Cursor.readUnsigned(1));
+
+    // Special opcodes.
+    if (Opcode >= OpcodeBase) {
+      unsigned Adjusted = Opcode - OpcodeBase;
+      advance(Adjusted / LineRange);
+      Row.LineNo += static_cast<Dwarf_Unsigned>(
+          LineBase + static_cast<Dwarf_Signed>(Adjusted % LineRange));
+      appendRow();
+      continue;
+    }
+
+    // Extended opcodes.
+    if (Opcode == 0U) {
+      Dwarf_Unsigned OpLength = Cursor.readULEB();
+      if (OpLength == 0U)
+        THROW_DWARF_ERROR(DW_DLE_LINE_TABLE_BAD);
+      Dwarf_Off OpEnd = Cursor.getOffset() + OpLength;
+      switch (Cursor.readUnsigned(1)) {
+      case DW_LNE_end_sequence:
+        Row.IsEndSequence = true;
+        appendRow();
+        resetRegisters();
+        break;
+      case DW_LNE_set_address:
+        Row.LineAddr = Cursor.readUnsigned(AddressSize);
+        OpIndex = 0U;
+        break;
+      case DW_LNE_set_discriminator:
+        Row.Discriminator = Cursor.readULEB();
+        break;
+      default:
+        // DW_LNE_define_file is skipped too, as dwarf_srcfiles doesn't include
+        // the files it defines.
+        break;
+      }
+      if (OpEnd > ProgramEnd)
+        THROW_DWARF_ERROR(DW_DLE_LINE_TABLE_BAD);
+      Cursor.setOffset(OpEnd);
+      continue;
+    }
+
+    // Standard opcodes.
+    switch (Opcode) {
+    case DW_LNS_copy:
+      appendRow();
+      break;
+    case DW_LNS_advance_pc:
+      advance(Cursor.readULEB());
+      break;
+    case DW_LNS_advance_line:
+      Row.LineNo += static_cast<Dwarf_Unsigned>(Cursor.readSLEB());
+      break;
+    case DW_LNS_set_file:
+      Row.SrcFileID = Cursor.readULEB();
+      break;
+    case DW_LNS_set_column:
+      Cursor.readULEB();
+      break;
+    case DW_LNS_negate_stmt:
+      Row.IsBeginStatement = !Row.IsBeginStatement;
+      break;
+    case DW_LNS_set_basic_block:
+      Row.IsBeginBlock = true;
+      break;
+    case DW_LNS_const_add_pc:
+      advance((255U - OpcodeBase) / LineRange);
+      break;
+    case DW_LNS_fixed_advance_pc:
+      Row.LineAddr += Cursor.readUnsigned(2);
+      OpIndex = 0U;
+      break;
+    case DW_LNS_set_prologue_end:
+      Row.IsPrologEnd = true;
+      break;
+    case DW_LNS_set_epilogue_begin:
+      Row.IsEpilogueBegin = true;
+      break;
+    case DW_LNS_set_isa:
+      Row.ISA = Cursor.readULEB();
+      break;
+    default:
+      if (IsTwoLevel && Opcode == DW_LNS_set_subprogram) {
+        CallContext = 0U;
+        Subprogram = Cursor.readULEB();
+      } else if (IsTwoLevel && Opcode == DW_LNS_inlined_call) {
+        CallContext = Table.Rows.size() +
+                      static_cast<Dwarf_Unsigned>(Cursor.readSLEB());
+        Subprogram = Cursor.readULEB();
+      } else if (IsTwoLevel && Opcode == DW_LNS_pop_context) {
+        // Return to the registers of the calling row.
+        if (CallContext > 0U && CallContext <= Table.Rows.size()) {
+          auto Caller = static_cast<size_t>(CallContext - 1U);
+          const DwarfLineEntry &CallerRow = Table.Rows[Caller];
+          Row.SrcFileID = CallerRow.SrcFileID;
+          Row.LineNo = CallerRow.LineNo;
+          Row.Discriminator = CallerRow.Discriminator;
+          Row.IsBeginStatement = CallerRow.IsBeginStatement;
+          CallContext = RowContexts[Caller].first;
+          Subprogram = RowContexts[Caller].second;
+        }
+      } else {
+        // Opcodes that aren't known are skipped using their operand counts.
+        for (auto Count = OpcodeLengths[Opcode - 1U]; Count > 0U; --Count)
+          Cursor.readULEB();
+      }
+      break;
+    }
+  }
+
+  return Table;
+}
+
+// NativeDie methods.
+
+NativeDie::NativeDie(const NativeDebugData &DbgData, const NativeUnit &DieUnit,
+                     Dwarf_Off DieOffset)
+    : DebugData(&DbgData), Unit(&DieUnit), Offset(DieOffset), Abbrev(nullptr),
+      AttrsOffset(DieOffset) {
+  if (Offset >= Unit->NextHeaderOffset)
+    return;
+  DataCursor Cursor(DebugData->Info.Data, DebugData->Info.Size, Offset,
+                    DebugData->IsLittleEndian);
+  Dwarf_Unsigned Code = Cursor.readULEB();
+  AttrsOffset = Cursor.getOffset();
+  // A zero code is a null entry, which ends a list of siblings.
+  if (Code == 0U)
+    return;
+  Abbrev = Unit->Abbrevs->lookup(Code);
+  if (!Abbrev)
+    THROW_DWARF_ERROR(DW_DLE_DIE_ABBREV_BAD);
+}
+
+NativeDieChildIterator NativeDie::childrenBegin() const {
+  if (!hasChildren())
+    return childrenEnd();
+  Dwarf_Off FirstChild = getAttrsEndOffset();
+  if (FirstChild >= Unit->NextHeaderOffset)
+    return childrenEnd();
+  return NativeDieChildIterator(NativeDie(*DebugData, *Unit, FirstChild));
+}
+
+NativeDieChildIterator NativeDie::childrenEnd() {
+  return NativeDieChildIterator();
+}
+
+std::string NativeDie::getName() const {
+  AttrValue Value;
+  if (!findAttr(DW_AT_name, Value))
+    return "";
+  return formString(Value);
+}
+
+std::string NativeDie::getTagName() const {
+  return getDwarfTagAsString(getTag());
+}
+
+bool NativeDie::findAttr(Dwarf_Half Attr, AttrValue &Value) const {
+  if (!Abbrev)
+    return false;
+  DataCursor Cursor(DebugData->Info.Data, DebugData->Info.Size, AttrsOffset,
+                    DebugData->IsLittleEndian);
+  for (const auto &Spec : Abbrev->Attrs) {
+    if (Spec.Attr == Attr) {
+      Value.Form = Spec.Form;
+      if (Value.Form == DW_FORM_indirect)
+        Value.Form = static_cast<Dwarf_Half>(Cursor.readULEB());
+      Value.Offset = Cursor.getOffset();
+      Value.ImplicitConst = Spec.ImplicitConst;
+      return true;
+    }
+    skipForm(Cursor, Spec.Form, *Unit);
+  }
+  return false;
+}
+
+Dwarf_Off NativeDie::getAttrsEndOffset() const {
+  if (!Abbrev)
+    return AttrsOffset;
+  DataCursor Cursor(DebugData->Info.Data, DebugData->Info.Size, AttrsOffset,
+                    DebugData->IsLittleEndian);
+  for (const auto &Spec : Abbrev->Attrs)
+    skipForm(Cursor, Spec.Form, *Unit);
+  return Cursor.getOffset();
+}
+
+Dwarf_Off NativeDie::getSubtreeEndOffset() const {
+  DataCursor Cursor(DebugData->Info.Data, DebugData->Info.Size,
+                    getAttrsEndOffset(), DebugData->IsLittleEndian);
+  if (!hasChildren())
+    return Cursor.getOffset();
+
+  // Walk over the children and their descendants until the null entry that
+  // ends this Die's children.
+  unsigned Depth = 1U;
+  while (Depth > 0U && Cursor.getOffset() < Unit->NextHeaderOffset) {
+    Dwarf_Unsigned Code = Cursor.readULEB();
+    if (Code == 0U) {
+      --Depth;
+      continue;
+    }
+    const NativeAbbrev *ChildAbbrev = Unit->Abbrevs->lookup(Code);
+    if (!ChildAbbrev)
+      THROW_DWARF_ERROR(DW_DLE_DIE_ABBREV_BAD);
+    for (const auto &Spec : ChildAbbrev->Attrs)
+      skipForm(Cursor, Spec.Form, *Unit);
+    if (ChildAbbrev->HasChildren)
+      ++Depth;
+  }
+  return Cursor.getOffset();
+}
+
+NativeDie NativeDie::getNextSibling() const {
+  Dwarf_Off Next = 0U;
+  AttrValue Sibling;
+  if (findAttr(DW_AT_sibling, Sibling)) {
+    Next = formRef(Sibling);
+    // Ignore a sibling that doesn't move forwards within the unit.
+    if (Next <= Offset || Next > Unit->NextHeaderOffset)
+      Next = 0U;
+  }
+  if (Next == 0U)
+    Next = getSubtreeEndOffset();
+  if (Next >= Unit->NextHeaderOffset)
+    return NativeDie();
+  return NativeDie(*DebugData, *Unit, Next);
+}
+
+bool NativeDie::hasAttr(Dwarf_Half Attr) const {
+  AttrValue Value;
+  return findAttr(Attr, Value);
+}
+
+bool NativeDie::getAttrAsFlag(Dwarf_Half Attr) const {
+  AttrValue Value;
+  return findAttr(Attr, Value) && formFlag(Value);
+}
+
+const NativeDie::OptionalAttrValue<Dwarf_Addr>
+NativeDie::getAttrAsAddr(Dwarf_Half Attr) const {
+  AttrValue Value;
+  if (!findAttr(Attr, Value))
+    return OptionalAttrValue<Dwarf_Addr>();
+  return OptionalAttrValue<Dwarf_Addr>(formAddr(Value));
+}
+
+const NativeDie::OptionalAttrValue<Dwarf_Off>
+NativeDie::getAttrAsRef(Dwarf_Half Attr) const {
+  AttrValue Value;
+  if (!findAttr(Attr, Value))
+    return OptionalAttrValue<Dwarf_Off>();
+  return OptionalAttrValue<Dwarf_Off>(formRef(Value));
+}
+
+const NativeDie::OptionalAttrValue<Dwarf_Unsigned>
+NativeDie::getAttrAsUnsigned(Dwarf_Half Attr) const {
+  AttrValue Value;
+  if (!findAttr(Attr, Value))
+    return OptionalAttrValue<Dwarf_Unsigned>();
+  return OptionalAttrValue<Dwarf_Unsigned>(formUnsigned(Value));
+}
+
+const NativeDie::OptionalAttrValue<Dwarf_Signed>
+NativeDie::getAttrAsSigned(Dwarf_Half Attr) const {
+  AttrValue Value;
+  if (!findAttr(Attr, Value))
+    return OptionalAttrValue<Dwarf_Signed>();
+  return OptionalAttrValue<Dwarf_Signed>(formSigned(Value));
+}
+
+const NativeDie::OptionalAttrValue<std::string>
+NativeDie::getAttrAsString(Dwarf_Half Attr) const {
+  AttrValue Value;
+  if (!findAttr(Attr, Value))
+    return OptionalAttrValue<std::string>();
+  return OptionalAttrValue<std::string>(formString(Value));
+}
+
+const NativeDie::OptionalAttrValue<NativeDie::SignedUnsigned>
+NativeDie::getAttrAsSignedOrUnsigned(Dwarf_Half Attr) const {
+  AttrValue Value;
+  if (!findAttr(Attr, Value))
+    return OptionalAttrValue<SignedUnsigned>();
+  SignedUnsigned Result;
+  Result.IsSigned = Value.Form == DW_FORM_sdata;
+  if (Result.IsSigned)
+    Result.SignedValue = formSigned(Value);
+  else
+    Result.UnsignedValue = formUnsigned(Value);
+  return OptionalAttrValue<SignedUnsigned>(Result);
+}
+
+Dwarf_Addr NativeDie::getAttrAsAddr(Dwarf_Half Attr, Dwarf_Addr Default) const {
+  if (auto Ret = getAttrAsAddr(Attr))
+    return *Ret;
+  return Default;
+}
+Dwarf_Off NativeDie::getAttrAsRef(Dwarf_Half Attr, Dwarf_Off Default) const {
+  if (auto Ret = getAttrAsRef(Attr))
+    return *Ret;
+  return Default;
+}
+Dwarf_Unsigned NativeDie::getAttrAsUnsigned(Dwarf_Half Attr,
+                                            Dwarf_Unsigned Default) const {
+  if (auto Ret = getAttrAsUnsigned(Attr))
+    return *Ret;
+  return Default;
+}
+Dwarf_Signed NativeDie::getAttrAsSigned(Dwarf_Half Attr,
+                                        Dwarf_Signed Default) const {
+  if (auto Ret = getAttrAsSigned(Attr))
+    return *Ret;
+  return Default;
+}
+std::string NativeDie::getAttrAsString(Dwarf_Half Attr,
+                                       const std::string &Default) const {
+  if (auto Ret = getAttrAsString(Attr))
+    return *Ret;
+  return Default;
+}
+
+NativeDieAttributes NativeDie::decodeAttributes() const {
+  return NativeDieAttributes(*this);
+}
+
+std::vector<Dwarf_Half> NativeDie::getAttrList() const {
+  std::vector<Dwarf_Half> Result;
+  if (Abbrev)
+    for (const auto &Spec : Abbrev->Attrs)
+      Result.push_back(Spec.Attr);
+  return Result;
+}
+
+bool NativeDie::formFlag(const AttrValue &Value) const {
+  switch (Value.Form) {
+  case DW_FORM_flag_present:
+    return true;
+  case DW_FORM_flag:
+    return DataCursor(DebugData->Info.Data, DebugData->Info.Size, Value.Offset,
+                      DebugData->IsLittleEndian)
+               .readUnsigned(1) != 0U;
+  default:
+    THROW_DWARF_ERROR(DW_DLE_ATTR_FORM_BAD);
+  }
+}
+
+Dwarf_Addr NativeDie::formAddr(const AttrValue &Value) const {
+  DataCursor Cursor(DebugData->Info.Data, DebugData->Info.Size, Value.Offset,
+                    DebugData->IsLittleEndian);
+  Dwarf_Unsigned Index;
+  switch (Value.Form) {
+  case DW_FORM_addr:
+    return Cursor.readUnsigned(Unit->AddressSize);
+  case DW_FORM_addrx:
+  case DW_FORM_GNU_addr_index:
+    Index = Cursor.readULEB();
+    break;
+  case FormAddrx1:
+  case FormAddrx2:
+  case FormAddrx3:
+  case FormAddrx4:
+    Index = Cursor.readUnsigned(getFixedFormSize(Value.Form, *Unit));
+    break;
+  default:
+    THROW_DWARF_ERROR(DW_DLE_ATTR_FORM_BAD);
+  }
+  DataCursor AddrCursor(DebugData->Addr.Data, DebugData->Addr.Size,
+                        Unit->AddrBase, DebugData->IsLittleEndian);
+  AddrCursor.skip(Index * Unit->AddressSize);
+  return AddrCursor.readUnsigned(Unit->AddressSize);
+}
+
+Dwarf_Off NativeDie::formRef(const AttrValue &Value) const {
+  DataCursor Cursor(DebugData->Info.Data, DebugData->Info.Size, Value.Offset,
+                    DebugData->IsLittleEndian);
+  switch (Value.Form) {
+  // Offsets from the start of the unit.
+  case DW_FORM_ref1:
+  case DW_FORM_ref2:
+  case DW_FORM_ref4:
+  case DW_FORM_ref8:
+    return Unit->HeaderOffset +
+           Cursor.readUnsigned(getFixedFormSize(Value.Form, *Unit));
+  case DW_FORM_ref_udata:
+    return Unit->HeaderOffset + Cursor.readULEB();
+  // Offsets from the start of the section.
+  case DW_FORM_ref_addr:
+  case DW_FORM_sec_offset:
+  case DW_FORM_GNU_ref_alt:
+    return Cursor.readUnsigned(getFixedFormSize(Value.Form, *Unit));
+  // Before DWARF 4 these forms were also used for section offsets.
+  case DW_FORM_data4:
+  case DW_FORM_data8:
+    if (Unit->Version < 4)
+      return Cursor.readUnsigned(getFixedFormSize(Value.Form, *Unit));
+    THROW_DWARF_ERROR(DW_DLE_NOT_REF_FORM);
+  default:
+    THROW_DWARF_ERROR(DW_DLE_BAD_REF_FORM);
+  }
+}
+
+Dwarf_Unsigned NativeDie::formUnsigned(const AttrValue &Value) const {
+  DataCursor Cursor(DebugData->Info.Data, DebugData->Info.Size, Value.Offset,
+                    DebugData->IsLittleEndian);
+  switch (Value.Form) {
+  case DW_FORM_data1:
+  case DW_FORM_data2:
+  case DW_FORM_data4:
+  case DW_FORM_data8:
+    return Cursor.readUnsigned(getFixedFormSize(Value.Form, *Unit));
+  case DW_FORM_udata:
+    return Cursor.readULEB();
+  case DW_FORM_implicit_const:
+    return static_cast<Dwarf_Unsigned>(Value.ImplicitConst);
+  default:
+    THROW_DWARF_ERROR(DW_DLE_ATTR_FORM_BAD);
+  }
+}
+
+Dwarf_Signed NativeDie::formSigned(const AttrValue &Value) const {
+  DataCursor Cursor(DebugData->Info.Data, DebugData->Info.Size, Value.Offset,
+                    DebugData->IsLittleEndian);
+  switch (Value.Form) {
+  case DW_FORM_data1:
+  case DW_FORM_data2:
+  case DW_FORM_data4:
+  case DW_FORM_data8:
+    return Cursor.readSigned(getFixedFormSize(Value.Form, *Unit));
+  case DW_FORM_sdata:
+    return Cursor.readSLEB();
+  case DW_FORM_implicit_const:
+    return Value.ImplicitConst;
+  default:
+    THROW_DWARF_ERROR(DW_DLE_ATTR_FORM_BAD);
+  }
+}
+
+const char *NativeDie::formString(const AttrValue &Value) const {
+  DataCursor Cursor(DebugData->Info.Data, DebugData->Info.Size, Value.Offset,
+                    DebugData->IsLittleEndian);
+  const NativeDebugData::Section *Strings = &DebugData->Str;
+  Dwarf_Off StrOffset;
+  switch (Value.Form) {
+  case DW_FORM_string:
+    return Cursor.readCString();
+  case DW_FORM_strp:
+    StrOffset = Cursor.readUnsigned(Unit->OffsetSize);
+    break;
+  case DW_FORM_line_strp:
+    StrOffset = Cursor.readUnsigned(Unit->OffsetSize);
+    Strings = &DebugData->LineStr;
+    break;
+  case DW_FORM_strx:
+  case DW_FORM_GNU_str_index:
+  case FormStrx1:
+  case FormStrx2:
+  case FormStrx3:
+  case FormStrx4: {
+    Dwarf_Unsigned Index =
+        (Value.Form == DW_FORM_strx || Value.Form == DW_FORM_GNU_str_index)
+            ? Cursor.readULEB()
+            : Cursor.readUnsigned(getFixedFormSize(Value.Form, *Unit));
+    DataCursor OffsetsCursor(DebugData->StrOffsets.Data,
+                             DebugData->StrOffsets.Size, Unit->StrOffsetsBase,
+                             DebugData->IsLittleEndian);
+    OffsetsCursor.skip(Index * Unit->OffsetSize);
+    StrOffset = OffsetsCursor.readUnsigned(Unit->OffsetSize);
+    break;
+  }
+  default:
+    THROW_DWARF_ERROR(DW_DLE_STRING_FORM_IMPROPER);
+  }
+  if (StrOffset >= Strings->Size)
+    THROW_DWARF_ERROR(DW_DLE_STRP_OFFSET_BAD);
+  return DataCursor(Strings->Data, Strings->Size, StrOffset,
+                    DebugData->IsLittleEndian)
+      .readCString();
+}
+
+#undef THROW_DWARF_ERROR
+
+// NativeDieAttributes methods.
+
+NativeDieAttributes::NativeDieAttributes(const NativeDie &AttrsDie)
+    : Die(AttrsDie), Values() {
+  if (!Die.Abbrev)
+    return;
+  DataCursor Cursor(Die.DebugData->Info.Data, Die.DebugData->Info.Size,
+                    Die.AttrsOffset, Die.DebugData->IsLittleEndian);
+  const auto &Specs = Die.Abbrev->Attrs;
+  for (auto Spec = Specs.begin(), End = Specs.end(); Spec != End; ++Spec) {
+    size_t Slot = getDecodedAttrSlot(Spec->Attr);
+    // Keep the first of each attribute that is used, as findAttr would.
+    if (Slot < NumDecodedAttrs && Values[Slot].Form == 0) {
+      auto &Value = Values[Slot];
+      Value.Form = Spec->Form;
+      if (Value.Form == DW_FORM_indirect)
+        Value.Form = static_cast<Dwarf_Half>(Cursor.readULEB());
+      Value.Offset = Cursor.getOffset();
+      Value.ImplicitConst = Spec->ImplicitConst;
+      // The value of the last attribute doesn't need to be skipped.
+      if (Spec + 1 != End)
+        skipForm(Cursor, Value.Form, *Die.Unit);
+    } else if (Spec + 1 != End)
+      skipForm(Cursor, Spec->Form, *Die.Unit);
+  }
+}
+
+const NativeDie::AttrValue *
+NativeDieAttributes::findAttr(Dwarf_Half Attr) const {
+  size_t Slot = getDecodedAttrSlot(Attr);
+  assert(Slot < NumDecodedAttrs && "Attribute is not decoded");
+  if (Slot < NumDecodedAttrs && Values[Slot].Form != 0)
+    return &Values[Slot];
+  return nullptr;
+}
+
+bool NativeDieAttributes::getAttrAsFlag(Dwarf_Half Attr) const {
+  auto Value = findAttr(Attr);
+  return Value && Die.formFlag(*Value);
+}
+
+const NativeDieAttributes::OptionalAttrValue<Dwarf_Off>
+NativeDieAttributes::getAttrAsRef(Dwarf_Half Attr) const {
+  if (auto Value = findAttr(Attr))
+    return OptionalAttrValue<Dwarf_Off>(Die.formRef(*Value));
+  return OptionalAttrValue<Dwarf_Off>();
+}
+
+const NativeDieAttributes::OptionalAttrValue<Dwarf_Unsigned>
+NativeDieAttributes::getAttrAsUnsigned(Dwarf_Half Attr) const {
+  if (auto Value = findAttr(Attr))
+    return OptionalAttrValue<Dwarf_Unsigned>(Die.formUnsigned(*Value));
+  return OptionalAttrValue<Dwarf_Unsigned>();
+}
+
+const NativeDieAttributes::OptionalAttrValue<Dwarf_Signed>
+NativeDieAttributes::getAttrAsSigned(Dwarf_Half Attr) const {
+  if (auto Value = findAttr(Attr))
+    return OptionalAttrValue<Dwarf_Signed>(Die.formSigned(*Value));
+  return OptionalAttrValue<Dwarf_Signed>();
+}
+
+const NativeDieAttributes::OptionalAttrValue<std::string>
+NativeDieAttributes::getAttrAsString(Dwarf_Half Attr) const {
+  if (auto Value = findAttr(Attr))
+    return OptionalAttrValue<std::string>(Die.formString(*Value));
+  return OptionalAttrValue<std::string>();
+}
+
+size_t NativeDieAttributes::getAttrAsStringIndex(
+    Dwarf_Half Attr, DwarfStringCache &Cache) const {
+  if (auto Value = findAttr(Attr))
+    return Cache.getStringIndex(Die.formString(*Value), Value->Form);
+  return 0U;
+}
+
+const NativeDieAttributes::OptionalAttrValue<DwarfDie::SignedUnsigned>
+NativeDieAttributes::getAttrAsSignedOrUnsigned(Dwarf_Half Attr) const {
+  auto Value = findAttr(Attr);
+  if (!Value)
+    return OptionalAttrValue<SignedUnsigned>();
+  SignedUnsigned Result;
+  Result.IsSigned = Value->Form == DW_FORM_sdata;
+  if (Result.IsSigned)
+    Result.SignedValue = Die.formSigned(*Value);
+  else
+    Result.UnsignedValue = Die.formUnsigned(*Value);
+  return OptionalAttrValue<SignedUnsigned>(Result);
+}
+
+Dwarf_Off NativeDieAttributes::getAttrAsRef(Dwarf_Half Attr,
+                                            Dwarf_Off Default) const {
+  if (auto Ret = getAttrAsRef(Attr))
+    return *Ret;
+  return Default;
+}
+Dwarf_Unsigned
+NativeDieAttributes::getAttrAsUnsigned(Dwarf_Half Attr,
+                                       Dwarf_Unsigned Default) const {
+  if (auto Ret = getAttrAsUnsigned(Attr))
+    return *Ret;
+  return Default;
+}
+Dwarf_Signed NativeDieAttributes::getAttrAsSigned(Dwarf_Half Attr,
+                                                  Dwarf_Signed Default) const {
+  if (auto Ret = getAttrAsSigned(Attr))
+    return *Ret;
+  return Default;
+}
+std::string NativeDieAttributes::getAttrAsString(
+    Dwarf_Half Attr, const std::string &Default) const {
+  if (auto Ret = getAttrAsString(Attr))
+    return *Ret;
+  return Default;
+}
+
+// NativeDieChildIterator methods.
+
+NativeDieChildIterator &NativeDieChildIterator::operator++() {
+  Child = Child.getNextSibling();
+  return *this;
+}
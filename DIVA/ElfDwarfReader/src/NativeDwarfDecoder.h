@@ -0,0 +1,416 @@
+//===-- ElfDwarfReader/NativeDwarfDecoder.h ---------------------*- C++ -*-===//
+///
+/// Copyright (c) Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of a DWARF decoder that reads the DIEs
+/// directly from the mapped ELF sections, without going through libdwarf.
+///
+/// The DIEs are handed out as lightweight cursors into .debug_info, with the
+/// same interface as the libdwarf wrappers in LibDwarfHelpers.h, so the reader
+/// can be used with either. All of the decoded data is immutable once it has
+/// been loaded, so it can be shared between threads.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef NATIVE_DWARF_DECODER_H
+#define NATIVE_DWARF_DECODER_H
+
+#include "FileUtilities.h"
+#include "LibDwarfHelpers.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ElfDwarfReader {
+
+class NativeDebugData;
+class NativeDie;
+class NativeDieAttributes;
+class NativeDieChildCursor;
+class NativeDieChildIterator;
+
+/// \brief The contents of a section.
+struct NativeSection {
+  NativeSection() : Data(nullptr), Size(0U) {}
+  NativeSection(const char *SectionData, size_t SectionSize)
+      : Data(SectionData), Size(SectionSize) {}
+  const char *Data;
+  size_t Size;
+};
+
+/// \brief An abbreviation declaration from .debug_abbrev.
+struct NativeAbbrev {
+  struct AttrSpec {
+    Dwarf_Half Attr;
+    Dwarf_Half Form;
+    // Only used by DW_FORM_implicit_const.
+    Dwarf_Signed ImplicitConst;
+  };
+
+  Dwarf_Half Tag;
+  bool HasChildren;
+  std::vector<AttrSpec> Attrs;
+};
+
+/// \brief All the abbreviation declarations at one .debug_abbrev offset.
+class NativeAbbrevTable {
+public:
+  /// \brief get the declaration for an abbreviation code, or nullptr if the
+  /// code is not in the table.
+  const NativeAbbrev *lookup(Dwarf_Unsigned Code) const;
+
+  /// \brief Add a declaration, returns false if the code was already used.
+  bool add(Dwarf_Unsigned Code, NativeAbbrev &&Abbrev);
+
+private:
+  // Codes are normally numbered from one without gaps, so they index Dense
+  // (Code - 1). Any other codes go in Sparse.
+  std::vector<NativeAbbrev> Dense;
+  std::unordered_map<Dwarf_Unsigned, NativeAbbrev> Sparse;
+};
+
+/// \brief A unit header from .debug_info.
+struct NativeUnit {
+  Dwarf_Off HeaderOffset;
+  Dwarf_Off FirstDieOffset;
+  Dwarf_Off NextHeaderOffset;
+  Dwarf_Half Version;
+  Dwarf_Small AddressSize;
+  Dwarf_Small OffsetSize;
+  const NativeAbbrevTable *Abbrevs;
+  // Bases for the indexed string and address forms (read from the unit DIE).
+  Dwarf_Unsigned StrOffsetsBase;
+  Dwarf_Unsigned AddrBase;
+};
+
+/// \brief A line table decoded from a .debug_line line-number program.
+struct NativeLineTable {
+  NativeLineTable() : Version(0U) {}
+
+  Dwarf_Half Version;
+  /// The full path of each source file, indexed by file number. File numbers
+  /// start at one before DWARF 5, so the first name is empty for those.
+  std::vector<std::string> FileNames;
+  /// The rows of the line matrix, the logical rows for two-level tables.
+  std::vector<DwarfLineEntry> Rows;
+};
+
+/// \brief The sections needed to decode a line-number program.
+struct NativeLineSections {
+  NativeLineSections() : IsLittleEndian(true) {}
+
+  NativeSection Line;
+  NativeSection Str;
+  NativeSection LineStr;
+  bool IsLittleEndian;
+};
+
+/// \brief Decode the line-number program at Offset in .debug_line.
+///
+/// This supports DWARF 2 to 5 and the experimental two-level tables. The file
+/// names are built the same way as dwarf_srcfiles, using CompDir for relative
+/// paths. AddressSize is only used before DWARF 5, which has it in the header.
+/// With FilesOnly, only the header is read. Throws a LibDwarfError if the
+/// program is malformed.
+NativeLineTable decodeLineProgram(const NativeLineSections &Sections,
+                                  Dwarf_Off Offset, Dwarf_Small AddressSize,
+                                  const std::string &CompDir,
+                                  bool FilesOnly = false);
+
+/// \brief The debug sections of an ELF file and their decoded unit headers
+/// and abbreviation tables.
+class NativeDebugData {
+public:
+  friend class NativeDie;
+  friend class NativeDieAttributes;
+
+  /// \brief Load the debug information from an ELF file.
+  ///
+  /// Returns nullptr if the file uses anything the native decoder doesn't
+  /// support (such as compressed sections or unknown relocations), in which
+  /// case libdwarf should be used instead.
+  static std::unique_ptr<NativeDebugData>
+  create(const std::string &UnifiedPath);
+
+  NativeDebugData(const NativeDebugData &) = delete;
+  NativeDebugData &operator=(const NativeDebugData &) = delete;
+
+  /// \brief get all the unit headers in .debug_info order.
+  const std::vector<NativeUnit> &getUnits() const { return Units; }
+
+  /// \brief get the unit containing a global .debug_info offset, or nullptr.
+  const NativeUnit *findUnit(Dwarf_Off Offset) const;
+
+  /// \brief get the Die at a global offset in the .debug_info section. The
+  /// returned Die is null if there is no Die at the offset.
+  NativeDie getDie(Dwarf_Off Offset) const;
+
+  /// \brief Decode the line table of the compile unit whose Die is at
+  /// CUOffset, see decodeLineProgram. The table is empty if the unit doesn't
+  /// have one.
+  NativeLineTable getLineTable(Dwarf_Off CUOffset,
+                               bool FilesOnly = false) const;
+
+  bool isLittleEndian() const { return IsLittleEndian; }
+
+private:
+  using Section = NativeSection;
+
+  NativeDebugData() : IsLittleEndian(true) {}
+
+  // Find the debug sections, relocating them if needed. Returns false if the
+  // file can't be handled.
+  bool loadSections();
+  // Read the unit headers and their abbreviation tables.
+  bool loadUnits();
+
+  LibScopeView::MappedFile File;
+  bool IsLittleEndian;
+
+  Section Info;
+  Section Abbrev;
+  Section Str;
+  Section LineStr;
+  Section Line;
+  Section StrOffsets;
+  Section Addr;
+
+  // Relocated copies of sections, for relocatable objects.
+  std::vector<std::unique_ptr<char[]>> RelocatedSections;
+
+  // Abbreviation tables by .debug_abbrev offset. A map is used so the tables
+  // don't move once the units point at them.
+  std::map<Dwarf_Off, NativeAbbrevTable> AbbrevTables;
+
+  std::vector<NativeUnit> Units;
+};
+
+/// \brief A cursor to a DIE in the .debug_info section.
+///
+/// This has the same interface as DwarfDie, but is cheap to copy and doesn't
+/// own any resources.
+class NativeDie {
+public:
+  friend class NativeDebugData;
+  friend class NativeDieAttributes;
+  friend class NativeDieChildIterator;
+
+  template <typename ValTy>
+  using OptionalAttrValue = DwarfDie::OptionalAttrValue<ValTy>;
+  using SignedUnsigned = DwarfDie::SignedUnsigned;
+  using ChildCursor = NativeDieChildCursor;
+
+  NativeDie()
+      : DebugData(nullptr), Unit(nullptr), Offset(0U), Abbrev(nullptr),
+        AttrsOffset(0U) {}
+  NativeDie(const NativeDebugData &DbgData, const NativeUnit &DieUnit,
+            Dwarf_Off DieOffset);
+
+  /// \brief Check if this is a null entry (or doesn't point at a Die).
+  bool isNull() const { return Abbrev == nullptr; }
+
+  const NativeUnit *getUnit() const { return Unit; }
+  bool hasChildren() const { return Abbrev && Abbrev->HasChildren; }
+
+  NativeDieChildIterator childrenBegin() const;
+  static NativeDieChildIterator childrenEnd();
+
+  Dwarf_Off getGlobalOffset() const { return Offset; }
+  std::string getName() const;
+  Dwarf_Half getTag() const { return Abbrev ? Abbrev->Tag : 0; }
+  std::string getTagName() const;
+
+  // Attribute getters.
+  bool hasAttr(Dwarf_Half Attr) const;
+  bool getAttrAsFlag(Dwarf_Half Attr) const;
+  const OptionalAttrValue<Dwarf_Addr> getAttrAsAddr(Dwarf_Half Attr) const;
+  const OptionalAttrValue<Dwarf_Off> getAttrAsRef(Dwarf_Half Attr) const;
+  const OptionalAttrValue<Dwarf_Unsigned>
+  getAttrAsUnsigned(Dwarf_Half Attr) const;
+  const OptionalAttrValue<Dwarf_Signed> getAttrAsSigned(Dwarf_Half Attr) const;
+  const OptionalAttrValue<std::string> getAttrAsString(Dwarf_Half Attr) const;
+
+  /// \brief get an attribute as either a signed or unsigned value.
+  const OptionalAttrValue<SignedUnsigned>
+  getAttrAsSignedOrUnsigned(Dwarf_Half Attr) const;
+
+  // Attribute getters with defaults.
+  Dwarf_Addr getAttrAsAddr(Dwarf_Half Attr, Dwarf_Addr Default) const;
+  Dwarf_Off getAttrAsRef(Dwarf_Half Attr, Dwarf_Off Default) const;
+  Dwarf_Unsigned getAttrAsUnsigned(Dwarf_Half Attr,
+                                   Dwarf_Unsigned Default) const;
+  Dwarf_Signed getAttrAsSigned(Dwarf_Half Attr, Dwarf_Signed Default) const;
+  std::string getAttrAsString(Dwarf_Half Attr,
+                              const std::string &Default) const;
+
+  /// \brief Read the attributes used by the reader in a single pass over the
+  /// Die's attribute values.
+  NativeDieAttributes decodeAttributes() const;
+
+  /// \brief get the attribute codes of the Die in order.
+  std::vector<Dwarf_Half> getAttrList() const;
+
+  friend bool operator==(const NativeDie &A, const NativeDie &B) {
+    return A.Abbrev == B.Abbrev && (A.isNull() || A.Offset == B.Offset);
+  }
+  friend bool operator!=(const NativeDie &A, const NativeDie &B) {
+    return !(A == B);
+  }
+
+private:
+  // The raw location of an attribute's value.
+  struct AttrValue {
+    Dwarf_Half Form;
+    Dwarf_Off Offset;
+    Dwarf_Signed ImplicitConst;
+  };
+
+  // Find an attribute, returns false if the Die doesn't have it.
+  bool findAttr(Dwarf_Half Attr, AttrValue &Value) const;
+  // get the offset just past the end of the Die's attributes.
+  Dwarf_Off getAttrsEndOffset() const;
+  // get the offset just past the end of the Die and all its children.
+  Dwarf_Off getSubtreeEndOffset() const;
+  // get the next sibling, or a null Die if this is the last child.
+  NativeDie getNextSibling() const;
+
+  // Form conversions, these throw a LibDwarfError for the same forms that
+  // libdwarf rejects.
+  bool formFlag(const AttrValue &Value) const;
+  Dwarf_Addr formAddr(const AttrValue &Value) const;
+  Dwarf_Off formRef(const AttrValue &Value) const;
+  Dwarf_Unsigned formUnsigned(const AttrValue &Value) const;
+  Dwarf_Signed formSigned(const AttrValue &Value) const;
+  const char *formString(const AttrValue &Value) const;
+
+  const NativeDebugData *DebugData;
+  const NativeUnit *Unit;
+  Dwarf_Off Offset;
+  const NativeAbbrev *Abbrev;
+  // Offset of the first attribute value (after the abbreviation code).
+  Dwarf_Off AttrsOffset;
+};
+
+/// \brief The attributes of a NativeDie that are used by the reader, see
+/// getDecodedAttrSlot().
+///
+/// This has the same interface as DwarfDieAttributes. Only the locations of
+/// the values are recorded, they are converted when they are requested.
+class NativeDieAttributes {
+public:
+  template <typename ValTy>
+  using OptionalAttrValue = DwarfDie::OptionalAttrValue<ValTy>;
+  using SignedUnsigned = DwarfDie::SignedUnsigned;
+
+  explicit NativeDieAttributes(const NativeDie &AttrsDie);
+
+  // Attribute getters.
+  bool hasAttr(Dwarf_Half Attr) const { return findAttr(Attr) != nullptr; }
+  bool getAttrAsFlag(Dwarf_Half Attr) const;
+  const OptionalAttrValue<Dwarf_Off> getAttrAsRef(Dwarf_Half Attr) const;
+  const OptionalAttrValue<Dwarf_Unsigned>
+  getAttrAsUnsigned(Dwarf_Half Attr) const;
+  const OptionalAttrValue<Dwarf_Signed> getAttrAsSigned(Dwarf_Half Attr) const;
+  const OptionalAttrValue<std::string> getAttrAsString(Dwarf_Half Attr) const;
+
+  /// \brief get an attribute as either a signed or unsigned value.
+  const OptionalAttrValue<SignedUnsigned>
+  getAttrAsSignedOrUnsigned(Dwarf_Half Attr) const;
+
+  // Attribute getters with defaults.
+  Dwarf_Off getAttrAsRef(Dwarf_Half Attr, Dwarf_Off Default) const;
+  Dwarf_Unsigned getAttrAsUnsigned(Dwarf_Half Attr,
+                                   Dwarf_Unsigned Default) const;
+  Dwarf_Signed getAttrAsSigned(Dwarf_Half Attr, Dwarf_Signed Default) const;
+  std::string getAttrAsString(Dwarf_Half Attr,
+                              const std::string &Default) const;
+
+  /// \brief get a string attribute's StringPool index, or 0 if the Die doesn't
+  /// have it.
+  size_t getAttrAsStringIndex(Dwarf_Half Attr, DwarfStringCache &Cache) const;
+
+private:
+  // get the value in Attr's slot, or nullptr if the Die doesn't have it.
+  const NativeDie::AttrValue *findAttr(Dwarf_Half Attr) const;
+
+  NativeDie Die;
+  // A Form of zero marks an attribute the Die doesn't have.
+  NativeDie::AttrValue Values[NumDecodedAttrs];
+};
+
+/// \brief Access all a NativeDie's children in sequence.
+///
+/// Siblings are found through DW_AT_sibling when it is present, otherwise the
+/// previous child's subtree is skipped over.
+class NativeDieChildIterator {
+public:
+  NativeDieChildIterator() = default;
+  explicit NativeDieChildIterator(const NativeDie &FirstChild)
+      : Child(FirstChild) {}
+
+  const NativeDie &operator*() const { return Child; }
+  const NativeDie *operator->() const { return &Child; }
+
+  friend bool operator==(const NativeDieChildIterator &a,
+                         const NativeDieChildIterator &b) {
+    return a.Child == b.Child;
+  }
+  friend bool operator!=(const NativeDieChildIterator &a,
+                         const NativeDieChildIterator &b) {
+    return !(a == b);
+  }
+
+  NativeDieChildIterator &operator++();
+  void operator++(int) { ++(*this); }
+
+  bool atEnd() const { return Child.isNull(); }
+
+private:
+  NativeDie Child;
+};
+
+/// \brief Visit a NativeDie's children in sequence, with the same interface
+/// as DwarfDieChildCursor.
+class NativeDieChildCursor {
+public:
+  explicit NativeDieChildCursor(const NativeDie &Parent)
+      : IT(Parent.childrenBegin()) {}
+
+  const NativeDie &operator*() const { return *IT; }
+  const NativeDie *operator->() const { return &*IT; }
+
+  void next() { ++IT; }
+
+  bool atEnd() const { return IT.atEnd(); }
+
+private:
+  NativeDieChildIterator IT;
+};
+
+} // end namespace ElfDwarfReader
+
+#endif // NATIVE_DWARF_DECODER_H
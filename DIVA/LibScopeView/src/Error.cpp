@@ -93,9 +93,17 @@ const ErrorEntry &getEntry(const ErrorCode Code) {
   return ErrorTable[static_cast<size_t>(Code)];
 }
 
+// Write any buffered output, so that it comes before the message. A thread
+// printing to a context of its own keeps its text, to be written out in order.
+void flushOutput() {
+  if (LibScopeView::PrintContext *Context = LibScopeView::getPrintContext())
+    Context->flush();
+}
+
 } // namespace
 
 void LibScopeError::warning(const std::string &Msg) {
+  flushOutput();
   fprintf(stderr, "\nWarning: %s\n", Msg.c_str());
   // Printing to stderr includes a flush on Linux but not Windows
   fflush(stderr);
@@ -112,6 +120,7 @@ void LibScopeError::warning(const std::string &Msg) {
 #endif
 
 void LibScopeError::fatalError(const ErrorCode Code) {
+  flushOutput();
   fprintf(stderr, "\n%s: ", getEntry(Code).Name);
   fprintf(stderr, getEntry(Code).Format);
   fprintf(stderr, "\n");
@@ -119,6 +128,7 @@ void LibScopeError::fatalError(const ErrorCode Code) {
 }
 void LibScopeError::fatalError(const ErrorCode Code,
                                const std::string &Detail1) {
+  flushOutput();
   fprintf(stderr, "\n%s: ", getEntry(Code).Name);
   fprintf(stderr, getEntry(Code).Format, Detail1.c_str());
   fprintf(stderr, "\n");
@@ -126,6 +136,7 @@ void LibScopeError::fatalError(const ErrorCode Code,
 }
 void LibScopeError::fatalError(const ErrorCode Code, const std::string &Detail1,
                                const std::string &Detail2) {
+  flushOutput();
   fprintf(stderr, "\n%s: ", getEntry(Code).Name);
   fprintf(stderr, getEntry(Code).Format, Detail1.c_str(), Detail2.c_str());
   fprintf(stderr, "\n");
@@ -50,6 +50,7 @@
 #include <errno.h>
 #include <limits.h>
 #include <stdlib.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -317,3 +318,44 @@ FileDescriptor &FileDescriptor::operator=(FileDescriptor &&Other) {
   swap(*this, Tmp);
   return *this;
 }
+
+MappedFile::MappedFile(const std::string &UnifiedPath)
+    : Data(nullptr), Size(0U) {
+  FileDescriptor FD(UnifiedPath);
+#ifdef PLATFORM_WIN
+  HANDLE File = reinterpret_cast<HANDLE>(_get_osfhandle(*FD));
+  LARGE_INTEGER FileSize;
+  if (!GetFileSizeEx(File, &FileSize) || FileSize.QuadPart == 0)
+    return;
+  HANDLE Mapping =
+      CreateFileMappingA(File, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!Mapping)
+    return;
+  void *View = MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+  // The view keeps the mapping alive.
+  CloseHandle(Mapping);
+  if (!View)
+    return;
+  Size = static_cast<size_t>(FileSize.QuadPart);
+#else
+  struct stat FileStat;
+  if (fstat(*FD, &FileStat) != 0 || FileStat.st_size == 0)
+    return;
+  void *View = mmap(nullptr, static_cast<size_t>(FileStat.st_size), PROT_READ,
+                    MAP_PRIVATE, *FD, 0);
+  if (View == MAP_FAILED)
+    return;
+  Size = static_cast<size_t>(FileStat.st_size);
+#endif
+  Data = static_cast<const char *>(View);
+}
+
+MappedFile::~MappedFile() {
+  if (Data) {
+#ifdef PLATFORM_WIN
+    UnmapViewOfFile(Data);
+#else
+    munmap(const_cast<char *>(Data), Size);
+#endif
+  }
+}
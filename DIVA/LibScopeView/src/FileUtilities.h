@@ -31,7 +31,9 @@
 #ifndef FILE_UTILITIES_H
 #define FILE_UTILITIES_H
 
+#include <cstddef>
 #include <string>
+#include <utility>
 
 namespace LibScopeView {
 
@@ -99,6 +101,38 @@ private:
   int FD;
 };
 
+/// \brief RAII wrapper around a read-only memory mapping of a whole file.
+class MappedFile {
+public:
+  MappedFile() : Data(nullptr), Size(0U) {}
+  MappedFile(const std::string &UnifiedPath);
+  ~MappedFile();
+
+  const char *data() const { return Data; }
+  size_t size() const { return Size; }
+
+  friend void swap(MappedFile &A, MappedFile &B) {
+    std::swap(A.Data, B.Data);
+    std::swap(A.Size, B.Size);
+  }
+
+  MappedFile(const MappedFile &Other) = delete;
+  MappedFile &operator=(const MappedFile &Other) = delete;
+
+  MappedFile(MappedFile &&Other) : Data(nullptr), Size(0U) {
+    swap(*this, Other);
+  }
+  MappedFile &operator=(MappedFile &&Other) {
+    MappedFile Tmp(std::move(Other));
+    swap(*this, Tmp);
+    return *this;
+  }
+
+private:
+  const char *Data;
+  size_t Size;
+};
+
 } // namespace LibScopeView
 
 #endif // FILE_UTILITIES_H
@@ -28,35 +28,71 @@
 //===----------------------------------------------------------------------===//
 
 #include "Line.h"
+#include "LineTable.h"
 #include "PrintContext.h"
 #include "Reader.h"
 #include "Utilities.h"
 
-#include <sstream>
+#include <assert.h>
 
 using namespace LibScopeView;
 
 Line::Line(LevelType Lvl)
-    : Element(Lvl), Discriminator(0) {
+    : Element(Lvl), Discriminator(0), Table(nullptr) {
   setIsLine();
+  setKind(ok_line);
 
   Line::setTag();
 }
 
-Line::Line() : Element(), Discriminator(0) {
+Line::Line() : Element(), Discriminator(0), Table(nullptr) {
   setIsLine();
+  setKind(ok_line);
 
   Line::setTag();
 }
 
+Line::Line(LevelType Lvl, const LineTable &Table)
+    : Element(Lvl), Discriminator(0), Table(&Table) {
+  setIsLine();
+  setKind(ok_line);
+  setIsLineRecord();
+#ifndef NDEBUG
+  Tag = 0;
+#endif
+}
+
 Line::~Line() {}
 
-uint32_t Line::LinesAllocated = 0;
+void Line::setRow(size_t Row) {
+  assert(Table && "Line::setRow called on a Line that is not a view");
+  setLineNumber(Table->getLineNumber(Row));
+  setAddress(Table->getAddress(Row));
+  setFileNameIndex(Table->getFileNameIndex(Row));
+  if (Table->getFlag(Row, lf_invalid_filename))
+    setInvalidFileName();
+  else
+    resetInvalidFileName();
+
+  Discriminator = Table->getDiscriminator(Row);
+  LineAttributesFlags[HasDiscriminator] =
+      Table->getFlag(Row, lf_has_discriminator);
+  LineAttributesFlags[IsNewStatement] = Table->getFlag(Row, lf_new_statement);
+  LineAttributesFlags[IsNewBasicBlock] = Table->getFlag(Row, lf_basic_block);
+  LineAttributesFlags[IsLineEndSequence] =
+      Table->getFlag(Row, lf_end_sequence);
+  LineAttributesFlags[IsEpilogueBegin] =
+      Table->getFlag(Row, lf_epilogue_begin);
+  LineAttributesFlags[IsPrologueEnd] = Table->getFlag(Row, lf_prologue_end);
+}
+
+std::atomic<uint32_t> Line::LinesAllocated(0);
 
 void Line::setTag() {
-  ++Line::LinesAllocated;
 #ifndef NDEBUG
-  Tag = Line::LinesAllocated;
+  Tag = ++Line::LinesAllocated;
+#else
+  ++Line::LinesAllocated;
 #endif
 }
 
@@ -107,57 +143,49 @@ void Line::dump() {
 }
 
 void Line::dumpExtra() {
-  GlobalPrintContext->print("%s\n", getAsText().c_str());
+  getPrintContext()->printText(*this);
 }
 
-std::string Line::getAsText() const {
-  std::stringstream Result;
-  Result << '{' << getKindAsString() << '}';
+void Line::appendText(TextBuffer &Text) const {
+  Text.append('{');
+  Text.append(getKindAsString());
+  Text.append('}');
   if (getReader()->getOptions().getFormatLine() ||
       getReader()->getOptions().getPrintCodelineAttributes()) {
     if (getIsNewStatement()) {
-      Result << '\n' << getAttributeInfoAsText(KindNewStatement);
+      appendAttributeInfo(Text, KindNewStatement);
     }
     if (getIsPrologueEnd()) {
-      Result << '\n' << getAttributeInfoAsText(KindPrologueEnd);
+      appendAttributeInfo(Text, KindPrologueEnd);
     }
     if (getIsLineEndSequence()) {
-      Result << '\n' << getAttributeInfoAsText(KindEndSequence);
+      appendAttributeInfo(Text, KindEndSequence);
     }
     if (getIsNewBasicBlock()) {
-      Result << '\n' << getAttributeInfoAsText(KindBasicBlock);
+      appendAttributeInfo(Text, KindBasicBlock);
     }
     if (getHasDiscriminator()) {
-      Result << '\n' << getAttributeInfoAsText(KindDiscriminator);
+      appendAttributeInfo(Text, KindDiscriminator);
     }
     if (getIsEpilogueBegin()) {
-      Result << '\n' << getAttributeInfoAsText(KindEpilogueBegin);
+      appendAttributeInfo(Text, KindEpilogueBegin);
     }
   }
-  return Result.str();
 }
 
-std::string Line::getAsYAML() const {
-  std::stringstream YAML;
-  std::stringstream Attrs;
-  const std::string YAMLTrue(": true");
-  const std::string YAMLFalse(": false");
-  Attrs << "\n  " << KindNewStatement
-        << (getIsNewStatement() ? YAMLTrue : YAMLFalse);
-  Attrs << "\n  " << KindPrologueEnd
-        << (getIsPrologueEnd() ? YAMLTrue : YAMLFalse);
-  Attrs << "\n  " << KindEndSequence
-        << (getIsLineEndSequence() ? YAMLTrue : YAMLFalse);
-  Attrs << "\n  " << KindBasicBlock
-        << (getIsNewBasicBlock() ? YAMLTrue : YAMLFalse);
-  Attrs << "\n  " << KindDiscriminator
-        << (getHasDiscriminator() ? YAMLTrue : YAMLFalse);
-  Attrs << "\n  " << KindEpilogueBegin
-        << (getIsEpilogueBegin() ? YAMLTrue : YAMLFalse);
-
-  if (Attrs.str().empty())
-    Attrs << " {}";
-
-  YAML << getCommonYAML() << "\nattributes:" << Attrs.str();
-  return YAML.str();
+void Line::appendYAML(TextBuffer &YAML) const {
+  auto appendFlag = [&YAML](const char *Kind, bool Value) {
+    YAML.append("\n  ");
+    YAML.append(Kind);
+    YAML.append(Value ? ": true" : ": false");
+  };
+
+  appendCommonYAML(YAML);
+  YAML.append("\nattributes:");
+  appendFlag(KindNewStatement, getIsNewStatement());
+  appendFlag(KindPrologueEnd, getIsPrologueEnd());
+  appendFlag(KindEndSequence, getIsLineEndSequence());
+  appendFlag(KindBasicBlock, getIsNewBasicBlock());
+  appendFlag(KindDiscriminator, getHasDiscriminator());
+  appendFlag(KindEpilogueBegin, getIsEpilogueBegin());
 }
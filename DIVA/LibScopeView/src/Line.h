@@ -34,6 +34,8 @@
 
 namespace LibScopeView {
 
+class LineTable;
+
 /// \brief  Class to represent a single line info entry.
 ///
 /// Contains a filename, line number and address.
@@ -41,11 +43,18 @@ class Line : public Element {
 public:
   Line();
   Line(LevelType Lvl);
+  /// \brief Create a Line that views the rows of a LineTable, see setRow().
+  ///
+  /// The view is not counted as an allocated Line, as the table counts its
+  /// rows.
+  Line(LevelType Lvl, const LineTable &Table);
   virtual ~Line() override;
 
   Line &operator=(const Line &) = delete;
   Line(const Line &) = delete;
 
+  static bool classof(const Object *Obj) { return Obj->getKind() == ok_line; }
+
 private:
   // Line Kind.
   static const char *KindDiscriminator;
@@ -119,6 +128,17 @@ public:
   bool getIsPrologueEnd() const { return LineAttributesFlags[IsPrologueEnd]; }
   void setIsPrologueEnd() { LineAttributesFlags.set(IsPrologueEnd); }
 
+private:
+  // The table viewed by this Line, or nullptr.
+  const LineTable *Table;
+
+public:
+  /// \brief Show the values of a row of the viewed LineTable.
+  ///
+  /// The Object flags (pattern, global, etc.) are not changed, as they apply
+  /// to all of the rows.
+  void setRow(size_t Row);
+
 public:
   /// \brief Line address.
   Dwarf_Addr getAddress() const { return getDieOffset(); }
@@ -144,13 +164,13 @@ public:
   void dump() override;
   virtual void dumpExtra();
 
-  /// \brief Returns a text representation of this DIVA Object.
-  std::string getAsText() const override;
-  /// \brief Returns a YAML representation of this DIVA Object.
-  std::string getAsYAML() const override;
+  /// \brief Appends a text representation of this DIVA Object.
+  void appendText(TextBuffer &Text) const override;
+  /// \brief Appends a YAML representation of this DIVA Object.
+  void appendYAML(TextBuffer &YAML) const override;
 
 private:
-  static uint32_t LinesAllocated;
+  static std::atomic<uint32_t> LinesAllocated;
 
 public:
   static uint32_t getInstanceCount() { return LinesAllocated; }
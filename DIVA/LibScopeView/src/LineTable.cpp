@@ -0,0 +1,67 @@
+//===-- LibScopeView/LineTable.cpp ------------------------------*- C++ -*-===//
+///
+/// Copyright (c) Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Implementation for the LineTable class.
+///
+//===----------------------------------------------------------------------===//
+
+#include "LineTable.h"
+
+#include <assert.h>
+#include <limits>
+
+using namespace LibScopeView;
+
+std::atomic<uint32_t> LineTable::RowsAllocated(0);
+
+void LineTable::addRow(Dwarf_Addr Address, uint64_t LineNumber,
+                       size_t FileNameIndex, Dwarf_Half Discriminator,
+                       uint8_t RowFlags) {
+  // Line numbers and string pool indexes are well below 2^32 in practice.
+  assert(LineNumber <= std::numeric_limits<uint32_t>::max());
+  assert(FileNameIndex <= std::numeric_limits<uint32_t>::max());
+  Addresses.push_back(Address);
+  LineNumbers.push_back(static_cast<uint32_t>(LineNumber));
+  FileNameIndexes.push_back(static_cast<uint32_t>(FileNameIndex));
+  Discriminators.push_back(Discriminator);
+  Flags.push_back(RowFlags);
+  ++RowsAllocated;
+}
+
+void LineTable::reserve(size_t Rows) {
+  Addresses.reserve(Rows);
+  LineNumbers.reserve(Rows);
+  FileNameIndexes.reserve(Rows);
+  Discriminators.reserve(Rows);
+  Flags.reserve(Rows);
+}
+
+size_t LineTable::getBytesReserved() const {
+  return Addresses.capacity() * sizeof(Dwarf_Addr) +
+         LineNumbers.capacity() * sizeof(uint32_t) +
+         FileNameIndexes.capacity() * sizeof(uint32_t) +
+         Discriminators.capacity() * sizeof(Dwarf_Half) +
+         Flags.capacity() * sizeof(uint8_t);
+}
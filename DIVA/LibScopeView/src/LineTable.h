@@ -0,0 +1,109 @@
+//===-- LibScopeView/LineTable.h --------------------------------*- C++ -*-===//
+///
+/// Copyright (c) Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Definition of the LineTable class.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LINETABLE_H
+#define LINETABLE_H
+
+#include "Object.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace LibScopeView {
+
+/// \brief Flags describing a row of a LineTable.
+enum LineTableFlag : uint8_t {
+  lf_new_statement = 1U << 0,
+  lf_basic_block = 1U << 1,
+  lf_end_sequence = 1U << 2,
+  lf_epilogue_begin = 1U << 3,
+  lf_prologue_end = 1U << 4,
+  lf_has_discriminator = 1U << 5,
+  lf_invalid_filename = 1U << 6
+};
+
+/// \brief The line records of a compile unit, stored by column.
+///
+/// A row holds only the values that differ between line records: the address,
+/// line number, filename index, discriminator and flags. Everything else a
+/// Line has (level, parent, kind) is the same for every row, so printers and
+/// filters read a row through a Line created on the stack to view it.
+class LineTable {
+public:
+  LineTable() {}
+
+  LineTable(const LineTable &) = delete;
+  LineTable &operator=(const LineTable &) = delete;
+  LineTable(LineTable &&) = default;
+  LineTable &operator=(LineTable &&) = default;
+
+  /// \brief Add a row to the end of the table.
+  void addRow(Dwarf_Addr Address, uint64_t LineNumber, size_t FileNameIndex,
+              Dwarf_Half Discriminator, uint8_t Flags);
+
+  /// \brief Reserve memory for a number of rows.
+  void reserve(size_t Rows);
+
+  /// \brief The number of rows.
+  size_t size() const { return Addresses.size(); }
+  bool empty() const { return Addresses.empty(); }
+
+  /// \brief The values of a row.
+  Dwarf_Addr getAddress(size_t Row) const { return Addresses[Row]; }
+  uint64_t getLineNumber(size_t Row) const { return LineNumbers[Row]; }
+  size_t getFileNameIndex(size_t Row) const { return FileNameIndexes[Row]; }
+  Dwarf_Half getDiscriminator(size_t Row) const {
+    return Discriminators[Row];
+  }
+  uint8_t getFlags(size_t Row) const { return Flags[Row]; }
+  bool getFlag(size_t Row, LineTableFlag Flag) const {
+    return (Flags[Row] & Flag) != 0;
+  }
+
+  /// \brief The number of bytes reserved for the rows.
+  size_t getBytesReserved() const;
+
+private:
+  std::vector<Dwarf_Addr> Addresses;
+  std::vector<uint32_t> LineNumbers;
+  std::vector<uint32_t> FileNameIndexes;
+  std::vector<Dwarf_Half> Discriminators;
+  std::vector<uint8_t> Flags;
+
+private:
+  static std::atomic<uint32_t> RowsAllocated;
+
+public:
+  static uint32_t getInstanceCount() { return RowsAllocated; }
+};
+
+} // namespace LibScopeView
+
+#endif // LINETABLE_H
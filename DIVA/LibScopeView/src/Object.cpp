@@ -29,6 +29,7 @@
 
 #include "FileUtilities.h"
 #include "Line.h"
+#include "LineTable.h"
 #include "PrintContext.h"
 #include "Reader.h"
 #include "StringPool.h"
@@ -48,8 +49,9 @@
 #pragma clang diagnostic pop
 #endif
 
+#include <algorithm>
 #include <assert.h>
-#include <sstream>
+#include <cstring>
 
 using namespace LibScopeView;
 
@@ -69,6 +71,18 @@ void LibScopeView::printAllocationInfo() {
                             "Symbols: ", Symbol::getInstanceCount());
   GlobalPrintContext->print("%s %6d\n", "Types:   ", Type::getInstanceCount());
   GlobalPrintContext->print("%s %6d\n", "Lines:   ", Line::getInstanceCount());
+  GlobalPrintContext->print("%s %6d\n",
+                            "LineRows:", LineTable::getInstanceCount());
+}
+
+UncountedObjects::UncountedObjects()
+    : Scopes(Scope::ScopesAllocated), Symbols(Symbol::SymbolsAllocated),
+      Types(Type::TypesAllocated) {}
+
+UncountedObjects::~UncountedObjects() {
+  Scope::ScopesAllocated = Scopes;
+  Symbol::SymbolsAllocated = Symbols;
+  Type::TypesAllocated = Types;
 }
 
 //===----------------------------------------------------------------------===//
@@ -92,6 +106,7 @@ void Object::commonConstructor() {
   Level = 0;
   DieOffset = 0;
   DieTag = 0;
+  Kind = ok_unknown;
 
 #ifndef NDEBUG
   Tag = 0;
@@ -104,6 +119,22 @@ void Object::setTag() {
 #endif
 }
 
+const char *LibScopeView::getAccessSpecifierName(AccessSpecifier Access,
+                                                 const Scope *Parent) {
+  switch (Access) {
+  case AccessSpecifier::Private:
+    return "private";
+  case AccessSpecifier::Protected:
+    return "protected";
+  case AccessSpecifier::Public:
+    return "public";
+  case AccessSpecifier::Unspecified:
+    break;
+  }
+  assert(Parent);
+  return Parent && Parent->getIsClassType() ? "private" : "public";
+}
+
 uint32_t Object::getTag() const {
 #ifndef NDEBUG
   return Tag;
@@ -114,33 +145,25 @@ uint32_t Object::getTag() const {
 
 namespace {
 
-const char *OffsetAsString(Dwarf_Off Offset) {
+void appendOffset(TextBuffer &Text, Dwarf_Off Offset) {
   // [0x00000000]
-  const unsigned MaxLineSize = 16;
-  static char Buffer[MaxLineSize];
-  int Res = snprintf(Buffer, MaxLineSize, "[0x%08" DW_PR_DUx "]", Offset);
-  assert((Res >= 0) && (static_cast<unsigned>(Res) < MaxLineSize) &&
-         "string overflow");
-  (void)Res;
-  return Buffer;
+  Text.append("[0x");
+  Text.appendHex(Offset, 8);
+  Text.append(']');
 }
 
 } // namespace
 
-const char *Object::getDieOffsetAsString() const {
-  const char *Str = "";
-  if (getReader()->getOptions().getAttributeOffset()) {
-    Str = OffsetAsString(getDieOffset());
+void Object::appendDieOffset(TextBuffer &Text) const {
+  if (getPrintContext()->getLayout().getOptions().getAttributeOffset()) {
+    appendOffset(Text, getDieOffset());
   }
-  return Str;
 }
 
-const char *Object::getTypeDieOffsetAsString() const {
-  const char *Str = "";
-  if (getReader()->getOptions().getAttributeOffset()) {
-    Str = OffsetAsString(getType() ? getType()->getDieOffset() : 0);
+void Object::appendTypeDieOffset(TextBuffer &Text) const {
+  if (getPrintContext()->getLayout().getOptions().getAttributeOffset()) {
+    appendOffset(Text, getType() ? getType()->getDieOffset() : 0);
   }
-  return Str;
 }
 
 Dwarf_Off Object::getDieParent() const {
@@ -153,7 +176,7 @@ const char *Object::getDiscriminatorAsString() const {
   const char *Str = "";
   if (Discriminator && getReader()->getOptions().getFormatDiscriminators()) {
     const unsigned MaxLineSize = 16;
-    static char Buffer[MaxLineSize];
+    thread_local char Buffer[MaxLineSize];
     int Res = snprintf(Buffer, MaxLineSize, ":%d", Discriminator);
     assert((Res >= 0) && (static_cast<unsigned>(Res) < MaxLineSize) &&
            "string overflow");
@@ -171,7 +194,7 @@ const char *Object::getNoLineString() const {
 const char *Object::getLineAsString(uint64_t LnNumber,
                                     Dwarf_Half Discriminator) const {
   const unsigned MaxLineSize = 16;
-  static char Buffer[MaxLineSize];
+  thread_local char Buffer[MaxLineSize];
   const char *Str = Buffer;
   if (LnNumber) {
     int Res;
@@ -199,7 +222,7 @@ const char *Object::getReferenceAsString(uint64_t LnNumber, bool Spaces) const {
   const char *Str = "";
   if (LnNumber) {
     const unsigned MaxLineSize = 16;
-    static char Buffer[MaxLineSize];
+    thread_local char Buffer[MaxLineSize];
     int Res = snprintf(Buffer, MaxLineSize, "@%s%s",
                        std::to_string(LnNumber).c_str(), Spaces ? " " : "");
     assert((Res >= 0) && (static_cast<unsigned>(Res) < MaxLineSize) &&
@@ -241,12 +264,17 @@ void Object::resolveQualifiedName(const Scope *ExplicitParent) {
 }
 
 std::string Object::getIndentString() const {
+  TextBuffer Text;
+  appendIndent(Text);
+  return Text.str();
+}
+
+void Object::appendIndent(TextBuffer &Text) const {
   // No indent for root.
   if (getLevel() == 0 && getIsScope() && getParent() == nullptr)
-    return "";
-  return getReader()->getOptions().getFormatIndentation()
-             ? std::string((getLevel() + 1) * 2, ' ')
-             : "";
+    return;
+  if (getReader()->getOptions().getFormatIndentation())
+    Text.append(static_cast<size_t>(getLevel() + 1) * 2, ' ');
 }
 
 bool Object::referenceMatch(const Object *Obj) const {
@@ -412,167 +440,155 @@ bool Object::setFullName(Type *BaseType, Scope *BaseScope, Scope *SpecScope,
 
 namespace {
 
-std::string getTagString(const Dwarf_Half DWTag, const bool IsLine) {
-  if (IsLine)
-    return "[DW_AT_stml_list]";
+void appendTagString(TextBuffer &Text, const Dwarf_Half DWTag,
+                     const bool IsLine) {
+  if (IsLine) {
+    Text.append("[DW_AT_stml_list]");
+    return;
+  }
 
   if (DWTag) {
     const char *tag_name;
-    if (dwarf_get_TAG_name(DWTag, &tag_name) == DW_DLV_OK)
-      return std::string("[") + std::string(tag_name) + std::string("]");
+    if (dwarf_get_TAG_name(DWTag, &tag_name) == DW_DLV_OK) {
+      Text.append('[');
+      Text.append(tag_name);
+      Text.append(']');
+      return;
+    }
   }
-  return "[DW_TAG_file]";
+  Text.append("[DW_TAG_file]");
 }
 
-} // namespace
+// The width of a DWARF tag in the attributes, as "%-42s" gives.
+const size_t TagFieldWidth = 42;
 
-// Number of characters written by PrintAttributes.
-size_t Object::IndentationSize = 0;
+} // namespace
 
 std::string Object::getAttributesAsText() {
-  static bool CalculateIndentation = true;
-  // Record the required space for the offsets (object and parent) and
-  // DWARF tag. These fields are not required for the {InputFile} object.
-  static size_t OffsetWidth = 0;
-  static size_t ParentWidth = 0;
-  static size_t TagWidth = 0;
+  TextBuffer Text;
+  appendAttributes(Text);
+  return Text.str();
+}
+
+void Object::appendAttributes(TextBuffer &Text) {
+  AttributeLayout &Layout = getPrintContext()->getLayout();
+  const CmdOptions &Options = Layout.getOptions();
 
   // Calculate the indentation size, so we can use that value when printing
   // additional attributes to DIVA objects. This value is calculated just for
-  // the first object.
-  if (CalculateIndentation) {
-    CalculateIndentation = false;
-    if (getReader()->getOptions().getAttributeOffset()) {
-      OffsetWidth = static_cast<size_t>(
-          snprintf(nullptr, 0, "[0x%08" DW_PR_DUx "]", getDieOffset()));
+  // the first object. The widths of the offsets (object and parent) and DWARF
+  // tag are recorded too, as these fields are left blank for the {InputFile}
+  // object.
+  if (!Layout.getCalculated()) {
+    size_t OffsetWidth = 0;
+    size_t ParentWidth = 0;
+    size_t TagWidth = 0;
+    size_t IndentationSize = 0;
+    TextBuffer Field;
+    if (Options.getAttributeOffset()) {
+      appendOffset(Field, getDieOffset());
+      OffsetWidth = Field.size();
       IndentationSize += OffsetWidth;
     }
-    if (getReader()->getOptions().getAttributeParent()) {
-      ParentWidth = static_cast<size_t>(
-          snprintf(nullptr, 0, "[0x%08" DW_PR_DUx "]", getDieParent()));
+    if (Options.getAttributeParent()) {
+      Field.clear();
+      appendOffset(Field, getDieParent());
+      ParentWidth = Field.size();
       IndentationSize += ParentWidth;
     }
-    if (getReader()->getOptions().getAttributeType()) {
-      IndentationSize +=
-          static_cast<size_t>(snprintf(nullptr, 0, "[%s]", getObjectType()));
+    if (Options.getAttributeType()) {
+      IndentationSize += strlen(getObjectType()) + 2;
     }
-    if (getReader()->getOptions().getAttributeLevel()) {
-      IndentationSize +=
-          static_cast<size_t>(snprintf(nullptr, 0, "%03d", getLevel()));
+    if (Options.getAttributeLevel()) {
+      Field.clear();
+      Field.appendDecimal(getLevel());
+      IndentationSize += std::max<size_t>(Field.size(), 3);
     }
-    if (getReader()->getOptions().getAttributeGlobal()) {
-      IndentationSize += static_cast<size_t>(
-          snprintf(nullptr, 0U, "%c", getIsGlobalReference() ? 'X' : ' '));
+    if (Options.getAttributeGlobal()) {
+      IndentationSize += 1;
     }
-    if (getReader()->getOptions().getAttributeTag()) {
-      std::string tag_str = getTagString(getDieTag(), getIsLine());
-      TagWidth =
-          static_cast<size_t>(snprintf(nullptr, 0U, "%-42s", tag_str.c_str()));
+    if (Options.getAttributeTag()) {
+      Field.clear();
+      appendTagString(Field, getDieTag(), getIsLine());
+      TagWidth = std::max(Field.size(), TagFieldWidth);
       IndentationSize += TagWidth;
     }
+    Layout.setWidths(OffsetWidth, ParentWidth, TagWidth, IndentationSize);
   }
 
-  // The values for the attributes are well defined (DIE offsets, scope level
-  // and 'global' bits, etc. A buffer size of 64 is more than adequate to hold
-  // the largest value (DWARF tag).
-  const unsigned MaxSize = 64;
-  int Res;
-  static char Literal[MaxSize];
-  Literal[0] = 0;
-
-  std::string Attributes;
-
   // Do not print the DIE offset, Level or DWARF TAG for a {InputFile} object.
   bool IsInputFileObject = (getIsScope() && !getParent());
-  if (getReader()->getOptions().getAttributeOffset()) {
-    if (IsInputFileObject) {
-      Res = std::snprintf(Literal, MaxSize, "%s",
-                          std::string(OffsetWidth, ' ').c_str());
-    } else {
-      Res = std::snprintf(Literal, MaxSize, "[0x%08" DW_PR_DUx "]",
-                          getDieOffset());
-    }
-    assert((Res >= 0) && (static_cast<unsigned>(Res) < MaxSize) &&
-           "string overflow");
-    Attributes += std::string(Literal);
+  if (Options.getAttributeOffset()) {
+    if (IsInputFileObject)
+      Text.append(Layout.getOffsetWidth(), ' ');
+    else
+      appendOffset(Text, getDieOffset());
   }
-  if (getReader()->getOptions().getAttributeParent()) {
-    if (IsInputFileObject) {
-      Res = std::snprintf(Literal, MaxSize, "%s",
-                          std::string(ParentWidth, ' ').c_str());
-    } else {
-      Res = std::snprintf(Literal, MaxSize, "[0x%08" DW_PR_DUx "]",
-                          getDieParent());
-    }
-    assert((Res >= 0) && (static_cast<unsigned>(Res) < MaxSize) &&
-           "string overflow");
-    Attributes += std::string(Literal);
+  if (Options.getAttributeParent()) {
+    if (IsInputFileObject)
+      Text.append(Layout.getParentWidth(), ' ');
+    else
+      appendOffset(Text, getDieParent());
   }
-  if (getReader()->getOptions().getAttributeType()) {
-    Res = std::snprintf(Literal, MaxSize, "[%s]", getObjectType());
-    assert((Res >= 0) && (static_cast<unsigned>(Res) < MaxSize) &&
-           "string overflow");
-    Attributes += std::string(Literal);
+  if (Options.getAttributeType()) {
+    Text.append('[');
+    Text.append(getObjectType());
+    Text.append(']');
   }
-  if (getReader()->getOptions().getAttributeLevel()) {
+  if (Options.getAttributeLevel()) {
     if (IsInputFileObject) {
-      Res = std::snprintf(Literal, MaxSize, "   ");
+      Text.append("   ");
     } else {
-      Res = std::snprintf(Literal, MaxSize, "%03d", getLevel());
+      // The level has at least 3 digits.
+      LevelType Level = getLevel();
+      if (Level < 100)
+        Text.append(Level < 10 ? "00" : "0");
+      Text.appendDecimal(Level);
     }
-    assert((Res >= 0) && (static_cast<unsigned>(Res) < MaxSize) &&
-           "string overflow");
-    Attributes += std::string(Literal);
   }
-  if (getReader()->getOptions().getAttributeGlobal()) {
-    Res = std::snprintf(Literal, MaxSize, "%c",
-                        getIsGlobalReference() ? 'X' : ' ');
-    assert((Res >= 0) && (static_cast<unsigned>(Res) < MaxSize) &&
-           "string overflow");
-    Attributes += std::string(Literal);
+  if (Options.getAttributeGlobal()) {
+    Text.append(getIsGlobalReference() ? 'X' : ' ');
   }
-  if (getReader()->getOptions().getAttributeTag()) {
+  if (Options.getAttributeTag()) {
     if (IsInputFileObject) {
-      Res = std::snprintf(Literal, MaxSize, "%s",
-                          std::string(TagWidth, ' ').c_str());
+      Text.append(Layout.getTagWidth(), ' ');
     } else {
-      std::string tag_str = getTagString(getDieTag(), getIsLine());
-      Res = std::snprintf(Literal, MaxSize, "%-42s", tag_str.c_str());
+      size_t Start = Text.size();
+      appendTagString(Text, getDieTag(), getIsLine());
+      size_t Length = Text.size() - Start;
+      if (Length < TagFieldWidth)
+        Text.append(TagFieldWidth - Length, ' ');
     }
-    assert((Res >= 0) && (static_cast<unsigned>(Res) < MaxSize) &&
-           "string overflow");
-    Attributes += std::string(Literal);
   }
-  (void)Res;
-
-  return Attributes;
 }
 
 void Object::printAttributes() {
-  GlobalPrintContext->print("%s", getAttributesAsText().c_str());
+  appendAttributes(getPrintContext()->getBuffer());
+  getPrintContext()->flushIfFull();
 }
 
-// Record the last seen filename index. It is reset after the object that
-// represents the Compile Unit is printed.
-size_t Object::LastFilenameIndex = 0;
+void Object::resetFileIndex() { getPrintContext()->setLastFileIndex(0); }
 
 void Object::printFileIndex() {
-  // Check if there is a change in the File ID sequence.
+  // Check if there is a change in the File ID sequence. The last seen
+  // filename index is reset after the object that represents the Compile Unit
+  // is printed.
+  PrintContext *Context = getPrintContext();
   size_t FNameIndex = getFileNameIndex();
-  if (getInvalidFileName() || FNameIndex != LastFilenameIndex) {
-    LastFilenameIndex = FNameIndex;
+  if (getInvalidFileName() || FNameIndex != Context->getLastFileIndex()) {
+    Context->setLastFileIndex(FNameIndex);
 
     // Keep a nice layout.
-    GlobalPrintContext->print("\n");
-    std::string Indent(IndentationSize, ' ');
-    GlobalPrintContext->print(Indent.c_str());
+    getPrintContext()->print("\n");
+    Context->getBuffer().append(Context->getLayout().getIndentationSize(),
+                                ' ');
 
     const char *Source = "  {Source}";
     if (getInvalidFileName()) {
-      GlobalPrintContext->print("%s [0x%08x]\n", Source, FNameIndex);
+      getPrintContext()->print("%s [0x%08x]\n", Source, FNameIndex);
     } else {
       std::string FName = getFileName(/*format_options=*/true);
-      GlobalPrintContext->print("%s \"%s\"\n", Source, FName.c_str());
+      getPrintContext()->print("%s \"%s\"\n", Source, FName.c_str());
     }
   }
 }
@@ -588,98 +604,121 @@ void Object::dump() {
   printAttributes();
 
   // Print the line and any discriminator.
-  GlobalPrintContext->print(" %5s %s ", getLineNumberAsString(),
-                            getIndentString().c_str());
+  TextBuffer &Text = getPrintContext()->getBuffer();
+  Text.append(' ');
+  Text.appendRight(getLineNumberAsString(), 5);
+  Text.append(' ');
+  appendIndent(Text);
+  Text.append(' ');
+  getPrintContext()->flushIfFull();
 }
 
-void Object::print(bool /*SplitCU*/, bool /*Match*/, bool /*IsNull*/) {
-  dump();
+std::string Object::getAsText() const {
+  TextBuffer Text;
+  appendText(Text);
+  return Text.str();
 }
 
-std::string Object::getAsText() const { return ""; }
-
-std::string Object::getAsYAML() const { return ""; }
+std::string Object::getAsYAML() const {
+  TextBuffer YAML;
+  appendYAML(YAML);
+  return YAML.str();
+}
 
-std::string
-Object::getAttributeInfoAsText(const std::string &AttributeText) const {
+void Object::appendAttributeInfo(TextBuffer &Text,
+                                 const char *AttributeText) const {
   // First we want to indent for any left aligned info being printed
   // (indentation_size). An extra space is printed before the line number, after
   // the line number and after the level indent so we need to indent an extra 3
   // for those. Then we want to indent the space where the line number would be.
   // Then We want to indent the attribute info 4 columns to the right of the
   // object.
-  static const std::string ConstantIndent(
-      std::string(IndentationSize, ' ') + std::string(3, ' ') +
-      getNoLineString() + std::string(4, ' '));
+  Text.append('\n');
+  Text.append(getPrintContext()->getLayout().getIndentationSize() + 3, ' ');
+  Text.append(getNoLineString());
+  Text.append(4, ' ');
 
   // Then we want to indent based on the object level and add the dash.
-  return ConstantIndent + getIndentString() + "- " + AttributeText;
+  appendIndent(Text);
+  Text.append("- ");
+  Text.append(AttributeText);
 }
 
 std::string Object::getCommonYAML() const {
-  std::stringstream YAML;
+  TextBuffer YAML;
+  appendCommonYAML(YAML);
+  return YAML.str();
+}
 
+void Object::appendCommonYAML(TextBuffer &YAML) const {
   // Kind.
-  YAML << "object: \"" << getKindAsString() << "\"\n";
+  YAML.append("object: \"");
+  YAML.append(getKindAsString());
+  YAML.append("\"\n");
 
   // Name.
-  std::string Name;
-  if (getHasQualifiedName())
-    Name += getQualifiedName();
+  const char *QualifiedName = getHasQualifiedName() ? getQualifiedName() : "";
+  const char *Name = getName();
   if (getIsSymbol() &&
       static_cast<const Symbol *>(this)->getIsUnspecifiedParameter())
-    Name += "...";
-  else
-    Name += getName();
-
-  YAML << "name: ";
-  if (!Name.empty())
-    YAML << "\"" << Name << "\"\n";
-  else
-    YAML << "null\n";
+    Name = "...";
+
+  YAML.append("name: ");
+  if (*QualifiedName || *Name) {
+    YAML.append('"');
+    YAML.append(QualifiedName);
+    YAML.append(Name);
+    YAML.append("\"\n");
+  } else
+    YAML.append("null\n");
 
   // Type.
-  YAML << "type: ";
+  YAML.append("type: ");
   if (getType() &&
       // Template's types are printed in attributes.
       !(getIsType() && static_cast<const Type *>(this)->getIsTemplateParam())) {
-    std::string TypeName;
+    YAML.append('"');
     if (getType()->getHasQualifiedName())
-      TypeName += getType()->getQualifiedName();
-    TypeName += getType()->getName();
-    YAML << "\"" << TypeName << "\"\n";
+      YAML.append(getType()->getQualifiedName());
+    YAML.append(getType()->getName());
+    YAML.append("\"\n");
     // Functions must have types.
   } else if (getIsScope() && static_cast<const Scope *>(this)->getIsFunction())
-    YAML << "\"void\"\n";
+    YAML.append("\"void\"\n");
   else
-    YAML << "null\n";
+    YAML.append("null\n");
 
   // Source.
-  YAML << "source:\n  line: ";
-  if (getLineNumber() != 0)
-    YAML << getLineNumber() << '\n';
-  else
-    YAML << "null\n";
+  YAML.append("source:\n  line: ");
+  if (getLineNumber() != 0) {
+    YAML.appendDecimal(getLineNumber());
+    YAML.append('\n');
+  } else
+    YAML.append("null\n");
 
   std::string FileName(getFileName(/*format_options*/ true));
-  YAML << "  file: ";
+  YAML.append("  file: ");
   if (getInvalidFileName())
-    YAML << "\"?\"\n";
-  else if (!FileName.empty())
-    YAML << "\"" << FileName << "\"\n";
-  else
-    YAML << "null\n";
+    YAML.append("\"?\"\n");
+  else if (!FileName.empty()) {
+    YAML.append('"');
+    YAML.append(FileName);
+    YAML.append("\"\n");
+  } else
+    YAML.append("null\n");
 
   // Dwarf.
-  YAML << "dwarf:\n  offset: 0x" << std::hex << getDieOffset() << "\n  tag: ";
+  YAML.append("dwarf:\n  offset: 0x");
+  YAML.appendHex(getDieOffset());
+  YAML.append("\n  tag: ");
   if (getDieTag() != 0) {
     const char *TagName;
     dwarf_get_TAG_name(getDieTag(), &TagName);
-    YAML << "\"" << TagName << "\"";
+    YAML.append('"');
+    YAML.append(TagName);
+    YAML.append('"');
   } else
-    YAML << "null";
-
-  return YAML.str();
+    YAML.append("null");
 }
 
 //===----------------------------------------------------------------------===//
@@ -711,7 +750,12 @@ const char *Element::getName() const {
   return StringPool::getStringValue(NameIndex);
 }
 
-void Element::setNameIndex(size_t name_index) { NameIndex = name_index; }
+void Element::setNameIndex(size_t name_index) {
+  NameIndex = name_index;
+#ifndef NDEBUG
+  Name = StringPool::getStringValue(name_index);
+#endif
+}
 
 size_t Element::getNameIndex() const { return NameIndex; }
 
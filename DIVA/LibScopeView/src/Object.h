@@ -43,8 +43,13 @@
 #pragma clang diagnostic pop
 #endif
 
+#include "TextBuffer.h"
+
+#include <atomic>
 #include <bitset>
+#include <cassert>
 #include <cstdint>
+#include <string>
 
 namespace LibScopeView {
 
@@ -54,6 +59,26 @@ class Type;
 
 void printAllocationInfo();
 
+/// \brief Keeps the Scopes, Symbols and Types created while it exists out of
+/// the allocated object counts.
+///
+/// It is for objects that are not read from the input, such as those a reader
+/// creates to ask the view about a kind of object. No other objects should be
+/// created meanwhile.
+class UncountedObjects {
+public:
+  UncountedObjects();
+  ~UncountedObjects();
+
+  UncountedObjects(const UncountedObjects &) = delete;
+  UncountedObjects &operator=(const UncountedObjects &) = delete;
+
+private:
+  uint32_t Scopes;
+  uint32_t Symbols;
+  uint32_t Types;
+};
+
 typedef uint16_t LevelType;
 
 /// \brief Get/set attribute functions.
@@ -63,6 +88,37 @@ typedef bool (Object::*ObjGetFunction)() const;
 /// \brief Enum to represent C++ access specifiers.
 enum class AccessSpecifier { Unspecified, Private, Protected, Public };
 
+/// \brief Get the name of an access specifier. An unspecified access is
+/// private in a class and public anywhere else.
+const char *getAccessSpecifierName(AccessSpecifier Access,
+                                   const Scope *Parent);
+
+/// \brief The concrete class of an Object, set by its constructor. The kinds
+/// derived from Type and Scope are kept contiguous so that classof() can test
+/// a range.
+enum ObjectKind : uint8_t {
+  ok_unknown, // An Object outside the hierarchy below (tests only).
+  ok_line,
+  ok_symbol,
+  ok_type,
+  ok_type_definition,
+  ok_type_enumerator,
+  ok_type_import,
+  ok_type_param,
+  ok_type_subrange,
+  ok_scope,
+  ok_scope_aggregate,
+  ok_scope_alias,
+  ok_scope_array,
+  ok_scope_compile_unit,
+  ok_scope_enumeration,
+  ok_scope_function,
+  ok_scope_function_inlined,
+  ok_scope_namespace,
+  ok_scope_template_pack,
+  ok_scope_root
+};
+
 /// \brief Class to represent the basic information for a DIVA object.
 class Object {
 public:
@@ -91,12 +147,22 @@ private:
     HasReference,
     HasQualifiedName,
     HasPattern,
+    IsArenaAllocated,
     ObjectAttributesSize
   };
   // Flags specifying various properties of the Object.
   std::bitset<ObjectAttributesSize> ObjectAttributesFlags;
 
+  // The concrete class of the Object.
+  ObjectKind Kind;
+
+protected:
+  void setKind(ObjectKind K) { Kind = K; }
+
 public:
+  /// \brief The concrete class of the Object, for dyn_cast and cast.
+  ObjectKind getKind() const { return Kind; }
+
   /// \brief Get the object's type as a string.
   virtual const char *getObjectType() const = 0;
 
@@ -143,6 +209,7 @@ public:
     return ObjectAttributesFlags[InvalidFilename];
   }
   void setInvalidFileName() { ObjectAttributesFlags.set(InvalidFilename); }
+  void resetInvalidFileName() { ObjectAttributesFlags.reset(InvalidFilename); }
 
   /// \brief The Object has a reference to another object.
   ///
@@ -160,14 +227,15 @@ public:
   bool getHasPattern() const { return ObjectAttributesFlags[HasPattern]; }
   void setHasPattern() { ObjectAttributesFlags.set(HasPattern); }
 
-private:
-  // Track source file changes while printing.
-  static size_t LastFilenameIndex;
-  // Filler gap for the attributes.
-  static size_t IndentationSize;
+  /// \brief The Object is owned by an ObjectArena.
+  bool getIsArenaAllocated() const {
+    return ObjectAttributesFlags[IsArenaAllocated];
+  }
+  void setIsArenaAllocated() { ObjectAttributesFlags.set(IsArenaAllocated); }
 
 protected:
-  static void resetFileIndex() { LastFilenameIndex = 0; }
+  // Track source file changes while printing, from the start of a CU.
+  static void resetFileIndex();
 
   // Scope level for this object.
   LevelType Level;
@@ -267,6 +335,7 @@ public:
   LevelType getLevel() const { return Level; }
   void setLevel(LevelType Lvl) { Level = Lvl; }
   std::string getIndentString() const;
+  void appendIndent(TextBuffer &Text) const;
 
   bool referenceMatch(const Object *Obj) const;
 
@@ -280,8 +349,8 @@ public:
   virtual const char *getDiscriminatorAsString() const;
 
   // Get some attributes as string.
-  const char *getDieOffsetAsString() const;
-  const char *getTypeDieOffsetAsString() const;
+  void appendDieOffset(TextBuffer &Text) const;
+  void appendTypeDieOffset(TextBuffer &Text) const;
   const char *getTypeAsString() const;
 
   /// \brief String to be used for objects with no line number.
@@ -313,26 +382,29 @@ public:
 
   /// \brief Get the attributes associated with the object as string.
   std::string getAttributesAsText();
-
-public:
-  static size_t getIndentationSize() { return IndentationSize; }
+  void appendAttributes(TextBuffer &Text);
 
 public:
   virtual void dump();
-  virtual void print(bool SplitCU, bool Match, bool IsNull);
   virtual uint32_t getTag() const;
   virtual void setTag();
 
   /// \brief Should this object be printed under children?
   virtual bool getIsPrintedAsObject() const { return true; }
+  /// \brief Appends a text representation of this DIVA Object.
+  virtual void appendText(TextBuffer &Text) const = 0;
+  /// \brief Appends a YAML representation of this DIVA Object.
+  virtual void appendYAML(TextBuffer &YAML) const = 0;
   /// \brief Returns a text representation of this DIVA Object.
-  virtual std::string getAsText() const = 0;
+  std::string getAsText() const;
   /// \brief Returns a YAML representation of this DIVA Object.
-  virtual std::string getAsYAML() const = 0;
+  std::string getAsYAML() const;
 
 protected:
-  /// \brief Returns a text representation of attribute information.
-  std::string getAttributeInfoAsText(const std::string &AttributeText) const;
+  /// \brief Appends a new line with a piece of attribute information.
+  void appendAttributeInfo(TextBuffer &Text, const char *AttributeText) const;
+  /// \brief Appends the common YAML information for this object.
+  void appendCommonYAML(TextBuffer &YAML) const;
   /// \brief Returns the common YAML information for this object.
   std::string getCommonYAML() const;
 
@@ -352,6 +424,10 @@ public:
   Element &operator=(const Element &) = delete;
   Element(const Element &) = delete;
 
+  static bool classof(const Object *Obj) {
+    return Obj->getKind() != ok_unknown;
+  }
+
 private:
   void CommonConstructor();
 
@@ -415,6 +491,22 @@ public:
   Object *getType() const override { return TheType; }
 };
 
+/// \brief Return Obj as a ToTy if it is one (as given by ToTy::classof), or
+/// nullptr otherwise. A cheaper replacement for dynamic_cast within the
+/// Object hierarchy.
+template <typename ToTy> ToTy *dyn_cast(Object *Obj) {
+  return Obj && ToTy::classof(Obj) ? static_cast<ToTy *>(Obj) : nullptr;
+}
+template <typename ToTy> const ToTy *dyn_cast(const Object *Obj) {
+  return Obj && ToTy::classof(Obj) ? static_cast<const ToTy *>(Obj) : nullptr;
+}
+
+/// \brief Return Obj as a ToTy, which it must be.
+template <typename ToTy> ToTy &cast(Object &Obj) {
+  assert(ToTy::classof(&Obj) && "cast to the wrong Object kind");
+  return static_cast<ToTy &>(Obj);
+}
+
 } // namespace LibScopeView
 
 #endif // OBJECT_H
@@ -0,0 +1,113 @@
+//===-- ObjectArena.cpp -----------------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Implementation of the ObjectArena class.
+///
+//===----------------------------------------------------------------------===//
+
+#include "ObjectArena.h"
+#include "PrintContext.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+
+using namespace LibScopeView;
+
+namespace {
+
+// Large enough that the cost of a new block is spread over many objects.
+const size_t BlockSize = 64U * 1024U;
+
+} // namespace
+
+ObjectArena::ObjectArena()
+    : Next(nullptr), End(nullptr), BytesUsed(), BytesReserved(0U) {}
+
+void *ObjectArena::allocate(size_t Size, size_t Align, ArenaKind Kind) {
+  assert(Align <= alignof(std::max_align_t) && "Unsupported alignment");
+  auto Address = reinterpret_cast<uintptr_t>(Next);
+  size_t Padding = (Align - Address % Align) % Align;
+  if (!Next || Padding + Size > static_cast<size_t>(End - Next)) {
+    // Objects larger than a block get a block of their own.
+    size_t NewBlockSize = std::max(BlockSize, Size);
+    Blocks.emplace_back(new char[NewBlockSize]);
+    Next = Blocks.back().get();
+    End = Next + NewBlockSize;
+    BytesReserved += NewBlockSize;
+    Padding = 0U;
+  }
+  void *Result = Next + Padding;
+  Next += Padding + Size;
+  BytesUsed[Kind] += Size;
+  return Result;
+}
+
+void ObjectArena::merge(ObjectArena &Other) {
+  assert(this != &Other && "Merging an arena with itself");
+  // Keep allocating from this arena's current block.
+  std::move(Other.Blocks.begin(), Other.Blocks.end(),
+            std::back_inserter(Blocks));
+  Objects.insert(Objects.end(), Other.Objects.begin(), Other.Objects.end());
+  for (size_t Kind = 0; Kind < ak_count; ++Kind)
+    BytesUsed[Kind] += Other.BytesUsed[Kind];
+  BytesReserved += Other.BytesReserved;
+
+  Other.Blocks.clear();
+  Other.Objects.clear();
+  Other.Next = Other.End = nullptr;
+  std::fill(std::begin(Other.BytesUsed), std::end(Other.BytesUsed), 0U);
+  Other.BytesReserved = 0U;
+}
+
+void ObjectArena::clear() {
+  // Scopes in the arena don't destroy their children, so every object is
+  // destroyed exactly once here, in creation order.
+  for (Object *Obj : Objects)
+    Obj->~Object();
+  Objects.clear();
+  Blocks.clear();
+  Next = End = nullptr;
+  std::fill(std::begin(BytesUsed), std::end(BytesUsed), 0U);
+  BytesReserved = 0U;
+}
+
+void ObjectArena::printAllocationInfo(const std::string &Name) const {
+  GlobalPrintContext->print("\n** Arena Allocation: %s **\n", Name.c_str());
+  const char *Names[ak_count] = {"Scopes:  ", "Symbols: ", "Types:   ",
+                                 "Lines:   "};
+  size_t Total = 0U;
+  for (size_t Kind = 0; Kind < ak_count; ++Kind) {
+    GlobalPrintContext->print("%s %10llu bytes\n", Names[Kind],
+                              static_cast<unsigned long long>(BytesUsed[Kind]));
+    Total += BytesUsed[Kind];
+  }
+  GlobalPrintContext->print("%s %10llu bytes\n", "Used:    ",
+                            static_cast<unsigned long long>(Total));
+  GlobalPrintContext->print("%s %10llu bytes in %llu blocks\n", "Reserved:",
+                            static_cast<unsigned long long>(BytesReserved),
+                            static_cast<unsigned long long>(Blocks.size()));
+}
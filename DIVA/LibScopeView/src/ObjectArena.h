@@ -0,0 +1,128 @@
+//===-- ObjectArena.h -------------------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Definition of the ObjectArena class.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef OBJECTARENA_H_
+#define OBJECTARENA_H_
+
+#include "Line.h"
+#include "Scope.h"
+#include "Symbol.h"
+#include "Type.h"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace LibScopeView {
+
+/// \brief The kinds of Object that an ObjectArena records usage for.
+enum ArenaKind { ak_scope, ak_symbol, ak_type, ak_line, ak_count };
+
+/// \brief Bump allocator that owns the Objects of a scope tree.
+///
+/// Objects are placed one after the other in large blocks, and are all
+/// destroyed and released together by clear(), instead of each Scope deleting
+/// its children. The children of a Scope created in an arena must be created
+/// in the same arena.
+///
+/// An arena is not thread safe. Threads that create objects at the same time
+/// should each use their own arena, and then merge them into one.
+class ObjectArena {
+public:
+  ObjectArena();
+  ~ObjectArena() { clear(); }
+
+  ObjectArena(const ObjectArena &) = delete;
+  ObjectArena &operator=(const ObjectArena &) = delete;
+
+  /// \brief Create an Object in the arena.
+  template <typename ObjTy, typename... ArgTys>
+  ObjTy *create(ArgTys &&... Args) {
+    static_assert(std::is_base_of<Object, ObjTy>::value,
+                  "Only Objects can be created in an ObjectArena");
+    void *Memory = allocate(sizeof(ObjTy), alignof(ObjTy), getKind<ObjTy>());
+    ObjTy *Obj = new (Memory) ObjTy(std::forward<ArgTys>(Args)...);
+    Obj->setIsArenaAllocated();
+    Objects.push_back(Obj);
+    return Obj;
+  }
+
+  /// \brief Take all of the objects from another arena, which is left empty.
+  void merge(ObjectArena &Other);
+
+  /// \brief Destroy all the objects and release the memory.
+  void clear();
+
+  /// \brief The number of bytes used by objects of a kind.
+  size_t getBytesUsed(ArenaKind Kind) const { return BytesUsed[Kind]; }
+  /// \brief The number of bytes reserved in blocks.
+  size_t getBytesReserved() const { return BytesReserved; }
+  /// \brief The number of blocks.
+  size_t getBlockCount() const { return Blocks.size(); }
+  /// \brief The number of objects in the arena.
+  size_t getObjectCount() const { return Objects.size(); }
+
+  /// \brief Print the memory used by each kind of object, Name identifies the
+  /// arena in the output.
+  void printAllocationInfo(const std::string &Name) const;
+
+private:
+  template <typename ObjTy> static ArenaKind getKind() {
+    if (std::is_base_of<Scope, ObjTy>::value)
+      return ak_scope;
+    if (std::is_base_of<Symbol, ObjTy>::value)
+      return ak_symbol;
+    if (std::is_base_of<Type, ObjTy>::value)
+      return ak_type;
+    return ak_line;
+  }
+
+  // Get Size bytes of memory aligned to Align, starting a new block if the
+  // current one doesn't have space.
+  void *allocate(size_t Size, size_t Align, ArenaKind Kind);
+
+  std::vector<std::unique_ptr<char[]>> Blocks;
+  // The free space in the current block.
+  char *Next;
+  char *End;
+
+  // The objects in creation order, so they can be destroyed.
+  std::vector<Object *> Objects;
+
+  size_t BytesUsed[ak_count];
+  size_t BytesReserved;
+};
+
+} // namespace LibScopeView
+
+#endif // OBJECTARENA_H_
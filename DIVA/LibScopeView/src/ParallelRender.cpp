@@ -0,0 +1,141 @@
+//===-- LibScopeView/ParallelRender.cpp -------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Implementation of renderInOrder.
+///
+//===----------------------------------------------------------------------===//
+
+#include "ParallelRender.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace LibScopeView;
+
+void LibScopeView::renderInOrder(
+    size_t Count, unsigned Jobs,
+    const std::function<void(size_t, std::string &)> &Render,
+    const std::function<void(size_t, std::string &)> &Emit) {
+  if (Jobs <= 1 || Count <= 1) {
+    std::string Text;
+    for (size_t Index = 0; Index < Count; ++Index) {
+      Text.clear();
+      Render(Index, Text);
+      Emit(Index, Text);
+    }
+    return;
+  }
+
+  // There is no use for more threads than items.
+  Jobs = static_cast<unsigned>(std::min<size_t>(Jobs, Count));
+
+  // How many items can be rendered ahead of the one being emitted.
+  const size_t Window = size_t(Jobs) * 4;
+
+  struct Item {
+    std::string Text;
+    bool Rendered = false;
+  };
+  std::vector<Item> Items(Count);
+  size_t NextRender = 0;
+  size_t NextEmit = 0;
+  bool Stop = false;
+  std::exception_ptr Error;
+  std::mutex ItemsMutex;
+  // Signalled when an item is rendered, and when a thread stops on an error.
+  std::condition_variable ItemRendered;
+  // Signalled when an item is emitted, which lets the window move on.
+  std::condition_variable ItemEmitted;
+
+  auto stopOnError = [&]() {
+    std::lock_guard<std::mutex> Lock(ItemsMutex);
+    if (!Error)
+      Error = std::current_exception();
+    Stop = true;
+    ItemRendered.notify_all();
+    ItemEmitted.notify_all();
+  };
+
+  auto Worker = [&]() {
+    while (true) {
+      size_t Index;
+      {
+        std::unique_lock<std::mutex> Lock(ItemsMutex);
+        ItemEmitted.wait(Lock, [&]() {
+          return Stop || NextRender >= Count ||
+                 NextRender < NextEmit + Window;
+        });
+        if (Stop || NextRender >= Count)
+          return;
+        Index = NextRender++;
+      }
+      std::string Text;
+      try {
+        Render(Index, Text);
+      } catch (...) {
+        stopOnError();
+        return;
+      }
+      {
+        std::lock_guard<std::mutex> Lock(ItemsMutex);
+        Items[Index].Text.swap(Text);
+        Items[Index].Rendered = true;
+      }
+      ItemRendered.notify_one();
+    }
+  };
+
+  std::vector<std::thread> Workers;
+  for (unsigned WorkerIndex = 0; WorkerIndex < Jobs; ++WorkerIndex)
+    Workers.emplace_back(Worker);
+
+  try {
+    for (size_t Index = 0; Index < Count; ++Index) {
+      std::string Text;
+      {
+        std::unique_lock<std::mutex> Lock(ItemsMutex);
+        ItemRendered.wait(Lock,
+                          [&]() { return Stop || Items[Index].Rendered; });
+        if (Stop)
+          break;
+        Text.swap(Items[Index].Text);
+        NextEmit = Index + 1;
+      }
+      ItemEmitted.notify_all();
+      Emit(Index, Text);
+    }
+  } catch (...) {
+    stopOnError();
+  }
+
+  for (auto &Thread : Workers)
+    Thread.join();
+  if (Error)
+    std::rethrow_exception(Error);
+}
@@ -0,0 +1,53 @@
+//===-- LibScopeView/ParallelRender.h ---------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Rendering the output of independent parts of a tree on several threads.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SCOPEVIEW_PARALLELRENDER_H
+#define SCOPEVIEW_PARALLELRENDER_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace LibScopeView {
+
+/// \brief Renders the items 0 to Count - 1 on up to Jobs threads, and passes
+/// the text of each item to Emit on the calling thread, in order.
+///
+/// An item is emitted as soon as it and the items before it are rendered.
+/// Only a few items are rendered ahead of the one being emitted, so the text
+/// of the whole output is not held at once. If Render or Emit throws, the
+/// threads stop taking new items and the exception is rethrown once they have
+/// finished.
+void renderInOrder(size_t Count, unsigned Jobs,
+                   const std::function<void(size_t, std::string &)> &Render,
+                   const std::function<void(size_t, std::string &)> &Emit);
+
+} // end namespace LibScopeView
+
+#endif // SCOPEVIEW_PARALLELRENDER_H
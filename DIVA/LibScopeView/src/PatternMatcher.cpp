@@ -0,0 +1,922 @@
+//===-- PatternMatcher.cpp --------------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Implementation of the PatternMatcher class.
+///
+//===----------------------------------------------------------------------===//
+
+#include "PatternMatcher.h"
+#include "StringPool.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+using namespace LibScopeView;
+
+namespace {
+
+const uint32_t NoState = ~0U;
+
+// The most states a DFA and the NFA it is built from can have, and the most
+// NFA states visited while building it. The expressions that go beyond these
+// are split into several DFAs, and an expression that does on its own is left
+// to std::regex.
+const size_t MaxNfaStates = 16384;
+const size_t MaxDfaStates = 1024;
+const size_t MaxDfaWork = size_t(1) << 18;
+
+// The largest count of a {n,m} quantifier that is expanded.
+const unsigned MaxRepeat = 256;
+
+typedef std::bitset<256> CharSet;
+
+// Hash a string, and get its length.
+uint32_t hashString(const char *Str, size_t &Length) {
+  // FNV-1a.
+  uint32_t Hash = 2166136261U;
+  const char *Start = Str;
+  for (; *Str; ++Str)
+    Hash = (Hash ^ static_cast<unsigned char>(*Str)) * 16777619U;
+  Length = static_cast<size_t>(Str - Start);
+  return Hash;
+}
+
+CharSet getRange(unsigned Low, unsigned High) {
+  CharSet Chars;
+  for (unsigned Char = Low; Char <= High; ++Char)
+    Chars.set(Char);
+  return Chars;
+}
+
+// The classes of the ECMAScript grammar, in the "C" locale used by std::regex.
+CharSet getDigits() { return getRange('0', '9'); }
+
+CharSet getWordChars() {
+  CharSet Chars = getDigits() | getRange('a', 'z') | getRange('A', 'Z');
+  Chars.set('_');
+  return Chars;
+}
+
+CharSet getSpaces() { return getRange('\t', '\r') | getRange(' ', ' '); }
+
+// The characters matched by '.', which are all but the line terminators.
+CharSet getLineChars() {
+  CharSet Chars;
+  Chars.set();
+  Chars.reset('\n');
+  Chars.reset('\r');
+  return Chars;
+}
+
+// A node of a parsed regular expression.
+struct RegexNode {
+  enum NodeKind {
+    nk_chars,     // Any one of the characters.
+    nk_sequence,  // Each of the children in turn.
+    nk_alternate, // Any one of the children.
+    nk_repeat,    // The child from Min to Max times.
+    nk_begin,     // The ^ assertion.
+    nk_end        // The $ assertion.
+  };
+
+  explicit RegexNode(NodeKind Kind) : Kind(Kind) {}
+
+  NodeKind Kind;
+  CharSet Chars;
+  std::vector<std::unique_ptr<RegexNode>> Children;
+  unsigned Min = 0;
+  unsigned Max = 0;
+};
+
+typedef std::unique_ptr<RegexNode> RegexNodePtr;
+
+const unsigned Unbounded = ~0U;
+
+// Parses a regular expression in the ECMAScript grammar. The expressions
+// have already been accepted by std::regex, so the parser only has to fail
+// for the valid expressions that a DFA cannot express, or that it does not
+// know the meaning of.
+class RegexParser {
+public:
+  explicit RegexParser(const std::string &Pattern)
+      : Pos(Pattern.data()), End(Pattern.data() + Pattern.size()) {}
+
+  // Get the parsed expression, or nullptr if it is not supported.
+  RegexNodePtr parse() {
+    RegexNodePtr Node = parseAlternative();
+    return Pos == End ? std::move(Node) : nullptr;
+  }
+
+private:
+  RegexNodePtr parseAlternative();
+  RegexNodePtr parseSequence();
+  RegexNodePtr parseTerm();
+  RegexNodePtr parseAtom();
+  bool parseQuantifier(unsigned &Min, unsigned &Max);
+  bool parseClass(CharSet &Chars);
+  bool parseClassAtom(CharSet &Chars, int &Char);
+  bool parseEscape(CharSet &Chars, int &Char);
+  bool parseNumber(unsigned &Number);
+
+  static bool isQuantifier(char Char) {
+    return Char == '*' || Char == '+' || Char == '?' || Char == '{';
+  }
+
+  static RegexNodePtr makeChars(const CharSet &Chars) {
+    RegexNodePtr Node(new RegexNode(RegexNode::nk_chars));
+    Node->Chars = Chars;
+    return Node;
+  }
+
+  const char *Pos;
+  const char *End;
+};
+
+RegexNodePtr RegexParser::parseAlternative() {
+  RegexNodePtr Node(new RegexNode(RegexNode::nk_alternate));
+  for (;;) {
+    RegexNodePtr Sequence = parseSequence();
+    if (!Sequence)
+      return nullptr;
+    Node->Children.push_back(std::move(Sequence));
+    if (Pos == End || *Pos != '|')
+      return Node;
+    ++Pos;
+  }
+}
+
+RegexNodePtr RegexParser::parseSequence() {
+  RegexNodePtr Node(new RegexNode(RegexNode::nk_sequence));
+  while (Pos != End && *Pos != '|' && *Pos != ')') {
+    RegexNodePtr Term = parseTerm();
+    if (!Term)
+      return nullptr;
+    Node->Children.push_back(std::move(Term));
+  }
+  return Node;
+}
+
+RegexNodePtr RegexParser::parseTerm() {
+  if (*Pos == '^' || *Pos == '$') {
+    RegexNodePtr Node(
+        new RegexNode(*Pos == '^' ? RegexNode::nk_begin : RegexNode::nk_end));
+    ++Pos;
+    // Assertions cannot be quantified.
+    if (Pos != End && isQuantifier(*Pos))
+      return nullptr;
+    return Node;
+  }
+
+  RegexNodePtr Atom = parseAtom();
+  if (!Atom || Pos == End || !isQuantifier(*Pos))
+    return Atom;
+
+  RegexNodePtr Node(new RegexNode(RegexNode::nk_repeat));
+  if (!parseQuantifier(Node->Min, Node->Max))
+    return nullptr;
+  // A lazy quantifier matches the same strings.
+  if (Pos != End && *Pos == '?')
+    ++Pos;
+  if (Pos != End && isQuantifier(*Pos))
+    return nullptr;
+  Node->Children.push_back(std::move(Atom));
+  return Node;
+}
+
+bool RegexParser::parseQuantifier(unsigned &Min, unsigned &Max) {
+  switch (*Pos++) {
+  case '*':
+    Min = 0;
+    Max = Unbounded;
+    return true;
+  case '+':
+    Min = 1;
+    Max = Unbounded;
+    return true;
+  case '?':
+    Min = 0;
+    Max = 1;
+    return true;
+  default:
+    break;
+  }
+
+  // A {n}, {n,} or {n,m} quantifier.
+  if (!parseNumber(Min))
+    return false;
+  Max = Min;
+  if (Pos != End && *Pos == ',') {
+    ++Pos;
+    Max = Unbounded;
+    if (Pos != End && *Pos != '}' && !parseNumber(Max))
+      return false;
+  }
+  if (Pos == End || *Pos != '}')
+    return false;
+  ++Pos;
+  return Min <= MaxRepeat && Min <= Max &&
+         (Max == Unbounded || Max <= MaxRepeat);
+}
+
+bool RegexParser::parseNumber(unsigned &Number) {
+  if (Pos == End || !isdigit(static_cast<unsigned char>(*Pos)))
+    return false;
+  Number = 0;
+  while (Pos != End && isdigit(static_cast<unsigned char>(*Pos))) {
+    // Saturate, as the count is checked against MaxRepeat.
+    Number = std::min(Number * 10 + (*Pos - '0'), MaxRepeat + 1);
+    ++Pos;
+  }
+  return true;
+}
+
+RegexNodePtr RegexParser::parseAtom() {
+  char Char = *Pos++;
+  switch (Char) {
+  case '(':
+    if (Pos != End && *Pos == '?') {
+      // Only non-capturing groups; not the lookahead assertions.
+      if (End - Pos < 2 || Pos[1] != ':')
+        return nullptr;
+      Pos += 2;
+    }
+    {
+      RegexNodePtr Node = parseAlternative();
+      if (!Node || Pos == End || *Pos != ')')
+        return nullptr;
+      ++Pos;
+      return Node;
+    }
+  case '.':
+    return makeChars(getLineChars());
+  case '[': {
+    CharSet Chars;
+    if (!parseClass(Chars))
+      return nullptr;
+    return makeChars(Chars);
+  }
+  case '\\': {
+    CharSet Chars;
+    int Single;
+    if (!parseEscape(Chars, Single))
+      return nullptr;
+    return makeChars(Chars);
+  }
+  case ')':
+  case '*':
+  case '+':
+  case '?':
+  case '{':
+  case '}':
+  case ']':
+    return nullptr;
+  default: {
+    CharSet Chars;
+    Chars.set(static_cast<unsigned char>(Char));
+    return makeChars(Chars);
+  }
+  }
+}
+
+bool RegexParser::parseClass(CharSet &Chars) {
+  bool Negate = false;
+  if (Pos != End && *Pos == '^') {
+    Negate = true;
+    ++Pos;
+  }
+  // Leave the empty class, and a ] as its first character, to std::regex.
+  if (Pos != End && *Pos == ']')
+    return false;
+
+  for (;;) {
+    if (Pos == End)
+      return false;
+    if (*Pos == ']') {
+      ++Pos;
+      break;
+    }
+    // POSIX classes, collating symbols and equivalence classes.
+    if (*Pos == '[' && End - Pos >= 2 &&
+        (Pos[1] == ':' || Pos[1] == '.' || Pos[1] == '='))
+      return false;
+
+    CharSet Low;
+    int LowChar;
+    if (!parseClassAtom(Low, LowChar))
+      return false;
+    if (LowChar >= 0 && End - Pos >= 2 && *Pos == '-' && Pos[1] != ']') {
+      ++Pos;
+      CharSet High;
+      int HighChar;
+      if (!parseClassAtom(High, HighChar) || HighChar < LowChar)
+        return false;
+      // Ranges of the bytes that are negative chars depend on the library.
+      if (HighChar >= 0x80)
+        return false;
+      Chars |= getRange(static_cast<unsigned>(LowChar),
+                        static_cast<unsigned>(HighChar));
+    } else {
+      Chars |= Low;
+    }
+  }
+
+  if (Negate)
+    Chars.flip();
+  return true;
+}
+
+bool RegexParser::parseClassAtom(CharSet &Chars, int &Char) {
+  if (*Pos == '\\') {
+    ++Pos;
+    return parseEscape(Chars, Char);
+  }
+  Char = static_cast<unsigned char>(*Pos++);
+  Chars.set(static_cast<size_t>(Char));
+  return true;
+}
+
+bool RegexParser::parseEscape(CharSet &Chars, int &Char) {
+  if (Pos == End)
+    return false;
+
+  // The character class escapes set Char to -1.
+  Char = -1;
+  char Escaped = *Pos++;
+  switch (Escaped) {
+  case 'd':
+    Chars |= getDigits();
+    return true;
+  case 'D':
+    Chars |= ~getDigits();
+    return true;
+  case 'w':
+    Chars |= getWordChars();
+    return true;
+  case 'W':
+    Chars |= ~getWordChars();
+    return true;
+  case 's':
+    Chars |= getSpaces();
+    return true;
+  case 'S':
+    Chars |= ~getSpaces();
+    return true;
+  case 't':
+    Char = '\t';
+    break;
+  case 'n':
+    Char = '\n';
+    break;
+  case 'v':
+    Char = '\v';
+    break;
+  case 'f':
+    Char = '\f';
+    break;
+  case 'r':
+    Char = '\r';
+    break;
+  case '0':
+    // Not an octal escape.
+    if (Pos != End && isdigit(static_cast<unsigned char>(*Pos)))
+      return false;
+    Char = '\0';
+    break;
+  case 'x': {
+    if (End - Pos < 2 || !isxdigit(static_cast<unsigned char>(Pos[0])) ||
+        !isxdigit(static_cast<unsigned char>(Pos[1])))
+      return false;
+    Char = static_cast<int>(std::stoi(std::string(Pos, 2), nullptr, 16));
+    Pos += 2;
+    break;
+  }
+  default:
+    // The word boundaries, back references, and the escapes with a meaning
+    // that depends on the library (such as \b in a class or \c).
+    if (isalnum(static_cast<unsigned char>(Escaped)))
+      return false;
+    Char = static_cast<unsigned char>(Escaped);
+    break;
+  }
+  Chars.set(static_cast<size_t>(Char));
+  return true;
+}
+
+// A state of the NFA the regular expressions are compiled into. A state
+// either consumes one of Chars and moves to Next, or moves to any of
+// Epsilons without consuming, if its Guard holds.
+struct NfaState {
+  enum StateGuard {
+    sg_none,  // Always.
+    sg_begin, // At the start of the input.
+    sg_end    // At the end of the input.
+  };
+
+  CharSet Chars;
+  uint32_t Next = NoState;
+  std::vector<uint32_t> Epsilons;
+  StateGuard Guard = sg_none;
+};
+
+// Builds the NFA for a set of regular expressions, with state 0 as the
+// accepting state.
+class NfaBuilder {
+public:
+  NfaBuilder() : States(1) {}
+
+  std::vector<NfaState> &getStates() { return States; }
+
+  // Get the start of the NFA for a Node that continues to Out, or NoState if
+  // there are too many states.
+  uint32_t compile(const RegexNode &Node, uint32_t Out);
+
+private:
+  uint32_t addState() {
+    States.emplace_back();
+    return static_cast<uint32_t>(States.size() - 1);
+  }
+
+  std::vector<NfaState> States;
+};
+
+uint32_t NfaBuilder::compile(const RegexNode &Node, uint32_t Out) {
+  if (States.size() > MaxNfaStates || Out == NoState)
+    return NoState;
+
+  switch (Node.Kind) {
+  case RegexNode::nk_chars: {
+    uint32_t State = addState();
+    States[State].Chars = Node.Chars;
+    States[State].Next = Out;
+    return State;
+  }
+  case RegexNode::nk_sequence:
+    for (auto It = Node.Children.rbegin(); It != Node.Children.rend(); ++It)
+      Out = compile(**It, Out);
+    return Out;
+  case RegexNode::nk_alternate: {
+    if (Node.Children.size() == 1)
+      return compile(*Node.Children.front(), Out);
+    uint32_t State = addState();
+    for (const auto &Child : Node.Children) {
+      uint32_t Start = compile(*Child, Out);
+      if (Start == NoState)
+        return NoState;
+      States[State].Epsilons.push_back(Start);
+    }
+    return State;
+  }
+  case RegexNode::nk_repeat: {
+    const RegexNode &Child = *Node.Children.front();
+    uint32_t Next = Out;
+    if (Node.Max == Unbounded) {
+      // Loop back to a state that can also leave to Out.
+      uint32_t Loop = addState();
+      uint32_t Start = compile(Child, Loop);
+      States[Loop].Epsilons = {Start, Out};
+      Next = Loop;
+    } else {
+      // Each optional copy can continue to another one or leave to Out.
+      for (unsigned Count = Node.Min; Count < Node.Max; ++Count) {
+        uint32_t Optional = addState();
+        uint32_t Start = compile(Child, Next);
+        States[Optional].Epsilons = {Start, Out};
+        Next = Optional;
+      }
+    }
+    for (unsigned Count = 0; Count < Node.Min; ++Count)
+      Next = compile(Child, Next);
+    return Next;
+  }
+  case RegexNode::nk_begin:
+  case RegexNode::nk_end: {
+    uint32_t State = addState();
+    States[State].Epsilons.push_back(Out);
+    States[State].Guard =
+        Node.Kind == RegexNode::nk_begin ? NfaState::sg_begin
+                                         : NfaState::sg_end;
+    return State;
+  }
+  }
+  return NoState;
+}
+
+// Computes the states reachable without consuming, with work space that is
+// kept from one set to the next.
+class ClosureBuilder {
+public:
+  explicit ClosureBuilder(const std::vector<NfaState> &States)
+      : States(States), Marks(States.size(), 0) {}
+
+  // Add the states reachable from Set without consuming to it, and sort it.
+  // Returns the number of states visited.
+  size_t addClosure(std::vector<uint32_t> &Set, bool AtBegin, bool AtEnd);
+
+private:
+  const std::vector<NfaState> &States;
+  // The states seen by the current closure are marked with its Generation.
+  std::vector<uint32_t> Marks;
+  uint32_t Generation = 0;
+  std::vector<uint32_t> Pending;
+};
+
+size_t ClosureBuilder::addClosure(std::vector<uint32_t> &Set, bool AtBegin,
+                                  bool AtEnd) {
+  if (++Generation == 0) {
+    std::fill(Marks.begin(), Marks.end(), 0);
+    Generation = 1;
+  }
+  Pending.assign(Set.begin(), Set.end());
+  for (uint32_t State : Set)
+    Marks[State] = Generation;
+  size_t Visited = 0;
+  while (!Pending.empty()) {
+    const NfaState &Current = States[Pending.back()];
+    Pending.pop_back();
+    ++Visited;
+    if ((Current.Guard == NfaState::sg_begin && !AtBegin) ||
+        (Current.Guard == NfaState::sg_end && !AtEnd))
+      continue;
+    for (uint32_t Next : Current.Epsilons)
+      if (Marks[Next] != Generation) {
+        Marks[Next] = Generation;
+        Set.push_back(Next);
+        Pending.push_back(Next);
+      }
+  }
+  std::sort(Set.begin(), Set.end());
+  return Visited;
+}
+
+// Hashes a sorted set of NFA states.
+struct StateSetHash {
+  size_t operator()(const std::vector<uint32_t> &Set) const {
+    uint64_t Hash = 0xcbf29ce484222325ULL;
+    for (uint32_t State : Set)
+      Hash = (Hash ^ State) * 0x100000001b3ULL;
+    return static_cast<size_t>(Hash);
+  }
+};
+
+// Build the DFA for a set of parsed expressions, with a transition for every
+// state and byte in Next. Returns false if it is beyond the limits.
+bool buildDfa(const std::vector<const RegexNode *> &Nodes,
+              std::vector<uint32_t> &DfaNext, std::vector<bool> &Accepted,
+              uint32_t &Dead) {
+  // Compile the expressions into one NFA, from a state that can move to the
+  // start of each of them.
+  NfaBuilder Builder;
+  std::vector<uint32_t> Starts;
+  for (const RegexNode *Node : Nodes) {
+    uint32_t Start = Builder.compile(*Node, 0);
+    if (Start == NoState || Builder.getStates().size() > MaxNfaStates)
+      return false;
+    Starts.push_back(Start);
+  }
+  const std::vector<NfaState> &States = Builder.getStates();
+
+  // Split the bytes into the classes that no set of characters tells apart.
+  std::unordered_set<CharSet> CharSets;
+  for (const NfaState &State : States)
+    if (State.Next != NoState)
+      CharSets.insert(State.Chars);
+  std::vector<unsigned> ByteClasses(256, 0);
+  unsigned ClassCount = 1;
+  for (const CharSet &Chars : CharSets) {
+    std::map<std::pair<unsigned, bool>, unsigned> Split;
+    for (unsigned Char = 0; Char < 256; ++Char) {
+      auto Key = std::make_pair(ByteClasses[Char], Chars[Char]);
+      auto It = Split.emplace(Key, static_cast<unsigned>(Split.size())).first;
+      ByteClasses[Char] = It->second;
+    }
+    ClassCount = static_cast<unsigned>(Split.size());
+  }
+  std::vector<unsigned> ClassBytes(ClassCount);
+  for (unsigned Char = 0; Char < 256; ++Char)
+    ClassBytes[ByteClasses[Char]] = Char;
+
+  // The subset construction, from the states reachable at the start. The
+  // start is never the same as another state, as the ^ assertions hold there.
+  ClosureBuilder Closure(States);
+  std::unordered_map<std::vector<uint32_t>, uint32_t, StateSetHash> DfaStates;
+  std::vector<std::vector<uint32_t>> Sets;
+  std::vector<uint32_t> Start(Starts);
+  size_t Work = Closure.addClosure(Start, /*AtBegin=*/true, /*AtEnd=*/false);
+  Sets.push_back(Start);
+  Dead = NoState;
+  std::vector<uint32_t> AtEnd;
+  std::vector<uint32_t> Next;
+  std::vector<uint32_t> Targets(ClassCount);
+  for (size_t Current = 0; Current < Sets.size(); ++Current) {
+    if (Sets.size() > MaxDfaStates || Work > MaxDfaWork)
+      return false;
+
+    AtEnd = Sets[Current];
+    Work += Closure.addClosure(AtEnd, /*AtBegin=*/Current == 0,
+                               /*AtEnd=*/true);
+    Accepted.push_back(std::binary_search(AtEnd.begin(), AtEnd.end(), 0));
+
+    for (unsigned Class = 0; Class < ClassCount; ++Class) {
+      Next.clear();
+      for (uint32_t State : Sets[Current])
+        if (States[State].Next != NoState &&
+            States[State].Chars[ClassBytes[Class]])
+          Next.push_back(States[State].Next);
+      Work += Sets[Current].size();
+      std::sort(Next.begin(), Next.end());
+      Next.erase(std::unique(Next.begin(), Next.end()), Next.end());
+      Work += Closure.addClosure(Next, /*AtBegin=*/false, /*AtEnd=*/false);
+
+      auto Inserted =
+          DfaStates.emplace(Next, static_cast<uint32_t>(Sets.size()));
+      if (Inserted.second) {
+        if (Next.empty())
+          Dead = Inserted.first->second;
+        Sets.push_back(Next);
+      }
+      Targets[Class] = Inserted.first->second;
+    }
+    for (unsigned Char = 0; Char < 256; ++Char)
+      DfaNext.push_back(Targets[ByteClasses[Char]]);
+  }
+  return true;
+}
+
+// Check if Node is .*text.*, where the text has no line terminator, and get
+// the text. Such an expression matches the inputs that contain the text and
+// no line terminator.
+bool getLineText(const RegexNode &Node, std::string &Text) {
+  const RegexNode *Sequence = &Node;
+  while (Sequence->Kind == RegexNode::nk_alternate &&
+         Sequence->Children.size() == 1)
+    Sequence = Sequence->Children.front().get();
+  if (Sequence->Kind != RegexNode::nk_sequence ||
+      Sequence->Children.size() < 2)
+    return false;
+
+  const CharSet LineChars = getLineChars();
+  auto isAnyLine = [&LineChars](const RegexNode &Child) {
+    return Child.Kind == RegexNode::nk_repeat && Child.Min == 0 &&
+           Child.Max == Unbounded &&
+           Child.Children.front()->Kind == RegexNode::nk_chars &&
+           Child.Children.front()->Chars == LineChars;
+  };
+  const auto &Children = Sequence->Children;
+  if (!isAnyLine(*Children.front()) || !isAnyLine(*Children.back()))
+    return false;
+
+  Text.clear();
+  for (size_t Index = 1; Index + 1 < Children.size(); ++Index) {
+    const RegexNode &Child = *Children[Index];
+    if (Child.Kind != RegexNode::nk_chars || Child.Chars.count() != 1)
+      return false;
+    unsigned Char = 0;
+    while (!Child.Chars[Char])
+      ++Char;
+    if (!LineChars[Char])
+      return false;
+    Text += static_cast<char>(Char);
+  }
+  return true;
+}
+
+} // namespace
+
+PatternMatcher::PatternMatcher(const MatchInfo &Patterns) {
+  std::vector<std::string> AnyPatterns;
+  for (const Match &Pattern : Patterns) {
+    if (Pattern.Mode == mm_match)
+      addExact(Pattern.Pattern);
+    else if (Pattern.Mode == mm_any)
+      AnyPatterns.push_back(Pattern.Pattern);
+  }
+  Any.compile(AnyPatterns);
+  std::vector<std::string> LinePatterns;
+  compileRegex(Patterns, LinePatterns);
+  Line.compile(LinePatterns);
+}
+
+void PatternMatcher::addExact(const std::string &Pattern) {
+  size_t Length;
+  if (matchExact(Pattern.c_str()))
+    return;
+  Exact.push_back(Pattern);
+
+  // Keep the table at most half full.
+  if (ExactTable.size() < Exact.size() * 2) {
+    ExactTable.assign(std::max<size_t>(16, ExactTable.size() * 2), 0);
+    for (size_t Index = 0; Index < Exact.size(); ++Index) {
+      size_t Mask = ExactTable.size() - 1;
+      size_t Slot = hashString(Exact[Index].c_str(), Length) & Mask;
+      while (ExactTable[Slot])
+        Slot = (Slot + 1) & Mask;
+      ExactTable[Slot] = static_cast<uint32_t>(Index + 1);
+    }
+    return;
+  }
+  size_t Mask = ExactTable.size() - 1;
+  size_t Slot = hashString(Pattern.c_str(), Length) & Mask;
+  while (ExactTable[Slot])
+    Slot = (Slot + 1) & Mask;
+  ExactTable[Slot] = static_cast<uint32_t>(Exact.size());
+}
+
+void PatternMatcher::AnyAutomaton::compile(
+    const std::vector<std::string> &Patterns) {
+  if (Patterns.empty())
+    return;
+
+  // Build the trie of the patterns, with state 0 as its root.
+  Next.assign(256, NoState);
+  Matched.assign(1, false);
+  for (const std::string &Pattern : Patterns) {
+    uint32_t State = 0;
+    for (char Char : Pattern) {
+      uint32_t &To = Next[State * 256 + static_cast<unsigned char>(Char)];
+      if (To == NoState) {
+        To = static_cast<uint32_t>(Matched.size());
+        Matched.push_back(false);
+        Next.resize(Next.size() + 256, NoState);
+      }
+      State = Next[State * 256 + static_cast<unsigned char>(Char)];
+    }
+    Matched[State] = true;
+  }
+
+  // Fill in the missing transitions from the failure links, breadth first so
+  // that the states a failure link leads to are complete.
+  std::vector<uint32_t> Failures(Matched.size(), 0);
+  std::vector<uint32_t> Pending;
+  for (unsigned Char = 0; Char < 256; ++Char) {
+    uint32_t &To = Next[Char];
+    if (To == NoState)
+      To = 0;
+    else
+      Pending.push_back(To);
+  }
+  for (size_t Index = 0; Index < Pending.size(); ++Index) {
+    uint32_t State = Pending[Index];
+    uint32_t Failure = Failures[State];
+    if (Matched[Failure])
+      Matched[State] = true;
+    for (unsigned Char = 0; Char < 256; ++Char) {
+      uint32_t &To = Next[State * 256 + Char];
+      if (To == NoState) {
+        To = Next[Failure * 256 + Char];
+      } else {
+        Failures[To] = Next[Failure * 256 + Char];
+        Pending.push_back(To);
+      }
+    }
+  }
+}
+
+void PatternMatcher::compileRegex(const MatchInfo &Patterns,
+                                  std::vector<std::string> &LinePatterns) {
+  std::vector<RegexNodePtr> Nodes;
+  std::vector<const Match *> Compiled;
+  std::string Text;
+  for (const Match &Pattern : Patterns) {
+    if (Pattern.Mode != mm_regex)
+      continue;
+    RegexNodePtr Node = RegexParser(Pattern.Pattern).parse();
+    if (!Node) {
+      Fallbacks.push_back(Pattern.RE);
+      continue;
+    }
+    // The common .*text.* form would make a DFA large when there are many
+    // of them, as it has to track each text found so far.
+    if (getLineText(*Node, Text)) {
+      LinePatterns.push_back(Text);
+      continue;
+    }
+    Nodes.push_back(std::move(Node));
+    Compiled.push_back(&Pattern);
+  }
+
+  // Compile the expressions into one DFA, and split a range of them in two
+  // while its DFA is beyond the limits.
+  std::vector<std::pair<size_t, size_t>> Ranges;
+  if (!Nodes.empty())
+    Ranges.emplace_back(0, Nodes.size());
+  while (!Ranges.empty()) {
+    size_t First = Ranges.back().first;
+    size_t Last = Ranges.back().second;
+    Ranges.pop_back();
+    std::vector<const RegexNode *> Range;
+    for (size_t Index = First; Index < Last; ++Index)
+      Range.push_back(Nodes[Index].get());
+    RegexDfa Dfa;
+    if (buildDfa(Range, Dfa.Next, Dfa.Accepted, Dfa.Dead)) {
+      Dfas.push_back(std::move(Dfa));
+    } else if (Last - First == 1) {
+      Fallbacks.push_back(Compiled[First]->RE);
+    } else {
+      size_t Middle = First + (Last - First) / 2;
+      Ranges.emplace_back(Middle, Last);
+      Ranges.emplace_back(First, Middle);
+    }
+  }
+}
+
+bool PatternMatcher::match(const char *Input) const {
+  return matchExact(Input) || Any.match(Input) || matchLine(Input) ||
+         std::any_of(Dfas.begin(), Dfas.end(),
+                     [Input](const RegexDfa &Dfa) {
+                       return Dfa.match(Input);
+                     }) ||
+         std::any_of(Fallbacks.begin(), Fallbacks.end(),
+                     [Input](const std::regex &RE) {
+                       return std::regex_match(Input, RE);
+                     });
+}
+
+bool PatternMatcher::matchExact(const char *Input) const {
+  if (ExactTable.empty())
+    return false;
+  size_t Length;
+  size_t Mask = ExactTable.size() - 1;
+  for (size_t Slot = hashString(Input, Length) & Mask; ExactTable[Slot];
+       Slot = (Slot + 1) & Mask) {
+    const std::string &Pattern = Exact[ExactTable[Slot] - 1];
+    if (Pattern.size() == Length && memcmp(Pattern.data(), Input, Length) == 0)
+      return true;
+  }
+  return false;
+}
+
+bool PatternMatcher::matchLine(const char *Input) const {
+  return !Line.Matched.empty() && !strpbrk(Input, "\n\r") &&
+         Line.match(Input);
+}
+
+bool PatternMatcher::AnyAutomaton::match(const char *Input) const {
+  if (Matched.empty())
+    return false;
+  uint32_t State = 0;
+  if (Matched[State])
+    return true;
+  for (; *Input; ++Input) {
+    State = Next[State * 256 + static_cast<unsigned char>(*Input)];
+    if (Matched[State])
+      return true;
+  }
+  return false;
+}
+
+bool PatternMatcher::RegexDfa::match(const char *Input) const {
+  uint32_t State = 0;
+  for (; *Input; ++Input) {
+    State = Next[State * 256 + static_cast<unsigned char>(*Input)];
+    if (State == Dead)
+      return false;
+  }
+  return Accepted[State];
+}
+
+bool NameMatchCache::match(const PatternMatcher &Matcher, size_t NameIndex) {
+  uint64_t Hash = static_cast<uint64_t>(NameIndex) * 0x9E3779B97F4A7C15ULL;
+  Shard &TheShard = Shards[Hash >> (64 - ShardBits)];
+  std::lock_guard<std::mutex> Lock(TheShard.ShardMutex);
+  auto Found = TheShard.Results.find(NameIndex);
+  if (Found != TheShard.Results.end())
+    return Found->second;
+  bool Result = Matcher.match(StringPool::getStringValue(NameIndex));
+  TheShard.Results.emplace(NameIndex, Result);
+  return Result;
+}
+
+void NameMatchCache::clear() {
+  for (Shard &TheShard : Shards) {
+    std::lock_guard<std::mutex> Lock(TheShard.ShardMutex);
+    TheShard.Results.clear();
+  }
+}
@@ -0,0 +1,170 @@
+//===-- PatternMatcher.h ----------------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Definition of the Match structure and the PatternMatcher class.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef PATTERNMATCHER_H
+#define PATTERNMATCHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <regex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace LibScopeView {
+
+/// \brief Pattern Mode for a Match.
+enum MatchMode {
+  mm_none = 0, // No given pattern.
+  mm_match,    // Perfect match.
+  mm_any,      // Partial match.
+  mm_regex     // Regular expression.
+};
+
+/// \brief Small data structure to keep the search/tree pattern information.
+struct Match {
+  std::string Pattern; // Normal pattern.
+  std::regex RE;       // Regular Expression Pattern.
+  MatchMode Mode;      // Match mode.
+  Match() : Mode(mm_none) {}
+};
+
+typedef std::vector<Match> MatchInfo;
+
+/// \brief Matches strings against a set of patterns, which are compiled once.
+///
+/// The perfect match patterns are kept in a hash table, and the partial match
+/// patterns are compiled into an Aho-Corasick automaton. So are the regular
+/// expressions of the form .*text.*, which match the inputs that contain the
+/// text and no line terminator. The other regular expressions are compiled
+/// together into as few DFAs as keep them small, which accept the same
+/// strings as std::regex_match with the ECMAScript grammar. An expression
+/// that uses a feature a DFA cannot express (such as a back reference, an
+/// assertion other than ^ and $, or a POSIX class), or whose own DFA is too
+/// large, is left to std::regex.
+///
+/// A compiled matcher is not changed by matching, so it can be used from
+/// several threads at once.
+class PatternMatcher {
+public:
+  PatternMatcher() {}
+  explicit PatternMatcher(const MatchInfo &Patterns);
+
+  /// \brief Check if the input matches any of the patterns.
+  bool match(const char *Input) const;
+
+  /// \brief The number of regular expressions left to std::regex.
+  size_t getFallbackCount() const { return Fallbacks.size(); }
+
+  /// \brief The number of DFAs the regular expressions are compiled into.
+  size_t getDfaCount() const { return Dfas.size(); }
+
+private:
+  // An Aho-Corasick automaton, with a transition for every state and byte.
+  // Matched is set for the states that end a pattern.
+  struct AnyAutomaton {
+    std::vector<uint32_t> Next;
+    std::vector<bool> Matched;
+
+    void compile(const std::vector<std::string> &Patterns);
+    bool match(const char *Input) const;
+  };
+
+  // A DFA for some of the regular expressions, with a transition for every
+  // state and byte. State 0 is the start, and Dead is the state that matches
+  // nothing. Accepted is set for the states that accept at the end of the
+  // input.
+  struct RegexDfa {
+    std::vector<uint32_t> Next;
+    std::vector<bool> Accepted;
+    uint32_t Dead = 0;
+
+    bool match(const char *Input) const;
+  };
+
+  void addExact(const std::string &Pattern);
+  void compileRegex(const MatchInfo &Patterns,
+                    std::vector<std::string> &LinePatterns);
+
+  bool matchExact(const char *Input) const;
+  bool matchLine(const char *Input) const;
+
+  // The perfect match patterns, and an open-addressing table of their
+  // positions plus one. The table size is a power of two.
+  std::vector<std::string> Exact;
+  std::vector<uint32_t> ExactTable;
+
+  // The partial match patterns.
+  AnyAutomaton Any;
+  // The text of the .*text.* regular expressions.
+  AnyAutomaton Line;
+
+  // The regular expressions compiled into DFAs.
+  std::vector<RegexDfa> Dfas;
+
+  // The regular expressions the DFAs cannot express.
+  std::vector<std::regex> Fallbacks;
+};
+
+/// \brief Remembers which interned names match a PatternMatcher, so that each
+/// name is matched only once.
+///
+/// It can be used from several threads at once. A copy starts empty.
+class NameMatchCache {
+public:
+  NameMatchCache() {}
+  NameMatchCache(const NameMatchCache &) {}
+  NameMatchCache &operator=(const NameMatchCache &) {
+    clear();
+    return *this;
+  }
+
+  /// \brief Check if the name with the given StringPool index matches.
+  bool match(const PatternMatcher &Matcher, size_t NameIndex);
+
+  /// \brief Forget the results, such as when the patterns change.
+  void clear();
+
+private:
+  struct Shard {
+    std::mutex ShardMutex;
+    std::unordered_map<size_t, bool> Results;
+  };
+
+  // The shard is chosen by the top bits of a hash of the index.
+  static const unsigned ShardBits = 4;
+  static const unsigned NumShards = 1U << ShardBits;
+
+  Shard Shards[NumShards];
+};
+
+} // namespace LibScopeView
+
+#endif // PATTERNMATCHER_H
@@ -29,21 +29,65 @@
 
 #include "PrintContext.h"
 #include "FileUtilities.h"
+#include "Object.h"
 #include "Platform.h"
+#include "Reader.h"
 
 #include <cstdarg>
+#include <cstdint>
 
 using namespace LibScopeView;
 
 std::unique_ptr<PrintContext> LibScopeView::GlobalPrintContext;
 
-PrintContext::PrintContext()
-    : File(nullptr), FileSave(nullptr), TheLocation(""), LocationDone(false) {}
+namespace {
+// The context set for the current thread by a ThreadPrintContext.
+thread_local PrintContext *CurrentPrintContext = nullptr;
+} // namespace
+
+PrintContext *LibScopeView::getPrintContext() {
+  return CurrentPrintContext ? CurrentPrintContext : GlobalPrintContext.get();
+}
+
+ThreadPrintContext::ThreadPrintContext(PrintContext &Context)
+    : Saved(CurrentPrintContext) {
+  CurrentPrintContext = &Context;
+}
+
+ThreadPrintContext::~ThreadPrintContext() { CurrentPrintContext = Saved; }
+
+AttributeLayout::AttributeLayout()
+    : HasOptions(false), Calculated(false), OffsetWidth(0), ParentWidth(0),
+      TagWidth(0), IndentationSize(0) {}
+
+void AttributeLayout::setOptions(const CmdOptions &NewOptions) {
+  Options = NewOptions;
+  HasOptions = true;
+}
+
+const CmdOptions &AttributeLayout::getOptions() const {
+  return HasOptions ? Options : getReader()->getOptions();
+}
+
+void AttributeLayout::setWidths(size_t Offset, size_t Parent, size_t Tag,
+                                size_t Total) {
+  OffsetWidth = Offset;
+  ParentWidth = Parent;
+  TagWidth = Tag;
+  IndentationSize = Total;
+  Calculated = true;
+}
+
+PrintContext::PrintContext() : PrintContext(nullptr) {}
 
 PrintContext::PrintContext(FILE *context)
-    : File(context), FileSave(nullptr), TheLocation(""), LocationDone(false) {}
+    : BufferSize(DefaultBufferSize), File(context), FileSave(nullptr),
+      TheLocation(""), LocationDone(false), KeepText(false),
+      LastFileIndex(0) {
+  Buffer.reserve(BufferSize);
+}
 
-PrintContext::~PrintContext() {}
+PrintContext::~PrintContext() { flush(); }
 
 void PrintContext::create(FILE *Context) {
   GlobalPrintContext = std::make_unique<PrintContext>(Context);
@@ -75,6 +119,7 @@ bool PrintContext::open(const std::string &FilePath) {
 
   if (OpenedFile) {
     // Preserve the current printing context.
+    flush();
     FileSave = File;
     File = OpenedFile;
   }
@@ -83,6 +128,7 @@ bool PrintContext::open(const std::string &FilePath) {
 
 void PrintContext::close() {
   if (File) {
+    flush();
     fclose(File);
 
     // Restore the printing context.
@@ -90,19 +136,55 @@ void PrintContext::close() {
   }
 }
 
+void PrintContext::setBufferSize(size_t Size) {
+  flush();
+  if (KeepText)
+    return;
+  BufferSize = Size;
+  Buffer.reserve(BufferSize);
+}
+
+void PrintContext::setKeepText() {
+  flush();
+  KeepText = true;
+  BufferSize = SIZE_MAX;
+}
+
+void PrintContext::flush() {
+  if (!Buffer.empty() && !KeepText) {
+    if (File)
+      fwrite(Buffer.data(), 1, Buffer.size(), File);
+    Buffer.clear();
+  }
+}
+
+void PrintContext::write(const char *Text, size_t Length) {
+  Buffer.append(Text, Length);
+  flushIfFull();
+}
+
+void PrintContext::writeLine(const std::string &Text) {
+  Buffer.append(Text);
+  Buffer.append('\n');
+  flushIfFull();
+}
+
+void PrintContext::printText(const Object &Obj) {
+  size_t Size = Buffer.size();
+  Obj.appendText(Buffer);
+  if (Buffer.size() != Size)
+    Buffer.append('\n');
+  flushIfFull();
+}
+
 int PrintContext::print(const char *Fmt, ...) {
+  size_t Size = Buffer.size();
   va_list ap;
   va_start(ap, Fmt);
-
-#ifdef __clang__
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wformat-nonliteral"
-#endif
-  int result = vfprintf(File, Fmt, ap);
-#ifdef __clang__
-#pragma clang diagnostic pop
-#endif
-
+  Buffer.appendFormatted(Fmt, ap);
   va_end(ap);
-  return result;
+
+  int Result = static_cast<int>(Buffer.size() - Size);
+  flushIfFull();
+  return Result;
 }
@@ -30,18 +30,82 @@
 #ifndef PRINT_CONTEXT_H
 #define PRINT_CONTEXT_H
 
+#include "CmdOptions.h"
+#include "TextBuffer.h"
+
+#include <cstddef>
+#include <cstdio>
 #include <memory>
 #include <string>
 
 namespace LibScopeView {
 
+class Object;
+
+/// \brief The attributes printed in front of each object, such as the DIE
+/// offsets and the level, and the widths of their columns.
+///
+/// Each print context has a layout of its own. The widths, and so the
+/// indentation of the lines printed under an object, are fixed by the first
+/// object printed. The attributes are those selected by the reader's options,
+/// unless the layout is given options of its own.
+class AttributeLayout {
+public:
+  AttributeLayout();
+
+  /// \brief Print the attributes selected by Options, rather than those of
+  /// the reader's options.
+  void setOptions(const CmdOptions &NewOptions);
+  /// \brief The options that select the attributes.
+  const CmdOptions &getOptions() const;
+
+  /// \brief The widths have been fixed by the first object printed.
+  bool getCalculated() const { return Calculated; }
+  void setWidths(size_t Offset, size_t Parent, size_t Tag, size_t Total);
+
+  size_t getOffsetWidth() const { return OffsetWidth; }
+  size_t getParentWidth() const { return ParentWidth; }
+  size_t getTagWidth() const { return TagWidth; }
+  /// \brief The width of all of the attributes.
+  size_t getIndentationSize() const { return IndentationSize; }
+
+private:
+  CmdOptions Options;
+  bool HasOptions;
+  bool Calculated;
+  size_t OffsetWidth;
+  size_t ParentWidth;
+  size_t TagWidth;
+  size_t IndentationSize;
+};
+
 /// \brief Class to represent an output print context.
+///
+/// The printed text is collected in a buffer, which is written to the file
+/// when it is full, when the file is changed by open() or close(), and by
+/// flush(). Anything else that writes to the same file, such as std::cout,
+/// must call flush() first to keep the output in order. A buffer size of 0
+/// writes each print straight to the file.
+///
+/// Text can also be appended to the buffer directly, with getBuffer(),
+/// followed by a call to flushIfFull().
+///
+/// A context can instead keep all of its text, such as to print a compile
+/// unit on a worker thread. The text is then written out by the thread that
+/// owns the output, in order.
+///
+/// The objects are printed with the context's AttributeLayout.
 class PrintContext {
 public:
   PrintContext();
   PrintContext(FILE *Context);
   ~PrintContext();
 
+  PrintContext(const PrintContext &) = delete;
+  PrintContext &operator=(const PrintContext &) = delete;
+
+  static const size_t DefaultBufferSize = 1024 * 1024;
+
   typedef int (*PrintFunc)(const char *, ...);
 
 public:
@@ -51,21 +115,75 @@ public:
   bool open(const std::string &FilePath);
   void close();
   int print(const char *Fmt, ...);
+  void write(const char *Text, size_t Length);
+  void write(const std::string &Text) { write(Text.data(), Text.size()); }
+  /// \brief Write the text followed by a new line.
+  void writeLine(const std::string &Text);
+  /// \brief Print the text representation of an object, followed by a new
+  /// line. Nothing is printed if the text is empty.
+  void printText(const Object &Obj);
+  /// \brief Write the buffered text to the file.
+  void flush();
+  /// \brief Write the buffered text to the file, if the buffer is full.
+  void flushIfFull() {
+    if (Buffer.size() >= BufferSize)
+      flush();
+  }
+  TextBuffer &getBuffer() { return Buffer; }
   bool createLocation(const std::string &Location);
 
+  /// \brief Keep all the text in the buffer, to be taken with getBuffer(),
+  /// instead of writing it to the file.
+  void setKeepText();
+
+  /// \brief The file name index of the last object printed with its file
+  /// name, which is only printed again when it changes.
+  size_t getLastFileIndex() const { return LastFileIndex; }
+  void setLastFileIndex(size_t Index) { LastFileIndex = Index; }
+
+  AttributeLayout &getLayout() { return Layout; }
+  const AttributeLayout &getLayout() const { return Layout; }
+  void setLayout(const AttributeLayout &NewLayout) { Layout = NewLayout; }
+
 public:
   std::string getLocation() { return TheLocation; }
 
+  size_t getBufferSize() const { return BufferSize; }
+  void setBufferSize(size_t Size);
+
 private:
+  TextBuffer Buffer;
+  size_t BufferSize;
   FILE *File;
   FILE *FileSave;
   std::string TheLocation;
   bool LocationDone;
+  bool KeepText;
+  size_t LastFileIndex;
+  AttributeLayout Layout;
 };
 
 // Instance to handle the print context.
 extern std::unique_ptr<PrintContext> GlobalPrintContext;
 
+/// \brief Get the context the objects are printed to by the current thread.
+/// This is GlobalPrintContext, unless a ThreadPrintContext has been set.
+PrintContext *getPrintContext();
+
+/// \brief Makes the current thread print to the given context, rather than to
+/// GlobalPrintContext, for as long as it exists.
+class ThreadPrintContext {
+public:
+  explicit ThreadPrintContext(PrintContext &Context);
+  ~ThreadPrintContext();
+
+  ThreadPrintContext(const ThreadPrintContext &) = delete;
+  ThreadPrintContext &operator=(const ThreadPrintContext &) = delete;
+
+private:
+  PrintContext *Saved;
+};
+
 } // namespace LibScopeView
 
 #endif // PRINT_CONTEXT_H
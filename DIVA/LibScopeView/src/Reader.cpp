@@ -28,17 +28,21 @@
 //===----------------------------------------------------------------------===//
 
 #include "Reader.h"
+#include "FileUtilities.h"
 #include "Line.h"
 #include "PrintContext.h"
-#include "ScopeVisitor.h"
+#include "ScopePipeline.h"
+#include "ScopeTextPrinter.h"
+#include "Sort.h"
 #include "Symbol.h"
 #include "Type.h"
 #include "Utilities.h"
 
 #include <assert.h>
 #include <iostream>
+#include <memory>
 #include <sstream>
-#include <unordered_set>
+#include <thread>
 
 using namespace LibScopeView;
 
@@ -55,6 +59,7 @@ Reader::Reader(ViewSpecification *ViewSpec)
   if (ViewSpec) {
     Spec = *ViewSpec;
   }
+  Spec.compilePatterns();
 
   // Let the specific reader Create the scope root.
   Scopes = nullptr;
@@ -75,21 +80,68 @@ bool Reader::executeActions() {
   return true;
 }
 
+void Reader::loadLineTable(ScopeCompileUnit &CU) {
+  // Nothing to read, so clear the pending state.
+  CU.setLineTable(LineTable());
+}
+
+bool Reader::getLinesNeeded() {
+  return getOptions().getPrintCodeline() || getOptions().getPrintSummary();
+}
+
+bool Reader::getPatternPushdown() {
+  // The objects that don't match are still counted by the summary, marked
+  // as global from other compile units, and read for the template arguments.
+  const CmdOptions &Options = getOptions();
+  if (!Spec.getReadPruning() ||
+      !(Spec.getAnyFilterPattern() || Spec.getAnyTreePattern()) ||
+      !Options.getPrintScopes() || Options.getPrintSummary() ||
+      Options.getAttributeGlobal() || Options.getFormatOnlyGlobals() ||
+      Options.getFormatOnlyLocals() || Options.getFormatTemplatesEncoded())
+    return false;
+
+  // A --tree match on the root prints the whole tree.
+  return Spec.getAnyFilterPattern() || !Scopes ||
+         !Spec.matchTreePattern(Scopes->getNameIndex());
+}
+
+bool Reader::getKindPruning() {
+  // The objects of other kinds are still marked as global from other compile
+  // units, and pass on that they are global or local to their parents.
+  const CmdOptions &Options = getOptions();
+  return Spec.getReadPruning() && !Options.getAttributeGlobal() &&
+         !Options.getFormatOnlyGlobals() && !Options.getFormatOnlyLocals();
+}
+
+unsigned Reader::getJobCount() {
+  // The trace output would be interleaved by the threads.
+  if (getOptions().getTraceVerbose())
+    return 1;
+  unsigned Jobs = Spec.getJobs();
+  if (Jobs == 0)
+    Jobs = std::max(std::thread::hardware_concurrency(), 1U);
+  return Jobs;
+}
+
 // Print summary details for the Scopes Tree.
 void Reader::printSummary() {
   if (!PrintedHeader) {
     getScopesRoot()->dump();
   }
+  GlobalPrintContext->flush();
   TheSummaryTable.getPrintedSummaryTable(std::cout);
 }
 
-void Reader::print() {
-  // If doing any search (--filter), do not do any scope tree printing.
+void Reader::print(const std::vector<ScopePrinter *> &Printers) {
+  // If doing any search (--filter), do not do any scope tree printing. The
+  // printers still print the whole tree.
   if (getSpecification()->getAnyFilterPattern()) {
     printObjects();
+    ScopePrinter::print(getScopesRoot(), Printers, getJobCount());
   } else {
-    printScopes();
+    printScopes(Printers);
   }
+  GlobalPrintContext->flush();
   std::cout << "\n";
 }
 
@@ -113,7 +165,7 @@ void Reader::printObjects() {
   }
 }
 
-void Reader::printScopes() {
+void Reader::printScopes(const std::vector<ScopePrinter *> &Printers) {
   bool DoPrint = getPrintObjects();
   if (DoPrint) {
     // Propagate any matching information into the scopes tree.
@@ -127,45 +179,57 @@ void Reader::printScopes() {
         // If no split location, use the scope root name.
         SplitDir = Scp->getName();
       }
-      if (!GlobalPrintContext->createLocation(SplitDir)) {
-        // If enable to create a print context location, reset the given
-        // location option and swith to non-split mode.
+      if (!recursiveMakeDir(unifyFilePath(SplitDir))) {
+        // If enable to create the location, reset the given location option
+        // and swith to non-split mode.
         DoSplit = false;
       }
     }
 
     PrintedHeader = true;
 
-    // We do a normal print, using the standard settings.
-    bool Match = getSpecification()->getAnyTreePattern();
-    Scp->print(DoSplit, Match, DoPrint);
+    // We do a normal print, using the standard settings, in the same walk
+    // over the tree as the other printers.
+    std::vector<ScopePrinter *> AllPrinters;
+    ScopeTextPrinter TextPrinter;
+    if (DoSplit)
+      TextPrinter.setOutputDir(SplitDir);
+    else
+      TextPrinter.setOutput(std::cout);
+    AllPrinters.push_back(&TextPrinter);
 
     // Check if we need to reprint, using extra settings; in that case we
-    // add the offset and level to the printing options.
+    // add the offset and level to the attributes of a second text printer.
+    // Its split output is printed in the same walk. Otherwise it follows the
+    // first text, and is printed after it rather than kept until then.
+    std::unique_ptr<ScopeTextPrinter> ExtraPrinter;
+    bool ExtraAfter = false;
     if (getOptions().getViewDualPrint()) {
-      // Preserve original settings.
-      bool DumpObjectOffset = getOptions().getAttributeOffset();
-      bool DumpObjectLevel = getOptions().getAttributeLevel();
-      getOptions().setAttributeOffset();
-      getOptions().setAttributeLevel();
+      CmdOptions ExtraOptions(getOptions());
+      ExtraOptions.setAttributeOffset();
+      ExtraOptions.setAttributeLevel();
+      ExtraPrinter = std::make_unique<ScopeTextPrinter>();
+      ExtraPrinter->setOptions(ExtraOptions);
 
       // Append a prefix to indicate, the location contains extra info.
       SplitDir.append("_ext");
-      if (DoSplit && !GlobalPrintContext->createLocation(SplitDir)) {
-        // If enable to create a print context location, reset the given
-        // location option and swith to non-split mode.
-        DoSplit = false;
+      if (DoSplit && recursiveMakeDir(unifyFilePath(SplitDir))) {
+        ExtraPrinter->setOutputDir(SplitDir);
+        AllPrinters.push_back(ExtraPrinter.get());
+      } else {
+        ExtraPrinter->setOutput(std::cout);
+        ExtraAfter = true;
       }
-
-      // Print the Scopes Tree.
-      Scp->print(DoSplit, Match, DoPrint);
-
-      // Restore the original settings.
-      DumpObjectOffset ? getOptions().setAttributeOffset()
-                         : getOptions().resetAttributeOffset();
-      DumpObjectLevel ? getOptions().setAttributeLevel()
-                        : getOptions().resetAttributeLevel();
     }
+
+    // Print the Scopes Tree.
+    AllPrinters.insert(AllPrinters.end(), Printers.begin(), Printers.end());
+    GlobalPrintContext->flush();
+    ScopePrinter::print(Scp, AllPrinters, getJobCount());
+    if (ExtraAfter)
+      ScopePrinter::print(Scp, {ExtraPrinter.get()}, getJobCount());
+  } else {
+    ScopePrinter::print(getScopesRoot(), Printers, getJobCount());
   }
 
   if (getReader()->getOptions().getPrintSummary()) {
@@ -180,40 +244,52 @@ bool Reader::loadFile(const char *FileName) {
   return executeActions();
 }
 
-// Visitors for post-creation actions.
+// Passes for post-creation actions.
 namespace {
 
-// Visitor that creates all the full type names once the CU tree has been
-// created.
-class NameResolver : public ScopeVisitor {
+// Pass that passes what each branch of the tree contains up to its root.
+class ContentFlagsPass : public ScopePass {
+public:
+  ContentFlagsPass() : ScopePass("content flags") {}
+
 private:
-  void visitImpl(Object *Obj) override {
-    resolve(Obj);
-    visitChildren(Obj);
+  void visitAfter(Object *Obj, size_t /*Slot*/) override {
+    if (auto Scp = dyn_cast<Scope>(Obj))
+      for (Scope *Child : Scp->getScopes())
+        Scp->addContentFlags(*Child);
   }
+};
+
+// Pass that creates all the full type names once the CU tree has been
+// created. It follows the types of objects, and resolves them first.
+class NamePass : public ScopePass {
+public:
+  NamePass() : ScopePass("names") {}
+
+private:
+  void visitBefore(Object *Obj, size_t /*Slot*/) override { resolve(Obj); }
 
   void resolve(Object *Obj) {
-    if (AlreadyResolved.count(Obj))
+    if (Obj->getIsResolved())
       return;
-    AlreadyResolved.insert(Obj);
+    Obj->setIsResolved();
 
     // Resolve type names.
-    if (auto Ty = dynamic_cast<Type *>(Obj)) {
+    if (auto Ty = dyn_cast<Type>(Obj)) {
       resolveTypeName(Ty);
       return;
     }
 
-    if (auto ObjScope = dynamic_cast<Scope *>(Obj)) {
+    if (auto ObjScope = dyn_cast<Scope>(Obj)) {
       // Resolve function pointer names.
       if (ObjScope->getIsSubroutineType()) {
-        resolveFunctionPointerName(
-            dynamic_cast<ScopeFunction *>(Obj));
+        resolveFunctionPointerName(dyn_cast<ScopeFunction>(Obj));
         return;
       }
 
       // Resolve array names.
       if (ObjScope->getIsArrayType()) {
-        resolveArrayName(dynamic_cast<ScopeArray *>(Obj));
+        resolveArrayName(dyn_cast<ScopeArray>(Obj));
         return;
       }
     }
@@ -271,23 +347,23 @@ private:
     }
     Array->setName(ResolvedName.c_str());
   }
-
-  std::unordered_set<Object *> AlreadyResolved;
 };
 
-// Visitor that sets the attributes of objects to those they reference.
-class ReferenceAttributeResolver : public ScopeVisitor {
+// Pass that sets the attributes of objects to those they reference.
+class ReferencePass : public ScopePass {
+public:
+  ReferencePass() : ScopePass("references") {}
+
 private:
-  void visitImpl(Object *Obj) override {
+  void visitBefore(Object *Obj, size_t /*Slot*/) override {
     resolveReference(Obj);
-    visitChildren(Obj);
   }
 
   // Get an Object's referenced Object, handling any type specifics.
   static Object *getObjectReference(Object *Obj) {
-    if (auto Scp = dynamic_cast<Scope *>(Obj))
+    if (auto Scp = dyn_cast<Scope>(Obj))
       return Scp->getReference();
-    if (auto Sym = dynamic_cast<Symbol *>(Obj))
+    if (auto Sym = dyn_cast<Symbol>(Obj))
       return Sym->getReference();
     return nullptr;
   }
@@ -309,13 +385,13 @@ private:
 
     // Set type.
     if (Reference->getType()) {
-      dynamic_cast<Element *>(Obj)->setType(Reference->getType());
+      cast<Element>(*Obj).setType(Reference->getType());
       Obj->setHasType();
     }
 
     // Cover the static function case that initScopeFromAttrs can't reach.
-    auto ObjFunc = dynamic_cast<ScopeFunction *>(Obj);
-    auto RefFunc = dynamic_cast<ScopeFunction *>(Reference);
+    auto ObjFunc = dyn_cast<ScopeFunction>(Obj);
+    auto RefFunc = dyn_cast<ScopeFunction>(Reference);
     if (ObjFunc && RefFunc && RefFunc->getIsStatic())
       ObjFunc->setIsStatic();
 
@@ -325,51 +401,138 @@ private:
   }
 };
 
-// Visitor that does any modifications to the CU tree that need to be done after
-// it has been created and the type names and references have been resolved.
-class TreeResolver : public ScopeVisitor {
+// Pass that marks the objects under a global object as global.
+class GlobalPass : public ScopePass {
 public:
-  TreeResolver(Reader &Reader, CmdOptions &Opts)
-      : ReaderInstance(Reader), Options(Opts) {}
+  GlobalPass() : ScopePass("globals") {}
 
 private:
-  void visitImpl(Object *Obj) override {
-    if (Obj->getIsResolved())
+  void visitBefore(Object *Obj, size_t /*Slot*/) override {
+    if (Obj->getParent() && Obj->getParent()->getIsGlobalReference())
+      Obj->setIsGlobalReference();
+  }
+};
+
+// Pass that finds the objects matching the filter patterns and the scopes
+// matching the tree patterns.
+// TODO: Filters should be evaluated while printing.
+class PatternPass : public ScopePass {
+public:
+  PatternPass(ViewSpecification &Spec, std::vector<Object *> &MatchedObjects,
+              std::vector<Scope *> &MatchedScopes)
+      : ScopePass("patterns"), Spec(Spec), MatchedObjects(MatchedObjects),
+        MatchedScopes(MatchedScopes) {}
+
+private:
+  void begin(size_t Slots) override {
+    SlotObjects.assign(Slots, std::vector<Object *>());
+    SlotScopes.assign(Slots, std::vector<Scope *>());
+  }
+
+  void visitBefore(Object *Obj, size_t Slot) override {
+    if (!Obj->isNamed())
       return;
-    Obj->setIsResolved();
+    if (Spec.getAnyFilterPattern() && Spec.matchFilterPattern(Obj->getNameIndex()))
+      SlotObjects[Slot].push_back(Obj);
+    if (auto Scp = dyn_cast<Scope>(Obj))
+      if (Spec.getAnyTreePattern() && Spec.matchTreePattern(Scp->getNameIndex()))
+        SlotScopes[Slot].push_back(Scp);
+  }
 
-    // Resolve any filters.
-    // TODO: Filters should be evaluated while printing.
-    ReaderInstance.resolveFilterPatternMatch(Obj);
-    if (auto Scp = dynamic_cast<Scope *>(Obj))
-      ReaderInstance.resolveTreePatternMatch(Scp);
+  // The root is visited first, so the matches are kept in tree order.
+  void end() override {
+    for (const auto &Objects : SlotObjects)
+      MatchedObjects.insert(MatchedObjects.end(), Objects.begin(),
+                            Objects.end());
+    for (const auto &Scopes : SlotScopes)
+      MatchedScopes.insert(MatchedScopes.end(), Scopes.begin(), Scopes.end());
+  }
 
-    // If the parent is global then mark this as global.
-    if (Obj->getParent() && Obj->getParent()->getIsGlobalReference())
-      Obj->setIsGlobalReference();
+  ViewSpecification &Spec;
+  std::vector<Object *> &MatchedObjects;
+  std::vector<Scope *> &MatchedScopes;
+  std::vector<std::vector<Object *>> SlotObjects;
+  std::vector<std::vector<Scope *>> SlotScopes;
+};
 
-    visitChildren(Obj);
+// Pass that encodes the template arguments in the names of templates. These
+// are read from the template parameters' types.
+class TemplatePass : public ScopePass {
+public:
+  TemplatePass() : ScopePass("templates") {}
 
-    // Template name resolution.
-    if (auto *ObjScope = dynamic_cast<Scope *>(Obj))
-      if (Options.getFormatTemplatesEncoded() && ObjScope->getIsTemplate())
+private:
+  void visitAfter(Object *Obj, size_t /*Slot*/) override {
+    if (auto *ObjScope = dyn_cast<Scope>(Obj))
+      if (ObjScope->getIsTemplate())
         ObjScope->setName(
             ObjScope->encodeTemplateArguments(/*qualify_base=*/false).c_str());
   }
+};
+
+// Pass that sorts the children of each scope. The names are ranked when the
+// traversal begins, after the passes that set them.
+class SortPass : public ScopePass {
+public:
+  SortPass(SortMode Mode) : ScopePass("sort"), Mode(Mode) {}
+
+private:
+  void begin(size_t /*Slots*/) override {
+    Sorter.reset(new ObjectSorter(Mode));
+  }
 
-  Reader &ReaderInstance;
-  const CmdOptions &Options;
+  void visitAfter(Object *Obj, size_t /*Slot*/) override {
+    if (auto Scp = dyn_cast<Scope>(Obj))
+      Scp->sortChildren(*Sorter);
+  }
+
+  void end() override { Sorter.reset(); }
+
+  SortMode Mode;
+  std::unique_ptr<ObjectSorter> Sorter;
 };
 } // namespace
 
 void Reader::postCreationActions() {
   assert(Scopes);
 
-  NameResolver().visit(Scopes);
-  ReferenceAttributeResolver().visit(Scopes);
-  TreeResolver(*this, getOptions()).visit(Scopes);
-
-  Scopes->sortScopes();
+  // The type names are created first, as the other passes read the names of
+  // the types they follow. The template arguments are read from the types
+  // of the parameters, and so are encoded once all the names are set and
+  // before any scope's children are sorted.
+  ContentFlagsPass ContentFlags;
+  NamePass Names;
+  GlobalPass Globals;
+  ReferencePass References;
+  References.addDependency(Names, dk_tree);
+  PatternPass Patterns(Spec, ViewMatchedObjects, ViewMatchedScopes);
+  Patterns.addDependency(Names, dk_tree);
+  Patterns.addDependency(References, dk_object);
+  TemplatePass Templates;
+  Templates.addDependency(References, dk_tree);
+  Templates.addDependency(Patterns, dk_object);
+  SortPass Sort(getViewSortMode());
+  Sort.addDependency(Names, dk_tree);
+  Sort.addDependency(References, dk_object);
+  Sort.addDependency(Templates, dk_tree);
+
+  ScopePipeline Pipeline;
+  Pipeline.addPass(ContentFlags);
+  Pipeline.addPass(Names);
+  Pipeline.addPass(Globals);
+  Pipeline.addPass(References);
+  if (Spec.getAnyFilterPattern() || Spec.getAnyTreePattern())
+    Pipeline.addPass(Patterns);
+  if (getOptions().getFormatTemplatesEncoded())
+    Pipeline.addPass(Templates);
+  if (getViewSortMode() != sr_none)
+    Pipeline.addPass(Sort);
+
+  for (const auto &Link : CrossUnitLinks)
+    Pipeline.addLink(Link.first, Link.second);
+  CrossUnitLinks.clear();
+
+  Pipeline.run(*Scopes, getJobCount());
 }
 
 void Reader::propagatePatternMatch() {
@@ -385,7 +548,7 @@ void Reader::propagatePatternMatch() {
 void Reader::resolveTreePatternMatch(Scope *Scp) {
   ViewSpecification *ViewSpec = getReader()->getSpecification();
   if (ViewSpec->getAnyTreePattern()) {
-    if (Scp->isNamed() && ViewSpec->matchTreePattern(Scp->getName())) {
+    if (Scp->isNamed() && ViewSpec->matchTreePattern(Scp->getNameIndex())) {
       ViewMatchedScopes.push_back(Scp);
     }
   }
@@ -394,7 +557,8 @@ void Reader::resolveTreePatternMatch(Scope *Scp) {
 void Reader::resolveFilterPatternMatch(Object *Object) {
   ViewSpecification *ViewSpec = getReader()->getSpecification();
   if (ViewSpec->getAnyFilterPattern()) {
-    if (Object->isNamed() && ViewSpec->matchFilterPattern(Object->getName())) {
+    if (Object->isNamed() &&
+        ViewSpec->matchFilterPattern(Object->getNameIndex())) {
       ViewMatchedObjects.push_back(Object);
     }
   }
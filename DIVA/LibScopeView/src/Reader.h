@@ -30,6 +30,7 @@
 #ifndef READER_H
 #define READER_H
 
+#include "ObjectArena.h"
 #include "Scope.h"
 #include "SummaryTable.h"
 #include "ViewSpecification.h"
@@ -37,6 +38,7 @@
 namespace LibScopeView {
 
 class Scope;
+class ScopePrinter;
 class ViewSpecification;
 
 /// \brief Representation for a generic reader.
@@ -52,9 +54,13 @@ public:
   Reader(ViewSpecification *Spec);
 
   virtual bool loadFile(const char *FileName);
-  virtual void print();
 
-  virtual ~Reader() { delete Scopes; }
+  /// \brief Print the logical view as text, along with the views of the
+  /// given printers in the same walk over the tree. The printers print to the
+  /// output set on each of them.
+  virtual void print(const std::vector<ScopePrinter *> &Printers = {});
+
+  virtual ~Reader() { destroyScopes(); }
 
 private:
   // TODO: Make pure virtual but all the tests currently have to instantiate a
@@ -64,9 +70,38 @@ private:
 
   void postCreationActions();
 
+public:
+  /// \brief Read the line records of a compile unit that were left pending.
+  ///
+  /// Called the first time the compile unit's LineTable is asked for. Readers
+  /// that leave line records pending must implement this.
+  virtual void loadLineTable(ScopeCompileUnit &CU);
+
+  /// \brief If the view prints or counts the line records, in which case they
+  /// should be read with the rest of the objects rather than left pending.
+  bool getLinesNeeded();
+
+  /// \brief If the reader should only create the objects that may match the
+  /// --filter or --tree patterns, and those the matches need to be printed.
+  bool getPatternPushdown();
+
+  /// \brief If the reader should only create the objects of the kinds the
+  /// view prints, and those they need, such as their parents and types.
+  bool getKindPruning();
+
+  /// \brief The number of threads used to process and print the compile
+  /// units.
+  unsigned getJobCount();
+
+private:
+
+  // Release the scope tree. Objects from the arena are all released together.
   void destroyScopes() {
-    delete Scopes;
+    if (Scopes && !Scopes->getIsArenaAllocated())
+      delete Scopes;
     Scopes = nullptr;
+    Arena.clear();
+    CrossUnitLinks.clear();
   }
 
   void setInputFile(const char *Name) { Spec.setInputFile(Name); }
@@ -76,6 +111,9 @@ protected:
 
   Scope *Scopes;
 
+  // Owns the objects created by the reader.
+  ObjectArena Arena;
+
   // A header has been printed.
   bool PrintedHeader;
 
@@ -84,8 +122,8 @@ private:
   SummaryTable TheSummaryTable;
 
 public:
-  void incrementFound(const Object *Obj) {
-    TheSummaryTable.incrementFound(Obj);
+  void incrementFound(const Object *Obj, uint32_t Count = 1) {
+    TheSummaryTable.incrementFound(Obj, Count);
   }
   void incrementAdded(const Object *Obj) {
     TheSummaryTable.incrementAdded(Obj);
@@ -108,9 +146,22 @@ protected:
 
 protected:
   virtual void printObjects();
-  virtual void printScopes();
+  virtual void printScopes(const std::vector<ScopePrinter *> &Printers);
   virtual void printSummary();
 
+private:
+  // Pairs of objects under different compile units, where one has a type or
+  // reference to the other.
+  std::vector<std::pair<Object *, Object *>> CrossUnitLinks;
+
+protected:
+  /// \brief Record that Obj has a type or reference to Target in another
+  /// compile unit. Readers must record every such link, so that the
+  /// post-creation passes keep the compile units on the same thread.
+  void addCrossUnitLink(Object *Obj, Object *Target) {
+    CrossUnitLinks.emplace_back(Obj, Target);
+  }
+
 public:
   void propagatePatternMatch();
   void resolveTreePatternMatch(Scope *scope);
@@ -135,6 +186,9 @@ public:
   // Access to the scopes root.
   Scope *getScopesRoot() const { return Scopes; }
 
+  // Access to the objects created by the reader.
+  const ObjectArena &getArena() const { return Arena; }
+
   // Execute the required actions on the reader.
   bool executeActions();
 
@@ -36,35 +36,46 @@
 #include "Symbol.h"
 #include "Type.h"
 
-#include <sstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 
 using namespace LibScopeView;
 
 struct LogFunction {
   LogFunction(std::string f) : f_(f) {
-    if (getReader()->getOptions().getTraceVerbose())
+    if (getReader()->getOptions().getTraceVerbose()) {
+      getPrintContext()->flush();
       printf(">%s\n", f_.c_str());
+    }
   }
   ~LogFunction() {
-    if (getReader()->getOptions().getTraceVerbose())
+    if (getReader()->getOptions().getTraceVerbose()) {
+      getPrintContext()->flush();
       printf("<%s\n", f_.c_str());
+    }
   }
   std::string f_;
 };
 
 Scope::Scope(LevelType Lvl) : Element(Lvl) {
   setIsScope();
+  setKind(ok_scope);
 
   Scope::setTag();
 }
 
 Scope::Scope() : Element() {
   setIsScope();
+  setKind(ok_scope);
 
   Scope::setTag();
 }
 
 Scope::~Scope() {
+  // The children of a Scope in an ObjectArena are destroyed by the arena.
+  if (getIsArenaAllocated())
+    return;
   for (Type *Ty : TheTypes)
     delete (Ty);
   for (Symbol *Sym : TheSymbols)
@@ -75,12 +86,13 @@ Scope::~Scope() {
     delete (Ln);
 }
 
-uint32_t Scope::ScopesAllocated = 0;
+std::atomic<uint32_t> Scope::ScopesAllocated(0);
 
 void Scope::setTag() {
-  ++Scope::ScopesAllocated;
 #ifndef NDEBUG
-  Tag = Scope::ScopesAllocated;
+  Tag = ++Scope::ScopesAllocated;
+#else
+  ++Scope::ScopesAllocated;
 #endif
 }
 
@@ -163,13 +175,27 @@ void Scope::addObject(Line *Ln) {
     // m_children->push_back(line);
 
     // Indicate that this tree branch has lines.
-    traverse(&Scope::getHasLines, &Scope::setHasLines, /*down=*/false);
+    setHasLines();
   } else {
     throw std::logic_error("Cannot set line records on a scope that's not a "
                            "function or module.\n");
   }
 }
 
+void Scope::forEachLine(const std::function<void(Line *)> &Func) {
+  for (Line *Ln : TheLines)
+    Func(Ln);
+
+  const LineTable *Table = getLineTable();
+  Line *View = getLineTableView();
+  if (!Table || !View)
+    return;
+  for (size_t Row = 0; Row < Table->size(); ++Row) {
+    View->setRow(Row);
+    Func(View);
+  }
+}
+
 void Scope::addObject(Scope *Scp) {
   // Add it to parent.
   TheScopes.push_back(Scp);
@@ -182,14 +208,13 @@ void Scope::addObject(Scope *Scp) {
   // If the object is a global reference, mark its parent as having global
   // references; that information is used, to print only those branches
   // with global references.
-  if (Scp->getIsGlobalReference()) {
-    traverse(&Scope::getHasGlobals, &Scope::setHasGlobals, /*down=*/false);
-  } else {
-    traverse(&Scope::getHasLocals, &Scope::setHasLocals, /*down=*/false);
-  }
+  if (Scp->getIsGlobalReference())
+    setHasGlobals();
+  else
+    setHasLocals();
 
   // Indicate that this tree branch has scopes.
-  traverse(&Scope::getHasScopes, &Scope::setHasScopes, /*down=*/false);
+  setHasScopes();
 }
 
 void Scope::addObject(Symbol *Sym) {
@@ -204,14 +229,13 @@ void Scope::addObject(Symbol *Sym) {
   // If the object is a global reference, mark its parent as having global
   // references; that information is used, to print only those branches
   // with global references.
-  if (Sym->getIsGlobalReference()) {
-    traverse(&Scope::getHasGlobals, &Scope::setHasGlobals, /*down=*/false);
-  } else {
-    traverse(&Scope::getHasLocals, &Scope::setHasLocals, /*down=*/false);
-  }
+  if (Sym->getIsGlobalReference())
+    setHasGlobals();
+  else
+    setHasLocals();
 
   // Indicate that this tree branch has symbols.
-  traverse(&Scope::getHasSymbols, &Scope::setHasSymbols, /*down=*/false);
+  setHasSymbols();
 }
 
 void Scope::addObject(Type *Ty) {
@@ -226,14 +250,13 @@ void Scope::addObject(Type *Ty) {
   // If the object is a global reference, mark its parent as having global
   // references; that information is used, to print only those branches
   // with global references.
-  if (Ty->getIsGlobalReference()) {
-    traverse(&Scope::getHasGlobals, &Scope::setHasGlobals, /*down=*/false);
-  } else {
-    traverse(&Scope::getHasLocals, &Scope::setHasLocals, /*down=*/false);
-  }
+  if (Ty->getIsGlobalReference())
+    setHasGlobals();
+  else
+    setHasLocals();
 
   // Indicate that this tree branch has types.
-  traverse(&Scope::getHasTypes, &Scope::setHasTypes, /*down=*/false);
+  setHasTypes();
 }
 
 void Scope::getQualifiedName(std::string &qualified_name) const {
@@ -362,25 +385,37 @@ std::string Scope::encodeTemplateArguments(bool qualify_base) {
 void Scope::sortScopes() {
   LogFunction Log(__FUNCTION__);
 
-  // Get the sorting callback function.
-  SortFunction SortFunc = getSortFunction();
-  if (SortFunc) {
-    sortScopes(SortFunc);
+  // Get the sorting mode.
+  SortMode Mode = getViewSortMode();
+  if (Mode != sr_none) {
+    sortScopes(ObjectSorter(Mode));
   }
 }
 
-void Scope::sortScopes(SortFunction SortFunc) {
-  // Sort the contained objects, using the associated line.
-  std::sort(TheTypes.begin(), TheTypes.end(), SortFunc);
-  std::sort(TheSymbols.begin(), TheSymbols.end(), SortFunc);
-  std::sort(TheScopes.begin(), TheScopes.end(), SortFunc);
-
-  // Sort the contained objects, using the associated line.
-  std::sort(Children.begin(), Children.end(), SortFunc);
+void Scope::sortScopes(const ObjectSorter &Sorter) {
+  sortChildren(Sorter);
 
   // Scopes.
   for (Scope *Scp : TheScopes)
-    Scp->sortScopes(SortFunc);
+    Scp->sortScopes(Sorter);
+}
+
+void Scope::sortChildren(const ObjectSorter &Sorter) {
+  // Sort the contained objects, using the sort criteria.
+  Sorter.sort(Children);
+
+  // The lists of each kind are taken from the sorted children.
+  TheTypes.clear();
+  TheSymbols.clear();
+  TheScopes.clear();
+  for (Object *Child : Children) {
+    if (auto Ty = dyn_cast<Type>(Child))
+      TheTypes.push_back(Ty);
+    else if (auto Sym = dyn_cast<Symbol>(Child))
+      TheSymbols.push_back(Sym);
+    else
+      TheScopes.push_back(&cast<Scope>(*Child));
+  }
 }
 
 void Scope::sortCompileUnits() {
@@ -394,24 +429,27 @@ void Scope::sortCompileUnits() {
   }
 }
 
-void Scope::traverse(ScopeGetFunction GetFunc, ScopeSetFunction SetFunc,
-                     bool down) {
-  // First traverse the parent tree.
-  Scope *parent = this;
-  while (parent) {
-    // Terminates if the 'set_function' has already been executed.
-    if ((parent->*GetFunc)()) {
-      break;
-    }
-    (parent->*SetFunc)();
-    parent = parent->getParent();
-  }
-  // If requested, traverse the children tree.
-  if (down) {
-    // Traverse(get_function,set_function);
+void Scope::propagateContentFlags() {
+  for (Scope *Scp : TheScopes) {
+    Scp->propagateContentFlags();
+    addContentFlags(*Scp);
   }
 }
 
+void Scope::addContentFlags(const Scope &Child) {
+  // The flags describing what a Scope's tree contains.
+  static const std::bitset<ScopeAttributesSize> ContentFlags =
+      std::bitset<ScopeAttributesSize>()
+          .set(HasGlobals)
+          .set(HasLocals)
+          .set(HasLines)
+          .set(HasScopes)
+          .set(HasSymbols)
+          .set(HasTypes);
+
+  ScopeAttributesFlags |= Child.ScopeAttributesFlags & ContentFlags;
+}
+
 void Scope::traverse(ObjGetFunction GetFunc, ObjSetFunction SetFunc,
                      bool down) {
   // First traverse the parent tree.
@@ -441,9 +479,11 @@ void Scope::traverse(ObjGetFunction GetFunc, ObjSetFunction SetFunc) {
   for (Symbol *Sym : TheSymbols)
     (Sym->*SetFunc)();
 
-  // Line records.
+  // Line records. The rows of a line table share the flags of its view.
   for (Line *Ln : TheLines)
     (Ln->*SetFunc)();
+  if (Line *View = getLineTableView())
+    (View->*SetFunc)();
 
   // Scopes.
   for (Scope *Scp : TheScopes)
@@ -485,52 +525,6 @@ bool Scope::resolvePrinting() {
   return DoPrint;
 }
 
-void Scope::print(bool SplitCU, bool Match, bool IsNull) {
-  LogFunction Log(__FUNCTION__);
-
-  // If 'split_cu', we use the scope name (CU name) as the ouput file.
-  if (SplitCU && getIsCompileUnit()) {
-    std::string OutFilePath(GlobalPrintContext->getLocation() +
-                            flattenFilePath(getName()) + ".txt");
-
-    // Open print context.
-    if (!GlobalPrintContext->open(OutFilePath)) {
-      fatalError(LibScopeError::ErrorCode::ERR_SPLIT_UNABLE_TO_OPEN_FILE,
-                 OutFilePath);
-    }
-  }
-
-  // Check conditions such as local, global, etc.
-  bool DoPrint = resolvePrinting();
-
-  // Don't print in quiet mode unless splitting output.
-  DoPrint = DoPrint && (!getReader()->getOptions().getTraceQuiet() ||
-                        getReader()->getOptions().getViewSplit());
-
-  if (DoPrint) {
-    // Dump the object itself.
-    dump();
-    // Dump the children.
-    for (Object *Obj : Children) {
-      if (Match && !Obj->getHasPattern())
-        continue;
-      Obj->print(SplitCU, Match, IsNull);
-    }
-    // Dump the line records.
-    for (Line *Ln : TheLines) {
-      if (Match && !Ln->getHasPattern())
-        continue;
-      Ln->print(SplitCU, Match, IsNull);
-    }
-  }
-
-  // Restore the original output context.
-  if (SplitCU && getIsCompileUnit()) {
-    // Close the print context.
-    GlobalPrintContext->close();
-  }
-}
-
 const char *Scope::resolveName() {
   LogFunction Log(__FUNCTION__);
 
@@ -560,14 +554,12 @@ void Scope::dump() {
 }
 
 void Scope::dumpExtra() {
-  std::string Text = getAsText();
-  if (!Text.empty())
-    GlobalPrintContext->print("%s\n", Text.c_str());
+  getPrintContext()->printText(*this);
 }
 
 bool Scope::dump(bool DoHeader, const char *Header) {
   if (DoHeader) {
-    GlobalPrintContext->print("\n%s\n", Header);
+    getPrintContext()->print("\n%s\n", Header);
     DoHeader = false;
   }
 
@@ -577,132 +569,177 @@ bool Scope::dump(bool DoHeader, const char *Header) {
   return DoHeader;
 }
 
-std::string Scope::getAsText() const {
-  std::stringstream Result;
+void Scope::appendText(TextBuffer &Text) const {
   if (getIsBlock()) {
-    Result << '{' << getKindAsString() << '}';
+    Text.append('{');
+    Text.append(getKindAsString());
+    Text.append('}');
     if (getReader()->getOptions().getPrintBlockAttributes()) {
       if (getIsTryBlock())
-        Result << '\n' << getAttributeInfoAsText("try");
+        appendAttributeInfo(Text, "try");
       else if (getIsCatchBlock())
-        Result << '\n' << getAttributeInfoAsText("catch");
+        appendAttributeInfo(Text, "catch");
     }
   }
-  return Result.str();
 }
 
-std::string Scope::getAsYAML() const {
+void Scope::appendYAML(TextBuffer &YAML) const {
   if (getIsBlock()) {
-    std::stringstream YAML;
-    YAML << getCommonYAML() << "\nattributes:"
-         << "\n  try: " << (getIsTryBlock() ? "true" : "false")
-         << "\n  catch: " << (getIsCatchBlock() ? "true" : "false");
-    return YAML.str();
+    appendCommonYAML(YAML);
+    YAML.append("\nattributes:\n  try: ");
+    YAML.append(getIsTryBlock() ? "true" : "false");
+    YAML.append("\n  catch: ");
+    YAML.append(getIsCatchBlock() ? "true" : "false");
   }
-  return "";
 }
 
 ScopeAggregate::ScopeAggregate(LevelType Lvl)
     : Scope(Lvl) {
+  setKind(ok_scope_aggregate);
   Reference = nullptr;
 }
 
-ScopeAggregate::ScopeAggregate() : Scope() { Reference = nullptr; }
+ScopeAggregate::ScopeAggregate() : Scope() {
+  setKind(ok_scope_aggregate);
+  Reference = nullptr;
+}
 
 ScopeAggregate::~ScopeAggregate() {}
 
-std::string ScopeAggregate::getAsText() const {
-  std::string Result;
+void ScopeAggregate::appendText(TextBuffer &Text) const {
   const char *Name = getName();
-  Result = "{";
-  Result += getKindAsString();
-  Result += "} \"";
+  Text.append('{');
+  Text.append(getKindAsString());
+  Text.append("} \"");
   if (Name != nullptr)
-    Result += Name;
-  Result += '"';
+    Text.append(Name);
+  Text.append('"');
 
-  if (getIsTemplate()) {
-    Result += '\n';
-    Result += getAttributeInfoAsText("Template");
-  }
-
-  return Result;
+  if (getIsTemplate())
+    appendAttributeInfo(Text, "Template");
 }
 
-std::string ScopeAggregate::getAsYAML() const {
-  std::stringstream Result;
-
-  Result << getCommonYAML();
-  Result << "\nattributes:\n  is_template: "
-         << (getIsTemplate() ? "true" : "false");
+void ScopeAggregate::appendYAML(TextBuffer &YAML) const {
+  appendCommonYAML(YAML);
+  YAML.append("\nattributes:\n  is_template: ");
+  YAML.append(getIsTemplate() ? "true" : "false");
 
   // If we're getting YAML for a Union. then we can't have any inheritance
   // attributes.
   if (getIsUnionType())
-    return Result.str();
+    return;
 
-  Result << "\n  inherits_from:";
+  YAML.append("\n  inherits_from:");
 
   bool hasInheritance = false;
   for (auto type : TheTypes) {
     if (type->getIsInheritance()) {
       hasInheritance = true;
-      Result << "\n" << static_cast<TypeImport *>(type)->getAsYAML();
+      YAML.append('\n');
+      static_cast<TypeImport *>(type)->appendYAML(YAML);
     }
   }
 
   if (!hasInheritance)
-    Result << " []";
-
-  return Result.str();
+    YAML.append(" []");
 }
 
-ScopeAlias::ScopeAlias(LevelType Lvl) : Scope(Lvl) {}
+ScopeAlias::ScopeAlias(LevelType Lvl) : Scope(Lvl) { setKind(ok_scope_alias); }
 
-ScopeAlias::ScopeAlias() : Scope() {}
+ScopeAlias::ScopeAlias() : Scope() { setKind(ok_scope_alias); }
 
 ScopeAlias::~ScopeAlias() {}
 
 void ScopeAlias::dumpExtra() {
-  GlobalPrintContext->print("%s\n", getAsText().c_str());
+  getPrintContext()->printText(*this);
 }
 
-std::string ScopeAlias::getAsText() const {
-  std::stringstream Result;
-  Result << "{" << getKindAsString() << "} \"" << getName() << "\" -> "
-         << getTypeDieOffsetAsString() << '"' << getTypeQualifiedName()
-         << getTypeAsString() << '"';
-  return Result.str();
+void ScopeAlias::appendText(TextBuffer &Text) const {
+  Text.append('{');
+  Text.append(getKindAsString());
+  Text.append("} \"");
+  Text.append(getName());
+  Text.append("\" -> ");
+  appendTypeDieOffset(Text);
+  Text.append('"');
+  Text.append(getTypeQualifiedName());
+  Text.append(getTypeAsString());
+  Text.append('"');
 }
 
-std::string ScopeAlias::getAsYAML() const {
-  return getCommonYAML() + std::string("\nattributes: {}");
+void ScopeAlias::appendYAML(TextBuffer &YAML) const {
+  appendCommonYAML(YAML);
+  YAML.append("\nattributes: {}");
 }
 
-ScopeArray::ScopeArray(LevelType Lvl) : Scope(Lvl) {}
+ScopeArray::ScopeArray(LevelType Lvl) : Scope(Lvl) { setKind(ok_scope_array); }
 
-ScopeArray::ScopeArray() : Scope() {}
+ScopeArray::ScopeArray() : Scope() { setKind(ok_scope_array); }
 
 ScopeArray::~ScopeArray() {}
 
 void ScopeArray::dumpExtra() {
-  GlobalPrintContext->print("%s\n", getAsText().c_str());
+  getPrintContext()->printText(*this);
 }
 
-std::string ScopeArray::getAsText() const {
-  std::stringstream Result;
-  Result << "{" << getKindAsString() << "} " << getTypeDieOffsetAsString()
-         << '"' << getName() << '"';
-  return Result.str();
+void ScopeArray::appendText(TextBuffer &Text) const {
+  Text.append('{');
+  Text.append(getKindAsString());
+  Text.append("} ");
+  appendTypeDieOffset(Text);
+  Text.append('"');
+  Text.append(getName());
+  Text.append('"');
 }
 
 ScopeCompileUnit::ScopeCompileUnit(LevelType Lvl)
-    : Scope(Lvl) {}
+    : Scope(Lvl), PendingLineReader(nullptr) { setKind(ok_scope_compile_unit); }
 
-ScopeCompileUnit::ScopeCompileUnit() : Scope() {}
+ScopeCompileUnit::ScopeCompileUnit() : Scope(), PendingLineReader(nullptr) {
+  setKind(ok_scope_compile_unit);
+}
 
 ScopeCompileUnit::~ScopeCompileUnit() {}
 
+const LineTable *ScopeCompileUnit::getLineTable() const {
+  if (PendingLineReader)
+    PendingLineReader->loadLineTable(const_cast<ScopeCompileUnit &>(*this));
+  return &TheLineTable;
+}
+
+void ScopeCompileUnit::setLineTablePending(Reader &LineReader) {
+  PendingLineReader = &LineReader;
+
+  // The view is created now, so it gets any flags set on the rows before
+  // they are read.
+  createLineTableView();
+
+  // Indicate that this tree branch has lines.
+  setHasLines();
+}
+
+void ScopeCompileUnit::setLineTable(LineTable &&Table) {
+  PendingLineReader = nullptr;
+  TheLineTable = std::move(Table);
+  if (TheLineTable.empty())
+    return;
+
+  createLineTableView();
+
+  // Update Object Summary Table, all the rows are the same kind of line.
+  getReader()->incrementFound(LineTableView.get(), TheLineTable.size());
+
+  // Indicate that this tree branch has lines.
+  setHasLines();
+}
+
+void ScopeCompileUnit::createLineTableView() {
+  if (LineTableView)
+    return;
+  LineTableView.reset(new Line(getLevel() + 1, TheLineTable));
+  LineTableView->setParent(this);
+}
+
 void ScopeCompileUnit::setName(const char *Name) {
   std::string Path = unifyFilePath(Name);
   Scope::setName(Path.c_str());
@@ -711,199 +748,203 @@ void ScopeCompileUnit::setName(const char *Name) {
 void ScopeCompileUnit::dump() {
   // An extra line to improve readibility.
   if (getReader()->getSpecification()->printObject(this)) {
-    GlobalPrintContext->print("\n");
+    getPrintContext()->print("\n");
   }
   Scope::dump();
 }
 
 void ScopeCompileUnit::dumpExtra() {
-  GlobalPrintContext->print("%s\n", getAsText().c_str());
+  getPrintContext()->printText(*this);
   resetFileIndex();
 }
 
-std::string ScopeCompileUnit::getAsText() const {
-  std::string ObjectAsText;
-  ObjectAsText.append("{").append(getKindAsString()).append("}");
-  ObjectAsText.append(" \"").append(getName()).append("\"");
-
-  return ObjectAsText;
+void ScopeCompileUnit::appendText(TextBuffer &Text) const {
+  Text.append('{');
+  Text.append(getKindAsString());
+  Text.append("} \"");
+  Text.append(getName());
+  Text.append('"');
 }
 
-std::string ScopeCompileUnit::getAsYAML() const {
-  return getCommonYAML() + std::string("\nattributes: {}");
+void ScopeCompileUnit::appendYAML(TextBuffer &YAML) const {
+  appendCommonYAML(YAML);
+  YAML.append("\nattributes: {}");
 }
 
 ScopeEnumeration::ScopeEnumeration(LevelType Lvl)
-    : Scope(Lvl), IsClass(false) {}
+    : Scope(Lvl), IsClass(false) { setKind(ok_scope_enumeration); }
 
-ScopeEnumeration::ScopeEnumeration() : Scope(), IsClass(false) {}
+ScopeEnumeration::ScopeEnumeration() : Scope(), IsClass(false) {
+  setKind(ok_scope_enumeration);
+}
 
 ScopeEnumeration::~ScopeEnumeration() {}
 
 void ScopeEnumeration::dumpExtra() {
   // Print the full type name.
-  GlobalPrintContext->print("%s\n", getAsText().c_str());
+  getPrintContext()->printText(*this);
 }
 
-std::string ScopeEnumeration::getAsText() const {
-  std::string ObjectAsText;
-  std::string Name = getName();
+void ScopeEnumeration::appendText(TextBuffer &Text) const {
+  const char *Name = getName();
 
-  ObjectAsText.append("{").append(getKindAsString()).append("}");
+  Text.append('{');
+  Text.append(getKindAsString());
+  Text.append('}');
 
   if (getIsClass())
-    ObjectAsText.append(" ").append("class");
+    Text.append(" class");
 
-  ObjectAsText.append(" \"").append(Name).append("\"");
+  Text.append(" \"");
+  Text.append(Name);
+  Text.append('"');
 
-  if (getType() && Name != getType()->getName())
-    ObjectAsText.append(" -> \"").append(getType()->getName()).append("\"");
-
-  return ObjectAsText;
+  if (getType() && strcmp(Name, getType()->getName()) != 0) {
+    Text.append(" -> \"");
+    Text.append(getType()->getName());
+    Text.append('"');
+  }
 }
 
-std::string ScopeEnumeration::getAsYAML() const {
-  std::stringstream YAML;
-  YAML << getCommonYAML() << "\nattributes:"
-       << "\n  class: " << (getIsClass() ? "true" : "false")
-       << "\n  enumerators:";
+void ScopeEnumeration::appendYAML(TextBuffer &YAML) const {
+  appendCommonYAML(YAML);
+  YAML.append("\nattributes:\n  class: ");
+  YAML.append(getIsClass() ? "true" : "false");
+  YAML.append("\n  enumerators:");
 
-  std::stringstream Enumerators;
+  bool HasEnumerators = false;
   for (auto *Child : getChildren()) {
     if (!(Child->getIsType() &&
           static_cast<const Type *>(Child)->getIsEnumerator()))
       // TODO: Raise a warning here?
       continue;
     auto *ChildEnumerator = static_cast<TypeEnumerator *>(Child);
-    Enumerators << "\n    - enumerator: \"" << ChildEnumerator->getName()
-                << "\"\n      value: " << ChildEnumerator->getValue();
+    HasEnumerators = true;
+    YAML.append("\n    - enumerator: \"");
+    YAML.append(ChildEnumerator->getName());
+    YAML.append("\"\n      value: ");
+    YAML.append(ChildEnumerator->getValue());
   }
 
-  if (Enumerators.str().empty())
-    YAML << " []";
-  else
-    YAML << Enumerators.str();
-
-  return YAML.str();
+  if (!HasEnumerators)
+    YAML.append(" []");
 }
 
 ScopeFunction::ScopeFunction(LevelType Lvl)
     : Scope(Lvl), IsStatic(false), DeclaredInline(false),
       IsDeclaration(false) {
+  setKind(ok_scope_function);
   Reference = nullptr;
 }
 
 ScopeFunction::ScopeFunction()
     : Scope(), IsStatic(false), DeclaredInline(false), IsDeclaration(false) {
+  setKind(ok_scope_function);
   Reference = nullptr;
 }
 
 ScopeFunction::~ScopeFunction() {}
 
 void ScopeFunction::dumpExtra() {
-  GlobalPrintContext->print("%s\n", getAsText().c_str());
+  getPrintContext()->printText(*this);
 }
 
-std::string ScopeFunction::getAsText() const {
-  std::string Result = "{";
-  Result += getKindAsString();
-  Result += "}";
+void ScopeFunction::appendText(TextBuffer &Text) const {
+  Text.append('{');
+  Text.append(getKindAsString());
+  Text.append('}');
 
   if (getIsStatic())
-    Result += " static";
+    Text.append(" static");
   if (getIsDeclaredInline())
-    Result += " inline";
+    Text.append(" inline");
 
-  std::string Name;
-  if (getReader()->getOptions().getFormatQualifiedName())
+  Text.append(" \"");
+  if (getReader()->getOptions().getFormatQualifiedName()) {
+    std::string Name;
     getQualifiedName(Name);
-  else
-    Name = getName();
-
-  Result += " \"";
-  Result += Name;
-  Result += "\"";
-  Result += getDiscriminatorAsString();
-  Result += " -> ";
-  Result += getDieOffsetAsString();
-  Result += "\"";
-  Result += getTypeQualifiedName();
-  Result += getTypeAsString();
-  Result += "\"";
+    Text.append(Name);
+  } else {
+    Text.append(getName());
+  }
+  Text.append('"');
+  Text.append(getDiscriminatorAsString());
+  Text.append(" -> ");
+  appendDieOffset(Text);
+  Text.append('"');
+  Text.append(getTypeQualifiedName());
+  Text.append(getTypeAsString());
+  Text.append('"');
 
   // Attributes.
   if (Reference && Reference->getIsFunction()) {
-    Result += '\n';
-    Result += getAttributeInfoAsText("Declaration @ ");
+    appendAttributeInfo(Text, "Declaration @ ");
     // Cast to element as Scope has a different overload (not override) of
     // getFileName that returns nothing.
     if (!Reference->getInvalidFileName())
-      Result += static_cast<LibScopeView::Element *>(Reference)->getFileName(
-          /*format_options*/ true);
+      Text.append(static_cast<LibScopeView::Element *>(Reference)->getFileName(
+          /*format_options*/ true));
     else
-      Result += '?';
-    Result += ',';
-    Result += std::to_string(Reference->getLineNumber());
+      Text.append('?');
+    Text.append(',');
+    Text.appendDecimal(Reference->getLineNumber());
   } else {
-    if (!getIsDeclaration()) {
-      Result += '\n';
-      Result += getAttributeInfoAsText("No declaration");
-    }
+    if (!getIsDeclaration())
+      appendAttributeInfo(Text, "No declaration");
   }
 
-  if (getIsTemplate()) {
-    Result += '\n';
-    Result += getAttributeInfoAsText("Template");
-  }
-  if (getIsInlined()) {
-    Result += '\n';
-    Result += getAttributeInfoAsText("Inlined");
-  }
-  if (getIsDeclaration()) {
-    Result += '\n';
-    Result += getAttributeInfoAsText("Is declaration");
-  }
-
-  return Result;
+  if (getIsTemplate())
+    appendAttributeInfo(Text, "Template");
+  if (getIsInlined())
+    appendAttributeInfo(Text, "Inlined");
+  if (getIsDeclaration())
+    appendAttributeInfo(Text, "Is declaration");
 }
 
-std::string ScopeFunction::getAsYAML() const {
-  std::stringstream YAML;
-  YAML << getCommonYAML() << "\nattributes:\n";
+void ScopeFunction::appendYAML(TextBuffer &YAML) const {
+  appendCommonYAML(YAML);
+  YAML.append("\nattributes:\n");
 
   // Attributes.
-  YAML << "  declaration:\n";
+  YAML.append("  declaration:\n");
   if (Reference && Reference->getIsFunction()) {
     // Cast to element as Scope has a different overload (not override) of
     // getFileName that returns nothing.
-    YAML << "    file: ";
-    if (!Reference->getInvalidFileName())
-      YAML << "\""
-           << static_cast<LibScopeView::Element *>(Reference)->getFileName(
-                  /*format_options*/ true)
-           << "\"";
-    else
-      YAML << "\"?\"";
-    YAML << "\n    line: " << Reference->getLineNumber() << "\n";
+    YAML.append("    file: ");
+    if (!Reference->getInvalidFileName()) {
+      YAML.append('"');
+      YAML.append(static_cast<LibScopeView::Element *>(Reference)->getFileName(
+          /*format_options*/ true));
+      YAML.append('"');
+    } else
+      YAML.append("\"?\"");
+    YAML.append("\n    line: ");
+    YAML.appendDecimal(Reference->getLineNumber());
+    YAML.append('\n');
   } else {
-    YAML << "    file: null\n    line: null\n";
+    YAML.append("    file: null\n    line: null\n");
   }
-  YAML << "  is_template: " << (getIsTemplate() ? "true" : "false") << "\n"
-       << "  static: " << (getIsStatic() ? "true" : "false") << "\n"
-       << "  inline: " << (getIsDeclaredInline() ? "true" : "false") << "\n"
-       << "  is_inlined: " << (getIsInlined() ? "true" : "false") << "\n"
-       << "  is_declaration: " << (getIsDeclaration() ? "true" : "false");
-
-  return YAML.str();
+  YAML.append("  is_template: ");
+  YAML.append(getIsTemplate() ? "true" : "false");
+  YAML.append("\n  static: ");
+  YAML.append(getIsStatic() ? "true" : "false");
+  YAML.append("\n  inline: ");
+  YAML.append(getIsDeclaredInline() ? "true" : "false");
+  YAML.append("\n  is_inlined: ");
+  YAML.append(getIsInlined() ? "true" : "false");
+  YAML.append("\n  is_declaration: ");
+  YAML.append(getIsDeclaration() ? "true" : "false");
 }
 
 ScopeFunctionInlined::ScopeFunctionInlined(LevelType Lvl)
     : ScopeFunction(Lvl), CallLineNumber(0) {
+  setKind(ok_scope_function_inlined);
   Discriminator = 0;
 }
 
 ScopeFunctionInlined::ScopeFunctionInlined()
     : ScopeFunction(), CallLineNumber(0) {
+  setKind(ok_scope_function_inlined);
   Discriminator = 0;
 }
 
@@ -911,60 +952,68 @@ ScopeFunctionInlined::~ScopeFunctionInlined() {}
 
 ScopeNamespace::ScopeNamespace(LevelType Lvl)
     : Scope(Lvl) {
+  setKind(ok_scope_namespace);
   Reference = nullptr;
 }
 
-ScopeNamespace::ScopeNamespace() : Scope() { Reference = nullptr; }
+ScopeNamespace::ScopeNamespace() : Scope() {
+  setKind(ok_scope_namespace);
+  Reference = nullptr;
+}
 
 ScopeNamespace::~ScopeNamespace() {}
 
 void ScopeNamespace::dumpExtra() {
-  GlobalPrintContext->print("%s\n", getAsText().c_str());
+  getPrintContext()->printText(*this);
 }
 
-std::string ScopeNamespace::getAsText() const {
-  std::stringstream Result;
-  Result << '{' << getKindAsString() << '}';
-  std::string Name;
-  if (getReader()->getOptions().getFormatQualifiedName())
-    getQualifiedName(Name);
-  else
-    Name = getName();
-  if (!Name.empty())
-    Result << " \"" << Name << '"';
-  return Result.str();
+void ScopeNamespace::appendText(TextBuffer &Text) const {
+  Text.append('{');
+  Text.append(getKindAsString());
+  Text.append('}');
+  std::string QualifiedName;
+  const char *Name = getName();
+  if (getReader()->getOptions().getFormatQualifiedName()) {
+    getQualifiedName(QualifiedName);
+    Name = QualifiedName.c_str();
+  }
+  if (*Name) {
+    Text.append(" \"");
+    Text.append(Name);
+    Text.append('"');
+  }
 }
 
-std::string ScopeNamespace::getAsYAML() const {
-  return getCommonYAML() + std::string("\nattributes: {}");
+void ScopeNamespace::appendYAML(TextBuffer &YAML) const {
+  appendCommonYAML(YAML);
+  YAML.append("\nattributes: {}");
 }
 
 ScopeTemplatePack::ScopeTemplatePack(LevelType Lvl)
-    : Scope(Lvl) {}
+    : Scope(Lvl) { setKind(ok_scope_template_pack); }
 
-ScopeTemplatePack::ScopeTemplatePack() : Scope() {}
+ScopeTemplatePack::ScopeTemplatePack() : Scope() {
+  setKind(ok_scope_template_pack);
+}
 
 ScopeTemplatePack::~ScopeTemplatePack() {}
 
 void ScopeTemplatePack::dumpExtra() {
   // Print the full type name.
-  GlobalPrintContext->print("%s\n", getAsText().c_str());
+  getPrintContext()->printText(*this);
 }
 
-std::string ScopeTemplatePack::getAsText() const {
-  std::string Result;
-  Result += "{";
-  Result += getKindAsString();
-  Result += "}";
-  Result += " \"";
-  Result += getName();
-  Result += "\"";
-  return Result;
+void ScopeTemplatePack::appendText(TextBuffer &Text) const {
+  Text.append('{');
+  Text.append(getKindAsString());
+  Text.append("} \"");
+  Text.append(getName());
+  Text.append('"');
 }
 
-std::string ScopeTemplatePack::getAsYAML() const {
-  std::stringstream YAML;
-  YAML << getCommonYAML() << "\nattributes:\n  types:";
+void ScopeTemplatePack::appendYAML(TextBuffer &YAML) const {
+  appendCommonYAML(YAML);
+  YAML.append("\nattributes:\n  types:");
 
   auto isTemplate = [](const Object *Obj) -> bool {
     return Obj->getIsType() &&
@@ -972,21 +1021,21 @@ std::string ScopeTemplatePack::getAsYAML() const {
   };
   if (getChildrenCount() == 0 ||
       std::none_of(getChildren().cbegin(), getChildren().cend(), isTemplate)) {
-    YAML << " []";
-    return YAML.str();
+    YAML.append(" []");
+    return;
   }
 
   for (const auto *Child : getChildren()) {
-    if (isTemplate(Child))
-      YAML << "\n    - " << Child->getAsYAML();
+    if (isTemplate(Child)) {
+      YAML.append("\n    - ");
+      Child->appendYAML(YAML);
+    }
   }
-
-  return YAML.str();
 }
 
-ScopeRoot::ScopeRoot(LevelType Lvl) : Scope(Lvl) {}
+ScopeRoot::ScopeRoot(LevelType Lvl) : Scope(Lvl) { setKind(ok_scope_root); }
 
-ScopeRoot::ScopeRoot() : Scope() {}
+ScopeRoot::ScopeRoot() : Scope() { setKind(ok_scope_root); }
 
 ScopeRoot::~ScopeRoot() {}
 
@@ -1002,11 +1051,13 @@ void ScopeRoot::dump() {
 }
 
 void ScopeRoot::dumpExtra() {
-  GlobalPrintContext->print("%s\n", getAsText().c_str());
+  getPrintContext()->printText(*this);
 }
 
-std::string ScopeRoot::getAsText() const {
-  std::stringstream Result;
-  Result << "{" << getKindAsString() << "} \"" << getName() << '"';
-  return Result.str();
+void ScopeRoot::appendText(TextBuffer &Text) const {
+  Text.append('{');
+  Text.append(getKindAsString());
+  Text.append("} \"");
+  Text.append(getName());
+  Text.append('"');
 }
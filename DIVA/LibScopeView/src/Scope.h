@@ -30,14 +30,18 @@
 #ifndef SCOPEVIEWSCOPE_H
 #define SCOPEVIEWSCOPE_H
 
+#include "LineTable.h"
 #include "Object.h"
 #include "Sort.h"
 
+#include <functional>
+#include <memory>
 #include <vector>
 
 namespace LibScopeView {
 
 class Line;
+class Reader;
 class Symbol;
 
 /// \brief Class to represent a DWARF Scope object.
@@ -51,6 +55,10 @@ public:
   Scope &operator=(const Scope &) = delete;
   Scope(const Scope &) = delete;
 
+  static bool classof(const Object *Obj) {
+    return Obj->getKind() >= ok_scope && Obj->getKind() <= ok_scope_root;
+  }
+
 private:
   // Scope Kind.
   static const char *KindAggregate;
@@ -76,11 +84,6 @@ private:
   static const char *KindUndefined;
   static const char *KindUnion;
 
-public:
-  // Type of function to be called at each node in the Scope Tree.
-  typedef void (Scope::*ScopeSetFunction)();
-  typedef bool (Scope::*ScopeGetFunction)() const;
-
 public:
   // Flags specifying various properties of the Scope.
   enum ScopeAttributes {
@@ -293,11 +296,21 @@ public:
   virtual void setReference(Scope * /*Scp*/) {}
 
 public:
+  /// \brief Add a child. This only sets the Has* flags of this Scope, and
+  /// propagateContentFlags passes them up once the tree is complete.
   void addObject(Symbol *Sym);
   void addObject(Type *Ty);
   void addObject(Scope *Scp);
   void addObject(Line *Ln);
 
+  /// \brief Set the HasGlobals, HasLocals, HasLines, HasScopes, HasSymbols
+  /// and HasTypes flags of each Scope in this tree from its children, in a
+  /// single post-order pass.
+  void propagateContentFlags();
+
+  /// \brief Add the Has* flags of a child Scope to this Scope.
+  void addContentFlags(const Scope &Child);
+
 public:
   /// \brief Gets the child symbol at the specified index.
   Symbol *getSymbolAt(size_t Index) const {
@@ -316,6 +329,21 @@ public:
   const std::vector<Line *> &getLines() const { return TheLines; }
   std::vector<Line *> &getLines() { return TheLines; }
 
+  /// \brief The compact line records of the scope, if it has any.
+  virtual const LineTable *getLineTable() const { return nullptr; }
+
+  /// \brief Call Func with each line of the scope.
+  ///
+  /// The Line objects come first, then the rows of the line table. The rows
+  /// are all shown through the same Line, which only holds a row's values
+  /// during the call.
+  void forEachLine(const std::function<void(Line *)> &Func);
+
+protected:
+  /// \brief The Line used to view the rows of the line table.
+  virtual Line *getLineTableView() const { return nullptr; }
+
+public:
   const std::vector<Scope *> &getScopes() const { return TheScopes; }
   const std::vector<Symbol *> &getSymbols() const { return TheSymbols; }
   const std::vector<Type *> &getTypes() const { return TheTypes; }
@@ -326,7 +354,9 @@ public:
   }
 
   /// \brief Get the number of lines.
-  size_t getLineCount() const { return getLines().size(); }
+  size_t getLineCount() const {
+    return getLines().size() + (getLineTable() ? getLineTable()->size() : 0);
+  }
 
   /// \brief Get the number of scopes.
   size_t getScopeCount() const { return getScopes().size(); }
@@ -344,16 +374,18 @@ private:
 public:
   /// \brief Traverse the scopes tree with the given callback functions.
   void traverse(ObjGetFunction GetFunc, ObjSetFunction SetFunc, bool down);
-  void traverse(ScopeGetFunction GetFunc, ScopeSetFunction SetFunc, bool down);
 
-  /// \brief Navigate down the current scope and perform the callback.
-  void print(bool SplitCU, bool Match, bool IsNull) override;
+public:
 
   const char *resolveName();
 
   void sortScopes();
   void sortCompileUnits();
 
+  /// \brief Sort the children of this Scope, but not their children. The
+  /// types, symbols and scopes are kept in the order of the children.
+  void sortChildren(const ObjectSorter &Sorter);
+
 private:
   std::string encodeTheTemplateArguments(const std::vector<Type *> &Types,
                                          bool QualifyBase = false);
@@ -371,7 +403,7 @@ public:
   static std::string encodeTemplateArgument(Type &Ty);
 
 protected:
-  void sortScopes(SortFunction SortFunc);
+  void sortScopes(const ObjectSorter &Sorter);
 
 protected:
   // All the types in this scope.
@@ -399,13 +431,14 @@ public:
   virtual bool dump(bool DoHeader, const char *Header);
   virtual bool dumpAllowed() { return false; }
 
-  /// \brief Returns a text representation of this DIVA Object.
-  std::string getAsText() const override;
-  /// \brief Returns a YAML representation of this DIVA Object.
-  std::string getAsYAML() const override;
+  /// \brief Appends a text representation of this DIVA Object.
+  void appendText(TextBuffer &Text) const override;
+  /// \brief Appends a YAML representation of this DIVA Object.
+  void appendYAML(TextBuffer &YAML) const override;
 
 private:
-  static uint32_t ScopesAllocated;
+  static std::atomic<uint32_t> ScopesAllocated;
+  friend class UncountedObjects;
 
 public:
   static uint32_t getInstanceCount() { return ScopesAllocated; }
@@ -423,6 +456,10 @@ public:
   ScopeAggregate &operator=(const ScopeAggregate &) = delete;
   ScopeAggregate(const ScopeAggregate &) = delete;
 
+  static bool classof(const Object *Obj) {
+    return Obj->getKind() == ok_scope_aggregate;
+  }
+
 private:
   // DW_AT_specification, DW_AT_abstract_origin.
   Scope *Reference;
@@ -435,10 +472,10 @@ public:
   }
 
 public:
-  /// \brief Returns a text representation of this DIVA Object.
-  std::string getAsText() const override;
-  /// \brief Returns a YAML representation of this DIVA Object.
-  std::string getAsYAML() const override;
+  /// \brief Appends a text representation of this DIVA Object.
+  void appendText(TextBuffer &Text) const override;
+  /// \brief Appends a YAML representation of this DIVA Object.
+  void appendYAML(TextBuffer &YAML) const override;
 };
 
 /// \brief Class to represent a DWARF Template alias object.
@@ -451,13 +488,17 @@ public:
   ScopeAlias &operator=(const ScopeAlias &) = delete;
   ScopeAlias(const ScopeAlias &) = delete;
 
+  static bool classof(const Object *Obj) {
+    return Obj->getKind() == ok_scope_alias;
+  }
+
 public:
   void dumpExtra() override;
 
-  /// \brief Returns a text representation of this DIVA Object.
-  std::string getAsText() const override;
-  /// \brief Returns a YAML representation of this DIVA Object.
-  std::string getAsYAML() const override;
+  /// \brief Appends a text representation of this DIVA Object.
+  void appendText(TextBuffer &Text) const override;
+  /// \brief Appends a YAML representation of this DIVA Object.
+  void appendYAML(TextBuffer &YAML) const override;
 };
 
 /// \brief Class to represent a DWARF array object (DW_TAG_array_type).
@@ -470,12 +511,16 @@ public:
   ScopeArray &operator=(const ScopeArray &) = delete;
   ScopeArray(const ScopeArray &) = delete;
 
+  static bool classof(const Object *Obj) {
+    return Obj->getKind() == ok_scope_array;
+  }
+
 public:
   void dumpExtra() override;
 
   bool getIsPrintedAsObject() const override { return false; }
-  /// \brief Returns a text representation of this DIVA Object.
-  std::string getAsText() const override;
+  /// \brief Appends a text representation of this DIVA Object.
+  void appendText(TextBuffer &Text) const override;
 };
 
 /// \brief Class to represent a DWARF Compilation Unit (CU) object.
@@ -488,17 +533,50 @@ public:
   ScopeCompileUnit &operator=(const ScopeCompileUnit &) = delete;
   ScopeCompileUnit(const ScopeCompileUnit &) = delete;
 
+  static bool classof(const Object *Obj) {
+    return Obj->getKind() == ok_scope_compile_unit;
+  }
+
 public:
   void setName(const char *Name) override;
 
+public:
+  /// \brief The line records, which are read first if they are pending.
+  const LineTable *getLineTable() const override;
+
+  /// \brief Set the line records of the compile unit.
+  void setLineTable(LineTable &&Table);
+
+  /// \brief Leave the line records to be read by LineReader when they are
+  /// first asked for (see Reader::loadLineTable).
+  ///
+  /// The compile unit is taken to have lines, as it has a line program, so
+  /// HasLines is set without reading the records.
+  void setLineTablePending(Reader &LineReader);
+  bool getLineTablePending() const { return PendingLineReader != nullptr; }
+
+protected:
+  Line *getLineTableView() const override { return LineTableView.get(); }
+
+private:
+  void createLineTableView();
+
+private:
+  // The line records, stored by column as there are many of them.
+  LineTable TheLineTable;
+  // Shows the rows, and holds the Object flags set on all of them.
+  std::unique_ptr<Line> LineTableView;
+  // The reader to read the pending line records, or nullptr.
+  Reader *PendingLineReader;
+
 public:
   void dump() override;
   void dumpExtra() override;
 
-  /// \brief Returns a text representation of this DIVA Object.
-  std::string getAsText() const override;
-  /// \brief Returns a YAML representation of this DIVA Object.
-  std::string getAsYAML() const override;
+  /// \brief Appends a text representation of this DIVA Object.
+  void appendText(TextBuffer &Text) const override;
+  /// \brief Appends a YAML representation of this DIVA Object.
+  void appendYAML(TextBuffer &YAML) const override;
 };
 
 /// \brief Class to represent a DWARF enumerator object.
@@ -513,13 +591,17 @@ public:
   ScopeEnumeration &operator=(const ScopeEnumeration &) = delete;
   ScopeEnumeration(const ScopeEnumeration &) = delete;
 
+  static bool classof(const Object *Obj) {
+    return Obj->getKind() == ok_scope_enumeration;
+  }
+
 public:
   void dumpExtra() override;
 
-  /// \brief Returns a text representation of this DIVA Object.
-  std::string getAsText() const override;
-  /// \brief Returns a YAML representation of this DIVA Object.
-  std::string getAsYAML() const override;
+  /// \brief Appends a text representation of this DIVA Object.
+  void appendText(TextBuffer &Text) const override;
+  /// \brief Appends a YAML representation of this DIVA Object.
+  void appendYAML(TextBuffer &YAML) const override;
 
   void setIsClass() { IsClass = true; }
   bool getIsClass() const { return IsClass; }
@@ -538,6 +620,11 @@ public:
   ScopeFunction &operator=(const ScopeFunction &) = delete;
   ScopeFunction(const ScopeFunction &) = delete;
 
+  static bool classof(const Object *Obj) {
+    return Obj->getKind() == ok_scope_function ||
+           Obj->getKind() == ok_scope_function_inlined;
+  }
+
 private:
   // DW_AT_specification, DW_AT_abstract_origin.
   Scope *Reference;
@@ -567,10 +654,10 @@ public:
 public:
   void dumpExtra() override;
 
-  /// \brief Returns a text representation of this DIVA Object.
-  std::string getAsText() const override;
-  /// \brief Returns a YAML representation of this DIVA Object.
-  std::string getAsYAML() const override;
+  /// \brief Appends a text representation of this DIVA Object.
+  void appendText(TextBuffer &Text) const override;
+  /// \brief Appends a YAML representation of this DIVA Object.
+  void appendYAML(TextBuffer &YAML) const override;
 };
 
 /// \brief Class to represent a DWARF inlined function object.
@@ -583,6 +670,10 @@ public:
   ScopeFunctionInlined &operator=(const ScopeFunctionInlined &) = delete;
   ScopeFunctionInlined(const ScopeFunctionInlined &) = delete;
 
+  static bool classof(const Object *Obj) {
+    return Obj->getKind() == ok_scope_function_inlined;
+  }
+
 private:
   // Reference to DW_AT_GNU_discriminator attribute.
   Dwarf_Half Discriminator;
@@ -624,6 +715,10 @@ public:
   ScopeNamespace &operator=(const ScopeNamespace &) = delete;
   ScopeNamespace(const ScopeNamespace &) = delete;
 
+  static bool classof(const Object *Obj) {
+    return Obj->getKind() == ok_scope_namespace;
+  }
+
 private:
   // Reference to DW_AT_extension attribute.
   Scope *Reference;
@@ -639,10 +734,10 @@ public:
 public:
   void dumpExtra() override;
 
-  /// \brief Returns a text representation of this DIVA Object.
-  std::string getAsText() const override;
-  /// \brief Returns a YAML representation of this DIVA Object.
-  std::string getAsYAML() const override;
+  /// \brief Appends a text representation of this DIVA Object.
+  void appendText(TextBuffer &Text) const override;
+  /// \brief Appends a YAML representation of this DIVA Object.
+  void appendYAML(TextBuffer &YAML) const override;
 };
 
 /// \brief Class to represent a DWARF template pack.
@@ -657,13 +752,17 @@ public:
   ScopeTemplatePack &operator=(const ScopeTemplatePack &) = delete;
   ScopeTemplatePack(const ScopeTemplatePack &) = delete;
 
+  static bool classof(const Object *Obj) {
+    return Obj->getKind() == ok_scope_template_pack;
+  }
+
 public:
   void dumpExtra() override;
 
-  /// \brief Returns a text representation of this DIVA Object.
-  std::string getAsText() const override;
-  /// \brief Returns a YAML representation of this DIVA Object.
-  std::string getAsYAML() const override;
+  /// \brief Appends a text representation of this DIVA Object.
+  void appendText(TextBuffer &Text) const override;
+  /// \brief Appends a YAML representation of this DIVA Object.
+  void appendYAML(TextBuffer &YAML) const override;
 };
 
 /// \brief Class to represent an object file (single or multiple CUs).
@@ -676,6 +775,10 @@ public:
   ScopeRoot &operator=(const ScopeRoot &) = delete;
   ScopeRoot(const ScopeRoot &) = delete;
 
+  static bool classof(const Object *Obj) {
+    return Obj->getKind() == ok_scope_root;
+  }
+
 public:
   void setName(const char *Name) override;
 
@@ -686,8 +789,9 @@ public:
   bool dumpAllowed() override { return true; }
 
   bool getIsPrintedAsObject() const override { return false; }
-  /// \brief Returns a text representation of this DIVA Object.
-  std::string getAsText() const override;
+  /// \brief Appends a text representation of this DIVA Object.
+  void appendText(TextBuffer &Text) const override;
+
 };
 
 } // namespace LibScopeView
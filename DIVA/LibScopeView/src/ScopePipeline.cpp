@@ -0,0 +1,184 @@
+//===-- ScopePipeline.cpp ---------------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Implementation of the ScopePass and ScopePipeline classes.
+///
+//===----------------------------------------------------------------------===//
+
+#include "ScopePipeline.h"
+#include "Scope.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <exception>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
+
+using namespace LibScopeView;
+
+// So the vtable can be out of line.
+ScopePass::~ScopePass() {}
+
+void ScopePipeline::addPass(ScopePass &Pass) {
+  for (const ScopePass *Added : Passes)
+    for (const auto &Dependency : Added->getDependencies()) {
+      assert(Dependency.first != &Pass &&
+             "A pass must be added after the passes it depends on");
+      (void)Dependency;
+    }
+  Passes.push_back(&Pass);
+}
+
+std::vector<std::vector<ScopePass *>> ScopePipeline::getSchedule() const {
+  std::vector<std::vector<ScopePass *>> Schedule;
+  std::vector<size_t> Traversals;
+  for (ScopePass *Pass : Passes) {
+    size_t Traversal = 0;
+    for (const auto &Dependency : Pass->getDependencies()) {
+      auto It = std::find(Passes.begin(), Passes.end(), Dependency.first);
+      if (It == Passes.end())
+        continue;
+      size_t Index = static_cast<size_t>(It - Passes.begin());
+      Traversal = std::max(Traversal, Traversals[Index] +
+                                          (Dependency.second == dk_tree));
+    }
+    Traversals.push_back(Traversal);
+    if (Schedule.size() <= Traversal)
+      Schedule.resize(Traversal + 1);
+    Schedule[Traversal].push_back(Pass);
+  }
+  return Schedule;
+}
+
+std::vector<std::vector<size_t>>
+ScopePipeline::getGroups(const Scope &Root) const {
+  const auto &Children = Root.getChildren();
+  std::unordered_map<const Object *, size_t> ChildIndexes;
+  for (size_t Index = 0; Index < Children.size(); ++Index)
+    ChildIndexes.emplace(Children[Index], Index);
+
+  // The child of the root that an Object is under, or Children.size() if it is
+  // not under one.
+  auto getChildIndex = [&](const Object *Obj) {
+    while (Obj && Obj->getParent() != &Root)
+      Obj = Obj->getParent();
+    auto It = ChildIndexes.find(Obj);
+    return It == ChildIndexes.end() ? Children.size() : It->second;
+  };
+
+  // Join the linked children with a union-find, keeping the lowest index as
+  // the representative of each group.
+  std::vector<size_t> Leaders(Children.size());
+  std::iota(Leaders.begin(), Leaders.end(), 0U);
+  auto getLeader = [&Leaders](size_t Index) {
+    while (Leaders[Index] != Index)
+      Index = Leaders[Index] = Leaders[Leaders[Index]];
+    return Index;
+  };
+  for (const auto &Link : Links) {
+    size_t From = getChildIndex(Link.first);
+    size_t To = getChildIndex(Link.second);
+    if (From == Children.size() || To == Children.size())
+      continue;
+    From = getLeader(From);
+    To = getLeader(To);
+    Leaders[std::max(From, To)] = std::min(From, To);
+  }
+
+  std::vector<std::vector<size_t>> Groups;
+  std::vector<size_t> GroupIndexes(Children.size());
+  for (size_t Index = 0; Index < Children.size(); ++Index) {
+    size_t Leader = getLeader(Index);
+    if (Leader == Index) {
+      GroupIndexes[Index] = Groups.size();
+      Groups.emplace_back();
+    }
+    Groups[GroupIndexes[Leader]].push_back(Index);
+  }
+  return Groups;
+}
+
+void ScopePipeline::visit(const std::vector<ScopePass *> &Passes, Object *Obj,
+                          size_t Slot) {
+  for (ScopePass *Pass : Passes)
+    Pass->visitBefore(Obj, Slot);
+  if (auto Scp = dyn_cast<Scope>(Obj))
+    for (Object *Child : Scp->getChildren())
+      visit(Passes, Child, Slot);
+  for (ScopePass *Pass : Passes)
+    Pass->visitAfter(Obj, Slot);
+}
+
+void ScopePipeline::run(Scope &Root, unsigned Jobs) {
+  // The slots are numbered from the children before any pass reorders them.
+  const std::vector<Object *> Children(Root.getChildren());
+  std::vector<std::vector<size_t>> Groups;
+  if (Jobs > 1 && Children.size() > 1)
+    Groups = getGroups(Root);
+  Jobs = static_cast<unsigned>(std::min<size_t>(Jobs, Groups.size()));
+
+  for (const auto &Traversal : getSchedule()) {
+    for (ScopePass *Pass : Traversal)
+      Pass->begin(Children.size() + 1);
+    for (ScopePass *Pass : Traversal)
+      Pass->visitBefore(&Root, 0);
+
+    if (Jobs > 1) {
+      std::vector<std::exception_ptr> Errors(Jobs);
+      std::atomic<size_t> NextGroup(0U);
+      auto Worker = [&](unsigned WorkerIndex) {
+        try {
+          for (size_t Next = NextGroup++; Next < Groups.size();
+               Next = NextGroup++)
+            for (size_t Index : Groups[Next])
+              visit(Traversal, Children[Index], Index + 1);
+        } catch (...) {
+          Errors[WorkerIndex] = std::current_exception();
+          // Stop the other workers from starting any more groups.
+          NextGroup = Groups.size();
+        }
+      };
+      std::vector<std::thread> Workers;
+      for (unsigned WorkerIndex = 1; WorkerIndex < Jobs; ++WorkerIndex)
+        Workers.emplace_back(Worker, WorkerIndex);
+      Worker(0U);
+      for (auto &Thread : Workers)
+        Thread.join();
+      for (const auto &Error : Errors)
+        if (Error)
+          std::rethrow_exception(Error);
+    } else {
+      for (size_t Index = 0; Index < Children.size(); ++Index)
+        visit(Traversal, Children[Index], Index + 1);
+    }
+
+    for (ScopePass *Pass : Traversal)
+      Pass->visitAfter(&Root, 0);
+    for (ScopePass *Pass : Traversal)
+      Pass->end();
+  }
+}
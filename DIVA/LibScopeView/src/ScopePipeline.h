@@ -0,0 +1,138 @@
+//===-- ScopePipeline.h -----------------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Definition of the ScopePass and ScopePipeline classes.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SCOPEVIEW_SCOPEPIPELINE_H
+#define SCOPEVIEW_SCOPEPIPELINE_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace LibScopeView {
+
+class Object;
+class Scope;
+
+/// \brief How a pass depends on a pass that was added to the pipeline before
+/// it.
+enum DependencyKind {
+  dk_object, // The other pass must have visited the same Object first.
+  dk_tree    // The other pass must have finished with the whole tree.
+};
+
+/// \brief A pass over the Objects of a tree, run by a ScopePipeline.
+///
+/// The tree is split into slots: slot 0 is the root, and slot I + 1 is the
+/// tree of the root's child I. The Objects of different slots may be visited
+/// at the same time on different threads, so a pass that collects results
+/// keeps them per slot. The line records are not visited, as reading them may
+/// mean decoding a pending line table.
+class ScopePass {
+public:
+  ScopePass(const char *Name) : Name(Name) {}
+  virtual ~ScopePass();
+
+  ScopePass(const ScopePass &) = delete;
+  ScopePass &operator=(const ScopePass &) = delete;
+
+  const char *getName() const { return Name; }
+
+  /// \brief Run this pass after Pass. The dependency is ignored if Pass is
+  /// not added to the pipeline, and otherwise Pass must be added first.
+  void addDependency(const ScopePass &Pass, DependencyKind Kind) {
+    Dependencies.emplace_back(&Pass, Kind);
+  }
+  const std::vector<std::pair<const ScopePass *, DependencyKind>> &
+  getDependencies() const {
+    return Dependencies;
+  }
+
+  /// \brief Called before the traversal that runs the pass.
+  virtual void begin(size_t /*Slots*/) {}
+  /// \brief Called on an Object before its children are visited.
+  virtual void visitBefore(Object * /*Obj*/, size_t /*Slot*/) {}
+  /// \brief Called on an Object after its children have been visited.
+  virtual void visitAfter(Object * /*Obj*/, size_t /*Slot*/) {}
+  /// \brief Called after the traversal that runs the pass.
+  virtual void end() {}
+
+private:
+  const char *Name;
+  std::vector<std::pair<const ScopePass *, DependencyKind>> Dependencies;
+};
+
+/// \brief Runs a sequence of passes over a tree in as few traversals as the
+/// dependencies between them allow.
+///
+/// Each pass joins the earliest traversal that comes after the traversals of
+/// the passes it has a dk_tree dependency on, and is not before those of its
+/// dk_object dependencies. Within a traversal the passes run in the order
+/// they were added.
+///
+/// The root's children are visited on up to Jobs threads. A pass may follow
+/// a link (such as a type or reference) from one Object to another, so the
+/// children with links between them are visited together, in their order,
+/// by one thread.
+class ScopePipeline {
+public:
+  ScopePipeline() {}
+
+  ScopePipeline(const ScopePipeline &) = delete;
+  ScopePipeline &operator=(const ScopePipeline &) = delete;
+
+  /// \brief Add a pass to run after those already added.
+  void addPass(ScopePass &Pass);
+
+  /// \brief Record a link between Objects under different children of the
+  /// root.
+  void addLink(const Object *From, const Object *To) {
+    Links.emplace_back(From, To);
+  }
+
+  /// \brief Get the passes run by each traversal.
+  std::vector<std::vector<ScopePass *>> getSchedule() const;
+
+  /// \brief Run the passes over the tree of Root.
+  void run(Scope &Root, unsigned Jobs);
+
+private:
+  // Get the groups of the root's children that are linked together.
+  std::vector<std::vector<size_t>> getGroups(const Scope &Root) const;
+
+  // Visit Obj and its tree with the given passes.
+  static void visit(const std::vector<ScopePass *> &Passes, Object *Obj,
+                    size_t Slot);
+
+  std::vector<ScopePass *> Passes;
+  std::vector<std::pair<const Object *, const Object *>> Links;
+};
+
+} // end namespace LibScopeView
+
+#endif // SCOPEVIEW_SCOPEPIPELINE_H
@@ -30,53 +30,301 @@
 #include "ScopePrinter.h"
 #include "Error.h"
 #include "FileUtilities.h"
+#include "Line.h"
+#include "ParallelRender.h"
 #include "Scope.h"
 
+#include <algorithm>
 #include <assert.h>
+#include <cstdint>
 #include <fstream>
+#include <sstream>
 
 using namespace LibScopeView;
 
 namespace {
 // Default return for getHeader and getFooter.
 std::string EmptyString;
+
+// A set of the printers of a walk, one bit for each.
+typedef uint32_t PrinterSet;
+const size_t MaxPrinters = 32;
+
+PrinterSet printerBit(size_t Index) { return PrinterSet(1) << Index; }
 } // namespace
 
+// Prints the objects with the printers of a set that print them. The
+// printers are those given to print(), or their workers.
+class ScopePrinter::Walk {
+public:
+  explicit Walk(const std::vector<ScopePrinter *> &WalkPrinters)
+      : Printers(WalkPrinters) {}
+
+  // Print Obj, and what is under it.
+  void print(const Object *Obj, PrinterSet Set);
+
+  // Print the children and the line records of Scp.
+  void printChildren(const Scope *Scp, PrinterSet Set);
+  void printLines(const Scope *Scp, PrinterSet Set);
+
+  // Print the children of the object the walk starts at, where each compile
+  // unit is also printed by the printers with an output directory, to a file
+  // of its own. The children are printed on up to Jobs threads.
+  void printUnits(const Scope *Scp, PrinterSet Set, PrinterSet Dirs,
+                  unsigned Jobs);
+
+private:
+  // The printers with an output directory that print Unit to a file.
+  PrinterSet getFiles(const Object *Unit, PrinterSet Dirs);
+  void printUnit(const Object *Unit, PrinterSet Set, PrinterSet Dirs);
+
+  std::vector<ScopePrinter *> Printers;
+};
+
+void ScopePrinter::Walk::print(const Object *Obj, PrinterSet Set) {
+  PrinterSet Nested = 0;
+  for (size_t Index = 0; Index < Printers.size(); ++Index) {
+    ScopePrinter *Printer = Printers[Index];
+    if ((Set & printerBit(Index)) && Printer->getSelected(Obj) &&
+        Printer->printBefore(Obj, *Printer->OutputStream))
+      Nested |= printerBit(Index);
+  }
+  if (!Nested)
+    return;
+
+  if (Obj->getIsScope())
+    printChildren(static_cast<const Scope *>(Obj), Nested);
+  for (size_t Index = 0; Index < Printers.size(); ++Index)
+    if (Nested & printerBit(Index))
+      Printers[Index]->printAfter(Obj, *Printers[Index]->OutputStream);
+}
+
+void ScopePrinter::Walk::printChildren(const Scope *Scp, PrinterSet Set) {
+  for (const Object *Child : Scp->getChildren())
+    print(Child, Set);
+  printLines(Scp, Set);
+}
+
+void ScopePrinter::Walk::printLines(const Scope *Scp, PrinterSet Set) {
+  // Reading the line records may mean decoding a pending line table, so it
+  // is only done if a printer prints them.
+  PrinterSet Lines = 0;
+  for (size_t Index = 0; Index < Printers.size(); ++Index)
+    if ((Set & printerBit(Index)) && Printers[Index]->getPrintsLines(Scp))
+      Lines |= printerBit(Index);
+  if (Lines)
+    const_cast<Scope *>(Scp)->forEachLine(
+        [&](Line *Ln) { print(Ln, Lines); });
+}
+
+PrinterSet ScopePrinter::Walk::getFiles(const Object *Unit, PrinterSet Dirs) {
+  PrinterSet Files = 0;
+  if (Unit->getIsCompileUnit())
+    for (size_t Index = 0; Index < Printers.size(); ++Index)
+      if ((Dirs & printerBit(Index)) && Printers[Index]->getSelected(Unit))
+        Files |= printerBit(Index);
+  return Files;
+}
+
+void ScopePrinter::Walk::printUnit(const Object *Unit, PrinterSet Set,
+                                   PrinterSet Dirs) {
+  PrinterSet Files = getFiles(Unit, Dirs);
+  std::vector<std::ofstream> SplitOutputFiles(Printers.size());
+  for (size_t Index = 0; Index < Printers.size(); ++Index) {
+    if (!(Files & printerBit(Index)))
+      continue;
+    ScopePrinter *Printer = Printers[Index];
+    Printer->openOutputFile(Unit, SplitOutputFiles[Index]);
+    Printer->OutputStream = &SplitOutputFiles[Index];
+    *Printer->OutputStream << Printer->getHeader();
+  }
+
+  print(Unit, Set | Files);
+
+  for (size_t Index = 0; Index < Printers.size(); ++Index) {
+    if (!(Files & printerBit(Index)))
+      continue;
+    ScopePrinter *Printer = Printers[Index];
+    Printer->flush(*Printer->OutputStream);
+    *Printer->OutputStream << Printer->getFooter();
+    Printer->OutputStream = nullptr;
+  }
+}
+
+void ScopePrinter::Walk::printUnits(const Scope *Scp, PrinterSet Set,
+                                    PrinterSet Dirs, unsigned Jobs) {
+  std::vector<const Object *> Units(Scp->getChildren().begin(),
+                                    Scp->getChildren().end());
+  auto getPrintsApart = [&](const Object *Unit) {
+    PrinterSet UnitSet = Set | getFiles(Unit, Dirs);
+    for (size_t Index = 0; Index < Printers.size(); ++Index)
+      if ((UnitSet & printerBit(Index)) &&
+          !Printers[Index]->getPrintsApart(Unit))
+        return false;
+    return true;
+  };
+
+  // The units a printer can't print apart yet, such as before it has fixed
+  // its layout, are printed in turn until then.
+  size_t First = 0;
+  while (Jobs > 1 && First < Units.size() && !getPrintsApart(Units[First]))
+    printUnit(Units[First++], Set, Dirs);
+
+  // A worker starts at the top level, so the children of anything but the
+  // root are only printed apart to files of their own.
+  bool WithWorkers = Jobs > 1 && Units.size() - First > 1 &&
+                     (!Set || Scp->getIsRoot()) &&
+                     std::all_of(Units.begin() + First, Units.end(),
+                                 getPrintsApart);
+  for (size_t Index = 0; WithWorkers && Index < Printers.size(); ++Index)
+    if (((Set | Dirs) & printerBit(Index)) && !Printers[Index]->createWorker())
+      WithWorkers = false;
+  if (!WithWorkers) {
+    for (size_t Index = First; Index < Units.size(); ++Index)
+      printUnit(Units[Index], Set, Dirs);
+    return;
+  }
+
+  // Each unit is printed by a worker of each of its printers, and the text
+  // is written out here in their order.
+  struct Rendered {
+    PrinterSet Files = 0;
+    std::vector<std::unique_ptr<ScopePrinter>> Workers;
+    std::vector<std::string> Texts;
+  };
+  std::vector<Rendered> Items(Units.size() - First);
+  auto Render = [&](size_t Index, std::string & /*Text*/) {
+    const Object *Unit = Units[First + Index];
+    Rendered &Item = Items[Index];
+    Item.Files = getFiles(Unit, Dirs);
+    PrinterSet UnitSet = Set | Item.Files;
+    Item.Workers.resize(Printers.size());
+    Item.Texts.resize(Printers.size());
+    std::vector<ScopePrinter *> WorkerPrinters(Printers.size());
+    std::vector<std::ostringstream> Outputs(Printers.size());
+    for (size_t PrinterIndex = 0; PrinterIndex < Printers.size();
+         ++PrinterIndex) {
+      if (!(UnitSet & printerBit(PrinterIndex)))
+        continue;
+      Item.Workers[PrinterIndex] = Printers[PrinterIndex]->createWorker();
+      WorkerPrinters[PrinterIndex] = Item.Workers[PrinterIndex].get();
+      WorkerPrinters[PrinterIndex]->OutputStream = &Outputs[PrinterIndex];
+    }
+    Walk(WorkerPrinters).print(Unit, UnitSet);
+    for (size_t PrinterIndex = 0; PrinterIndex < Printers.size();
+         ++PrinterIndex) {
+      if (!WorkerPrinters[PrinterIndex])
+        continue;
+      WorkerPrinters[PrinterIndex]->flush(Outputs[PrinterIndex]);
+      Item.Texts[PrinterIndex] = Outputs[PrinterIndex].str();
+    }
+  };
+  auto Emit = [&](size_t Index, std::string & /*Text*/) {
+    const Object *Unit = Units[First + Index];
+    Rendered Item;
+    std::swap(Item, Items[Index]);
+    for (size_t PrinterIndex = 0; PrinterIndex < Printers.size();
+         ++PrinterIndex) {
+      if (!Item.Workers[PrinterIndex])
+        continue;
+      ScopePrinter *Printer = Printers[PrinterIndex];
+      const std::string &Text = Item.Texts[PrinterIndex];
+      if (Item.Files & printerBit(PrinterIndex)) {
+        std::ofstream SplitOutputFile;
+        Printer->openOutputFile(Unit, SplitOutputFile);
+        SplitOutputFile << Printer->getHeader();
+        SplitOutputFile.write(Text.data(), Text.size());
+        SplitOutputFile << Printer->getFooter();
+      } else {
+        Printer->flush(*Printer->OutputStream);
+        Printer->OutputStream->write(Text.data(), Text.size());
+      }
+      Printer->joinWorker(*Item.Workers[PrinterIndex]);
+    }
+  };
+  renderInOrder(Items.size(), Jobs, Render, Emit);
+}
+
 void ScopePrinter::print(const Object *Obj, std::ostream &Output) {
-  OutputStream = &Output;
-  *OutputStream << getHeader();
-  visit(Obj);
-  *OutputStream << getFooter();
+  setOutput(Output);
+  print(Obj, {this}, Jobs);
 }
 
 void ScopePrinter::print(const ScopeRoot *Root, const std::string &OutputDir) {
-  if (Root->getChildrenCount() == 0)
-    return;
+  setOutputDir(OutputDir);
+  print(Root, {this}, Jobs);
+}
+
+void ScopePrinter::setOutput(std::ostream &Output) {
+  OutputStream = &Output;
+  Split = false;
+}
 
+void ScopePrinter::setOutputDir(const std::string &Dir) {
   // Add a trailing seperator to OutputDir.
-  std::string SplitOutputDir(unifyFilePath(OutputDir));
-  if (SplitOutputDir.back() != '/') {
-    SplitOutputDir += '/';
+  OutputDir = unifyFilePath(Dir);
+  if (OutputDir.empty() || OutputDir.back() != '/')
+    OutputDir += '/';
+  OutputStream = nullptr;
+  Split = true;
+}
+
+void ScopePrinter::openOutputFile(const Object *CU,
+                                  std::ofstream &SplitOutputFile) {
+  std::string OutputPath(OutputDir);
+  OutputPath += flattenFilePath(CU->getName());
+  OutputPath += ".";
+  OutputPath += getFileExtension();
+
+  SplitOutputFile.open(nativeFilePath(OutputPath));
+  if (SplitOutputFile.fail())
+    fatalError(LibScopeError::ErrorCode::ERR_SPLIT_UNABLE_TO_OPEN_FILE,
+               OutputPath);
+}
+
+void ScopePrinter::print(const Object *Obj,
+                         const std::vector<ScopePrinter *> &Printers,
+                         unsigned Jobs) {
+  assert(Printers.size() <= MaxPrinters && "Too many printers for one walk");
+  PrinterSet Streams = 0;
+  PrinterSet Dirs = 0;
+  for (size_t Index = 0; Index < Printers.size(); ++Index)
+    (Printers[Index]->Split ? Dirs : Streams) |= printerBit(Index);
+
+  // The printers with an output directory print the CUs under Obj, once
+  // the directory is created.
+  auto Scp = Obj->getIsScope() ? static_cast<const Scope *>(Obj) : nullptr;
+  if (!Scp || Scp->getChildrenCount() == 0)
+    Dirs = 0;
+  for (size_t Index = 0; Index < Printers.size(); ++Index) {
+    ScopePrinter *Printer = Printers[Index];
+    if ((Dirs & printerBit(Index)) && !recursiveMakeDir(Printer->OutputDir))
+      fatalError(LibScopeError::ErrorCode::ERR_FILEIO_MAKE_DIR_FAILURE,
+                 Printer->OutputDir);
+    if (Streams & printerBit(Index))
+      *Printer->OutputStream << Printer->getHeader();
+  }
+
+  Walk TheWalk(Printers);
+  PrinterSet Nested = 0;
+  for (size_t Index = 0; Index < Printers.size(); ++Index) {
+    ScopePrinter *Printer = Printers[Index];
+    if ((Streams & printerBit(Index)) && Printer->getSelected(Obj) &&
+        Printer->printBefore(Obj, *Printer->OutputStream))
+      Nested |= printerBit(Index);
   }
-  // Create the directory.
-  if (!recursiveMakeDir(SplitOutputDir)) {
-    fatalError(LibScopeError::ErrorCode::ERR_FILEIO_MAKE_DIR_FAILURE,
-               SplitOutputDir);
+  if (Scp && (Nested || Dirs)) {
+    TheWalk.printUnits(Scp, Nested, Dirs, Jobs);
+    TheWalk.printLines(Scp, Nested);
   }
-  // Print each compile unit
-  for (const auto *CU : Root->getChildren()) {
-    if (CU->getIsCompileUnit()) {
-      // Open an output file for each CU.
-      std::string OutputPath(SplitOutputDir);
-      OutputPath += flattenFilePath(CU->getName());
-      OutputPath += ".";
-      OutputPath += getFileExtension();
-
-      std::ofstream SplitOutputFile(nativeFilePath(OutputPath));
-      if (SplitOutputFile.fail())
-        fatalError(LibScopeError::ErrorCode::ERR_SPLIT_UNABLE_TO_OPEN_FILE,
-                   OutputPath);
-      print(CU, SplitOutputFile);
+
+  for (size_t Index = 0; Index < Printers.size(); ++Index) {
+    ScopePrinter *Printer = Printers[Index];
+    if (Nested & printerBit(Index))
+      Printer->printAfter(Obj, *Printer->OutputStream);
+    if (Streams & printerBit(Index)) {
+      Printer->flush(*Printer->OutputStream);
+      *Printer->OutputStream << Printer->getFooter();
     }
   }
 }
@@ -84,9 +332,3 @@ void ScopePrinter::print(const ScopeRoot *Root, const std::string &OutputDir) {
 const std::string &ScopePrinter::getHeader() { return EmptyString; }
 
 const std::string &ScopePrinter::getFooter() { return EmptyString; }
-
-void ScopePrinter::visitImpl(const Object *Obj) {
-  assert(OutputStream && "ScopePrinter methods calling ScopePrinter::visit "
-                         "should set OutputStream first");
-  printImpl(Obj, *OutputStream);
-}
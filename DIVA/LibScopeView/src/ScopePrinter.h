@@ -30,13 +30,15 @@
 #ifndef SCOPEVIEW_SCOPEPRINTER_H
 #define SCOPEVIEW_SCOPEPRINTER_H
 
-#include "ScopeVisitor.h"
-
+#include <iosfwd>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace LibScopeView {
 
 class Object;
+class Scope;
 class ScopeRoot;
 
 /// \brief An abstract base class for a scope printer.
@@ -45,11 +47,22 @@ class ScopeRoot;
 /// splitting each compile unit is written to a seperate file in a given
 /// directory.
 ///
+/// Several printers can print the same tree in one walk over its objects,
+/// each to an output of its own, with print(Obj, Printers, Jobs). Each object
+/// is passed to printBefore() of each printer in turn, and its children are
+/// printed by those that return true, followed by printAfter().
+///
+/// A printer that implements createWorker() can print the compile units on
+/// several threads, with setJobs(). Each is printed by a worker printer of
+/// its own, and the output is written in the original order.
+///
 /// Typical usage:
 /// \code
 ///   class MyPrinter : public ScopePrinter {
-///     void printImpl(const Object *Obj, std::ostream &OutputStream) override {
+///     bool printBefore(const Object *Obj,
+///                      std::ostream &OutputStream) override {
 ///       OutputStream << Obj.getName() << ... << '\n';
+///       return true;
 ///     }
 ///     const std::string &getFileExtension() override {
 ///       static std::string Ext = "txt";
@@ -60,10 +73,13 @@ class ScopeRoot;
 ///   MyPrinter().print(Root, std::cout);
 ///   MyPrinter().print(Root, "output/dir");
 /// \endcode
-class ScopePrinter : private ConstScopeVisitor {
+class ScopePrinter {
 public:
-  ScopePrinter() : OutputStream(nullptr) {}
-  virtual ~ScopePrinter() override {}
+  ScopePrinter() : OutputStream(nullptr), Split(false), Jobs(1) {}
+  virtual ~ScopePrinter() {}
+
+  /// \brief Set the number of threads used to print the compile units.
+  void setJobs(unsigned NumJobs) { Jobs = NumJobs; }
 
   /// \brief Print Obj to Output.
   void print(const Object *Obj, std::ostream &Output);
@@ -71,12 +87,54 @@ public:
   /// \brief Print each CU under the ScopeRoot to a file in OutputDir.
   void print(const ScopeRoot *Root, const std::string &OutputDir);
 
-protected:
-  void printChildren(const Object *Obj) { visitChildren(Obj); }
+  /// \brief Make print(Obj, Printers, Jobs) print to Output.
+  void setOutput(std::ostream &Output);
+
+  /// \brief Make print(Obj, Printers, Jobs) print each CU under Obj to a file
+  /// in OutputDir.
+  void setOutputDir(const std::string &OutputDir);
+
+  /// \brief Print Obj with each of the printers, to the output set on each,
+  /// in one walk over the objects. The children of Obj are printed on up to
+  /// Jobs threads.
+  static void print(const Object *Obj,
+                    const std::vector<ScopePrinter *> &Printers,
+                    unsigned Jobs);
 
 private:
-  /// \brief Subclass interface for printing an object.
-  virtual void printImpl(const Object *Obj, std::ostream &OutputStream) = 0;
+  /// \brief Subclass interface for printing an object, before its children.
+  /// Returns true if the children and the line records are to be printed,
+  /// followed by printAfter().
+  virtual bool printBefore(const Object *Obj, std::ostream &OutputStream) = 0;
+
+  /// \brief Subclass interface for printing an object, after its children.
+  virtual void printAfter(const Object * /*Obj*/,
+                          std::ostream & /*OutputStream*/) {}
+
+  /// \brief If Obj is printed at all, rather than skipped along with
+  /// everything under it. A compile unit that is not selected has no file of
+  /// its own in split mode.
+  virtual bool getSelected(const Object * /*Obj*/) { return true; }
+
+  /// \brief If the line records of Scp are printed, after its children.
+  virtual bool getPrintsLines(const Scope * /*Scp*/) { return true; }
+
+  /// \brief Write anything the printer has buffered to OutputStream.
+  virtual void flush(std::ostream & /*OutputStream*/) {}
+
+  /// \brief Create a printer that prints a compile unit on a worker thread
+  /// exactly as this one would, or nullptr to print them all on this thread.
+  virtual std::unique_ptr<ScopePrinter> createWorker() const {
+    return nullptr;
+  }
+
+  /// \brief If a worker printer can print Obj, given what this printer has
+  /// printed so far. Otherwise Obj is printed on this thread.
+  virtual bool getPrintsApart(const Object * /*Obj*/) { return true; }
+
+  /// \brief Carry on from the state Worker was left in, once the text it
+  /// printed has been written.
+  virtual void joinWorker(const ScopePrinter & /*Worker*/) {}
 
   /// \brief get the file extension to use when splitting output (e.g. "txt").
   virtual const std::string &getFileExtension() = 0;
@@ -89,11 +147,19 @@ private:
   /// bottom of each split file.
   virtual const std::string &getFooter();
 
-  // Call printImpl() on the object with the appropriate OutputStream.
-  void visitImpl(const Object *Obj) override;
+  // The walk over the objects for a set of printers.
+  class Walk;
+
+  // Open the output file in OutputDir for CU.
+  void openOutputFile(const Object *CU, std::ofstream &SplitOutputFile);
 
   // Current output stream.
   std::ostream *OutputStream;
+  // Each CU is printed to a file in OutputDir.
+  bool Split;
+  std::string OutputDir;
+  // Number of threads used to print the compile units.
+  unsigned Jobs;
 };
 
 } // end namespace LibScopeView
@@ -0,0 +1,140 @@
+//===-- LibScopeView/ScopeTextPrinter.cpp ------------------------- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definitions of ScopeTextPrinter's methods.
+///
+//===----------------------------------------------------------------------===//
+
+
+#include "ScopeTextPrinter.h"
+#include "Reader.h"
+#include "Scope.h"
+
+#include <cstdint>
+#include <ostream>
+
+using namespace LibScopeView;
+
+namespace {
+
+// The file name index of a print context that has not printed a file name.
+const size_t UnchangedFileIndex = SIZE_MAX;
+
+// Check if what a child of the root prints doesn't depend on the file name
+// printed last by the children before it. A compile unit starts a new
+// sequence of file names when it prints itself.
+bool printsOnItsOwn(Object *Obj) {
+  CmdOptions &Options = getReader()->getOptions();
+  if (!Options.getFormatFileName() && !Options.getFormatPathName())
+    return true;
+  if (!Obj->getIsCompileUnit() || Obj->getFileNameIndex())
+    return false;
+  Scope *CU = static_cast<Scope *>(Obj);
+  // A unit that prints nothing leaves the sequence as it is.
+  if (!CU->resolvePrinting() ||
+      (Options.getTraceQuiet() && !Options.getViewSplit()))
+    return true;
+  return getReader()->getSpecification()->printObject(CU);
+}
+
+} // namespace
+
+ScopeTextPrinter::ScopeTextPrinter()
+    : FlushSize(GlobalPrintContext ? GlobalPrintContext->getBufferSize()
+                                   : PrintContext::DefaultBufferSize),
+      Match(getReader()->getSpecification()->getAnyTreePattern()) {
+  Context.setKeepText();
+}
+
+void ScopeTextPrinter::setOptions(const CmdOptions &Options) {
+  Context.getLayout().setOptions(Options);
+}
+
+bool ScopeTextPrinter::printBefore(const Object *Obj,
+                                   std::ostream &OutputStream) {
+  ThreadPrintContext UseContext(Context);
+  Object *Printed = const_cast<Object *>(Obj);
+  bool PrintChildren = false;
+  if (Obj->getIsScope()) {
+    // Check conditions such as local, global, etc.
+    PrintChildren = static_cast<Scope *>(Printed)->resolvePrinting();
+
+    // Don't print in quiet mode unless splitting output.
+    const CmdOptions &Options = getReader()->getOptions();
+    PrintChildren = PrintChildren &&
+                    (!Options.getTraceQuiet() || Options.getViewSplit());
+    if (!PrintChildren)
+      return false;
+  }
+
+  Printed->dump();
+  if (Context.getBuffer().size() >= FlushSize)
+    flush(OutputStream);
+  return PrintChildren;
+}
+
+bool ScopeTextPrinter::getSelected(const Object *Obj) {
+  // Below the top, only the objects with a matching pattern are printed.
+  return !Match || !Obj->getParent() || Obj->getHasPattern();
+}
+
+bool ScopeTextPrinter::getPrintsLines(const Scope * /*Scp*/) {
+  // The line records print nothing unless code lines are shown, so skip them
+  // to avoid reading any pending line table.
+  return getReader()->getOptions().getPrintCodeline();
+}
+
+void ScopeTextPrinter::flush(std::ostream &OutputStream) {
+  TextBuffer &Buffer = Context.getBuffer();
+  OutputStream.write(Buffer.data(), Buffer.size());
+  Buffer.clear();
+}
+
+std::unique_ptr<ScopePrinter> ScopeTextPrinter::createWorker() const {
+  // A worker prints with the same layout, and notes the first file name it
+  // prints rather than any printed before it.
+  ScopeTextPrinter *Worker = new ScopeTextPrinter();
+  Worker->Context.setLayout(Context.getLayout());
+  Worker->Context.setLastFileIndex(UnchangedFileIndex);
+  return std::unique_ptr<ScopePrinter>(Worker);
+}
+
+bool ScopeTextPrinter::getPrintsApart(const Object *Obj) {
+  // The layout of the attributes is fixed by the first object printed.
+  return Context.getLayout().getCalculated() &&
+         printsOnItsOwn(const_cast<Object *>(Obj));
+}
+
+void ScopeTextPrinter::joinWorker(const ScopePrinter &Worker) {
+  size_t FileIndex = static_cast<const ScopeTextPrinter &>(Worker)
+                         .Context.getLastFileIndex();
+  if (FileIndex != UnchangedFileIndex)
+    Context.setLastFileIndex(FileIndex);
+}
+
+const std::string &ScopeTextPrinter::getFileExtension() {
+  static std::string TextExtension = "txt";
+  return TextExtension;
+}
@@ -0,0 +1,73 @@
+//===-- LibScopeView/ScopeTextPrinter.h -------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the ScopeTextPrinter class.
+///
+//===----------------------------------------------------------------------===//
+
+
+#ifndef SCOPEVIEW_SCOPETEXTPRINTER_H
+#define SCOPEVIEW_SCOPETEXTPRINTER_H
+
+#include "PrintContext.h"
+#include "ScopePrinter.h"
+
+namespace LibScopeView {
+
+/// \brief A Scope printer that outputs the logical view as text.
+///
+/// The objects are printed as the reader's options select, to a print
+/// context of the printer's own. The attributes in front of each object can
+/// be selected by other options, such as for a second view with the DIE
+/// offsets and levels.
+class ScopeTextPrinter : public ScopePrinter {
+public:
+  ScopeTextPrinter();
+
+  /// \brief Print the attributes selected by Options, rather than those of
+  /// the reader's options.
+  void setOptions(const CmdOptions &Options);
+
+private:
+  bool printBefore(const Object *Obj, std::ostream &OutputStream) override;
+  bool getSelected(const Object *Obj) override;
+  bool getPrintsLines(const Scope *Scp) override;
+  void flush(std::ostream &OutputStream) override;
+  std::unique_ptr<ScopePrinter> createWorker() const override;
+  bool getPrintsApart(const Object *Obj) override;
+  void joinWorker(const ScopePrinter &Worker) override;
+  const std::string &getFileExtension() override;
+
+  // The context keeps the text, which is written to the output stream once
+  // FlushSize characters are gathered.
+  PrintContext Context;
+  size_t FlushSize;
+  // Only the objects that match the --tree patterns are printed.
+  bool Match;
+};
+
+} // end namespace LibScopeView
+
+#endif // SCOPEVIEW_SCOPETEXTPRINTER_H
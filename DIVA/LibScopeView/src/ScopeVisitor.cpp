@@ -47,7 +47,7 @@ void ScopeVisitor::visit(Object *Obj) {
   visitImpl(Obj);
 }
 
-void ScopeVisitor::visitChildren(Object *Obj) {
+void ScopeVisitor::visitChildren(Object *Obj, bool VisitLines) {
   assert(Obj && "ScopeVisitor::visitChildren passed nullptr");
   if (!Obj)
     return; // Handle gracefully in release.
@@ -60,9 +60,8 @@ void ScopeVisitor::visitChildren(Object *Obj) {
   for (Object *Child : Scp->getChildren()) {
     visit(Child);
   }
-  for (Object *Ln : Scp->getLines()) {
-    visit(Ln);
-  }
+  if (VisitLines)
+    Scp->forEachLine([this](Line *Ln) { visit(Ln); });
 }
 
 // So the vtable can be out of line.
@@ -52,7 +52,10 @@ private:
 
 protected:
   /// \brief Visit the children of an Object.
-  void visitChildren(Object *Obj);
+  ///
+  /// The line records are only visited if VisitLines is true, as reading
+  /// them may mean decoding a pending line table.
+  void visitChildren(Object *Obj, bool VisitLines = true);
 };
 
 /// \brief A ScopeVisitor that traverses and visits const Objects.
@@ -30,10 +30,6 @@
 #include "ScopeYAMLPrinter.h"
 #include "Scope.h"
 
-#include <algorithm>
-#include <assert.h>
-#include <sstream>
-
 using namespace LibScopeView;
 
 namespace {
@@ -50,11 +46,16 @@ std::string escapeBackslashes(const std::string &input) {
   return Result;
 }
 
+// Checks if Obj is the scope root, which is not printed itself.
+bool isRoot(const Object *Obj) {
+  return Obj->getIsScope() && static_cast<const Scope *>(Obj)->getIsRoot();
+}
+
 } // namespace
 
 ScopeYAMLPrinter::ScopeYAMLPrinter(std::string InputFile, std::string Version,
                                    uint8_t SizeOfIndent)
-    : IndentSize(SizeOfIndent), IndentLevel(1) {
+    : Emitter(SizeOfIndent) {
   InputFile = escapeBackslashes(InputFile);
   YAMLHeader.append("input_file: \"")
       .append(InputFile)
@@ -63,6 +64,11 @@ ScopeYAMLPrinter::ScopeYAMLPrinter(std::string InputFile, std::string Version,
       .append("\"\nobjects:\n");
 }
 
+std::unique_ptr<ScopePrinter> ScopeYAMLPrinter::createWorker() const {
+  // A worker starts at the top level, as this printer does for each CU.
+  return std::unique_ptr<ScopePrinter>(new ScopeYAMLPrinter(*this));
+}
+
 const std::string &ScopeYAMLPrinter::getFileExtension() {
   static std::string YAMLExtension = "yaml";
   return YAMLExtension;
@@ -70,51 +76,49 @@ const std::string &ScopeYAMLPrinter::getFileExtension() {
 
 const std::string &ScopeYAMLPrinter::getHeader() { return YAMLHeader; }
 
-void ScopeYAMLPrinter::printImpl(const Object *Obj,
-                                 std::ostream &OutputStream) {
-  // Don't print anything for the scope root, but do visit the children.
-  if (Obj->getIsScope() && static_cast<const Scope *>(Obj)->getIsRoot()) {
-    printChildren(Obj);
-    return;
-  }
+bool ScopeYAMLPrinter::printBefore(const Object *Obj,
+                                   std::ostream &OutputStream) {
+  // Don't print anything for the scope root, but do print the children.
+  if (isRoot(Obj))
+    return true;
 
   // Skip objects that shouldn't be printed as an object
   if (!Obj->getIsPrintedAsObject())
-    return;
+    return false;
 
-  std::stringstream ObjYAML(Obj->getAsYAML());
-  assert(!ObjYAML.str().empty());
-
-  // Add indentation.
-  // We need to indent the first level of objects once so they are under the
-  // header, then all subsequent layers need to be indented once for the
-  // children list itself and the once more for the child.
-  // We then need to indent by " -" for the first line to show it is an item in
-  // the list, and then by "  " on the other lines.
-  std::string Indent(((IndentLevel * 2) - 1) * IndentSize, ' ');
-  std::string Line;
-  std::getline(ObjYAML, Line);
-  OutputStream << Indent << "- " << Line << '\n';
-  while (std::getline(ObjYAML, Line)) {
-    OutputStream << Indent << "  " << Line << '\n';
-  }
+  Emitter.setOutput(OutputStream);
+  ObjYAML.clear();
+  Obj->appendYAML(ObjYAML);
+  Emitter.emitItem(ObjYAML);
 
-  // Print children.
-  OutputStream << Indent << "  "
-               << "children:";
+  // Print children. The emitter writes an empty list if none of them are
+  // printed as an object.
   if (Obj->getIsScope()) {
-    auto const *Scp = static_cast<const Scope *>(Obj);
-    const auto &Children = Scp->getChildren();
-    if (std::none_of(Children.cbegin(), Children.cend(), [](Object *Child) {
-          return Child->getIsPrintedAsObject();
-        })) {
-      OutputStream << " []\n";
-      return;
-    } else
-      OutputStream << "\n";
-    IndentLevel += 1;
-    printChildren(Obj);
-    IndentLevel -= 1;
-  } else
-    OutputStream << " []\n";
+    Emitter.beginChildren();
+    return true;
+  }
+  Emitter.emitNoChildren();
+
+  // Write the output once the outermost object is complete.
+  if (Emitter.getDepth() == 1)
+    Emitter.flush();
+  return false;
+}
+
+void ScopeYAMLPrinter::printAfter(const Object *Obj,
+                                  std::ostream &OutputStream) {
+  Emitter.setOutput(OutputStream);
+  if (isRoot(Obj)) {
+    Emitter.flush();
+    return;
+  }
+
+  Emitter.endChildren();
+  if (Emitter.getDepth() == 1)
+    Emitter.flush();
+}
+
+void ScopeYAMLPrinter::flush(std::ostream &OutputStream) {
+  Emitter.setOutput(OutputStream);
+  Emitter.flush();
 }
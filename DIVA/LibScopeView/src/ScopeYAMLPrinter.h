@@ -31,6 +31,8 @@
 #define SCOPEVIEW_SCOPEYAMLPRINTER_H
 
 #include "ScopePrinter.h"
+#include "TextBuffer.h"
+#include "YAMLEmitter.h"
 
 namespace LibScopeView {
 
@@ -41,13 +43,17 @@ public:
                             uint8_t SizeOfIndent = 2);
 
 private:
+  bool printBefore(const Object *Obj, std::ostream &OutputStream) override;
+  void printAfter(const Object *Obj, std::ostream &OutputStream) override;
+  void flush(std::ostream &OutputStream) override;
+  std::unique_ptr<ScopePrinter> createWorker() const override;
   const std::string &getFileExtension() override;
   const std::string &getHeader() override;
-  void printImpl(const Object *Obj, std::ostream &OutputStream) override;
 
   std::string YAMLHeader;
-  const uint8_t IndentSize;
-  uint32_t IndentLevel;
+  YAMLEmitter Emitter;
+  // Reused for the YAML of each object, so it is only allocated once.
+  TextBuffer ObjYAML;
 };
 
 } // end namespace LibScopeView
@@ -30,6 +30,13 @@
 #include "Reader.h"
 
 #include "Sort.h"
+#include "StringPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <numeric>
+#include <tuple>
 
 using namespace LibScopeView;
 
@@ -37,11 +44,24 @@ namespace {
 template <typename T> int compare(const T &LHS, const T &RHS) {
   return (LHS < RHS) ? -1 : ((LHS > RHS) ? 1 : 0);
 }
+
+// Compare two strings the way std::string does, without copying them.
+int compareStrings(const char *LHS, const char *RHS) {
+  return compare(strcmp(LHS, RHS), 0);
+}
+
+// The keys of an Object for ObjectSorter.
+struct SortKey {
+  uint32_t Kind;
+  uint32_t Name;
+  uint64_t Line;
+  Dwarf_Off Offset;
+  Object *Obj;
+};
 } // namespace
 
 int LibScopeView::compareKind(const Object *LHS, const Object *RHS) {
-  return compare(std::string(LHS->getKindAsString()),
-                 std::string(RHS->getKindAsString()));
+  return compareStrings(LHS->getKindAsString(), RHS->getKindAsString());
 }
 
 int LibScopeView::compareLine(const Object *LHS, const Object *RHS) {
@@ -49,7 +69,7 @@ int LibScopeView::compareLine(const Object *LHS, const Object *RHS) {
 }
 
 int LibScopeView::compareName(const Object *LHS, const Object *RHS) {
-  return compare(std::string(LHS->getName()), std::string(RHS->getName()));
+  return compareStrings(LHS->getName(), RHS->getName());
 }
 
 int LibScopeView::compareOffset(const Object *LHS, const Object *RHS) {
@@ -111,6 +131,12 @@ bool LibScopeView::sortByOffset(const Object *LHS, const Object *RHS) {
   return compareOffset(LHS, RHS) < 0;
 }
 
+SortMode LibScopeView::getViewSortMode() {
+  if (!LibScopeView::getReader()->getOptions().getViewSort())
+    return sr_none;
+  return LibScopeView::getReader()->getSpecification()->getSortMode();
+}
+
 SortFunction LibScopeView::getSortFunction() {
   // Sort function callback based on sort mode.
   struct SortInfo {
@@ -123,11 +149,99 @@ SortFunction LibScopeView::getSortFunction() {
       {sr_name, sortByName}, {sr_offset, sortByOffset},
   };
 
-  SortFunction sort_function = nullptr;
-  if (LibScopeView::getReader()->getOptions().getViewSort()) {
-    SortMode sort_mode =
-        LibScopeView::getReader()->getSpecification()->getSortMode();
-    sort_function = sort_info[sort_mode].SortFunc;
+  return sort_info[getViewSortMode()].SortFunc;
+}
+
+ObjectSorter::ObjectSorter(SortMode Mode) : Mode(Mode) {
+  assert(Mode != sr_none && "There is no order to sort in");
+  if (Mode == sr_offset)
+    return;
+
+  // The interned names are unique, so their positions are their ranks.
+  std::vector<size_t> Indexes = StringPool::getSortedIndexes();
+  NameRanks.reserve(Indexes.size());
+  for (size_t Rank = 0; Rank < Indexes.size(); ++Rank)
+    NameRanks.emplace(Indexes[Rank], static_cast<uint32_t>(Rank));
+}
+
+uint32_t ObjectSorter::getNameRank(size_t NameIndex) const {
+  auto It = NameRanks.find(NameIndex);
+  assert(It != NameRanks.end() && "The name was added after the sorter");
+  return It->second;
+}
+
+void ObjectSorter::sort(std::vector<Object *> &Objects) const {
+  if (Objects.size() < 2)
+    return;
+
+  // Only a few kinds are sorted at once, so they are ranked here. Each key
+  // first gets the position of its kind in Kinds.
+  std::vector<SortKey> Keys;
+  Keys.reserve(Objects.size());
+  std::vector<const char *> Kinds;
+  for (Object *Obj : Objects) {
+    SortKey Key = {0, 0, Obj->getLineNumber(), Obj->getDieOffset(), Obj};
+    if (Mode != sr_offset) {
+      Key.Name = getNameRank(Obj->getNameIndex());
+      const char *Kind = Obj->getKindAsString();
+      auto It = std::find(Kinds.begin(), Kinds.end(), Kind);
+      Key.Kind = static_cast<uint32_t>(It - Kinds.begin());
+      if (It == Kinds.end())
+        Kinds.push_back(Kind);
+    }
+    Keys.push_back(Key);
   }
-  return sort_function;
+  if (Kinds.size() > 1) {
+    std::vector<uint32_t> Order(Kinds.size());
+    std::iota(Order.begin(), Order.end(), 0U);
+    std::sort(Order.begin(), Order.end(), [&Kinds](uint32_t LHS, uint32_t RHS) {
+      return strcmp(Kinds[LHS], Kinds[RHS]) < 0;
+    });
+    // Different kinds can have the same name.
+    std::vector<uint32_t> Ranks(Kinds.size());
+    uint32_t Rank = 0;
+    for (size_t Index = 1; Index < Order.size(); ++Index) {
+      if (strcmp(Kinds[Order[Index - 1]], Kinds[Order[Index]]) != 0)
+        ++Rank;
+      Ranks[Order[Index]] = Rank;
+    }
+    for (SortKey &Key : Keys)
+      Key.Kind = Ranks[Key.Kind];
+  }
+
+  // The keys are compared in the same order as by the sort functions.
+  switch (Mode) {
+  case sr_kind:
+    std::sort(Keys.begin(), Keys.end(),
+              [](const SortKey &LHS, const SortKey &RHS) {
+                return std::tie(LHS.Kind, LHS.Name, LHS.Line, LHS.Offset) <
+                       std::tie(RHS.Kind, RHS.Name, RHS.Line, RHS.Offset);
+              });
+    break;
+  case sr_line:
+    std::sort(Keys.begin(), Keys.end(),
+              [](const SortKey &LHS, const SortKey &RHS) {
+                return std::tie(LHS.Line, LHS.Name, LHS.Kind, LHS.Offset) <
+                       std::tie(RHS.Line, RHS.Name, RHS.Kind, RHS.Offset);
+              });
+    break;
+  case sr_name:
+    std::sort(Keys.begin(), Keys.end(),
+              [](const SortKey &LHS, const SortKey &RHS) {
+                return std::tie(LHS.Name, LHS.Line, LHS.Kind, LHS.Offset) <
+                       std::tie(RHS.Name, RHS.Line, RHS.Kind, RHS.Offset);
+              });
+    break;
+  case sr_offset:
+    std::sort(Keys.begin(), Keys.end(),
+              [](const SortKey &LHS, const SortKey &RHS) {
+                return LHS.Offset < RHS.Offset;
+              });
+    break;
+  case sr_none:
+    break;
+  }
+
+  for (size_t Index = 0; Index < Keys.size(); ++Index)
+    Objects[Index] = Keys[Index].Obj;
 }
@@ -30,6 +30,11 @@
 #ifndef SORT_H
 #define SORT_H
 
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
 namespace LibScopeView {
 
 /// \brief Object Sorting Mode.
@@ -46,6 +51,7 @@ class Object;
 typedef bool (*SortFunction)(const Object *LHS, const Object *RHS);
 
 // Callback functions to sort objects.
+SortMode getViewSortMode();
 SortFunction getSortFunction();
 int compareKind(const Object *LHS, const Object *RHS);
 int compareLine(const Object *LHS, const Object *RHS);
@@ -56,6 +62,30 @@ bool sortByLine(const Object *LHS, const Object *RHS);
 bool sortByName(const Object *LHS, const Object *RHS);
 bool sortByOffset(const Object *LHS, const Object *RHS);
 
+/// \brief Sorts lists of Objects in the same order as the sort function of a
+/// mode.
+///
+/// The keys of each Object are computed once per sort, with the name and kind
+/// replaced by their ranks, so that comparing two Objects compares integers.
+/// The names are ranked when the sorter is created, so the Objects must not be
+/// given new names after that.
+class ObjectSorter {
+public:
+  explicit ObjectSorter(SortMode Mode);
+
+  SortMode getMode() const { return Mode; }
+
+  /// \brief Sort the Objects. This can be called from several threads.
+  void sort(std::vector<Object *> &Objects) const;
+
+private:
+  // Get the rank of an interned name.
+  uint32_t getNameRank(size_t NameIndex) const;
+
+  SortMode Mode;
+  std::unordered_map<size_t, uint32_t> NameRanks;
+};
+
 } // namespace LibScopeView
 
 #endif // SORT_H
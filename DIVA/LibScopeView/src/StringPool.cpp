@@ -31,8 +31,9 @@
 #include "CmdOptions.h"
 #include "PrintContext.h"
 
+#include <algorithm>
 #include <assert.h>
-#include <math.h>
+#include <stdexcept>
 #include <string.h>
 
 using namespace LibScopeView;
@@ -78,80 +79,154 @@ const char *StringPool::getStringValue(size_t Index) {
   return GlobalStringPool->getString(Index);
 }
 
-StringPool::StringPool() {
-  Hits = 0;
-  Misses = 0;
+std::vector<size_t> StringPool::getSortedIndexes() {
+  assert(GlobalStringPool);
+  return GlobalStringPool->getIndexesInOrder();
+}
 
-  TheStrings.push_back('\0');
+StringPool::StringPool()
+    : Chunks(new std::atomic<const char *>[MaxChunks]()), ChunkCount(0),
+      UsedBytes(1), WastedBytes(0) {
+  // The empty string is at index 0.
+  CurrentChunk = addChunks(1);
+  CurrentChunkData = ChunkStorage.back().get();
+  CurrentChunkData[0] = '\0';
+  CurrentChunkUsed = 1;
+
+  for (Shard &TheShard : Shards)
+    TheShard.Entries.resize(256);
 }
 
 StringPool::~StringPool() {}
 
 size_t StringPool::getIndex(const char *Str) {
-  // Index to string.
-  size_t Index = 0;
   // The NULL string is equivalent to the empty string.
-  if ((Str != nullptr) && (Str[0] != '\0')) {
-
-    // Any other string is hashed and looked up.
-    uint32_t Hash = strHash(Str);
-    size_t bucket = Hash % HASHTABLE_NUM_BUCKETS;
+  if ((Str == nullptr) || (Str[0] == '\0'))
+    return 0;
 
-    // Lookup.
-    bool Found = false;
-    Index = lookup(Str, bucket, Found);
-
-    if (!Found) {
-      // Create the string in the table.
-      Index = insert(Str, bucket);
-    }
+  // Any other string is hashed and looked up.
+  size_t Length;
+  uint32_t Hash = strHash(Str, Length);
+  Shard &TheShard = getShard(Hash);
+  std::lock_guard<std::mutex> Lock(TheShard.ShardMutex);
+
+  Entry &Found = findEntry(TheShard, Str, Length, Hash);
+  if (Found.Str) {
+    TheShard.Hits++;
+    return Found.Index;
   }
 
+  // Create the string in the table, keeping it at most 3/4 full.
+  Found.Index = insert(Str, Length);
+  Found.Str = Str;
+  Found.Length = Length;
+  Found.Hash = Hash;
+  size_t Index = Found.Index;
+  if (++TheShard.Count * 4 > TheShard.Entries.size() * 3)
+    growShard(TheShard);
   return Index;
 }
 
 size_t StringPool::lookup(const char *Str, bool &Found) {
-  // Any other string is hashed and looked up.
-  uint32_t Hash = strHash(Str);
-  size_t Bucket = Hash % HASHTABLE_NUM_BUCKETS;
-
-  // Lookup.
-  return lookup(Str, Bucket, Found);
+  Found = true;
+  if ((Str == nullptr) || (Str[0] == '\0'))
+    return 0;
+
+  size_t Length;
+  uint32_t Hash = strHash(Str, Length);
+  Shard &TheShard = getShard(Hash);
+  std::lock_guard<std::mutex> Lock(TheShard.ShardMutex);
+
+  const Entry &Existing = findEntry(TheShard, Str, Length, Hash);
+  Found = Existing.Str != nullptr;
+  if (!Found)
+    return 0;
+  TheShard.Hits++;
+  return Existing.Index;
 }
 
-size_t StringPool::lookup(const char *Str, size_t Bucket, bool &Found) {
-  // Index to string.
-  for (auto Index : HashTable[Bucket]) {
-    const char *stored_str = &(TheStrings[Index]);
-    if (strcmp(Str, stored_str) == 0) {
-      Hits++;
-      Found = true;
-      return Index;
-    }
+StringPool::Entry &StringPool::findEntry(Shard &TheShard, const char *Str,
+                                         size_t Length, uint32_t Hash) {
+  // Linear probing from the slot given by the bottom bits of the hash.
+  size_t Mask = TheShard.Entries.size() - 1;
+  for (size_t Slot = Hash & Mask;; Slot = (Slot + 1) & Mask) {
+    Entry &Candidate = TheShard.Entries[Slot];
+    if (!Candidate.Str)
+      return Candidate;
+    if (Candidate.Hash == Hash && Candidate.Length == Length &&
+        memcmp(Candidate.Str, Str, Length) == 0)
+      return Candidate;
   }
-
-  Found = false;
-  return 0;
 }
 
-size_t StringPool::insert(const char *Str, size_t Bucket) {
-  size_t Index = TheStrings.size();
-  while (*Str) {
-    TheStrings.push_back(*Str++);
+void StringPool::growShard(Shard &TheShard) {
+  std::vector<Entry> Old(TheShard.Entries.size() * 2);
+  Old.swap(TheShard.Entries);
+
+  // The stored hashes are reused, so no string is hashed again.
+  size_t Mask = TheShard.Entries.size() - 1;
+  for (const Entry &Existing : Old) {
+    if (!Existing.Str)
+      continue;
+    size_t Slot = Existing.Hash & Mask;
+    while (TheShard.Entries[Slot].Str)
+      Slot = (Slot + 1) & Mask;
+    TheShard.Entries[Slot] = Existing;
   }
-  TheStrings.push_back('\0');
+}
 
-  HashTable[Bucket].push_back(Index);
-  Misses++;
+size_t StringPool::insert(const char *&Str, size_t Length) {
+  std::lock_guard<std::mutex> Lock(StorageMutex);
+
+  size_t Size = Length + 1;
+  char *Stored;
+  size_t Index;
+  if (Size > ChunkSize) {
+    // Strings bigger than a chunk get chunks of their own.
+    size_t Count = (Size + ChunkSize - 1) >> ChunkBits;
+    Index = addChunks(Count) << ChunkBits;
+    Stored = ChunkStorage.back().get();
+    WastedBytes += (Count << ChunkBits) - Size;
+  } else {
+    if (CurrentChunkUsed + Size > ChunkSize) {
+      WastedBytes += ChunkSize - CurrentChunkUsed;
+      CurrentChunk = addChunks(1);
+      CurrentChunkData = ChunkStorage.back().get();
+      CurrentChunkUsed = 0;
+    }
+    Index = (CurrentChunk << ChunkBits) + CurrentChunkUsed;
+    Stored = CurrentChunkData + CurrentChunkUsed;
+    CurrentChunkUsed += Size;
+  }
+  memcpy(Stored, Str, Size);
+  UsedBytes += Size;
 
+  Str = Stored;
   return Index;
 }
 
+size_t StringPool::addChunks(size_t Count) {
+  size_t First = ChunkCount.load(std::memory_order_relaxed);
+  if (Count > MaxChunks - First)
+    throw std::length_error("String Pool is full.\n");
+
+  ChunkStorage.emplace_back(new char[Count << ChunkBits]);
+  char *Data = ChunkStorage.back().get();
+  for (size_t Chunk = 0; Chunk < Count; ++Chunk)
+    Chunks[First + Chunk].store(Data + (Chunk << ChunkBits),
+                                std::memory_order_release);
+  ChunkCount.store(First + Count, std::memory_order_release);
+  return First;
+}
+
 const char *StringPool::getString(size_t Index) {
-  if (Index > TheStrings.size()) {
+  // A chunk's start is published before its number is counted.
+  size_t Chunk = Index >> ChunkBits;
+  if (Chunk >= ChunkCount.load(std::memory_order_acquire)) {
     throw std::logic_error("Invalid string index in String Pool.\n");
   }
-  return &(TheStrings[Index]);
+  return Chunks[Chunk].load(std::memory_order_acquire) +
+         (Index & (ChunkSize - 1));
 }
 
 void StringPool::printInfo(const CmdOptions &Options) {
@@ -165,58 +240,98 @@ void StringPool::printInfo(const CmdOptions &Options) {
 }
 
 void StringPool::info(const char *Title) {
-  size_t MinEntries = static_cast<size_t>(-1);
-  size_t MaxEntries = 0;
-  double Average = (static_cast<double>(Misses) /
-                    static_cast<double>(HASHTABLE_NUM_BUCKETS));
-  double SumSquareErr = 0;
-  for (size_t i = 0; i < HASHTABLE_NUM_BUCKETS; ++i) {
-    if (MinEntries > HashTable[i].size())
-      MinEntries = HashTable[i].size();
-    if (MaxEntries < HashTable[i].size())
-      MaxEntries = HashTable[i].size();
-    SumSquareErr += ((static_cast<double>(HashTable[i].size()) - Average) *
-                     (static_cast<double>(HashTable[i].size()) - Average));
+  size_t Capacity = 0;
+  size_t Strings = 0;
+  size_t Hits = 0;
+  size_t TotalProbes = 0;
+  size_t MaxProbes = 0;
+  for (const Shard &TheShard : Shards) {
+    size_t Mask = TheShard.Entries.size() - 1;
+    Capacity += TheShard.Entries.size();
+    Strings += TheShard.Count;
+    Hits += TheShard.Hits;
+    // The number of entries a lookup of each string looks at.
+    for (size_t Slot = 0; Slot < TheShard.Entries.size(); ++Slot) {
+      const Entry &Existing = TheShard.Entries[Slot];
+      if (!Existing.Str)
+        continue;
+      size_t Probes = ((Slot - Existing.Hash) & Mask) + 1;
+      TotalProbes += Probes;
+      MaxProbes = std::max(MaxProbes, Probes);
+    }
   }
-  double Variance = SumSquareErr / static_cast<double>(HASHTABLE_NUM_BUCKETS);
+  double AverageProbes =
+      Strings ? static_cast<double>(TotalProbes) / static_cast<double>(Strings)
+              : 0.0;
 
   GlobalPrintContext->print("\n%s\n", Title);
-  GlobalPrintContext->print("Number of buckets:           %d\n", HASHTABLE_NUM_BUCKETS);
-  GlobalPrintContext->print("Pool misses (total strings): %d\n", Misses);
+  GlobalPrintContext->print("Number of shards:            %d\n", NumShards);
+  GlobalPrintContext->print("Number of table entries:     %d\n", Capacity);
+  GlobalPrintContext->print("Pool misses (total strings): %d\n", Strings);
   GlobalPrintContext->print("Pool hits:                   %d\n", Hits);
   GlobalPrintContext->print("Pool efficiency:             %f\n",
-         (static_cast<double>(Hits) / static_cast<double>(Misses)));
-  GlobalPrintContext->print("Min entries per bucket:      %d\n", MinEntries);
-  GlobalPrintContext->print("Max entries per bucket:      %d\n", MaxEntries);
-  GlobalPrintContext->print("Average entries per bucket:  %f\n", Average);
-  GlobalPrintContext->print("Standard deviation:          %f\n", sqrt(Variance));
-  GlobalPrintContext->print("Size of string table:        %d\n", TheStrings.size());
+         (static_cast<double>(Hits) / static_cast<double>(Strings)));
+  GlobalPrintContext->print("Load factor:                 %f\n",
+         (static_cast<double>(Strings) / static_cast<double>(Capacity)));
+  GlobalPrintContext->print("Average probes per string:   %f\n", AverageProbes);
+  GlobalPrintContext->print("Max probes per string:       %d\n", MaxProbes);
+  GlobalPrintContext->print("Size of string table:        %d\n", UsedBytes);
+  GlobalPrintContext->print("Number of chunks:            %d\n",
+                            ChunkCount.load());
+  GlobalPrintContext->print("Wasted tail bytes:           %d\n", WastedBytes);
 }
 
-uint32_t StringPool::strHash(const char *Str) {
+uint32_t StringPool::strHash(const char *Str, size_t &Length) {
+  const char *Start = Str;
   uint32_t Hash = 0;
-  if (Str) {
-    while (*Str != 0x00) {
-      char Ch = *Str++;
+  while (*Str != 0x00) {
+    char Ch = *Str++;
 
-      Hash += static_cast<uint32_t>(Ch);
-      Hash += (Hash << 10);
-      Hash ^= (Hash >> 6);
-    }
-    Hash += (Hash << 3);
-    Hash ^= (Hash >> 11);
-    Hash += (Hash << 15);
+    Hash += static_cast<uint32_t>(Ch);
+    Hash += (Hash << 10);
+    Hash ^= (Hash >> 6);
   }
+  Hash += (Hash << 3);
+  Hash ^= (Hash >> 11);
+  Hash += (Hash << 15);
+  Length = static_cast<size_t>(Str - Start);
   return Hash;
 }
 
+std::vector<size_t> StringPool::getIndexesInOrder() {
+  // The empty string is not in the tables, and sorts first.
+  std::vector<std::pair<const char *, size_t>> Strings;
+  Strings.emplace_back("", 0);
+  for (Shard &TheShard : Shards) {
+    std::lock_guard<std::mutex> Lock(TheShard.ShardMutex);
+    for (const Entry &Existing : TheShard.Entries)
+      if (Existing.Str)
+        Strings.emplace_back(Existing.Str, Existing.Index);
+  }
+  std::sort(Strings.begin() + 1, Strings.end(),
+            [](const std::pair<const char *, size_t> &LHS,
+               const std::pair<const char *, size_t> &RHS) {
+              return strcmp(LHS.first, RHS.first) < 0;
+            });
+
+  std::vector<size_t> Indexes;
+  Indexes.reserve(Strings.size());
+  for (const auto &String : Strings)
+    Indexes.push_back(String.second);
+  return Indexes;
+}
+
 void StringPool::dump(const char *Title) {
   GlobalPrintContext->print("\n%s\n", Title);
-  for (size_t Bucket = 0; Bucket < HASHTABLE_NUM_BUCKETS; ++Bucket) {
-    for (auto Index : HashTable[Bucket]) {
-      const char *Str = &(TheStrings[Index]);
-      GlobalPrintContext->print("Bucket=%08x,index=%08x,str='%s'\n", Bucket,
-                                Index, Str);
+  for (unsigned ShardIndex = 0; ShardIndex < NumShards; ++ShardIndex) {
+    const Shard &TheShard = Shards[ShardIndex];
+    for (size_t Slot = 0; Slot < TheShard.Entries.size(); ++Slot) {
+      const Entry &Existing = TheShard.Entries[Slot];
+      if (!Existing.Str)
+        continue;
+      GlobalPrintContext->print("Shard=%02x,slot=%08x,index=%08x,str='%s'\n",
+                                ShardIndex, Slot, Existing.Index,
+                                Existing.Str);
     }
   }
 }
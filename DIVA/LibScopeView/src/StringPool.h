@@ -30,21 +30,29 @@
 #ifndef STRINGPOOL_H_
 #define STRINGPOOL_H_
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
-#define HASHTABLE_NUM_BUCKETS 8192
-
 namespace LibScopeView {
 
 class CmdOptions;
 
 /// \brief This class implements a String Pool for deduplicating strings.
 ///
-/// The deduplicated strings are stored in one contiguous bit of memory, and a
-/// hash table is then used to index them.
+/// The deduplicated strings are stored in fixed-size chunks of memory, so they
+/// never move once added, and open-addressing hash tables are then used to
+/// index them. Each table entry keeps the hash and length of its string, so
+/// most mismatches are rejected without comparing the strings.
+///
+/// The pool can be used from several threads at once (e.g. by a reader
+/// creating compile units in parallel). The tables are split into shards
+/// selected by the hash, each with its own lock, and strings can be read
+/// without taking a lock.
 class StringPool {
 public:
   StringPool(StringPool const &) = delete;
@@ -55,6 +63,10 @@ public:
   static size_t getStringIndex(const std::string &Str);
   static const char *getStringValue(size_t Index);
 
+  /// \brief Get the indexes of all the strings in the pool, in the order of
+  /// the strings.
+  static std::vector<size_t> getSortedIndexes();
+
   static void create();
   static void destroy(const CmdOptions &Options);
 
@@ -73,6 +85,10 @@ public:
   /// \brief Returns the string stored for the given index.
   const char *getString(size_t Index);
 
+  /// \brief Returns the indexes of all the strings, in the order of the
+  /// strings.
+  std::vector<size_t> getIndexesInOrder();
+
   /// \brief Dump the whole String Pool contents.
   void dump(const char *Title = "String Pool Table:");
 
@@ -84,31 +100,84 @@ protected:
   virtual ~StringPool();
 
 private:
+  // An entry in a hash table. Str is null for empty entries.
+  struct Entry {
+    const char *Str;
+    size_t Length;
+    size_t Index;
+    uint32_t Hash;
+  };
+
+  // A part of the hash table with its own lock. The number of entries is
+  // always a power of two.
+  struct Shard {
+    std::mutex ShardMutex;
+    std::vector<Entry> Entries;
+    size_t Count = 0;
+    size_t Hits = 0;
+  };
+
+  // The shard is chosen by the top bits of the hash.
+  static const unsigned ShardBits = 4;
+  static const unsigned NumShards = 1U << ShardBits;
+
+  // The strings are stored in chunks of this size. An index is the chunk
+  // number times the chunk size plus the offset in the chunk. Strings that
+  // are too big for a chunk get several consecutive chunk numbers.
+  static const unsigned ChunkBits = 20;
+  static const size_t ChunkSize = static_cast<size_t>(1) << ChunkBits;
+  static const size_t MaxChunks = static_cast<size_t>(1) << 16;
+
   // Create an empty String Pool.
   StringPool();
 
-  // The hashing function for the String Pool.
-  uint32_t strHash(const char *Str);
+  // The hashing function for the String Pool, which also gets the length.
+  uint32_t strHash(const char *Str, size_t &Length);
+
+  Shard &getShard(uint32_t Hash) { return Shards[Hash >> (32 - ShardBits)]; }
 
-  // Looks for a specific string inside the String Pool.
-  size_t lookup(const char *Str, size_t Bucket, bool &Found);
+  // Find the entry for a string in a shard, or the empty entry where it
+  // should go. The shard must be locked.
+  Entry &findEntry(Shard &TheShard, const char *Str, size_t Length,
+                   uint32_t Hash);
 
-  // Creates a specific string in this String Pool and returns it's index.
-  size_t insert(const char *Str, size_t Bucket);
+  // Double the size of a shard's hash table.
+  void growShard(Shard &TheShard);
+
+  // Copies a string into the storage and returns it's index. Str is set to
+  // the stored copy, which never moves.
+  size_t insert(const char *&Str, size_t Length);
+
+  // Allocate Count consecutive chunks and return the number of the first.
+  // The storage must be locked.
+  size_t addChunks(size_t Count);
 
   // Display information requested by the user.
   void printInfo(const CmdOptions &Options);
 
 private:
-  // All the strings in the pool, as null-terminated char sequences.
-  std::vector<char> TheStrings;
+  Shard Shards[NumShards];
+
+  // Serializes adding to the storage.
+  std::mutex StorageMutex;
+
+  // The chunks holding the strings, as null-terminated char sequences.
+  std::vector<std::unique_ptr<char[]>> ChunkStorage;
+
+  // The start of each chunk number in use, published for reading the strings
+  // without a lock.
+  std::unique_ptr<std::atomic<const char *>[]> Chunks;
+  std::atomic<size_t> ChunkCount;
 
-  // The hash table indexing the strings in the pool.
-  std::vector<size_t> HashTable[HASHTABLE_NUM_BUCKETS];
+  // The chunk strings are being added to, and how much of it is used.
+  size_t CurrentChunk;
+  char *CurrentChunkData;
+  size_t CurrentChunkUsed;
 
-  // Track hits and misses.
-  size_t Hits;
-  size_t Misses;
+  // The bytes used by strings, and the unused bytes left at the end of
+  // chunks.
+  size_t UsedBytes;
+  size_t WastedBytes;
 };
 
 } // namespace LibScopeView
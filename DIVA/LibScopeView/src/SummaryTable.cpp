@@ -58,7 +58,7 @@ SummaryTable::SummaryTable()
 
   // Add a row to the table for each DIVA object.
   for (auto Label : RowLabels) {
-    Rows.emplace(Label, SummaryTableRow());
+    Rows[Label];
   }
 }
 
@@ -85,23 +85,23 @@ void SummaryTable::getPrintedSummaryTable(std::ostream &Out) {
       << Indent << Divider << "\n";
 
   // Output each row.
-  for (auto Row : Rows) {
-    auto RowLabel = Row.first;
-    auto RowData = Row.second;
+  for (const auto &Row : Rows) {
+    const auto &RowLabel = Row.first;
+    const auto &RowData = Row.second;
     Out << Indent << std::left << std::setw(LabelWidth) << RowLabel
-        << std::right << std::setw(ColumnWidth) << RowData.ObjectsFound
-        << std::setw(ColumnWidth) << RowData.ObjectsPrinted << "\n";
+        << std::right << std::setw(ColumnWidth) << RowData.ObjectsFound.load()
+        << std::setw(ColumnWidth) << RowData.ObjectsPrinted.load() << "\n";
   }
 
   // Output the footer.
   Out << Indent << Divider << std::endl
       << std::left << Indent << std::setw(LabelWidth) << TotalsLabel
-      << std::right << std::setw(ColumnWidth) << TotalFound
-      << std::setw(ColumnWidth) << TotalPrinted << "\n"
+      << std::right << std::setw(ColumnWidth) << TotalFound.load()
+      << std::setw(ColumnWidth) << TotalPrinted.load() << "\n"
       << "\n";
 }
 
-void SummaryTable::incrementFound(const Object *Obj) {
+void SummaryTable::incrementFound(const Object *Obj, uint32_t Count) {
   if (!Obj)
     return;
 
@@ -110,8 +110,8 @@ void SummaryTable::incrementFound(const Object *Obj) {
   if (Row == Rows.end())
     return;
 
-  ++(Row->second.ObjectsFound);
-  ++TotalFound;
+  Row->second.ObjectsFound += Count;
+  TotalFound += Count;
 }
 
 void SummaryTable::incrementPrinted(const Object *Obj) {
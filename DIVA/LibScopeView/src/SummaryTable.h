@@ -30,6 +30,8 @@
 #ifndef SUMMARY_TABLE_H
 #define SUMMARY_TABLE_H
 
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <string>
 
@@ -45,7 +47,9 @@ public:
   void getPrintedSummaryTable(std::ostream &out);
 
   /// \brief Increment a specific column in Obj's row.
-  void incrementFound(const Object *obj);
+  ///
+  /// The counters are atomic, so objects can be counted concurrently.
+  void incrementFound(const Object *obj, uint32_t Count = 1);
   void incrementPrinted(const Object *obj);
   void incrementMissing(const Object *obj);
   void incrementAdded(const Object *obj);
@@ -56,20 +60,20 @@ private:
         : ObjectsFound(0), ObjectsPrinted(0), ObjectsMissing(0),
           ObjectsAdded(0) {}
     // Each row has numerous fields that can be incremented as needed.
-    uint32_t ObjectsFound;
-    uint32_t ObjectsPrinted;
-    uint32_t ObjectsMissing;
-    uint32_t ObjectsAdded;
+    std::atomic<uint32_t> ObjectsFound;
+    std::atomic<uint32_t> ObjectsPrinted;
+    std::atomic<uint32_t> ObjectsMissing;
+    std::atomic<uint32_t> ObjectsAdded;
   };
 
   // Map of the rows, indexed via the ObjectsClassID.
   std::map<std::string, SummaryTableRow> Rows;
 
   // Totals for all four columns of the summary table.
-  unsigned int TotalFound;
-  unsigned int TotalPrinted;
-  unsigned int TotalMissing;
-  unsigned int TotalAdded;
+  std::atomic<unsigned int> TotalFound;
+  std::atomic<unsigned int> TotalPrinted;
+  std::atomic<unsigned int> TotalMissing;
+  std::atomic<unsigned int> TotalAdded;
 
   // Column width values.
   const static uint32_t LabelWidth = 19;
@@ -32,7 +32,6 @@
 #include "Reader.h"
 
 #include <assert.h>
-#include <sstream>
 
 using namespace LibScopeView;
 
@@ -40,6 +39,7 @@ Symbol::Symbol(LevelType Lvl)
     : Element(Lvl), TheAccessSpecifier(AccessSpecifier::Unspecified),
       IsStatic(false), Reference(nullptr) {
   setIsSymbol();
+  setKind(ok_symbol);
 
   Symbol::setTag();
 }
@@ -48,19 +48,21 @@ Symbol::Symbol()
     : Element(), TheAccessSpecifier(AccessSpecifier::Unspecified),
       IsStatic(false), Reference(nullptr) {
   setIsSymbol();
+  setKind(ok_symbol);
 
   Symbol::setTag();
 }
 
 Symbol::~Symbol() {}
 
-uint32_t Symbol::SymbolsAllocated = 0;
+std::atomic<uint32_t> Symbol::SymbolsAllocated(0);
 
 // Set Unique Object identifier, for debug purposes
 void Symbol::setTag() {
-  ++Symbol::SymbolsAllocated;
 #ifndef NDEBUG
-  Tag = Symbol::SymbolsAllocated;
+  Tag = ++Symbol::SymbolsAllocated;
+#else
+  ++Symbol::SymbolsAllocated;
 #endif
 }
 
@@ -131,12 +133,12 @@ void Symbol::dump() {
 }
 
 void Symbol::dumpExtra() {
-  GlobalPrintContext->print("%s\n", getAsText().c_str());
+  getPrintContext()->printText(*this);
 }
 
 bool Symbol::dump(bool DoHeader, const char *Header) {
   if (DoHeader) {
-    GlobalPrintContext->print("\n%s\n", Header);
+    getPrintContext()->print("\n%s\n", Header);
     DoHeader = false;
   }
 
@@ -146,95 +148,62 @@ bool Symbol::dump(bool DoHeader, const char *Header) {
   return DoHeader;
 }
 
-std::string Symbol::getAsText() const {
-  std::stringstream Result;
+void Symbol::appendText(TextBuffer &Text) const {
   const Symbol *Sym = getIsInlined() ? Reference : this;
-  Result << "{" << Sym->getKindAsString() << "}";
+  Text.append('{');
+  Text.append(Sym->getKindAsString());
+  Text.append('}');
 
   // Access specifier.
   if (Sym->getIsMember()) {
-    switch (getAccessSpecifier()) {
-    case AccessSpecifier::Private:
-      Result << " private";
-      break;
-    case AccessSpecifier::Protected:
-      Result << " protected";
-      break;
-    case AccessSpecifier::Public:
-      Result << " public";
-      break;
-    case AccessSpecifier::Unspecified:
-      assert(getParent());
-      if (getParent() && getParent()->getIsClassType())
-        Result << " private";
-      else
-        Result << " public";
-      break;
-    }
+    Text.append(' ');
+    Text.append(getAccessSpecifierName(getAccessSpecifier(), getParent()));
   }
 
   if (Sym->getIsStatic())
-    Result << " static";
+    Text.append(" static");
 
   if (Sym->getIsUnspecifiedParameter()) {
-    Result << " \"...\"";
+    Text.append(" \"...\"");
   } else {
     if (Sym->getNameIndex() != 0) {
-      Result << " \"";
+      Text.append(" \"");
       if (Sym->getHasQualifiedName() &&
           getReader()->getOptions().getFormatQualifiedName())
-        Result << Sym->getQualifiedName();
-      Result << getName() << "\"";
+        Text.append(Sym->getQualifiedName());
+      Text.append(getName());
+      Text.append('"');
     }
 
     const Scope *parent = Sym->getParent();
     if (parent && parent->getIsScope() && parent->getIsTemplate())
-      Result << " <- ";
+      Text.append(" <- ");
     else
-      Result << " -> ";
-    Result << Sym->getTypeDieOffsetAsString() << "\""
-           << Sym->getTypeQualifiedName() << Sym->getTypeAsString() << "\"";
+      Text.append(" -> ");
+    Sym->appendTypeDieOffset(Text);
+    Text.append('"');
+    Text.append(Sym->getTypeQualifiedName());
+    Text.append(Sym->getTypeAsString());
+    Text.append('"');
   }
-
-  return Result.str();
 }
 
-std::string Symbol::getAsYAML() const {
-  std::stringstream YAML;
-  std::stringstream Attrs;
+void Symbol::appendYAML(TextBuffer &YAML) const {
   const Symbol *Sym = getIsInlined() ? Reference : this;
 
+  appendCommonYAML(YAML);
+  YAML.append("\nattributes:");
+
   // Access specifier.
   if (Sym->getIsMember()) {
-    Attrs << "\n  access_specifier: \"";
-    switch (getAccessSpecifier()) {
-    case AccessSpecifier::Private:
-      Attrs << "private";
-      break;
-    case AccessSpecifier::Protected:
-      Attrs << "protected";
-      break;
-    case AccessSpecifier::Public:
-      Attrs << "public";
-      break;
-    case AccessSpecifier::Unspecified:
-      assert(getParent());
-      if (getParent() && getParent()->getIsClassType())
-        Attrs << "private";
-      else
-        Attrs << "public";
-      break;
-    }
-    Attrs << '"';
+    YAML.append("\n  access_specifier: \"");
+    YAML.append(getAccessSpecifierName(getAccessSpecifier(), getParent()));
+    YAML.append('"');
+  } else {
+    YAML.append(" {}");
   }
 
   // TODO: Uncomment and test once static is set by reader.
   // if (getIsMember())
   //   Attrs << "\n  static: " << (Sym->getIsStatic() ? "true" : "false");
-
-  if (Attrs.str().empty())
-    Attrs << " {}";
-
-  YAML << getCommonYAML() << "\nattributes:" << Attrs.str();
-  return YAML.str();
 }
@@ -44,6 +44,8 @@ public:
   Symbol &operator=(const Symbol &) = delete;
   Symbol(const Symbol &) = delete;
 
+  static bool classof(const Object *Obj) { return Obj->getKind() == ok_symbol; }
+
 private:
   // Symbol Kind.
   static const char *KindMember;
@@ -118,13 +120,14 @@ public:
   virtual void dumpExtra();
   virtual bool dump(bool DoHeader, const char *Header);
 
-  /// \brief Returns a text representation of this DIVA Object.
-  std::string getAsText() const override;
-  /// \brief Returns a YAML representation of this DIVA Object.
-  std::string getAsYAML() const override;
+  /// \brief Appends a text representation of this DIVA Object.
+  void appendText(TextBuffer &Text) const override;
+  /// \brief Appends a YAML representation of this DIVA Object.
+  void appendYAML(TextBuffer &YAML) const override;
 
 private:
-  static uint32_t SymbolsAllocated;
+  static std::atomic<uint32_t> SymbolsAllocated;
+  friend class UncountedObjects;
 
 public:
   static uint32_t getInstanceCount() { return SymbolsAllocated; }
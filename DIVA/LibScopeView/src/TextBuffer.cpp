@@ -0,0 +1,104 @@
+//===-- LibScopeView/TextBuffer.cpp -----------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Implementation for the TextBuffer class.
+///
+//===----------------------------------------------------------------------===//
+
+#include "TextBuffer.h"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace LibScopeView;
+
+void TextBuffer::appendSigned(long long Value) {
+  if (Value < 0) {
+    Text.push_back('-');
+    appendUnsigned(0ULL - static_cast<unsigned long long>(Value));
+  } else {
+    appendUnsigned(static_cast<unsigned long long>(Value));
+  }
+}
+
+void TextBuffer::appendUnsigned(unsigned long long Value) {
+  // The digits are made from the last one back.
+  char Digits[20];
+  char *Start = Digits + sizeof(Digits);
+  do {
+    *--Start = static_cast<char>('0' + Value % 10);
+    Value /= 10;
+  } while (Value);
+  Text.append(Start, Digits + sizeof(Digits) - Start);
+}
+
+void TextBuffer::appendHex(uint64_t Value, unsigned MinDigits) {
+  static const char HexDigits[] = "0123456789abcdef";
+  char Digits[16];
+  char *Start = Digits + sizeof(Digits);
+  do {
+    *--Start = HexDigits[Value & 0xf];
+    Value >>= 4;
+  } while (Value);
+  size_t Length = static_cast<size_t>(Digits + sizeof(Digits) - Start);
+  if (Length < MinDigits)
+    Text.append(MinDigits - Length, '0');
+  Text.append(Start, Length);
+}
+
+void TextBuffer::appendRight(const char *Str, size_t Width) {
+  size_t Length = strlen(Str);
+  if (Length < Width)
+    Text.append(Width - Length, ' ');
+  Text.append(Str, Length);
+}
+
+#ifdef __clang__
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wformat-nonliteral"
+#endif
+void TextBuffer::appendFormatted(const char *Fmt, va_list Args) {
+  // Most texts fit in a small buffer; a longer one is formatted again, in
+  // place at the end of the text.
+  va_list Retry;
+  va_copy(Retry, Args);
+  char Small[256];
+  int Result = vsnprintf(Small, sizeof(Small), Fmt, Args);
+  if (Result >= 0) {
+    size_t Length = static_cast<size_t>(Result);
+    if (Length < sizeof(Small)) {
+      Text.append(Small, Length);
+    } else {
+      size_t Size = Text.size();
+      Text.resize(Size + Length + 1);
+      vsnprintf(&Text[Size], Length + 1, Fmt, Retry);
+      Text.resize(Size + Length);
+    }
+  }
+  va_end(Retry);
+}
+#ifdef __clang__
+#pragma clang diagnostic pop
+#endif
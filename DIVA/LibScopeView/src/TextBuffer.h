@@ -0,0 +1,95 @@
+//===-- LibScopeView/TextBuffer.h -------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Definition of the TextBuffer class.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef TEXT_BUFFER_H
+#define TEXT_BUFFER_H
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace LibScopeView {
+
+/// \brief A buffer that text is appended to, such as the text or YAML form of
+/// an object.
+///
+/// The buffer keeps its memory when it is cleared, so it can be reused without
+/// allocating. Numbers are formatted directly, without the stream and locale
+/// machinery.
+class TextBuffer {
+public:
+  TextBuffer() {}
+
+  void append(char C) { Text.push_back(C); }
+  void append(const char *Str) { Text.append(Str); }
+  void append(const char *Str, size_t Length) { Text.append(Str, Length); }
+  void append(const std::string &Str) { Text.append(Str); }
+  /// \brief Append Count copies of C.
+  void append(size_t Count, char C) { Text.append(Count, C); }
+
+  /// \brief Append the decimal form of a number.
+  void appendDecimal(int Value) { appendSigned(Value); }
+  void appendDecimal(long Value) { appendSigned(Value); }
+  void appendDecimal(long long Value) { appendSigned(Value); }
+  void appendDecimal(unsigned Value) { appendUnsigned(Value); }
+  void appendDecimal(unsigned long Value) { appendUnsigned(Value); }
+  void appendDecimal(unsigned long long Value) { appendUnsigned(Value); }
+
+  /// \brief Append the lower case hexadecimal form of a number, with leading
+  /// zeros up to MinDigits digits.
+  void appendHex(uint64_t Value, unsigned MinDigits = 1);
+
+  /// \brief Append the text with spaces in front, so it is at least Width
+  /// characters long, as "%*s" does.
+  void appendRight(const char *Str, size_t Width);
+
+  /// \brief Append the text formatted by vsnprintf.
+  void appendFormatted(const char *Fmt, va_list Args);
+
+  const char *data() const { return Text.data(); }
+  size_t size() const { return Text.size(); }
+  bool empty() const { return Text.empty(); }
+  void clear() { Text.clear(); }
+  void reserve(size_t Size) { Text.reserve(Size); }
+  const std::string &str() const { return Text; }
+  /// \brief Exchange the text with Other, such as to hand it on without
+  /// copying it.
+  void swap(std::string &Other) { Text.swap(Other); }
+
+private:
+  void appendSigned(long long Value);
+  void appendUnsigned(unsigned long long Value);
+
+  std::string Text;
+};
+
+} // namespace LibScopeView
+
+#endif // TEXT_BUFFER_H
@@ -34,30 +34,32 @@
 
 #include <assert.h>
 #include <cstring>
-#include <sstream>
 
 using namespace LibScopeView;
 
 Type::Type(LevelType Lvl) : Element(Lvl), ByteSize(0) {
   setIsType();
+  setKind(ok_type);
 
   Type::setTag();
 }
 
 Type::Type() : ByteSize(0) {
   setIsType();
+  setKind(ok_type);
 
   Type::setTag();
 }
 
 Type::~Type() {}
 
-uint32_t Type::TypesAllocated = 0;
+std::atomic<uint32_t> Type::TypesAllocated(0);
 
 void Type::setTag() {
-  ++Type::TypesAllocated;
 #ifndef NDEBUG
-  Tag = Type::TypesAllocated;
+  Tag = ++Type::TypesAllocated;
+#else
+  ++Type::TypesAllocated;
 #endif
 }
 
@@ -170,12 +172,12 @@ void Type::dump() {
 }
 
 void Type::dumpExtra() {
-  GlobalPrintContext->print("%s\n", getAsText().c_str());
+  getPrintContext()->printText(*this);
 }
 
 bool Type::dump(bool DoHeader, const char *Header) {
   if (DoHeader) {
-    GlobalPrintContext->print("\n%s\n", Header);
+    getPrintContext()->print("\n%s\n", Header);
     DoHeader = false;
   }
 
@@ -187,39 +189,42 @@ bool Type::dump(bool DoHeader, const char *Header) {
 
 bool Type::getIsPrintedAsObject() const { return getIsBaseType(); }
 
-std::string Type::getAsText() const {
-  std::string Result;
-  Result += "{";
-  Result += getKindAsString();
-  Result += "} -> \"";
-  Result += getName();
-  Result += "\"";
+void Type::appendText(TextBuffer &Text) const {
+  Text.append('{');
+  Text.append(getKindAsString());
+  Text.append("} -> \"");
+  Text.append(getName());
+  Text.append('"');
   unsigned byte_size = getByteSize();
   if (byte_size) {
-    Result += '\n';
-    Result += getAttributeInfoAsText(std::to_string(byte_size));
-    Result += " bytes";
+    appendAttributeInfo(Text, "");
+    Text.appendDecimal(byte_size);
+    Text.append(" bytes");
   }
-  return Result;
 }
 
-std::string Type::getAsYAML() const {
+void Type::appendYAML(TextBuffer &YAML) const {
   assert(getIsBaseType());
 
-  // We can't use getCommonYAML here as the name is printed under 'type:'.
-  std::stringstream YAML;
-  YAML << "object: \"" << getKindAsString() << "\"\nname: null\ntype: \""
-       << getName() << "\"\nsource:\n  line: null\n  file: null\n"
-       << "dwarf:\n  offset: 0x" << std::hex << getDieOffset() << "\n";
+  // We can't use appendCommonYAML here as the name is printed under 'type:'.
+  YAML.append("object: \"");
+  YAML.append(getKindAsString());
+  YAML.append("\"\nname: null\ntype: \"");
+  YAML.append(getName());
+  YAML.append("\"\nsource:\n  line: null\n  file: null\n");
+  YAML.append("dwarf:\n  offset: 0x");
+  YAML.appendHex(getDieOffset());
+  YAML.append('\n');
 
   const char *TagName = "";
   if (getDieTag())
     dwarf_get_TAG_name(getDieTag(), &TagName);
-  YAML << "  tag: \"" << TagName << "\"\n";
-
-  YAML << "attributes:\n  size: " << std::dec << getByteSize();
+  YAML.append("  tag: \"");
+  YAML.append(TagName);
+  YAML.append("\"\n");
 
-  return YAML.str();
+  YAML.append("attributes:\n  size: ");
+  YAML.appendDecimal(getByteSize());
 }
 
 unsigned Type::getByteSize() const { return ByteSize; }
@@ -227,9 +232,11 @@ unsigned Type::getByteSize() const { return ByteSize; }
 void Type::setByteSize(unsigned Size) { ByteSize = Size; }
 
 /// \brief Class to represent a DWARF typedef object.
-TypeDefinition::TypeDefinition(LevelType Lvl) : Type(Lvl) {}
+TypeDefinition::TypeDefinition(LevelType Lvl) : Type(Lvl) {
+  setKind(ok_type_definition);
+}
 
-TypeDefinition::TypeDefinition() : Type() {}
+TypeDefinition::TypeDefinition() : Type() { setKind(ok_type_definition); }
 
 TypeDefinition::~TypeDefinition() {}
 
@@ -257,32 +264,37 @@ void TypeDefinition::setUnderlyingType(Object *Obj) { setType(Obj); }
 
 void TypeDefinition::dumpExtra() {
   // Print the full type name.
-  GlobalPrintContext->print("%s\n", getAsText().c_str());
-}
-
-std::string TypeDefinition::getAsText() const {
-  std::string Result;
-  Result += "{";
-  Result += getKindAsString();
-  Result += "} \"";
-  Result += getName();
-  Result += "\" -> ";
-  Result += getTypeDieOffsetAsString();
-  Result += "\"";
+  getPrintContext()->printText(*this);
+}
+
+void TypeDefinition::appendText(TextBuffer &Text) const {
+  Text.append('{');
+  Text.append(getKindAsString());
+  Text.append("} \"");
+  Text.append(getName());
+  Text.append("\" -> ");
+  appendTypeDieOffset(Text);
+  Text.append('"');
   if (getType() != nullptr)
-    Result += getType()->getName();
-  Result += "\"";
-  return Result;
+    Text.append(getType()->getName());
+  Text.append('"');
 }
 
-std::string TypeDefinition::getAsYAML() const {
-  return getCommonYAML() + std::string("\nattributes: {}");
+void TypeDefinition::appendYAML(TextBuffer &YAML) const {
+  appendCommonYAML(YAML);
+  YAML.append("\nattributes: {}");
 }
 
 /// \brief Class to represent a DWARF enumerator (DW_TAG_enumerator).
-TypeEnumerator::TypeEnumerator(LevelType Lvl) : Type(Lvl) { ValueIndex = 0; }
+TypeEnumerator::TypeEnumerator(LevelType Lvl) : Type(Lvl) {
+  setKind(ok_type_enumerator);
+  ValueIndex = 0;
+}
 
-TypeEnumerator::TypeEnumerator() : Type() { ValueIndex = 0; }
+TypeEnumerator::TypeEnumerator() : Type() {
+  setKind(ok_type_enumerator);
+  ValueIndex = 0;
+}
 
 TypeEnumerator::~TypeEnumerator() {}
 
@@ -298,34 +310,35 @@ size_t TypeEnumerator::getValueIndex() const { return ValueIndex; }
 
 void TypeEnumerator::dumpExtra() {
   // Print the full type.
-  GlobalPrintContext->print("%s\n", getAsText().c_str());
+  getPrintContext()->printText(*this);
 }
 
-std::string TypeEnumerator::getAsText() const {
-  std::string ObjectAsText = "  -";
-  std::string Name = getName();
-  std::string Value = getValue();
-  std::string DieOffset = getTypeDieOffsetAsString();
-
-  ObjectAsText.append(" \"").append(Name).append("\" = ").append(Value);
+void TypeEnumerator::appendText(TextBuffer &Text) const {
+  Text.append("  - \"");
+  Text.append(getName());
+  Text.append("\" = ");
+  Text.append(getValue());
 
-  if (!DieOffset.empty())
-    ObjectAsText.append(" ").append(DieOffset);
-
-  return ObjectAsText;
+  if (getPrintContext()->getLayout().getOptions().getAttributeOffset()) {
+    Text.append(' ');
+    appendTypeDieOffset(Text);
+  }
 }
 
-std::string TypeEnumerator::getAsYAML() const {
+void TypeEnumerator::appendYAML(TextBuffer & /*YAML*/) const {
   // Printing enumerators is handled in ScopeEnumeration.
-  return "";
 }
 
 /// \brief Class to represent a DWARF Import object (Using).
 TypeImport::TypeImport(LevelType Lvl)
-    : Type(Lvl), InheritanceAccess(AccessSpecifier::Unspecified) {}
+    : Type(Lvl), InheritanceAccess(AccessSpecifier::Unspecified) {
+  setKind(ok_type_import);
+}
 
 TypeImport::TypeImport()
-    : Type(), InheritanceAccess(AccessSpecifier::Unspecified) {}
+    : Type(), InheritanceAccess(AccessSpecifier::Unspecified) {
+  setKind(ok_type_import);
+}
 
 TypeImport::~TypeImport() {}
 
@@ -342,128 +355,94 @@ void TypeImport::setInheritanceAccess(AccessSpecifier access) {
 
 void TypeImport::dumpExtra() {
   if (getIsInheritance()) {
-    GlobalPrintContext->print("%s\n", getAsText().c_str());
+    getPrintContext()->printText(*this);
     return;
   }
   // Do not print the full type name; just the imported object.
-  GlobalPrintContext->print("%s\n", getAsText().c_str());
+  getPrintContext()->printText(*this);
 }
 
 bool TypeImport::getIsPrintedAsObject() const { return !getIsInheritance(); }
 
-std::string TypeImport::getAsText() const {
+void TypeImport::appendText(TextBuffer &Text) const {
   if (getIsInheritance())
-    return getInheritanceAsText();
+    appendInheritanceText(Text);
   else
-    return getUsingAsText();
-}
-
-std::string TypeImport::getInheritanceAsText() const {
-  std::stringstream Result;
-  Result << "  - ";
-  switch (getInheritanceAccess()) {
-  case AccessSpecifier::Private:
-    Result << "private";
-    break;
-  case AccessSpecifier::Protected:
-    Result << "protected";
-    break;
-  case AccessSpecifier::Public:
-    Result << "public";
-    break;
-  case AccessSpecifier::Unspecified:
-    assert(getParent());
-    if (getParent() && getParent()->getIsClassType())
-      Result << "private";
-    else
-      Result << "public";
-    break;
-  }
-  Result << " \"" << getTypeName() << '"';
-  return Result.str();
+    appendUsingText(Text);
+}
+
+void TypeImport::appendInheritanceText(TextBuffer &Text) const {
+  Text.append("  - ");
+  Text.append(getAccessSpecifierName(getInheritanceAccess(), getParent()));
+  Text.append(" \"");
+  Text.append(getTypeName());
+  Text.append('"');
 }
 
-std::string TypeImport::getUsingAsText() const {
-  std::stringstream Result;
-  Result << "{" << getKindAsString() << "}";
-  Result << getTypeDieOffsetAsString();
+void TypeImport::appendUsingText(TextBuffer &Text) const {
+  Text.append('{');
+  Text.append(getKindAsString());
+  Text.append('}');
+  appendTypeDieOffset(Text);
   Object *objtype = getType();
   if (objtype) {
     Scope *Parent = nullptr;
     if (getIsImportedDeclaration()) {
       if (objtype->getIsType()) {
         Parent = objtype->getParent();
-        Result << " type";
+        Text.append(" type");
       } else if (objtype->getIsScope()) {
         auto scope = static_cast<Scope *>(objtype);
         Parent = scope->getParent();
         if (scope->getIsFunction())
-          Result << " function";
+          Text.append(" function");
         else if (scope->getIsAggregate())
-          Result << " type";
+          Text.append(" type");
       } else if (objtype->getIsSymbol()) {
         auto symbol = static_cast<Symbol *>(objtype);
         if (symbol->getIsVariable() || symbol->getIsMember()) {
           Parent = symbol->getParent();
-          Result << " variable";
+          Text.append(" variable");
         }
       }
     } else if (getIsImportedModule())
-      Result << " namespace";
-    Result << " \"";
+      Text.append(" namespace");
+    Text.append(" \"");
     std::string ParentName;
     if (Parent != nullptr && !Parent->getIsCompileUnit())
       Parent->getQualifiedName(ParentName);
-    if (!ParentName.empty())
-      Result << ParentName << "::";
-    Result << objtype->getName() << "\"";
+    if (!ParentName.empty()) {
+      Text.append(ParentName);
+      Text.append("::");
+    }
+    Text.append(objtype->getName());
+    Text.append('"');
   }
-  return Result.str();
 }
 
-std::string TypeImport::getAsYAML() const {
+void TypeImport::appendYAML(TextBuffer &YAML) const {
   // If type import is inheritance, then this object is treated as an attribute
   // and is already printed.
   if (!getIsPrintedAsObject())
-    return getInheritanceAsYAML();
-
-  return getUsingAsYAML();
+    appendInheritanceYAML(YAML);
+  else
+    appendUsingYAML(YAML);
 }
 
-std::string TypeImport::getInheritanceAsYAML() const {
-  std::stringstream Result;
+void TypeImport::appendInheritanceYAML(TextBuffer &YAML) const {
   if (!getIsInheritance())
-    return Result.str();
-
-  Result << "    - parent: \"" << getTypeName() << "\"\n"
-         << "      access_specifier: ";
-
-  switch (getInheritanceAccess()) {
-  case AccessSpecifier::Private:
-    Result << "\"private\"";
-    break;
-  case AccessSpecifier::Protected:
-    Result << "\"protected\"";
-    break;
-  case AccessSpecifier::Public:
-    Result << "\"public\"";
-    break;
-  case AccessSpecifier::Unspecified:
-    assert(getParent());
-    if (getParent() && getParent()->getIsClassType())
-      Result << "\"private\"";
-    else
-      Result << "\"public\"";
-  }
+    return;
 
-  return Result.str();
+  YAML.append("    - parent: \"");
+  YAML.append(getTypeName());
+  YAML.append("\"\n      access_specifier: \"");
+  YAML.append(getAccessSpecifierName(getInheritanceAccess(), getParent()));
+  YAML.append('"');
 }
 
-std::string TypeImport::getUsingAsYAML() const {
-  std::stringstream Result;
-
+void TypeImport::appendUsingYAML(TextBuffer &YAML) const {
   // Determine the UsingType and name for the Using object.
-  std::string UsingType;
+  const char *UsingType = "";
   std::string Name;
   Object *ObjType = getType();
   if (ObjType) {
@@ -496,29 +475,36 @@ std::string TypeImport::getUsingAsYAML() const {
     Name.append(ObjType->getName());
   }
 
-  // We can't use getCommonYAML here as it returns the name of the Using as its
-  // type.
-  Result << "object: \"" << getKindAsString() << "\""
-         << "\nname: \"" << Name << "\""
-         << "\ntype: null"
-         << "\nsource:"
-         << "\n  line: " << getLineNumber() << "\n  file: \""
-         << getFileName(true) << "\""
-         << "\ndwarf:"
-         << "\n  offset: 0x" << std::hex << getDieOffset();
+  // We can't use appendCommonYAML here as it gives the name of the Using as
+  // its type.
+  YAML.append("object: \"");
+  YAML.append(getKindAsString());
+  YAML.append("\"\nname: \"");
+  YAML.append(Name);
+  YAML.append("\"\ntype: null\nsource:\n  line: ");
+  YAML.appendDecimal(getLineNumber());
+  YAML.append("\n  file: \"");
+  YAML.append(getFileName(true));
+  YAML.append("\"\ndwarf:\n  offset: 0x");
+  YAML.appendHex(getDieOffset());
   const char *TagName;
   assert(getDieTag());
   dwarf_get_TAG_name(getDieTag(), &TagName);
-  Result << "\n  tag: \"" << TagName << "\""
-         << "\nattributes:"
-         << "\n  using_type:" << UsingType;
-
-  return Result.str();
+  YAML.append("\n  tag: \"");
+  YAML.append(TagName);
+  YAML.append("\"\nattributes:\n  using_type:");
+  YAML.append(UsingType);
 }
 
-TypeParam::TypeParam(LevelType Lvl) : Type(Lvl) { ValueIndex = 0; }
+TypeParam::TypeParam(LevelType Lvl) : Type(Lvl) {
+  setKind(ok_type_param);
+  ValueIndex = 0;
+}
 
-TypeParam::TypeParam() : Type() { ValueIndex = 0; }
+TypeParam::TypeParam() : Type() {
+  setKind(ok_type_param);
+  ValueIndex = 0;
+}
 
 TypeParam::~TypeParam() {}
 
@@ -535,7 +521,7 @@ size_t TypeParam::getValueIndex() const { return ValueIndex; }
 void TypeParam::dumpExtra() {
   // Depending on the type of parameter, the dump includes different
   // information: type, value or reference to a template.
-  GlobalPrintContext->print("%s\n", getAsText().c_str());
+  getPrintContext()->printText(*this);
 }
 
 bool TypeParam::getIsPrintedAsObject() const {
@@ -543,66 +529,77 @@ bool TypeParam::getIsPrintedAsObject() const {
   return !(getParent() && getParent()->getIsTemplatePack());
 }
 
-std::string TypeParam::getAsText() const {
-  std::string Result;
+void TypeParam::appendText(TextBuffer &Text) const {
   // Template packs print differently.
   const Scope *Parent = getParent();
   bool IsPack = Parent && Parent->getIsTemplatePack();
   if (!IsPack) {
-    Result += "{";
-    Result += getKindAsString();
-    Result += "} \"";
+    Text.append('{');
+    Text.append(getKindAsString());
+    Text.append("} \"");
     if (getReader()->getOptions().getFormatQualifiedName())
-      Result += getQualifiedName();
-    Result += getName();
-    Result += "\" ";
+      Text.append(getQualifiedName());
+    Text.append(getName());
+    Text.append("\" ");
   }
-  Result += "<- ";
-  Result += getTypeDieOffsetAsString();
+  Text.append("<- ");
+  appendTypeDieOffset(Text);
 
   if (getIsTemplateType()) {
-    Result += "\"";
-    Result += getTypeQualifiedName();
-    Result += getTypeName();
-    Result += "\"";
+    Text.append('"');
+    Text.append(getTypeQualifiedName());
+    Text.append(getTypeName());
+    Text.append('"');
   } else if (getIsTemplateValue()) {
-    Result += getValue();
+    Text.append(getValue());
   } else if (getIsTemplateTemplate()) {
-    Result += "\"";
-    Result += getValue();
-    Result += "\"";
+    Text.append('"');
+    Text.append(getValue());
+    Text.append('"');
   }
-  return Result;
 }
 
-std::string TypeParam::getAsYAML() const {
-  std::stringstream YAML;
-
+void TypeParam::appendYAML(TextBuffer &YAML) const {
   // Template parameters within template packs are printed by the pack.
-  if (!(getParent() && getParent()->getIsTemplatePack()))
-    YAML << getCommonYAML() << "\nattributes:\n  types:\n    - ";
+  if (!(getParent() && getParent()->getIsTemplatePack())) {
+    appendCommonYAML(YAML);
+    YAML.append("\nattributes:\n  types:\n    - ");
+  }
 
-  if (getIsTemplateType())
-    YAML << "\"" << getTypeQualifiedName() << getTypeName() << "\"";
-  else if (getIsTemplateValue())
-    YAML << getValue();
+  if (getIsTemplateType()) {
+    YAML.append('"');
+    YAML.append(getTypeQualifiedName());
+    YAML.append(getTypeName());
+    YAML.append('"');
+  } else if (getIsTemplateValue())
+    YAML.append(getValue());
   else {
     assert(getIsTemplateTemplate());
-    YAML << "\"" << getValue() << "\"";
+    YAML.append('"');
+    YAML.append(getValue());
+    YAML.append('"');
   }
-
-  return YAML.str();
 }
 
-TypeSubrange::TypeSubrange(LevelType Lvl) : Type(Lvl) {}
+TypeSubrange::TypeSubrange(LevelType Lvl) : Type(Lvl) {
+  setKind(ok_type_subrange);
+}
 
-TypeSubrange::TypeSubrange() : Type() {}
+TypeSubrange::TypeSubrange() : Type() { setKind(ok_type_subrange); }
 
 TypeSubrange::~TypeSubrange() {}
 
 void TypeSubrange::dumpExtra() {
   // Print the full type name.
-  GlobalPrintContext->print("{%s} -> %s'%s' '%s'\n", getKindAsString(),
-                            getTypeDieOffsetAsString(), getTypeName(),
-                            getName());
+  TextBuffer &Text = getPrintContext()->getBuffer();
+  Text.append('{');
+  Text.append(getKindAsString());
+  Text.append("} -> ");
+  appendTypeDieOffset(Text);
+  Text.append('\'');
+  Text.append(getTypeName());
+  Text.append("' '");
+  Text.append(getName());
+  Text.append("'\n");
+  getPrintContext()->flushIfFull();
 }
@@ -43,6 +43,10 @@ public:
   Type &operator=(const Type &) = delete;
   Type(const Type &) = delete;
 
+  static bool classof(const Object *Obj) {
+    return Obj->getKind() >= ok_type && Obj->getKind() <= ok_type_subrange;
+  }
+
 private:
   // Type Kind.
   static const char *KindBase;
@@ -213,13 +217,14 @@ public:
   virtual bool dump(bool DoHeader, const char *Header);
 
   bool getIsPrintedAsObject() const override;
-  /// \brief Returns a text representation of this DIVA Object.
-  std::string getAsText() const override;
-  /// \brief Returns a YAML representation of this DIVA Object.
-  std::string getAsYAML() const override;
+  /// \brief Appends a text representation of this DIVA Object.
+  void appendText(TextBuffer &Text) const override;
+  /// \brief Appends a YAML representation of this DIVA Object.
+  void appendYAML(TextBuffer &YAML) const override;
 
 private:
-  static uint32_t TypesAllocated;
+  static std::atomic<uint32_t> TypesAllocated;
+  friend class UncountedObjects;
 
 public:
   static uint32_t getInstanceCount() { return TypesAllocated; }
@@ -245,6 +250,10 @@ public:
   TypeDefinition &operator=(const TypeDefinition &) = delete;
   TypeDefinition(const TypeDefinition &) = delete;
 
+  static bool classof(const Object *Obj) {
+    return Obj->getKind() == ok_type_definition;
+  }
+
 public:
   /// \brief Get the underlying type for a typedef.
   Object *getUnderlyingType() override;
@@ -256,10 +265,10 @@ public:
   void dumpExtra() override;
 
   bool getIsPrintedAsObject() const override { return true; }
-  /// \brief Returns a text representation of this DIVA Object.
-  std::string getAsText() const override;
-  /// \brief Returns a YAML representation of this DIVA Object.
-  std::string getAsYAML() const override;
+  /// \brief Appends a text representation of this DIVA Object.
+  void appendText(TextBuffer &Text) const override;
+  /// \brief Appends a YAML representation of this DIVA Object.
+  void appendYAML(TextBuffer &YAML) const override;
 };
 
 /// \brief Class to represent a DW_TAG_enumerator
@@ -272,6 +281,10 @@ public:
   TypeEnumerator &operator=(const TypeEnumerator &) = delete;
   TypeEnumerator(const TypeEnumerator &) = delete;
 
+  static bool classof(const Object *Obj) {
+    return Obj->getKind() == ok_type_enumerator;
+  }
+
 private:
   size_t ValueIndex; // Enumerator value.
 
@@ -285,10 +298,10 @@ public:
   void dumpExtra() override;
 
   bool getIsPrintedAsObject() const override { return false; }
-  /// \brief Returns a text representation of this DIVA Object.
-  std::string getAsText() const override;
-  /// \brief Returns a YAML representation of this DIVA Object.
-  std::string getAsYAML() const override;
+  /// \brief Appends a text representation of this DIVA Object.
+  void appendText(TextBuffer &Text) const override;
+  /// \brief Appends a YAML representation of this DIVA Object.
+  void appendYAML(TextBuffer &YAML) const override;
 };
 
 /// \brief Class to represent DW_TAG_imported_module /
@@ -302,6 +315,10 @@ public:
   TypeImport &operator=(const TypeImport &) = delete;
   TypeImport(const TypeImport &) = delete;
 
+  static bool classof(const Object *Obj) {
+    return Obj->getKind() == ok_type_import;
+  }
+
 public:
   /// \brief Access specifier, only valid for inheritance.
   AccessSpecifier getInheritanceAccess() const;
@@ -315,17 +332,17 @@ public:
 
   bool getIsPrintedAsObject() const override;
 
-  /// \brief Returns a text representation of this DIVA Object.
-  std::string getAsText() const override;
-  /// \brief Returns a YAML representation of this DIVA Object.
-  std::string getAsYAML() const override;
+  /// \brief Appends a text representation of this DIVA Object.
+  void appendText(TextBuffer &Text) const override;
+  /// \brief Appends a YAML representation of this DIVA Object.
+  void appendYAML(TextBuffer &YAML) const override;
 
 private:
-  virtual std::string getInheritanceAsText() const;
-  virtual std::string getUsingAsText() const;
-  // Gets a YAML representation of DIVA Object as an Inheritance attribute.
-  virtual std::string getInheritanceAsYAML() const;
-  virtual std::string getUsingAsYAML() const;
+  virtual void appendInheritanceText(TextBuffer &Text) const;
+  virtual void appendUsingText(TextBuffer &Text) const;
+  // Appends a YAML representation of DIVA Object as an Inheritance attribute.
+  virtual void appendInheritanceYAML(TextBuffer &YAML) const;
+  virtual void appendUsingYAML(TextBuffer &YAML) const;
 };
 
 /// \brief Class to represent a DWARF Template parameter holder.
@@ -340,6 +357,10 @@ public:
   TypeParam &operator=(const TypeParam &) = delete;
   TypeParam(const TypeParam &) = delete;
 
+  static bool classof(const Object *Obj) {
+    return Obj->getKind() == ok_type_param;
+  }
+
 private:
   size_t ValueIndex; // Value in case of value or template parameters.
 
@@ -354,10 +375,10 @@ public:
 
   bool getIsPrintedAsObject() const override;
 
-  /// \brief Returns a text representation of this DIVA Object.
-  std::string getAsText() const override;
-  /// \brief Returns a YAML representation of this DIVA Object.
-  std::string getAsYAML() const override;
+  /// \brief Appends a text representation of this DIVA Object.
+  void appendText(TextBuffer &Text) const override;
+  /// \brief Appends a YAML representation of this DIVA Object.
+  void appendYAML(TextBuffer &YAML) const override;
 };
 
 /// \brief Class to represent a DW_TAG_subrange_type
@@ -370,6 +391,10 @@ public:
   TypeSubrange &operator=(const TypeSubrange &) = delete;
   TypeSubrange(const TypeSubrange &) = delete;
 
+  static bool classof(const Object *Obj) {
+    return Obj->getKind() == ok_type_subrange;
+  }
+
 public:
   void dumpExtra() override;
 };
@@ -114,6 +114,7 @@ void LibScopeView::printMemoryUsage(size_t MemoryUsage) {
   }
   Result << " KB\n";
 
+  GlobalPrintContext->flush();
   std::cout << Result.str();
 }
 
@@ -127,6 +128,7 @@ void LibScopeView::printTimeTaken(
   typedef std::chrono::duration<double, std::ratio<1>> Seconds;
   double TimeTaken =
       std::chrono::duration_cast<Seconds>(EndTime - StartTime).count();
+  GlobalPrintContext->flush();
   std::cout << "\nTime taken: " << std::setprecision(2) << TimeTaken
             << " seconds\n";
 }
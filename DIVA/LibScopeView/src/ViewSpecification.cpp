@@ -37,46 +37,27 @@
 using namespace LibScopeView;
 
 ViewSpecification::ViewSpecification()
-    : ViewReaderType(rt_unknown), ViewSortMode(sr_line) {}
+    : ViewReaderType(rt_unknown), ViewSortMode(sr_line), ViewJobs(1),
+      ViewDecoder(dt_libdwarf), ViewReadPruning(false),
+      PatternsCompiled(true) {}
 
 ViewSpecification::ViewSpecification(CmdOptions &options)
-    : ViewReaderType(), ViewSortMode() {
+    : ViewReaderType(), ViewSortMode(), ViewJobs(1), ViewDecoder(dt_libdwarf),
+      ViewReadPruning(false), PatternsCompiled(true) {
 
   Options = options;
 }
 
-bool ViewSpecification::matchPattern(const char *Input,
-                                     const MatchInfo &MatchInfo) const {
-  std::string Name(Input);
-  // Traverse all match specifications.
-  for (auto Matcher : MatchInfo) {
-    switch (Matcher.Mode) {
-    case mm_any:
-      if (Name.find(Matcher.Pattern) != std::string::npos)
-        return true;
-      break;
-    case mm_match:
-      if (!Name.compare(Matcher.Pattern))
-        return true;
-      break;
-    case mm_regex:
-      if (std::regex_match(Name, Matcher.RE))
-        return true;
-      break;
-    case mm_none:
-      // No pattern, match nothing.
-      break;
-    }
-  }
-  return false;
-}
-
-bool ViewSpecification::matchFilterPattern(const char *input) {
-  return matchPattern(input, FilterMatchInfo);
-}
-
-bool ViewSpecification::matchTreePattern(const char *input) {
-  return matchPattern(input, TreeMatchInfo);
+void ViewSpecification::compilePatterns() {
+  if (PatternsCompiled)
+    return;
+  // All of the patterns are compiled together, so this is done once rather
+  // than as each pattern is added.
+  FilterMatcher = PatternMatcher(FilterMatchInfo);
+  TreeMatcher = PatternMatcher(TreeMatchInfo);
+  FilterNames.clear();
+  TreeNames.clear();
+  PatternsCompiled = true;
 }
 
 bool ViewSpecification::printFileName() {
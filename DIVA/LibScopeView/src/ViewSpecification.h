@@ -31,10 +31,9 @@
 #define VIEW_SPECIFICATION_H
 
 #include "CmdOptions.h"
+#include "PatternMatcher.h"
 #include "Sort.h"
 
-#include <regex>
-
 namespace LibScopeView {
 
 class Line;
@@ -48,24 +47,12 @@ enum ReaderType {
   rt_unknown   // Unknown format.
 };
 
-/// \brief Pattern Mode for a Match.
-enum MatchMode {
-  mm_none = 0, // No given pattern.
-  mm_match,    // Perfect match.
-  mm_any,      // Partial match.
-  mm_regex     // Regular expression.
-};
-
-/// \brief Small data structure to keep the search/tree pattern information.
-struct Match {
-  std::string Pattern; // Normal pattern.
-  std::regex RE;       // Regular Expression Pattern.
-  MatchMode Mode;      // Match mode.
-  Match() : Mode(mm_none) {}
+/// \brief All supported decoders of the DWARF debug information.
+enum DecoderType {
+  dt_libdwarf, // LibDwarf libraries.
+  dt_native    // Built-in decoder reading the mapped sections directly.
 };
 
-typedef std::vector<Match> MatchInfo;
-
 /// \brief Commmon information for all readers.
 ///
 /// Initialised by the option parser.
@@ -79,6 +66,9 @@ private:
   std::string Id;            // View ID.
   ReaderType ViewReaderType; // Reader type.
   SortMode ViewSortMode;     // Object sort mode.
+  unsigned ViewJobs;         // Number of threads used by the reader.
+  DecoderType ViewDecoder;   // DWARF decoder used by the reader.
+  bool ViewReadPruning;      // Unneeded objects are not created.
 
   std::string InputFile;     // Input file name/path.
   std::string PrintSplitDir; // Split directory name.
@@ -86,6 +76,14 @@ private:
   MatchInfo FilterMatchInfo; // Match information.
   MatchInfo TreeMatchInfo;   // Match information.
 
+  // The patterns compiled for matching, and the names already matched.
+  PatternMatcher FilterMatcher;
+  PatternMatcher TreeMatcher;
+  NameMatchCache FilterNames;
+  NameMatchCache TreeNames;
+  // The matchers have been compiled from all of the added patterns.
+  bool PatternsCompiled;
+
 public:
   /// \brief View command line options.
   CmdOptions &getOptions() { return Options; }
@@ -104,6 +102,23 @@ public:
   SortMode getSortMode() const { return ViewSortMode; }
   void setSortMode(SortMode value) { ViewSortMode = value; }
 
+  /// \brief Number of threads used to create the scopes. A value of 0 uses
+  /// one thread per available core.
+  unsigned getJobs() const { return ViewJobs; }
+  void setJobs(unsigned value) { ViewJobs = value; }
+
+  /// \brief Decoder used to read the DWARF DIEs.
+  DecoderType getDecoderType() const { return ViewDecoder; }
+  void setDecoderType(DecoderType value) { ViewDecoder = value; }
+
+  /// \brief Only create the objects the text view needs while the DWARF is
+  /// read: the matches of the --filter and --tree patterns, the kinds of
+  /// objects that are printed, and what those need. The reader also checks
+  /// the other options allow it, but anything else printed from the tree
+  /// (such as the YAML output) must turn this off.
+  bool getReadPruning() const { return ViewReadPruning; }
+  void setReadPruning(bool value) { ViewReadPruning = value; }
+
   /// \brief Input filename.
   std::string getInputFile() const { return InputFile; }
   void setInputFile(const std::string &value);
@@ -118,23 +133,43 @@ public:
   /// \brief Any --tree pattern.
   bool getAnyTreePattern() const { return !TreeMatchInfo.empty(); }
 
-  /// \brief Filter pattern info.
-  void addFilterPattern(Match &M) { FilterMatchInfo.push_back(M); }
+  /// \brief Filter pattern info. The patterns are matched once they have
+  /// all been added and compiled with compilePatterns().
+  void addFilterPattern(Match &M) {
+    FilterMatchInfo.push_back(M);
+    PatternsCompiled = false;
+  }
 
   /// \brief Tree pattern info.
-  void addTreePattern(Match &M) { TreeMatchInfo.push_back(M); }
+  void addTreePattern(Match &M) {
+    TreeMatchInfo.push_back(M);
+    PatternsCompiled = false;
+  }
 
-private:
-  static ReaderType resolveReaderType(const std::string &Arg);
+  /// \brief Compile the --filter and --tree patterns for matching, unless
+  /// none have been added since they were last compiled.
+  void compilePatterns();
 
 private:
-  // Match a general pattern.
-  bool matchPattern(const char *Input, const MatchInfo &MatchInfo) const;
+  static ReaderType resolveReaderType(const std::string &Arg);
 
 public:
   /// \brief Check if input matches the --filter or --tree pattern.
-  bool matchFilterPattern(const char *Input);
-  bool matchTreePattern(const char *Input);
+  bool matchFilterPattern(const char *Input) const {
+    return FilterMatcher.match(Input);
+  }
+  bool matchTreePattern(const char *Input) const {
+    return TreeMatcher.match(Input);
+  }
+
+  /// \brief Check if the name with the given StringPool index matches the
+  /// --filter or --tree pattern. Each name is matched only once.
+  bool matchFilterPattern(size_t NameIndex) {
+    return FilterNames.match(FilterMatcher, NameIndex);
+  }
+  bool matchTreePattern(size_t NameIndex) {
+    return TreeNames.match(TreeMatcher, NameIndex);
+  }
 
 public:
   /// \brief Conditions to print an object.
@@ -0,0 +1,110 @@
+//===-- LibScopeView/YAMLEmitter.cpp ----------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definitions of YAMLEmitter's methods.
+///
+//===----------------------------------------------------------------------===//
+
+#include "YAMLEmitter.h"
+
+#include <assert.h>
+#include <cstring>
+#include <ostream>
+
+using namespace LibScopeView;
+
+YAMLEmitter::YAMLEmitter(uint8_t SizeOfIndent)
+    : OutputStream(nullptr), IndentSize(SizeOfIndent), Depth(1),
+      ChildrenPending(false) {
+  Buffer.reserve(FlushSize * 2);
+}
+
+const std::string &YAMLEmitter::getIndent() {
+  // The items of the top level sequence are indented once so they are under
+  // its key, then each deeper sequence is indented once for the children key
+  // and once more for the items in it.
+  while (Indents.size() < Depth)
+    Indents.emplace_back(((Indents.size() + 1) * 2 - 1) * IndentSize, ' ');
+  return Indents[Depth - 1];
+}
+
+void YAMLEmitter::emitItem(const TextBuffer &Mapping) {
+  assert(!Mapping.empty());
+
+  if (ChildrenPending) {
+    Buffer.append('\n');
+    ChildrenPending = false;
+  }
+
+  const std::string &Indent = getIndent();
+  const char *Line = Mapping.data();
+  const char *End = Line + Mapping.size();
+  const char *Prefix = "- ";
+  while (true) {
+    const char *LineEnd =
+        static_cast<const char *>(memchr(Line, '\n', End - Line));
+    if (LineEnd == nullptr)
+      LineEnd = End;
+    Buffer.append(Indent);
+    Buffer.append(Prefix, 2);
+    Buffer.append(Line, LineEnd - Line);
+    Buffer.append('\n');
+    if (LineEnd == End || LineEnd + 1 == End)
+      break;
+    Prefix = "  ";
+    Line = LineEnd + 1;
+  }
+
+  flushIfFull();
+}
+
+void YAMLEmitter::beginChildren() {
+  Buffer.append(getIndent());
+  Buffer.append("  children:");
+  ChildrenPending = true;
+  ++Depth;
+}
+
+void YAMLEmitter::endChildren() {
+  assert(Depth > 1 && "endChildren() without beginChildren()");
+  --Depth;
+  if (ChildrenPending) {
+    Buffer.append(" []\n");
+    ChildrenPending = false;
+  }
+}
+
+void YAMLEmitter::emitNoChildren() {
+  Buffer.append(getIndent());
+  Buffer.append("  children: []\n");
+}
+
+void YAMLEmitter::flush() {
+  if (Buffer.empty())
+    return;
+  assert(OutputStream && "YAMLEmitter::setOutput() should be called first");
+  OutputStream->write(Buffer.data(), Buffer.size());
+  Buffer.clear();
+}
@@ -0,0 +1,114 @@
+//===-- LibScopeView/YAMLEmitter.h ------------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the YAMLEmitter class.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef SCOPEVIEW_YAMLEMITTER_H
+#define SCOPEVIEW_YAMLEMITTER_H
+
+#include "TextBuffer.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace LibScopeView {
+
+/// \brief Writes the nested sequences of objects in the YAML output.
+///
+/// Each item is a mapping, and the emitter keeps track of the depth of the
+/// sequence being written so it can indent the lines of the mapping as they
+/// are copied to the output. The indentation for each depth is only built
+/// once. The output is gathered in a buffer and written to the stream in large
+/// blocks.
+///
+/// Typical usage:
+/// \code
+///   YAMLEmitter Emitter(2);
+///   Emitter.setOutput(Output);
+///   Emitter.emitItem(Mapping);
+///   Emitter.beginChildren();
+///   ... // Emit the children.
+///   Emitter.endChildren();
+///   Emitter.flush();
+/// \endcode
+class YAMLEmitter {
+public:
+  explicit YAMLEmitter(uint8_t SizeOfIndent);
+
+  /// \brief Set the stream the output is written to.
+  void setOutput(std::ostream &Output) { OutputStream = &Output; }
+
+  /// \brief Emit Mapping as the next item of the current sequence.
+  ///
+  /// Mapping is the YAML for one object, with one key on each line and
+  /// without a trailing newline. It is written as "- " followed by its first
+  /// line, with the other lines lined up under it.
+  void emitItem(const TextBuffer &Mapping);
+
+  /// \brief Emit the "children" key of the last item, and start the sequence
+  /// of its children.
+  void beginChildren();
+
+  /// \brief End the sequence started by beginChildren(). If no items were
+  /// emitted in it, the sequence is written as "[]".
+  void endChildren();
+
+  /// \brief Emit the "children" key of the last item, as an empty sequence.
+  void emitNoChildren();
+
+  /// \brief The depth of the current sequence, where the top level is 1.
+  unsigned getDepth() const { return Depth; }
+
+  /// \brief Write any buffered output to the stream.
+  void flush();
+
+private:
+  const std::string &getIndent();
+  void flushIfFull() {
+    if (Buffer.size() >= FlushSize)
+      flush();
+  }
+
+  // Write the buffer once it holds this many characters.
+  static const size_t FlushSize = 64 * 1024;
+
+  std::ostream *OutputStream;
+  TextBuffer Buffer;
+  // The indentation of the items at each depth.
+  std::vector<std::string> Indents;
+  const uint8_t IndentSize;
+  unsigned Depth;
+  // Set when a "children" key has been written, but neither an item of the
+  // sequence nor the "[]" of an empty one has followed it yet.
+  bool ChildrenPending;
+};
+
+} // end namespace LibScopeView
+
+#endif // SCOPEVIEW_YAMLEMITTER_H
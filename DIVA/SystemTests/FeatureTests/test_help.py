@@ -11,6 +11,8 @@ General options
       --help-advanced          Display advanced option information
   -v  --version                Display the version information
   -q  --quiet                  Suppress output to stdout
+      --jobs=<N>               Number of threads used to read and print the
+                               input (0 uses all cores)
 
 Output options
   -a  --show-all               Print all (expect advanced) objects and
@@ -127,6 +129,8 @@ General options
       --help-advanced          Display advanced option information
   -v  --version                Display the version information
   -q  --quiet                  Suppress output to stdout
+      --jobs=<N>               Number of threads used to read and print the
+                               input (0 uses all cores)
 """
 
 
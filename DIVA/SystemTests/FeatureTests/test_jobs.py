@@ -0,0 +1,27 @@
+"""
+Test that reading the compile units in parallel gives the same output as
+reading them with a single thread.
+"""
+import pytest
+
+
+@pytest.mark.parametrize('args', (
+    'example_16_lto.elf --show-all --show-global --show-codeline',
+    'example_16_lto.elf --show-all --show-DWARF-offset --sort=name',
+    'example_10.elf --show-all --show-summary',
+    'example_16.elf --show-only-globals',
+))
+@pytest.mark.parametrize('jobs', ('--jobs=0', '--jobs=2', '--jobs=16'))
+def test(diva, args, jobs):
+    assert diva(args) == diva('{} {}'.format(jobs, args))
+
+
+expected_invalid = """\
+
+ERR_CMD_INVALID_VALUE: Argument '--jobs' was given the invalid value 'all'.
+"""
+
+
+def test_invalid_value(diva):
+    assert diva('--jobs=all example_16.elf', nonzero=True) == \
+        (1, expected_invalid)
@@ -634,6 +634,37 @@ TEST(ArgumentParser, StringArgument) {
                         UnexpectedNegative, "--no-str-arg");
 }
 
+TEST(ArgumentParser, UnsignedArgument) {
+  unsigned ArgVal = 1;
+  Argument Arg(Argument::unsignedArg(Argument::NoShortcut, "num-arg", "N", "",
+                                     0, ArgVal));
+  EXPECT_EQ(ArgVal, 1U);
+  EXPECT_EQ(Arg.NameHelpSuffix, "=<N>");
+
+  Arg.ProcessArgWithValue(EmptyParser, "16");
+  EXPECT_EQ(ArgVal, 16U);
+
+  Arg.ProcessArgWithValue(EmptyParser, "0");
+  EXPECT_EQ(ArgVal, 0U);
+
+  // Test exceptions for values that are not unsigned integers.
+  EXPECT_THROW_WITH_ARG_AND_OPT(
+      { Arg.ProcessArgWithValue(EmptyParser, "-2"); }, InvalidChoice,
+      "--num-arg", "-2");
+  EXPECT_THROW_WITH_ARG_AND_OPT(
+      { Arg.ProcessArgWithValue(EmptyParser, "4x"); }, InvalidChoice,
+      "--num-arg", "4x");
+  EXPECT_THROW_WITH_ARG_AND_OPT(
+      { Arg.ProcessArgWithValue(EmptyParser, "99999999999999999999"); },
+      InvalidChoice, "--num-arg", "99999999999999999999");
+  EXPECT_EQ(ArgVal, 0U);
+
+  EXPECT_THROW_WITH_ARG({ Arg.ProcessArg(EmptyParser); }, ArgumentValueRequired,
+                        "--num-arg");
+  EXPECT_THROW_WITH_ARG({ Arg.ProcessNegativeArg(EmptyParser); },
+                        UnexpectedNegative, "--no-num-arg");
+}
+
 TEST(ArgumentParser, MultipleStringArgument) {
   std::vector<std::string> ArgValues;
   Argument Arg(
@@ -47,6 +47,7 @@ TEST(DivaOptions, Defaults) {
 
   EXPECT_FALSE(DOptForQuietDefault.QuietMode);
   EXPECT_FALSE(DOpt.ShowSummary);
+  EXPECT_EQ(DOpt.Jobs, 1U);
   EXPECT_FALSE(DOpt.SplitOutput);
   EXPECT_TRUE(DOpt.OutputDirectory.empty());
   EXPECT_EQ(DOpt.OutputFormats, std::set<OutputFormat>({OutputFormat::TEXT}));
@@ -96,6 +97,7 @@ TEST(DivaOptions, Defaults) {
   EXPECT_FALSE(DOpt.ShowScopeAllocation);
   EXPECT_FALSE(DOpt.ShowStringPoolInfo);
   EXPECT_FALSE(DOpt.DumpStringPool);
+  EXPECT_EQ(DOpt.Decoder, DwarfDecoder::LIBDWARF);
 }
 
 TEST(DivaOptions, InputFiles) {
@@ -202,6 +204,70 @@ TEST(DivaOptions, Sorting) {
   }
 }
 
+TEST(DivaOptions, Jobs) {
+  std::stringstream Output;
+
+  {
+    DivaOptions DOpt({"--quiet", "--jobs=4"}, Output, Output, Output);
+    EXPECT_EQ(Output.str(), "");
+    EXPECT_EQ(DOpt.Jobs, 4U);
+  }
+  {
+    DivaOptions DOpt({"--quiet", "--jobs=4", "--jobs=0"}, Output, Output,
+                     Output);
+    EXPECT_EQ(Output.str(), "");
+    EXPECT_EQ(DOpt.Jobs, 0U);
+  }
+  EXPECT_EXIT(
+      { DivaOptions DOpt1({"--jobs=many"}, Output, Output, std::cerr); },
+      ExitedWithCode(1),
+      "ERR_CMD_INVALID_VALUE: Argument '--jobs' was given the invalid value "
+      "'many'.");
+}
+
+TEST(DivaOptions, OutputBufferSize) {
+  std::stringstream Output;
+
+  {
+    DivaOptions DOpt({"--quiet"}, Output, Output, Output);
+    EXPECT_EQ(DOpt.OutputBufferSize, 1024U);
+  }
+  {
+    DivaOptions DOpt({"--quiet", "--output-buffer-size=64"}, Output, Output,
+                     Output);
+    EXPECT_EQ(Output.str(), "");
+    EXPECT_EQ(DOpt.OutputBufferSize, 64U);
+  }
+  {
+    DivaOptions DOpt({"--quiet", "--output-buffer-size=0"}, Output, Output,
+                     Output);
+    EXPECT_EQ(Output.str(), "");
+    EXPECT_EQ(DOpt.OutputBufferSize, 0U);
+  }
+}
+
+TEST(DivaOptions, DwarfDecoder) {
+  std::stringstream Output;
+
+  {
+    DivaOptions DOpt({"--dwarf-decoder=native"}, Output, Output, Output);
+    EXPECT_EQ(Output.str(), "");
+    EXPECT_EQ(DOpt.Decoder, DwarfDecoder::NATIVE);
+  }
+  {
+    DivaOptions DOpt({"--dwarf-decoder=native", "--dwarf-decoder=libdwarf"},
+                     Output, Output, Output);
+    EXPECT_EQ(Output.str(), "");
+    EXPECT_EQ(DOpt.Decoder, DwarfDecoder::LIBDWARF);
+  }
+  EXPECT_EXIT(
+      { DivaOptions DOpt1({"--dwarf-decoder=dwarfdump"}, Output, Output,
+                          std::cerr); },
+      ExitedWithCode(1),
+      "ERR_CMD_INVALID_VALUE: Argument '--dwarf-decoder' was given the invalid "
+      "value 'dwarfdump'.");
+}
+
 TEST(DivaOptions, Filters) {
   std::stringstream Output;
   DivaOptions DOpt({"--filter=f1", "--filter=f2,f3", "--filter-any=fa1",
@@ -93,11 +93,22 @@ class TestElfDwarfReader : public ::testing::Test {
 public:
   AssertionResult loadRootFromTestFile(std::string TestFile,
                                        LibScopeView::Scope **Root,
-                                       LibScopeView::CmdOptions &Options) {
+                                       LibScopeView::CmdOptions &Options,
+                                       unsigned Jobs = 1,
+                                       LibScopeView::DecoderType Decoder =
+                                           LibScopeView::dt_libdwarf) {
+    LibScopeView::ViewSpecification Spec(Options);
+    Spec.setJobs(Jobs);
+    Spec.setDecoderType(Decoder);
+    return loadRootFromTestFile(TestFile, Root, Spec);
+  }
+
+  AssertionResult loadRootFromTestFile(std::string TestFile,
+                                       LibScopeView::Scope **Root,
+                                       LibScopeView::ViewSpecification &Spec) {
     if (!LibScopeView::doesFileExist(getTestInputFilePath(TestFile)))
       return ::testing::AssertionFailure() << "Test file does not exist";
 
-    LibScopeView::ViewSpecification Spec(Options);
     Spec.setInputFile(getTestInputFilePath(TestFile));
     Reader = std::unique_ptr<DwarfReader>(new DwarfReader(&Spec));
     Reader->getOptions().setFormatFileName();
@@ -544,6 +555,219 @@ TEST_F(TestElfDwarfReader, ReadGlobals) {
   EXPECT_EQ(CU2->getScopeAt(0)->getType(), StructG);
 }
 
+TEST_F(TestElfDwarfReader, ReadCompileUnitsInParallel) {
+  LibScopeView::Scope *Root = nullptr;
+  LibScopeView::CmdOptions Options;
+  ASSERT_TRUE(loadRootFromTestFile("ElfDwarfReader/structure.elf", &Root,
+                                   Options, /*Jobs*/ 3));
+  ASSERT_TRUE(checkChildCount(Root, 3, 0, 0));
+
+  // The CUs are in the same order as when read by a single thread.
+  auto CU1 = Root->getScopes().at(0);
+  auto CU2 = Root->getScopes().at(1);
+  auto CU3 = Root->getScopes().at(2);
+
+  EXPECT_TRUE(CU1->getIsCompileUnit());
+  EXPECT_EQ(CU1->getDieOffset(), 0x0bU);
+  EXPECT_STREQ(CU1->getName(), "structure1.cpp");
+  EXPECT_EQ(CU1->getParent(), Root);
+  EXPECT_TRUE(checkChildCount(CU1, 1, 1, 0));
+
+  EXPECT_TRUE(CU2->getIsCompileUnit());
+  EXPECT_EQ(CU2->getDieOffset(), 0x56U);
+  EXPECT_STREQ(CU2->getName(), "structure2.cpp");
+  EXPECT_EQ(CU2->getParent(), Root);
+  EXPECT_TRUE(checkChildCount(CU2, 1, 1, 1));
+
+  EXPECT_TRUE(CU3->getIsCompileUnit());
+  EXPECT_EQ(CU3->getDieOffset(), 0x0a9U);
+  EXPECT_STREQ(CU3->getName(), "structure3.cpp");
+  EXPECT_EQ(CU3->getParent(), Root);
+  EXPECT_TRUE(checkChildCount(CU3, 0, 1, 1));
+
+  // What the CUs contain is passed up to the root.
+  EXPECT_TRUE(Root->getHasScopes());
+  EXPECT_TRUE(Root->getHasSymbols());
+  EXPECT_TRUE(Root->getHasTypes());
+}
+
+TEST_F(TestElfDwarfReader, ObjectsInArena) {
+  LibScopeView::Scope *Root = nullptr;
+  LibScopeView::CmdOptions Options;
+  ASSERT_TRUE(loadRootFromTestFile("ElfDwarfReader/structure.elf", &Root,
+                                   Options));
+  EXPECT_TRUE(Root->getIsArenaAllocated());
+  EXPECT_TRUE(Root->getScopes().at(0)->getIsArenaAllocated());
+  size_t ObjectCount = getReader().getArena().getObjectCount();
+  EXPECT_GT(ObjectCount, 3U);
+  EXPECT_GT(getReader().getArena().getBytesUsed(LibScopeView::ak_scope), 0U);
+
+  // The objects created by each worker end up in the reader's arena.
+  ASSERT_TRUE(loadRootFromTestFile("ElfDwarfReader/structure.elf", &Root,
+                                   Options, /*Jobs*/ 3));
+  EXPECT_TRUE(Root->getIsArenaAllocated());
+  EXPECT_TRUE(Root->getScopes().at(2)->getIsArenaAllocated());
+  EXPECT_EQ(getReader().getArena().getObjectCount(), ObjectCount);
+}
+
+TEST_F(TestElfDwarfReader, ReadGlobalsInParallel) {
+  LibScopeView::Scope *Root = nullptr;
+  LibScopeView::CmdOptions Options;
+  ASSERT_TRUE(loadRootFromTestFile("ElfDwarfReader/lto_cross_cu.elf", &Root,
+                                   Options, /*Jobs*/ 0));
+  ASSERT_TRUE(checkChildCount(Root, 2, 0, 0));
+
+  // The reference from CU2 to G in CU1 is resolved after both CUs are created.
+  auto CU1 = Root->getScopeAt(0);
+  ASSERT_TRUE(checkChildCount(CU1, 3, 1, 0));
+  ASSERT_TRUE(checkChildCount(CU1->getScopeAt(2), 1, 0, 0));
+  ASSERT_TRUE(checkChildCount(CU1->getScopeAt(2)->getScopeAt(0), 0, 0, 1));
+  auto StructG = CU1->getScopeAt(2)->getScopeAt(0);
+  EXPECT_TRUE(StructG->getIsGlobalReference());
+  EXPECT_TRUE(StructG->getSymbolAt(0)->getIsGlobalReference());
+
+  auto CU2 = Root->getScopeAt(1);
+  ASSERT_TRUE(checkChildCount(CU2, 1, 0, 0));
+  EXPECT_EQ(CU2->getScopeAt(0)->getType(), StructG);
+  EXPECT_FALSE(CU2->getScopeAt(0)->getIsGlobalReference());
+}
+
+TEST_F(TestElfDwarfReader, ReadWithNativeDecoder) {
+  LibScopeView::Scope *Root = nullptr;
+  LibScopeView::CmdOptions Options;
+  ASSERT_TRUE(loadRootFromTestFile("ElfDwarfReader/lto_cross_cu.elf", &Root,
+                                   Options, /*Jobs*/ 1,
+                                   LibScopeView::dt_native));
+  ASSERT_TRUE(checkChildCount(Root, 2, 0, 0));
+
+  auto CU1 = Root->getScopeAt(0);
+  EXPECT_STREQ(CU1->getName(), "lto_cross_cu1.cpp");
+  EXPECT_TRUE(CU1->getHasLines());
+  ASSERT_TRUE(checkChildCount(CU1, 3, 1, 0));
+  ASSERT_TRUE(checkChildCount(CU1->getScopeAt(2), 1, 0, 0));
+  ASSERT_TRUE(checkChildCount(CU1->getScopeAt(2)->getScopeAt(0), 0, 0, 1));
+  auto StructG = CU1->getScopeAt(2)->getScopeAt(0);
+  EXPECT_TRUE(StructG->getIsGlobalReference());
+  EXPECT_EQ(getSourceFileName(StructG), "lto_cross_cu.h");
+
+  auto CU2 = Root->getScopeAt(1);
+  ASSERT_TRUE(checkChildCount(CU2, 1, 0, 0));
+  EXPECT_EQ(CU2->getScopeAt(0)->getType(), StructG);
+}
+
+TEST_F(TestElfDwarfReader, ReadMatchedObjects) {
+  LibScopeView::Scope *Root = nullptr;
+  LibScopeView::CmdOptions Options;
+  Options.setPrintNone();
+  Options.setPrintScopes();
+  Options.setPrintFunction();
+  Options.setPrintVariable();
+  LibScopeView::ViewSpecification Spec(Options);
+  LibScopeView::Match Filter;
+  Filter.Pattern = "i_ptr";
+  Filter.Mode = LibScopeView::mm_match;
+  Spec.addFilterPattern(Filter);
+  Spec.setReadPruning(true);
+  ASSERT_TRUE(loadRootFromTestFile("ElfDwarfReader/type.o", &Root, Spec));
+  ASSERT_TRUE(checkChildCount(Root, 1, 0, 0));
+
+  // Only the match, its parents and its types are created.
+  auto CU = Root->getScopeAt(0);
+  ASSERT_EQ(CU->getScopeCount(), 1U);
+  auto Func = CU->getScopeAt(0);
+  EXPECT_STREQ(Func->getName(), "test");
+  ASSERT_TRUE(checkChildCount(Func, 0, 0, 1));
+  auto Var = Func->getSymbolAt(0);
+  EXPECT_STREQ(Var->getName(), "i_ptr");
+  ASSERT_NE(Var->getType(), nullptr);
+  EXPECT_STREQ(Var->getType()->getName(), "int *");
+  for (auto Ty : CU->getTypes())
+    EXPECT_STRNE(Ty->getName(), "T_INT");
+
+  Spec.setReadPruning(false);
+  ASSERT_TRUE(loadRootFromTestFile("ElfDwarfReader/type.o", &Root, Spec));
+  EXPECT_EQ(Root->getScopeAt(0)->getScopeCount(), 2U);
+}
+
+TEST_F(TestElfDwarfReader, ReadPrintedKinds) {
+  LibScopeView::Scope *Root = nullptr;
+  LibScopeView::CmdOptions Options;
+  Options.setPrintNone();
+  Options.setPrintScopes();
+  Options.setPrintSymbols();
+  Options.setPrintFunction();
+  LibScopeView::ViewSpecification Spec(Options);
+  Spec.setReadPruning(true);
+  ASSERT_TRUE(loadRootFromTestFile("ElfDwarfReader/type.o", &Root, Spec));
+  ASSERT_TRUE(checkChildCount(Root, 1, 0, 0));
+
+  // The functions and types are created, but not the variables or the
+  // parameter.
+  auto CU = Root->getScopeAt(0);
+  ASSERT_TRUE(checkChildCount(CU, 2, 8, 0));
+  EXPECT_STREQ(CU->getScopeAt(0)->getName(), "rv_ref");
+  EXPECT_STREQ(CU->getScopeAt(1)->getName(), "test");
+  EXPECT_TRUE(checkChildCount(CU->getScopeAt(0), 0, 0, 0));
+  EXPECT_TRUE(checkChildCount(CU->getScopeAt(1), 0, 0, 0));
+
+  // The variables are created with the types they reference.
+  Options.setPrintVariable();
+  LibScopeView::ViewSpecification VariableSpec(Options);
+  VariableSpec.setReadPruning(true);
+  ASSERT_TRUE(
+      loadRootFromTestFile("ElfDwarfReader/type.o", &Root, VariableSpec));
+  CU = Root->getScopeAt(0);
+  ASSERT_EQ(CU->getScopeCount(), 2U);
+  auto Func = CU->getScopeAt(1);
+  ASSERT_TRUE(checkChildCount(Func, 0, 0, 6));
+  EXPECT_STREQ(Func->getSymbolAt(0)->getTypeName(), "T_INT");
+  EXPECT_STREQ(Func->getSymbolAt(2)->getTypeName(), "int *");
+  EXPECT_EQ(CU->getScopeAt(0)->getSymbolCount(), 0U);
+
+  VariableSpec.setReadPruning(false);
+  ASSERT_TRUE(
+      loadRootFromTestFile("ElfDwarfReader/type.o", &Root, VariableSpec));
+  EXPECT_EQ(Root->getScopeAt(0)->getScopeAt(0)->getSymbolCount(), 1U);
+}
+
+// The objects created to decide which kinds to read aren't counted as
+// allocated.
+TEST_F(TestElfDwarfReader, CountPrunedObjects) {
+  auto getAllocated = []() {
+    return LibScopeView::Scope::getInstanceCount() +
+           LibScopeView::Symbol::getInstanceCount() +
+           LibScopeView::Type::getInstanceCount();
+  };
+  LibScopeView::Scope *Root = nullptr;
+  LibScopeView::CmdOptions Options;
+  Options.setPrintAll();
+  Options.setPrintSummary();
+  LibScopeView::ViewSpecification Spec(Options);
+  Spec.setReadPruning(false);
+  uint32_t Start = getAllocated();
+  ASSERT_TRUE(loadRootFromTestFile("ElfDwarfReader/type.o", &Root, Spec));
+  uint32_t Allocated = getAllocated() - Start;
+  EXPECT_EQ(Allocated, getReader().getArena().getObjectCount());
+
+  Spec.setReadPruning(true);
+  Start = getAllocated();
+  ASSERT_TRUE(loadRootFromTestFile("ElfDwarfReader/type.o", &Root, Spec));
+  EXPECT_EQ(getAllocated() - Start, Allocated);
+
+  // Only the objects that are read are counted when some kinds aren't.
+  Options.setPrintNone();
+  Options.setPrintScopes();
+  Options.setPrintFunction();
+  Options.setPrintSummary();
+  LibScopeView::ViewSpecification FunctionSpec(Options);
+  FunctionSpec.setReadPruning(true);
+  Start = getAllocated();
+  ASSERT_TRUE(
+      loadRootFromTestFile("ElfDwarfReader/type.o", &Root, FunctionSpec));
+  EXPECT_EQ(getAllocated() - Start, getReader().getArena().getObjectCount());
+  EXPECT_LT(getAllocated() - Start, Allocated);
+}
+
 TEST_F(TestElfDwarfReader, ReadImport) {
   LibScopeView::Scope *CU = nullptr;
   ASSERT_TRUE(loadSingleCUFromTestFile("ElfDwarfReader/import.o", &CU));
@@ -650,29 +874,60 @@ TEST_F(TestElfDwarfReader, ReadLines) {
   ASSERT_TRUE(loadSingleCUFromTestFile("ElfDwarfReader/lines.o", &CU));
   ASSERT_EQ(CU->getLineCount(), 7U);
 
-  auto *Ln = CU->getLines().at(0);
-  EXPECT_TRUE(Ln->getIsLineRecord());
-  EXPECT_EQ(Ln->getLineNumber(), 1U);
-  EXPECT_EQ(Ln->getAddress(), 0x00000000U);
-  EXPECT_EQ(Ln->getDieOffset(), 0x00000000U);
-  EXPECT_EQ(getSourceFileName(Ln), "lines.cpp");
-  EXPECT_TRUE(Ln->getIsNewStatement());
-  EXPECT_FALSE(Ln->getIsNewBasicBlock());
-  EXPECT_FALSE(Ln->getIsLineEndSequence());
-  EXPECT_FALSE(Ln->getIsEpilogueBegin());
-  EXPECT_FALSE(Ln->getIsPrologueEnd());
-
-  Ln = CU->getLines().at(6);
-  EXPECT_TRUE(Ln->getIsLineRecord());
-  EXPECT_EQ(Ln->getLineNumber(), 13U);
-  EXPECT_EQ(Ln->getAddress(), 0x00000032U);
-  EXPECT_EQ(Ln->getDieOffset(), 0x00000032U);
-  EXPECT_EQ(getSourceFileName(Ln), "lines.cpp");
-  EXPECT_TRUE(Ln->getIsNewStatement());
-  EXPECT_FALSE(Ln->getIsNewBasicBlock());
-  EXPECT_TRUE(Ln->getIsLineEndSequence());
-  EXPECT_FALSE(Ln->getIsEpilogueBegin());
-  EXPECT_FALSE(Ln->getIsPrologueEnd());
+  // The lines are read from the CU's line table.
+  ASSERT_TRUE(CU->getLines().empty());
+  const LibScopeView::LineTable *Lines = CU->getLineTable();
+  ASSERT_NE(Lines, nullptr);
+  ASSERT_EQ(Lines->size(), 7U);
+  LibScopeView::Line Ln(CU->getLevel() + 1, *Lines);
+
+  Ln.setRow(0);
+  EXPECT_TRUE(Ln.getIsLineRecord());
+  EXPECT_EQ(Ln.getLineNumber(), 1U);
+  EXPECT_EQ(Ln.getAddress(), 0x00000000U);
+  EXPECT_EQ(Ln.getDieOffset(), 0x00000000U);
+  EXPECT_EQ(getSourceFileName(&Ln), "lines.cpp");
+  EXPECT_TRUE(Ln.getIsNewStatement());
+  EXPECT_FALSE(Ln.getIsNewBasicBlock());
+  EXPECT_FALSE(Ln.getIsLineEndSequence());
+  EXPECT_FALSE(Ln.getIsEpilogueBegin());
+  EXPECT_FALSE(Ln.getIsPrologueEnd());
+
+  Ln.setRow(6);
+  EXPECT_TRUE(Ln.getIsLineRecord());
+  EXPECT_EQ(Ln.getLineNumber(), 13U);
+  EXPECT_EQ(Ln.getAddress(), 0x00000032U);
+  EXPECT_EQ(Ln.getDieOffset(), 0x00000032U);
+  EXPECT_EQ(getSourceFileName(&Ln), "lines.cpp");
+  EXPECT_TRUE(Ln.getIsNewStatement());
+  EXPECT_FALSE(Ln.getIsNewBasicBlock());
+  EXPECT_TRUE(Ln.getIsLineEndSequence());
+  EXPECT_FALSE(Ln.getIsEpilogueBegin());
+  EXPECT_FALSE(Ln.getIsPrologueEnd());
+}
+
+TEST_F(TestElfDwarfReader, ReadLinesOnDemand) {
+  // Without --show-codeline the line table is only read when asked for.
+  LibScopeView::Scope *Root = nullptr;
+  LibScopeView::CmdOptions Options;
+  ASSERT_TRUE(loadRootFromTestFile("ElfDwarfReader/lines.o", &Root, Options));
+  ASSERT_EQ(Root->getScopeCount(), 1U);
+  auto CU = static_cast<LibScopeView::ScopeCompileUnit *>(Root->getScopeAt(0));
+  EXPECT_TRUE(CU->getLineTablePending());
+  EXPECT_TRUE(CU->getHasLines());
+
+  const LibScopeView::LineTable *Lines = CU->getLineTable();
+  ASSERT_NE(Lines, nullptr);
+  EXPECT_FALSE(CU->getLineTablePending());
+  EXPECT_EQ(Lines->size(), 7U);
+  EXPECT_EQ(CU->getLineCount(), 7U);
+
+  // With --show-codeline the lines are read with the rest of the CU.
+  Options.setPrintCodeline();
+  ASSERT_TRUE(loadRootFromTestFile("ElfDwarfReader/lines.o", &Root, Options));
+  CU = static_cast<LibScopeView::ScopeCompileUnit *>(Root->getScopeAt(0));
+  EXPECT_FALSE(CU->getLineTablePending());
+  EXPECT_EQ(CU->getLineCount(), 7U);
 }
 
 TEST_F(TestElfDwarfReader, ReadNamespace) {
@@ -148,12 +148,68 @@ TEST_F(LibDwarfHelpers, DwarfDie) {
   EXPECT_EQ(TestDie.getAttrAsString(DW_AT_decl_line, "default"), "default");
 }
 
+TEST_F(LibDwarfHelpers, DwarfDieAttributes) {
+  auto CompileUnits = TestDebugData.getCompileUnits();
+  ASSERT_NE(CompileUnits.size(), 0U);
+
+  const DwarfDie &TestDie = CompileUnits[0].CUDie;
+  auto IT = TestDie.childrenBegin();
+  ASSERT_FALSE(IT.atEnd());
+  const DwarfDie &TestDie2 = *IT;
+
+  auto Attrs = TestDie.decodeAttributes();
+  auto Attrs2 = TestDie2.decodeAttributes();
+
+  // Test hasAttr.
+  EXPECT_TRUE(Attrs.hasAttr(DW_AT_name));
+  EXPECT_FALSE(Attrs.hasAttr(DW_AT_decl_file));
+  EXPECT_TRUE(Attrs2.hasAttr(DW_AT_decl_file));
+
+  // Test getting attributes that are there.
+  EXPECT_TRUE(Attrs2.getAttrAsFlag(DW_AT_external));
+  EXPECT_EQ(Attrs2.getAttrAsRef(DW_AT_type),
+            DwarfDie::OptionalAttrValue<Dwarf_Off>(0x52U));
+  EXPECT_EQ(Attrs2.getAttrAsUnsigned(DW_AT_decl_file),
+            DwarfDie::OptionalAttrValue<Dwarf_Unsigned>(1U));
+  EXPECT_EQ(Attrs2.getAttrAsSigned(DW_AT_decl_file),
+            DwarfDie::OptionalAttrValue<Dwarf_Signed>(1));
+  EXPECT_EQ(Attrs.getAttrAsString(DW_AT_name),
+            DwarfDie::OptionalAttrValue<std::string>(TestDie.getName()));
+  EXPECT_EQ(Attrs2.getAttrAsString(DW_AT_name, ""), TestDie2.getName());
+
+  // Test getting attributes that aren't there.
+  EXPECT_FALSE(Attrs.getAttrAsFlag(DW_AT_external));
+  EXPECT_FALSE(Attrs.getAttrAsRef(DW_AT_type).hasValue());
+  EXPECT_FALSE(Attrs.getAttrAsUnsigned(DW_AT_decl_line).hasValue());
+  EXPECT_FALSE(Attrs.getAttrAsSigned(DW_AT_decl_line).hasValue());
+  EXPECT_FALSE(Attrs.getAttrAsSignedOrUnsigned(DW_AT_const_value).hasValue());
+  EXPECT_FALSE(Attrs2.getAttrAsString(DW_AT_GNU_template_name).hasValue());
+  // With defaults.
+  EXPECT_EQ(Attrs.getAttrAsRef(DW_AT_type, 0x08U), 0x08U);
+  EXPECT_EQ(Attrs.getAttrAsUnsigned(DW_AT_decl_line, 12U), 12U);
+  EXPECT_EQ(Attrs.getAttrAsSigned(DW_AT_decl_line, -5), -5);
+  EXPECT_EQ(Attrs2.getAttrAsString(DW_AT_GNU_template_name, "default"),
+            "default");
+
+  // The decoded values match the Die's getters.
+  EXPECT_EQ(Attrs2.getAttrAsUnsigned(DW_AT_decl_line),
+            TestDie2.getAttrAsUnsigned(DW_AT_decl_line));
+
+  // Moving keeps the attributes.
+  auto Moved = std::move(Attrs2);
+  EXPECT_EQ(Moved.getAttrAsRef(DW_AT_type, 0U), 0x52U);
+}
+
 // Simple tree of dwarf tags for testing.
 struct TagTree {
   TagTree(Dwarf_Half Tag) : Tag(Tag) {}
 
   Dwarf_Half Tag;
   std::vector<TagTree> Children;
+
+  friend bool operator==(const TagTree &A, const TagTree &B) {
+    return A.Tag == B.Tag && A.Children == B.Children;
+  }
 };
 
 void buildTagTree(TagTree *root, const DwarfDie &Die) {
@@ -226,6 +282,36 @@ TEST_F(LibDwarfHelpers, DwarfDieChildIterator) {
   EXPECT_EQ(CU3_Type.Tag, DW_TAG_base_type);
 }
 
+void buildTagTreeWithCursor(TagTree *root, const DwarfDie &Die) {
+  root->Children.push_back(Die.getTag());
+  for (DwarfDieChildCursor Child(Die); !Child.atEnd(); Child.next())
+    buildTagTreeWithCursor(&(root->Children.back()), *Child);
+}
+
+TEST_F(LibDwarfHelpers, DwarfDieChildCursor) {
+  // The cursor should visit the same layout as the iterator.
+  TagTree Tree(0);
+  TagTree CursorTree(0);
+  for (const auto &CU : TestDebugData.getCompileUnits()) {
+    buildTagTree(&Tree, CU.CUDie);
+    buildTagTreeWithCursor(&CursorTree, CU.CUDie);
+  }
+  ASSERT_EQ(CursorTree.Children.size(), 3U);
+  EXPECT_TRUE(CursorTree == Tree);
+
+  // A Die without children.
+  auto CompileUnits = TestDebugData.getCompileUnits();
+  DwarfDieChildCursor Child(CompileUnits[1].CUDie);
+  ASSERT_FALSE(Child.atEnd());
+  EXPECT_EQ(Child->getTag(), DW_TAG_subprogram);
+  EXPECT_TRUE(DwarfDieChildCursor(*Child).atEnd());
+  Child.next();
+  ASSERT_FALSE(Child.atEnd());
+  EXPECT_EQ((*Child).getTag(), DW_TAG_base_type);
+  Child.next();
+  EXPECT_TRUE(Child.atEnd());
+}
+
 TEST_F(LibDwarfHelpers, DwarfLineTable) {
   auto CompileUnits = TestDebugData.getCompileUnits();
   ASSERT_FALSE(CompileUnits.empty());
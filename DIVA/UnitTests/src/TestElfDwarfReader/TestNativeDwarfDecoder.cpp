@@ -0,0 +1,566 @@
+//===-- UnitTests/TestNativeDwarfDecoder.cpp --------------------*- C++ -*-===//
+///
+/// Copyright (c) Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the tests for the native DWARF decoder, which are mostly
+/// cross-checks against the libdwarf wrappers.
+///
+//===----------------------------------------------------------------------===//
+
+#include "FileUtilities.h"
+#include "LibDwarfHelpers.h"
+#include "NativeDwarfDecoder.h"
+#include "StringPool.h"
+#include "UtilsForTesting.h"
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+
+using namespace ElfDwarfReader;
+
+using testing::AssertionResult;
+
+namespace {
+
+// All the test inputs with DWARF, read by both decoders.
+const char *const CrossCheckInputs[] = {
+    "DwarfHelpers/test.elf",
+    "ElfDwarfReader/aggregate.o",
+    "ElfDwarfReader/array.o",
+    "ElfDwarfReader/block.o",
+    "ElfDwarfReader/enum.o",
+    "ElfDwarfReader/function.o",
+    "ElfDwarfReader/function_decls.o",
+    "ElfDwarfReader/function_pointer.o",
+    "ElfDwarfReader/function_static_inline.o",
+    "ElfDwarfReader/import.o",
+    "ElfDwarfReader/inheritance.o",
+    "ElfDwarfReader/label.o",
+    "ElfDwarfReader/lines.o",
+    "ElfDwarfReader/lto_cross_cu.elf",
+    "ElfDwarfReader/members.o",
+    "ElfDwarfReader/qualified_name.o",
+    "ElfDwarfReader/structure.elf",
+    "ElfDwarfReader/symbol.o",
+    "ElfDwarfReader/template.o",
+    "ElfDwarfReader/template_pack.o",
+    "ElfDwarfReader/template_template.o",
+    "ElfDwarfReader/type.o",
+};
+
+// Get the attributes of a libdwarf Die in order.
+std::vector<Dwarf_Half> getAttrList(const DwarfDebugData &DebugData,
+                                    const DwarfDie &Die) {
+  std::vector<Dwarf_Half> Result;
+  Dwarf_Attribute *Attrs;
+  Dwarf_Signed AttrCount;
+  if (dwarf_attrlist(*Die, &Attrs, &AttrCount, nullptr) != DW_DLV_OK)
+    return Result;
+  for (Dwarf_Signed Index = 0; Index < AttrCount; ++Index) {
+    Dwarf_Half Attr;
+    dwarf_whatattr(Attrs[Index], &Attr, nullptr);
+    Result.push_back(Attr);
+    dwarf_dealloc(*DebugData, Attrs[Index], DW_DLA_ATTR);
+  }
+  dwarf_dealloc(*DebugData, Attrs, DW_DLA_LIST);
+  return Result;
+}
+
+// Call an attribute getter and describe the result, or the error number if it
+// throws.
+template <typename GetterFunc> std::string describe(GetterFunc Getter) {
+  std::stringstream Result;
+  try {
+    Getter(Result);
+  } catch (LibDwarfError &Err) {
+    Result << "error " << Err.getErrorNumber();
+  }
+  return Result.str();
+}
+
+template <typename ValTy>
+std::ostream &operator<<(std::ostream &OS,
+                         const DwarfDie::OptionalAttrValue<ValTy> &Value) {
+  if (!Value)
+    return OS << "none";
+  return OS << *Value;
+}
+
+// Describe the result of each of the getters that a Die and its decoded
+// attributes both have for an attribute.
+template <typename AttrsTy>
+std::string describeDecodedAttr(const AttrsTy &Attrs, Dwarf_Half Attr) {
+  std::string Result;
+  Result += describe([&](std::ostream &OS) { OS << Attrs.hasAttr(Attr); });
+  Result += ", flag: ";
+  Result +=
+      describe([&](std::ostream &OS) { OS << Attrs.getAttrAsFlag(Attr); });
+  Result += ", ref: ";
+  Result += describe([&](std::ostream &OS) { OS << Attrs.getAttrAsRef(Attr); });
+  Result += ", unsigned: ";
+  Result +=
+      describe([&](std::ostream &OS) { OS << Attrs.getAttrAsUnsigned(Attr); });
+  Result += ", signed: ";
+  Result +=
+      describe([&](std::ostream &OS) { OS << Attrs.getAttrAsSigned(Attr); });
+  Result += ", string: ";
+  Result +=
+      describe([&](std::ostream &OS) { OS << Attrs.getAttrAsString(Attr); });
+  Result += ", signed or unsigned: ";
+  Result += describe([&](std::ostream &OS) {
+    if (auto Value = Attrs.getAttrAsSignedOrUnsigned(Attr)) {
+      if (Value->IsSigned)
+        OS << "signed " << Value->SignedValue;
+      else
+        OS << "unsigned " << Value->UnsignedValue;
+    } else
+      OS << "none";
+  });
+  return Result;
+}
+
+// Describe the result of each of a Die's attribute getters for an attribute.
+template <typename DieTy>
+std::string describeAttr(const DieTy &Die, Dwarf_Half Attr) {
+  std::string Result = describeDecodedAttr(Die, Attr);
+  Result += ", addr: ";
+  Result += describe([&](std::ostream &OS) { OS << Die.getAttrAsAddr(Attr); });
+  return Result;
+}
+
+// Check that a native Die and all its children match the libdwarf Die.
+AssertionResult compareDies(const DwarfDebugData &DebugData,
+                            const DwarfDie &Expected, const NativeDie &Die) {
+  std::stringstream Where;
+  Where << "Die at 0x" << std::hex << Expected.getGlobalOffset();
+  if (Die.isNull() || Die.getGlobalOffset() != Expected.getGlobalOffset())
+    return ::testing::AssertionFailure() << Where.str() << " was not found";
+
+  if (Die.getTag() != Expected.getTag())
+    return ::testing::AssertionFailure()
+           << Where.str() << " has tag " << Die.getTagName() << ", expected "
+           << Expected.getTagName();
+  if (Die.getName() != Expected.getName())
+    return ::testing::AssertionFailure()
+           << Where.str() << " has name '" << Die.getName() << "', expected '"
+           << Expected.getName() << "'";
+
+  std::vector<Dwarf_Half> Attrs = Die.getAttrList();
+  if (Attrs != getAttrList(DebugData, Expected))
+    return ::testing::AssertionFailure()
+           << Where.str() << " has different attributes";
+  // Also check an attribute that no Die has.
+  Attrs.push_back(DW_AT_lo_user);
+  for (auto Attr : Attrs) {
+    std::string Value = describeAttr(Die, Attr);
+    std::string ExpectedValue = describeAttr(Expected, Attr);
+    if (Value != ExpectedValue) {
+      Where << " attribute 0x" << Attr;
+      return ::testing::AssertionFailure()
+             << Where.str() << " is {" << Value << "}, expected {"
+             << ExpectedValue << "}";
+    }
+  }
+
+  // The decoded attributes match the Die's getters, including a decoded
+  // attribute that the Die doesn't have.
+  auto DecodedAttrs = Die.decodeAttributes();
+  auto ExpectedDecodedAttrs = Expected.decodeAttributes();
+  Attrs.back() = DW_AT_GNU_template_name;
+  for (auto Attr : Attrs) {
+    if (getDecodedAttrSlot(Attr) == NumDecodedAttrs)
+      continue;
+    std::string ExpectedValue = describeDecodedAttr(Expected, Attr);
+    std::string Value = describeDecodedAttr(DecodedAttrs, Attr);
+    std::string LibDwarfValue = describeDecodedAttr(ExpectedDecodedAttrs, Attr);
+    if (Value != ExpectedValue || LibDwarfValue != ExpectedValue) {
+      Where << " decoded attribute 0x" << Attr;
+      return ::testing::AssertionFailure()
+             << Where.str() << " is {" << Value << "} and {" << LibDwarfValue
+             << "}, expected {" << ExpectedValue << "}";
+    }
+  }
+
+  auto IT = Die.childrenBegin(), End = Die.childrenEnd();
+  for (auto ExpectedIT = Expected.childrenBegin(),
+            ExpectedEnd = Expected.childrenEnd();
+       ExpectedIT != ExpectedEnd; ++ExpectedIT, ++IT) {
+    if (IT == End)
+      return ::testing::AssertionFailure()
+             << Where.str() << " is missing children";
+    AssertionResult Res = compareDies(DebugData, *ExpectedIT, *IT);
+    if (!Res)
+      return Res;
+  }
+  if (IT != End)
+    return ::testing::AssertionFailure()
+           << Where.str() << " has too many children";
+
+  return ::testing::AssertionSuccess();
+}
+
+// Check that the name indexes of a native Die and all its children, read
+// through the string caches, match the libdwarf Die's names.
+AssertionResult compareNameIndexes(const DwarfDie &Expected,
+                                   const NativeDie &Die,
+                                   DwarfStringCache &LibDwarfCache,
+                                   DwarfStringCache &NativeCache) {
+  size_t ExpectedIndex =
+      LibScopeView::StringPool::getStringIndex(Expected.getName());
+  if (Expected.decodeAttributes().getAttrAsStringIndex(
+          DW_AT_name, LibDwarfCache) != ExpectedIndex ||
+      Die.decodeAttributes().getAttrAsStringIndex(DW_AT_name, NativeCache) !=
+          ExpectedIndex)
+    return ::testing::AssertionFailure()
+           << "Die at 0x" << std::hex << Expected.getGlobalOffset()
+           << " has the wrong name index";
+
+  auto IT = Die.childrenBegin();
+  for (auto ExpectedIT = Expected.childrenBegin(),
+            ExpectedEnd = Expected.childrenEnd();
+       ExpectedIT != ExpectedEnd; ++ExpectedIT, ++IT) {
+    AssertionResult Res =
+        compareNameIndexes(*ExpectedIT, *IT, LibDwarfCache, NativeCache);
+    if (!Res)
+      return Res;
+  }
+  return ::testing::AssertionSuccess();
+}
+
+// Describe a line table row.
+std::string describeRow(const DwarfLineEntry &Row) {
+  std::stringstream Result;
+  Result << std::hex << "0x" << Row.LineAddr << std::dec << " line "
+         << Row.LineNo << " file " << Row.SrcFileID << " flags "
+         << Row.IsBeginStatement << Row.IsEndSequence << Row.IsBeginBlock
+         << Row.IsPrologEnd << Row.IsEpilogueBegin << " isa " << Row.ISA
+         << " discriminator " << Row.Discriminator;
+  return Result.str();
+}
+
+// Builds a .debug_line section for the tests.
+class LineProgramBuilder {
+public:
+  LineProgramBuilder &byte(unsigned Value) {
+    Data.push_back(static_cast<char>(Value));
+    return *this;
+  }
+  LineProgramBuilder &bytes(std::initializer_list<unsigned> Values) {
+    for (unsigned Value : Values)
+      byte(Value);
+    return *this;
+  }
+  LineProgramBuilder &fixed(Dwarf_Unsigned Value, unsigned Size) {
+    for (unsigned Index = 0; Index < Size; ++Index)
+      byte(static_cast<unsigned>((Value >> (Index * 8U)) & 0xffU));
+    return *this;
+  }
+  LineProgramBuilder &string(const char *Value) {
+    Data.append(Value).push_back('\0');
+    return *this;
+  }
+  // Patch a little endian 4 byte value at Offset.
+  void patch(size_t Offset, Dwarf_Unsigned Value) {
+    for (unsigned Index = 0; Index < 4U; ++Index)
+      Data[Offset + Index] = static_cast<char>((Value >> (Index * 8U)) & 0xffU);
+  }
+  size_t size() const { return Data.size(); }
+
+  NativeLineSections getSections() const {
+    NativeLineSections Sections;
+    Sections.Line = NativeSection(Data.data(), Data.size());
+    return Sections;
+  }
+
+private:
+  std::string Data;
+};
+
+} // end anonymous namespace
+
+TEST(NativeDwarfDecoder, NativeDebugData) {
+  auto TestData =
+      NativeDebugData::create(getTestInputFilePath("DwarfHelpers/test.elf"));
+  ASSERT_NE(TestData, nullptr);
+
+  // test.elf should have 3 compile units (test1.cpp, test2.cpp, test3.cpp).
+  const auto &Units = TestData->getUnits();
+  ASSERT_EQ(Units.size(), 3U);
+  EXPECT_EQ(Units[0].HeaderOffset, 0U);
+  EXPECT_EQ(Units[0].FirstDieOffset, 0x0bU);
+  EXPECT_EQ(Units[0].NextHeaderOffset, 0x5aU);
+  EXPECT_EQ(Units[1].HeaderOffset, 0x5aU);
+  EXPECT_EQ(Units[1].NextHeaderOffset, 0xa9U);
+  EXPECT_EQ(Units[2].HeaderOffset, 0xa9U);
+  EXPECT_EQ(Units[0].Version, 4U);
+  EXPECT_EQ(Units[0].AddressSize, 8U);
+  EXPECT_EQ(Units[0].OffsetSize, 4U);
+
+  EXPECT_EQ(TestData->findUnit(0x0U), &Units[0]);
+  EXPECT_EQ(TestData->findUnit(0x59U), &Units[0]);
+  EXPECT_EQ(TestData->findUnit(0x5aU), &Units[1]);
+  EXPECT_EQ(TestData->findUnit(Units[2].NextHeaderOffset), nullptr);
+
+  // Only offsets of Dies give a Die.
+  EXPECT_EQ(TestData->getDie(0x0bU).getName(), "test1.cpp");
+  EXPECT_TRUE(TestData->getDie(0x0U).isNull());
+  EXPECT_TRUE(TestData->getDie(Units[2].NextHeaderOffset).isNull());
+}
+
+TEST(NativeDwarfDecoder, NativeDie) {
+  auto TestData =
+      NativeDebugData::create(getTestInputFilePath("DwarfHelpers/test.elf"));
+  ASSERT_NE(TestData, nullptr);
+
+  NativeDie TestDie = TestData->getDie(0x0bU);
+  ASSERT_FALSE(TestDie.isNull());
+
+  // Test basic Attributes.
+  EXPECT_EQ(TestDie.getGlobalOffset(), 0x0bU);
+  EXPECT_EQ(TestDie.getName(), "test1.cpp");
+  EXPECT_EQ(TestDie.getTag(), DW_TAG_compile_unit);
+  EXPECT_EQ(TestDie.getTagName(), "DW_TAG_compile_unit");
+  EXPECT_TRUE(TestDie.hasAttr(DW_AT_name));
+  EXPECT_FALSE(TestDie.hasAttr(DW_AT_decl_file));
+
+  auto IT = TestDie.childrenBegin();
+  ASSERT_FALSE(IT.atEnd());
+  const NativeDie &TestDie2 = *IT;
+
+  // Test getting attributes that are there.
+  EXPECT_TRUE(TestDie2.getAttrAsFlag(DW_AT_external));
+  EXPECT_EQ(TestDie2.getAttrAsAddr(DW_AT_low_pc, 0), 0x004004e0U);
+  EXPECT_EQ(TestDie2.getAttrAsRef(DW_AT_type, 0), 0x52U);
+  EXPECT_EQ(TestDie2.getAttrAsUnsigned(DW_AT_decl_file, 0), 1U);
+  EXPECT_EQ(TestDie2.getAttrAsSigned(DW_AT_decl_file, 0), 1);
+
+  // Test getting attributes that aren't there.
+  EXPECT_FALSE(TestDie.getAttrAsFlag(DW_AT_decl_line));
+  EXPECT_FALSE(TestDie.getAttrAsRef(DW_AT_decl_line).hasValue());
+  EXPECT_EQ(TestDie.getAttrAsUnsigned(DW_AT_decl_line, 12U), 12U);
+  EXPECT_EQ(TestDie.getAttrAsString(DW_AT_decl_line, "default"), "default");
+
+  // Forms are converted the same way as libdwarf.
+  try {
+    TestDie2.getAttrAsRef(DW_AT_decl_file);
+    ADD_FAILURE() << "Expected a LibDwarfError";
+  } catch (LibDwarfError &Err) {
+    EXPECT_EQ(Err.getErrorNumber(), static_cast<Dwarf_Unsigned>(
+                                        DW_DLE_BAD_REF_FORM));
+  }
+
+  // The Die is the last child.
+  ++IT;
+  ASSERT_FALSE(IT.atEnd());
+  EXPECT_EQ(IT->getTag(), DW_TAG_base_type);
+  ++IT;
+  EXPECT_TRUE(IT.atEnd());
+  EXPECT_EQ(IT, TestDie.childrenEnd());
+}
+
+TEST(NativeDwarfDecoder, UnsupportedFile) {
+  // Files the decoder can't read are left to libdwarf.
+  EXPECT_EQ(NativeDebugData::create(getTestInputFilePath("Test.txt")),
+            nullptr);
+  EXPECT_EQ(NativeDebugData::create(getTestInputFilePath("3Bytes.o")), nullptr);
+}
+
+TEST(NativeDwarfDecoder, MatchesLibDwarf) {
+  for (const char *Input : CrossCheckInputs) {
+    SCOPED_TRACE(Input);
+    std::string InputPath = getTestInputFilePath(Input);
+    auto Native = NativeDebugData::create(InputPath);
+    ASSERT_NE(Native, nullptr);
+
+    LibScopeView::FileDescriptor FD(InputPath);
+    DwarfDebugData DebugData(*FD);
+    auto CompileUnits = DebugData.getCompileUnits();
+    ASSERT_EQ(CompileUnits.size(), Native->getUnits().size());
+
+    for (size_t Index = 0; Index < CompileUnits.size(); ++Index) {
+      const auto &CU = CompileUnits[Index];
+      const NativeUnit &Unit = Native->getUnits()[Index];
+      EXPECT_EQ(Unit.HeaderOffset, CU.HeaderOffset);
+      EXPECT_EQ(Unit.NextHeaderOffset, CU.NextHeaderOffset);
+      EXPECT_TRUE(compareDies(DebugData, CU.CUDie,
+                              Native->getDie(CU.CUDie.getGlobalOffset())));
+
+      // The line tables match dwarf_srcfiles and dwarf_srclines_b.
+      NativeLineTable Lines = Native->getLineTable(CU.CUDie.getGlobalOffset());
+      EXPECT_EQ(Lines.FileNames, CU.CUDie.getSourceFiles());
+      DwarfLineTable ExpectedLines(CU.CUDie);
+      ASSERT_EQ(Lines.Rows.size(), ExpectedLines.size());
+      for (size_t Row = 0; Row < ExpectedLines.size(); ++Row)
+        EXPECT_EQ(describeRow(Lines.Rows[Row]), describeRow(ExpectedLines[Row]));
+      EXPECT_EQ(Native->getLineTable(CU.CUDie.getGlobalOffset(),
+                                     /*FilesOnly=*/true)
+                    .FileNames,
+                Lines.FileNames);
+    }
+  }
+}
+
+TEST(NativeDwarfDecoder, LineTableVersion5) {
+  // libdwarf can't read DWARF 5 line tables, so this is checked against
+  // readelf --debug-dump=decodedline.
+  auto TestData = NativeDebugData::create(
+      getTestInputFilePath("ElfDwarfReader/lines_dwarf5.o"));
+  ASSERT_NE(TestData, nullptr);
+  ASSERT_EQ(TestData->getUnits().size(), 1U);
+
+  NativeLineTable Lines =
+      TestData->getLineTable(TestData->getUnits()[0].FirstDieOffset);
+  EXPECT_EQ(Lines.Version, 5U);
+  // File numbers start at zero, which is the primary source file.
+  std::vector<std::string> ExpectedFiles = {"/tmp/diva_examples/lines.cpp",
+                                            "/tmp/diva_examples/lines.cpp"};
+  EXPECT_EQ(Lines.FileNames, ExpectedFiles);
+
+  const Dwarf_Addr ExpectedAddrs[] = {0x0,  0x4,  0xb,  0x12, 0x19,
+                                      0x1f, 0x25, 0x2b, 0x32};
+  const Dwarf_Unsigned ExpectedLineNos[] = {1, 6, 8, 10, 12, 12, 12, 13, 13};
+  ASSERT_EQ(Lines.Rows.size(), 9U);
+  for (size_t Row = 0; Row < Lines.Rows.size(); ++Row) {
+    EXPECT_EQ(Lines.Rows[Row].LineAddr, ExpectedAddrs[Row]);
+    EXPECT_EQ(Lines.Rows[Row].LineNo, ExpectedLineNos[Row]);
+    EXPECT_EQ(Lines.Rows[Row].SrcFileID, 1U);
+    EXPECT_EQ(Lines.Rows[Row].IsEndSequence != 0, Row == 8U);
+  }
+}
+
+TEST(NativeDwarfDecoder, TwoLevelLineTable) {
+  LineProgramBuilder Builder;
+  Builder.fixed(0, 4).fixed(0xf006, 2).fixed(0, 4);
+  size_t HeaderStart = Builder.size();
+  // minimum_instruction_length, maximum_operations_per_instruction,
+  // default_is_stmt, line_base, line_range, opcode_base and the standard
+  // opcode lengths.
+  Builder.bytes({1, 1, 1, 0xfb, 14, 16});
+  Builder.bytes({0, 1, 1, 1, 1, 0, 0, 0, 1, 0, 0, 1, 1, 2, 0});
+  // The marker, then the offsets of the logicals and actuals programs.
+  Builder.bytes({0, 0, 0, 0xff, 0xff, 0x7f, 0x7f});
+  size_t OffsetsStart = Builder.size();
+  Builder.fixed(0, 4).fixed(0, 4);
+  // The directories, files and subprograms.
+  Builder.bytes({1, DW_LNCT_path, DW_FORM_string, 1}).string("/src");
+  Builder.bytes({2, DW_LNCT_path, DW_FORM_string, DW_LNCT_directory_index,
+                 DW_FORM_udata, 1});
+  Builder.string("a.c").byte(1);
+  Builder.bytes({1, DW_LNCT_path, DW_FORM_string, 0});
+  Builder.patch(HeaderStart - 4U, Builder.size() - HeaderStart);
+  Builder.patch(OffsetsStart, Builder.size() - HeaderStart);
+
+  // The logicals program has a call to an inlined subprogram.
+  Builder.bytes({0, 9, DW_LNE_set_address}).fixed(0x1000, 8);
+  Builder.bytes({DW_LNS_advance_line, 9, DW_LNS_copy});
+  Builder.bytes({DW_LNS_inlined_call, 0, 1});
+  Builder.bytes({DW_LNS_advance_line, 10, DW_LNS_advance_pc, 4, DW_LNS_copy});
+  Builder.bytes({DW_LNS_pop_context, DW_LNS_advance_pc, 4, DW_LNS_copy});
+  Builder.bytes({DW_LNS_advance_pc, 2, 0, 1, DW_LNE_end_sequence});
+  // The actuals program isn't read.
+  Builder.patch(OffsetsStart + 4U, Builder.size() - HeaderStart);
+  Builder.bytes({DW_LNS_copy});
+  Builder.patch(0, Builder.size() - 4U);
+
+  NativeLineTable Lines =
+      decodeLineProgram(Builder.getSections(), 0, 8, "/comp");
+  EXPECT_EQ(Lines.Version, 0xf006U);
+  std::vector<std::string> ExpectedFiles = {"", "/src/a.c"};
+  EXPECT_EQ(Lines.FileNames, ExpectedFiles);
+  ASSERT_EQ(Lines.Rows.size(), 4U);
+  EXPECT_EQ(describeRow(Lines.Rows[0]),
+            "0x1000 line 10 file 1 flags 10000 isa 0 discriminator 0");
+  EXPECT_EQ(describeRow(Lines.Rows[1]),
+            "0x1004 line 20 file 1 flags 10000 isa 0 discriminator 0");
+  EXPECT_EQ(describeRow(Lines.Rows[2]),
+            "0x1008 line 10 file 1 flags 10000 isa 0 discriminator 0");
+  EXPECT_EQ(describeRow(Lines.Rows[3]),
+            "0x100a line 10 file 1 flags 11000 isa 0 discriminator 0");
+}
+
+TEST(NativeDwarfDecoder, MalformedLineTable) {
+  auto expectError = [](const LineProgramBuilder &Builder,
+                        Dwarf_Unsigned ErrorNumber) {
+    try {
+      decodeLineProgram(Builder.getSections(), 0, 8, "");
+      ADD_FAILURE() << "Expected a LibDwarfError";
+    } catch (LibDwarfError &Err) {
+      EXPECT_EQ(Err.getErrorNumber(), ErrorNumber);
+    }
+  };
+
+  // A version 2 header with no directories or files.
+  auto buildHeader = [](unsigned Version, Dwarf_Unsigned HeaderLength) {
+    LineProgramBuilder Builder;
+    Builder.fixed(0, 4).fixed(Version, 2).fixed(HeaderLength, 4);
+    Builder.bytes({1, 1, 0xfb, 14, 4, 0, 1, 1, 0, 0});
+    Builder.bytes({DW_LNS_copy});
+    Builder.patch(0, Builder.size() - 4U);
+    return Builder;
+  };
+  EXPECT_EQ(decodeLineProgram(buildHeader(2, 10).getSections(), 0, 8, "")
+                .Rows.size(),
+            1U);
+  expectError(buildHeader(1, 10), DW_DLE_VERSION_STAMP_ERROR);
+  expectError(buildHeader(2, 5), DW_DLE_LINE_PROLOG_LENGTH_BAD);
+
+  // The unit length is past the end of the section.
+  LineProgramBuilder Builder = buildHeader(2, 10);
+  Builder.patch(0, Builder.size());
+  expectError(Builder, DW_DLE_DEBUG_LINE_LENGTH_BAD);
+}
+
+TEST(NativeDwarfDecoder, StringCache) {
+  for (const char *Input : CrossCheckInputs) {
+    SCOPED_TRACE(Input);
+    std::string InputPath = getTestInputFilePath(Input);
+    auto Native = NativeDebugData::create(InputPath);
+    ASSERT_NE(Native, nullptr);
+    LibScopeView::FileDescriptor FD(InputPath);
+    DwarfDebugData DebugData(*FD);
+
+    // Both decoders give the same indexes as adding the names to the pool.
+    DwarfStringCache LibDwarfCache;
+    DwarfStringCache NativeCache;
+    for (const auto &CU : DebugData.getCompileUnits())
+      EXPECT_TRUE(compareNameIndexes(CU.CUDie,
+                                     Native->getDie(CU.CUDie.getGlobalOffset()),
+                                     LibDwarfCache, NativeCache));
+    EXPECT_EQ(LibDwarfCache.size(), NativeCache.size());
+    EXPECT_EQ(LibDwarfCache.getHits(), NativeCache.getHits());
+  }
+
+  // Names used by several Dies are only added to the pool once.
+  auto Native =
+      NativeDebugData::create(getTestInputFilePath("ElfDwarfReader/type.o"));
+  ASSERT_NE(Native, nullptr);
+  DwarfStringCache Cache;
+  const NativeUnit &Unit = Native->getUnits()[0];
+  NativeDie CUDie = Native->getDie(Unit.FirstDieOffset);
+  size_t Index = CUDie.decodeAttributes().getAttrAsStringIndex(DW_AT_name, Cache);
+  EXPECT_STREQ(LibScopeView::StringPool::getStringValue(Index), "type.cpp");
+  EXPECT_EQ(CUDie.decodeAttributes().getAttrAsStringIndex(DW_AT_name, Cache),
+            Index);
+}
@@ -174,6 +174,30 @@ TEST(FileUtilities, fileDescriptorOpenFileThatDoesntExist) {
       ".*ERR_FILEIO_OPEN_FAILURE.*Unable to open file '.*DoesntExist.bad'.");
 }
 
+TEST(FileUtilities, MappedFile) {
+  const std::string FilePath = getTestInputFilePath("Test.txt");
+  ASSERT_TRUE(doesFileExist(FilePath));
+
+  MappedFile File(FilePath);
+  ASSERT_NE(File.data(), nullptr);
+  ASSERT_EQ(File.size(), 4U);
+  EXPECT_EQ(std::string(File.data(), File.size()), "Test");
+
+  // Moving passes on the mapping.
+  MappedFile Moved(std::move(File));
+  EXPECT_EQ(File.data(), nullptr);
+  EXPECT_EQ(File.size(), 0U);
+  ASSERT_EQ(Moved.size(), 4U);
+  EXPECT_EQ(std::string(Moved.data(), Moved.size()), "Test");
+}
+
+TEST(FileUtilities, mappedFileOpenFileThatDoesntExist) {
+  const std::string FilePath = getTestInputFilePath("DoesntExist.bad");
+  EXPECT_EXIT(
+      { MappedFile File(FilePath); }, testing::ExitedWithCode(1),
+      ".*ERR_FILEIO_OPEN_FAILURE.*Unable to open file '.*DoesntExist.bad'.");
+}
+
 TEST(FileUtilities, doesFileExistFailsForFilesThatDontExist) {
   const std::string FileLocation = getTestInputFilePath("DoesntExist.elf");
   EXPECT_FALSE(doesFileExist(FileLocation));
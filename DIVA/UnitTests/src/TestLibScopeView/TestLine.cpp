@@ -80,7 +80,7 @@ TEST(Line, getAsText_Line_Attributes) {
   Line Ln(/*level*/ 3);
   Ln.setIsLineRecord();
 
-  // See Object::getAttributeInfoAsText() for why the indent is this size.
+  // See Object::appendAttributeInfo() for why the indent is this size.
   std::string AttrIndent(3 + 4 + 8 + ((Ln.getLevel() + 1) * 2), ' ');
 
   Ln.setIsNewStatement();
@@ -0,0 +1,155 @@
+//===-- UnitTests/TestLibScopeView/TestLineTable.cpp ------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for LibScopeView::LineTable.
+///
+//===----------------------------------------------------------------------===//
+
+#include "Line.h"
+#include "LineTable.h"
+#include "Reader.h"
+#include "Scope.h"
+#include "StringPool.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using namespace LibScopeView;
+
+TEST(LineTable, addRow) {
+  LineTable Table;
+  EXPECT_TRUE(Table.empty());
+
+  Table.addRow(0x1000, 10, 3, 0, lf_new_statement | lf_prologue_end);
+  Table.addRow(0x1008, 11, 4, 2, lf_end_sequence | lf_has_discriminator);
+  ASSERT_EQ(Table.size(), 2U);
+
+  EXPECT_EQ(Table.getAddress(0), 0x1000U);
+  EXPECT_EQ(Table.getLineNumber(0), 10U);
+  EXPECT_EQ(Table.getFileNameIndex(0), 3U);
+  EXPECT_EQ(Table.getDiscriminator(0), 0U);
+  EXPECT_TRUE(Table.getFlag(0, lf_new_statement));
+  EXPECT_TRUE(Table.getFlag(0, lf_prologue_end));
+  EXPECT_FALSE(Table.getFlag(0, lf_end_sequence));
+
+  EXPECT_EQ(Table.getAddress(1), 0x1008U);
+  EXPECT_EQ(Table.getLineNumber(1), 11U);
+  EXPECT_EQ(Table.getFileNameIndex(1), 4U);
+  EXPECT_EQ(Table.getDiscriminator(1), 2U);
+  EXPECT_EQ(Table.getFlags(1), lf_end_sequence | lf_has_discriminator);
+
+  // A row is much smaller than a Line.
+  EXPECT_GE(Table.getBytesReserved(), 2U * 19U);
+  Table.reserve(1000);
+  EXPECT_LT(Table.getBytesReserved(), 1000U * sizeof(Line) / 4U);
+}
+
+TEST(LineTable, LineView) {
+  Reader R(nullptr);
+  setReader(&R);
+
+  LineTable Table;
+  size_t FileIndex = StringPool::getStringIndex("test.cpp");
+  Table.addRow(0x5555, 52, FileIndex, 0, lf_basic_block);
+  Table.addRow(0x5560, 53, 99, 7,
+               lf_has_discriminator | lf_epilogue_begin | lf_invalid_filename);
+
+  Line Ln(1, Table);
+  Ln.setRow(0);
+  EXPECT_TRUE(Ln.getIsLine());
+  EXPECT_TRUE(Ln.getIsLineRecord());
+  EXPECT_EQ(Ln.getLineNumber(), 52U);
+  EXPECT_EQ(Ln.getAddress(), 0x5555U);
+  EXPECT_EQ(Ln.getFileName(false), "test.cpp");
+  EXPECT_FALSE(Ln.getInvalidFileName());
+  EXPECT_TRUE(Ln.getIsNewBasicBlock());
+  EXPECT_FALSE(Ln.getHasDiscriminator());
+  EXPECT_FALSE(Ln.getIsEpilogueBegin());
+
+  Ln.setRow(1);
+  EXPECT_EQ(Ln.getLineNumber(), 53U);
+  EXPECT_EQ(Ln.getAddress(), 0x5560U);
+  EXPECT_EQ(Ln.getFileNameIndex(), 99U);
+  EXPECT_TRUE(Ln.getInvalidFileName());
+  EXPECT_FALSE(Ln.getIsNewBasicBlock());
+  EXPECT_TRUE(Ln.getHasDiscriminator());
+  EXPECT_EQ(Ln.getDiscriminator(), 7U);
+  EXPECT_TRUE(Ln.getIsEpilogueBegin());
+
+  // The Object flags are kept between rows.
+  Ln.setHasPattern();
+  Ln.setRow(0);
+  EXPECT_TRUE(Ln.getHasPattern());
+  EXPECT_FALSE(Ln.getInvalidFileName());
+}
+
+TEST(LineTable, CompileUnitLines) {
+  Reader R(nullptr);
+  setReader(&R);
+
+  ScopeRoot Root(0);
+  auto *CU = new ScopeCompileUnit(1);
+  CU->setIsCompileUnit();
+  Root.addObject(CU);
+  auto *Func = new Scope(2);
+  Func->setIsFunction();
+  CU->addObject(Func);
+
+  LineTable Table;
+  Table.addRow(0x10, 1, 0, 0, lf_new_statement);
+  Table.addRow(0x20, 2, 0, 0, lf_new_statement);
+  Table.addRow(0x30, 3, 0, 0, lf_end_sequence);
+  CU->setLineTable(std::move(Table));
+  EXPECT_EQ(CU->getLineCount(), 3U);
+  EXPECT_TRUE(CU->getHasLines());
+  Root.propagateContentFlags();
+  EXPECT_TRUE(Root.getHasLines());
+
+  std::vector<uint64_t> LineNumbers;
+  CU->forEachLine([&](Line *Ln) {
+    EXPECT_EQ(Ln->getParent(), CU);
+    EXPECT_EQ(Ln->getLevel(), 2U);
+    EXPECT_FALSE(Ln->getHasPattern());
+    LineNumbers.push_back(Ln->getLineNumber());
+  });
+  EXPECT_EQ(LineNumbers, std::vector<uint64_t>({1, 2, 3}));
+
+  // A pattern on a child of the CU does not apply to the CU's lines.
+  Func->traverse(&Scope::getHasPattern, &Scope::setHasPattern,
+                 /*down=*/true);
+  EXPECT_TRUE(CU->getHasPattern());
+  CU->forEachLine([](Line *Ln) { EXPECT_FALSE(Ln->getHasPattern()); });
+
+  // A pattern on the CU applies to all of its lines.
+  CU->traverse(&Scope::getHasPattern, &Scope::setHasPattern, /*down=*/true);
+  size_t Count = 0;
+  CU->forEachLine([&](Line *Ln) {
+    EXPECT_TRUE(Ln->getHasPattern());
+    ++Count;
+  });
+  EXPECT_EQ(Count, 3U);
+}
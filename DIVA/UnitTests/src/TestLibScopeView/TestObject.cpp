@@ -27,6 +27,7 @@
 ///
 //===----------------------------------------------------------------------===//
 
+#include "Line.h"
 #include "Reader.h"
 #include "Symbol.h"
 #include "Type.h"
@@ -81,8 +82,8 @@ public:
     Type = object;
   }
 
-  std::string getAsText() const { return nullptr; };
-  std::string getAsYAML() const { return nullptr; };
+  void appendText(TextBuffer &) const override {}
+  void appendYAML(TextBuffer &) const override {}
 
   using Object::getCommonYAML;
 
@@ -304,3 +305,56 @@ TEST(Object, ResolveQualifiedName) {
     EXPECT_STREQ(Sym.getQualifiedName(), "NS1::NS2::");
   }
 }
+
+TEST(Object, Kind) {
+  TestObject Obj;
+  EXPECT_EQ(Obj.getKind(), ok_unknown);
+  EXPECT_EQ(dyn_cast<Element>(&Obj), nullptr);
+  EXPECT_EQ(dyn_cast<Scope>(&Obj), nullptr);
+
+  Line Ln;
+  EXPECT_EQ(Ln.getKind(), ok_line);
+  EXPECT_EQ(dyn_cast<Element>(&Ln), &Ln);
+  EXPECT_EQ(dyn_cast<Symbol>(&Ln), nullptr);
+
+  Symbol Sym;
+  EXPECT_EQ(Sym.getKind(), ok_symbol);
+  EXPECT_EQ(dyn_cast<Symbol>(&Sym), &Sym);
+  EXPECT_EQ(dyn_cast<Type>(&Sym), nullptr);
+
+  // Each Type is a Type but no other kind of Type.
+  Type Ty;
+  TypeImport Import;
+  TypeSubrange Subrange;
+  EXPECT_EQ(Ty.getKind(), ok_type);
+  EXPECT_EQ(Import.getKind(), ok_type_import);
+  EXPECT_EQ(Subrange.getKind(), ok_type_subrange);
+  EXPECT_EQ(dyn_cast<Type>(&Ty), &Ty);
+  EXPECT_EQ(dyn_cast<Type>(&Import), &Import);
+  EXPECT_EQ(dyn_cast<Type>(&Subrange), &Subrange);
+  EXPECT_EQ(dyn_cast<TypeImport>(&Ty), nullptr);
+  EXPECT_EQ(dyn_cast<TypeImport>(&Subrange), nullptr);
+  EXPECT_EQ(dyn_cast<Scope>(&Import), nullptr);
+  EXPECT_EQ(&cast<TypeImport>(Import), &Import);
+
+  // ScopeFunction includes inlined functions.
+  Scope Block;
+  ScopeFunction Func;
+  ScopeFunctionInlined Inlined;
+  ScopeRoot Root;
+  EXPECT_EQ(Block.getKind(), ok_scope);
+  EXPECT_EQ(Func.getKind(), ok_scope_function);
+  EXPECT_EQ(Inlined.getKind(), ok_scope_function_inlined);
+  EXPECT_EQ(Root.getKind(), ok_scope_root);
+  EXPECT_EQ(dyn_cast<Scope>(&Block), &Block);
+  EXPECT_EQ(dyn_cast<Scope>(&Root), &Root);
+  EXPECT_EQ(dyn_cast<ScopeFunction>(&Block), nullptr);
+  EXPECT_EQ(dyn_cast<ScopeFunction>(&Func), &Func);
+  EXPECT_EQ(dyn_cast<ScopeFunction>(&Inlined), &Inlined);
+  EXPECT_EQ(dyn_cast<ScopeFunctionInlined>(&Func), nullptr);
+  EXPECT_EQ(dyn_cast<Type>(&Root), nullptr);
+
+  const Object *ConstObj = &Func;
+  EXPECT_EQ(dyn_cast<Scope>(ConstObj), &Func);
+  EXPECT_EQ(dyn_cast<Scope>(static_cast<Object *>(nullptr)), nullptr);
+}
@@ -0,0 +1,130 @@
+//===-- UnitTests/TestLibScopeView/TestObjectArena.cpp ----------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for LibScopeView::ObjectArena.
+///
+//===----------------------------------------------------------------------===//
+
+#include "ObjectArena.h"
+#include "Reader.h"
+
+#include "gtest/gtest.h"
+
+#include <memory>
+
+using namespace LibScopeView;
+
+TEST(ObjectArena, create) {
+  ObjectArena Arena;
+  EXPECT_EQ(Arena.getObjectCount(), 0U);
+  EXPECT_EQ(Arena.getBlockCount(), 0U);
+
+  auto *Func = Arena.create<ScopeFunction>(/*Level*/ 2);
+  auto *Sym = Arena.create<Symbol>(3);
+  auto *Ty = Arena.create<TypeSubrange>(3);
+  auto *Ln = Arena.create<Line>(1U);
+
+  EXPECT_EQ(Func->getLevel(), 2U);
+  EXPECT_TRUE(Func->getIsArenaAllocated());
+  EXPECT_TRUE(Sym->getIsArenaAllocated());
+  EXPECT_TRUE(Ty->getIsArenaAllocated());
+  EXPECT_TRUE(Ln->getIsArenaAllocated());
+
+  // Usage is recorded by kind.
+  EXPECT_EQ(Arena.getObjectCount(), 4U);
+  EXPECT_EQ(Arena.getBytesUsed(ak_scope), sizeof(ScopeFunction));
+  EXPECT_EQ(Arena.getBytesUsed(ak_symbol), sizeof(Symbol));
+  EXPECT_EQ(Arena.getBytesUsed(ak_type), sizeof(TypeSubrange));
+  EXPECT_EQ(Arena.getBytesUsed(ak_line), sizeof(Line));
+  EXPECT_EQ(Arena.getBlockCount(), 1U);
+  EXPECT_GE(Arena.getBytesReserved(),
+            sizeof(ScopeFunction) + sizeof(Symbol) + sizeof(TypeSubrange) +
+                sizeof(Line));
+
+  // Objects are suitably aligned.
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(Sym) % alignof(Symbol), 0U);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(Ln) % alignof(Line), 0U);
+
+  // Objects created with new are not.
+  std::unique_ptr<Symbol> HeapSym(new Symbol());
+  EXPECT_FALSE(HeapSym->getIsArenaAllocated());
+}
+
+TEST(ObjectArena, ManyBlocks) {
+  ObjectArena Arena;
+  for (unsigned Index = 0; Index < 10000U; ++Index)
+    Arena.create<Line>(1U)->setLineNumber(Index);
+  EXPECT_EQ(Arena.getObjectCount(), 10000U);
+  EXPECT_EQ(Arena.getBytesUsed(ak_line), 10000U * sizeof(Line));
+  EXPECT_GT(Arena.getBlockCount(), 1U);
+  EXPECT_GE(Arena.getBytesReserved(), Arena.getBytesUsed(ak_line));
+}
+
+TEST(ObjectArena, ScopeTree) {
+  Reader R(nullptr);
+  setReader(&R);
+
+  ObjectArena Arena;
+  auto *Root = Arena.create<ScopeRoot>(0U);
+  auto *CU = Arena.create<ScopeCompileUnit>(1);
+  CU->setIsCompileUnit();
+  Root->addObject(CU);
+  CU->addObject(Arena.create<Symbol>(2));
+  CU->addObject(Arena.create<Type>(2));
+  CU->addObject(Arena.create<Line>(2));
+  EXPECT_EQ(CU->getChildren().size(), 2U);
+  EXPECT_EQ(CU->getLines().size(), 1U);
+
+  // The whole tree is released by the arena, the scopes don't delete their
+  // children.
+  Arena.clear();
+  EXPECT_EQ(Arena.getObjectCount(), 0U);
+  EXPECT_EQ(Arena.getBlockCount(), 0U);
+  EXPECT_EQ(Arena.getBytesReserved(), 0U);
+  EXPECT_EQ(Arena.getBytesUsed(ak_scope), 0U);
+
+  // The arena can be used again after it is cleared.
+  EXPECT_TRUE(Arena.create<Scope>(0)->getIsArenaAllocated());
+  EXPECT_EQ(Arena.getObjectCount(), 1U);
+}
+
+TEST(ObjectArena, merge) {
+  ObjectArena Arena;
+  ObjectArena Other;
+  Arena.create<Scope>(0);
+  Other.create<Scope>(0);
+  Other.create<Symbol>(1);
+
+  Arena.merge(Other);
+  EXPECT_EQ(Arena.getObjectCount(), 3U);
+  EXPECT_EQ(Arena.getBlockCount(), 2U);
+  EXPECT_EQ(Arena.getBytesUsed(ak_scope), 2U * sizeof(Scope));
+  EXPECT_EQ(Arena.getBytesUsed(ak_symbol), sizeof(Symbol));
+
+  EXPECT_EQ(Other.getObjectCount(), 0U);
+  EXPECT_EQ(Other.getBlockCount(), 0U);
+  EXPECT_EQ(Other.getBytesUsed(ak_scope), 0U);
+  EXPECT_EQ(Other.getBytesReserved(), 0U);
+}
@@ -27,6 +27,7 @@
 ///
 //===----------------------------------------------------------------------===//
 
+#include "PrintContext.h"
 #include "Reader.h"
 #include "Symbol.h"
 #include "Type.h"
@@ -39,6 +40,9 @@ using namespace LibScopeView;
 TEST(ObjectAttributes, getAttributesAsText) {
   Reader R(nullptr);
   setReader(&R);
+  // The widths of the attributes are fixed in this context's layout.
+  PrintContext Context;
+  ThreadPrintContext UseContext(Context);
 
   ScopeRoot Root(-1);
   Root.setIsRoot();
@@ -262,3 +266,53 @@ TEST(ObjectAttributes, getAttributesAsText) {
   EXPECT_EQ(Variable->getAttributesAsText(),    "");
   EXPECT_EQ(Typedef->getAttributesAsText(),     "");
 }
+
+// Test each print context lays out the attributes with its own options.
+TEST(ObjectAttributes, LayoutPerContext) {
+  Reader R(nullptr);
+  setReader(&R);
+
+  ScopeRoot Root(-1);
+  Root.setIsRoot();
+  ScopeCompileUnit *CompileUnit = new ScopeCompileUnit(0U);
+  CompileUnit->setIsCompileUnit();
+  CompileUnit->setDieOffset(0x0b);
+  CompileUnit->setDieTag(DW_TAG_compile_unit);
+  Root.addObject(CompileUnit);
+
+  CmdOptions ExtraOptions;
+  ExtraOptions.setAttributeOffset();
+  ExtraOptions.setAttributeLevel();
+  PrintContext Context;
+  PrintContext ExtraContext;
+  ExtraContext.getLayout().setOptions(ExtraOptions);
+
+  {
+    ThreadPrintContext UseContext(ExtraContext);
+    EXPECT_EQ(CompileUnit->getAttributesAsText(), "[0x0000000b]000");
+    EXPECT_EQ(ExtraContext.getLayout().getIndentationSize(), 15U);
+  }
+  {
+    ThreadPrintContext UseContext(Context);
+    EXPECT_EQ(CompileUnit->getAttributesAsText(), "");
+    EXPECT_EQ(Context.getLayout().getIndentationSize(), 0U);
+  }
+
+  // The lines under an object are indented past its context's attributes.
+  // See Object::appendAttributeInfo() for the other 15 columns.
+  Scope Block(1U);
+  Block.setIsBlock();
+  Block.setIsTryBlock();
+  R.getOptions().setPrintBlockAttributes();
+  {
+    ThreadPrintContext UseContext(ExtraContext);
+    EXPECT_EQ(Block.getAsText(), "{Block}\n" + std::string(15 + 15, ' ') +
+                                     "- try");
+  }
+  {
+    ThreadPrintContext UseContext(Context);
+    EXPECT_EQ(Block.getAsText(), "{Block}\n" + std::string(15, ' ') +
+                                     "- try");
+  }
+  EXPECT_FALSE(R.getOptions().getAttributeOffset());
+}
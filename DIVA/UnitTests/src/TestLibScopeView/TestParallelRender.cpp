@@ -0,0 +1,105 @@
+//===-- UnitTests/TestLibScopeView/TestParallelRender.cpp -------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for LibScopeView::renderInOrder.
+///
+//===----------------------------------------------------------------------===//
+
+#include "ParallelRender.h"
+
+#include "gtest/gtest.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace LibScopeView;
+
+namespace {
+
+// Render each item as its index, and collect the emitted text in order.
+std::vector<std::string> renderIndexes(size_t Count, unsigned Jobs) {
+  std::vector<std::string> Emitted;
+  renderInOrder(
+      Count, Jobs,
+      [](size_t Index, std::string &Text) { Text = std::to_string(Index); },
+      [&Emitted](size_t Index, std::string &Text) {
+        EXPECT_EQ(std::to_string(Index), Text);
+        Emitted.push_back(Text);
+      });
+  return Emitted;
+}
+
+std::vector<std::string> expectedIndexes(size_t Count) {
+  std::vector<std::string> Expected;
+  for (size_t Index = 0; Index < Count; ++Index)
+    Expected.push_back(std::to_string(Index));
+  return Expected;
+}
+
+} // namespace
+
+TEST(ParallelRender, Serial) {
+  EXPECT_TRUE(renderIndexes(0, 1).empty());
+  EXPECT_EQ(expectedIndexes(1), renderIndexes(1, 4));
+  EXPECT_EQ(expectedIndexes(10), renderIndexes(10, 1));
+  EXPECT_EQ(expectedIndexes(10), renderIndexes(10, 0));
+}
+
+TEST(ParallelRender, Ordered) {
+  EXPECT_TRUE(renderIndexes(0, 4).empty());
+  EXPECT_EQ(expectedIndexes(2), renderIndexes(2, 4));
+  EXPECT_EQ(expectedIndexes(100), renderIndexes(100, 3));
+  EXPECT_EQ(expectedIndexes(1000), renderIndexes(1000, 8));
+  // No more threads than items are started.
+  EXPECT_EQ(expectedIndexes(3), renderIndexes(3, 20000));
+}
+
+TEST(ParallelRender, RenderThrows) {
+  std::vector<size_t> Emitted;
+  EXPECT_THROW(renderInOrder(
+                   100, 4,
+                   [](size_t Index, std::string &) {
+                     if (Index == 10)
+                       throw std::runtime_error("render");
+                   },
+                   [&Emitted](size_t Index, std::string &) {
+                     Emitted.push_back(Index);
+                   }),
+               std::runtime_error);
+  // Nothing after the failed item is emitted.
+  ASSERT_LE(Emitted.size(), 10u);
+  for (size_t Index = 0; Index < Emitted.size(); ++Index)
+    EXPECT_EQ(Index, Emitted[Index]);
+}
+
+TEST(ParallelRender, EmitThrows) {
+  EXPECT_THROW(renderInOrder(100, 4, [](size_t, std::string &) {},
+                             [](size_t Index, std::string &) {
+                               if (Index == 5)
+                                 throw std::runtime_error("emit");
+                             }),
+               std::runtime_error);
+}
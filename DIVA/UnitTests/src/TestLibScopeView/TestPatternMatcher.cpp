@@ -0,0 +1,268 @@
+//===-- UnitTests/TestLibScopeView/TestPatternMatcher.cpp -------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for LibScopeView::PatternMatcher.
+///
+//===----------------------------------------------------------------------===//
+
+#include "PatternMatcher.h"
+#include "StringPool.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+using namespace LibScopeView;
+
+namespace {
+
+Match makeMatch(const char *Pattern, MatchMode Mode) {
+  Match M;
+  M.Pattern = Pattern;
+  M.Mode = Mode;
+  if (Mode == mm_regex)
+    M.RE = std::regex(Pattern);
+  return M;
+}
+
+const char *Inputs[] = {"",
+                        " ",
+                        "a",
+                        "ab",
+                        "abc",
+                        "aab",
+                        "main",
+                        "_main",
+                        "foo<int, char>",
+                        "operator==",
+                        "x1y22z333",
+                        "std::vector<int>",
+                        "tab\there",
+                        "line\nbreak",
+                        "-",
+                        "a-b]",
+                        "\xe9t\xe9",
+                        "aaaaaaaaaaaaaaaaaaaaaaaaaaaaab"};
+
+} // namespace
+
+TEST(PatternMatcher, Exact) {
+  PatternMatcher Matcher(
+      {makeMatch("main", mm_match), makeMatch("", mm_match),
+       makeMatch("ab", mm_match), makeMatch("main", mm_match)});
+  EXPECT_TRUE(Matcher.match("main"));
+  EXPECT_TRUE(Matcher.match(""));
+  EXPECT_TRUE(Matcher.match("ab"));
+  EXPECT_FALSE(Matcher.match("a"));
+  EXPECT_FALSE(Matcher.match("abc"));
+  EXPECT_FALSE(Matcher.match("_main"));
+
+  // Grow the table past its first size.
+  MatchInfo Many;
+  for (int Index = 0; Index < 100; ++Index)
+    Many.push_back(makeMatch(std::to_string(Index).c_str(), mm_match));
+  PatternMatcher ManyMatcher(Many);
+  for (int Index = 0; Index < 100; ++Index)
+    EXPECT_TRUE(ManyMatcher.match(std::to_string(Index).c_str()));
+  EXPECT_FALSE(ManyMatcher.match("100"));
+}
+
+TEST(PatternMatcher, Any) {
+  PatternMatcher Matcher({makeMatch("he", mm_any), makeMatch("she", mm_any),
+                          makeMatch("hers", mm_any), makeMatch("::", mm_any)});
+  EXPECT_TRUE(Matcher.match("ushers"));
+  EXPECT_TRUE(Matcher.match("sh he"));
+  EXPECT_TRUE(Matcher.match("std::vector"));
+  EXPECT_FALSE(Matcher.match("hs"));
+  EXPECT_FALSE(Matcher.match("s:h:e"));
+  EXPECT_FALSE(Matcher.match(""));
+
+  // The empty pattern is in every input.
+  PatternMatcher Empty({makeMatch("", mm_any)});
+  EXPECT_TRUE(Empty.match(""));
+  EXPECT_TRUE(Empty.match("abc"));
+
+  EXPECT_FALSE(PatternMatcher().match(""));
+}
+
+// Test the regular expressions match the same inputs as std::regex_match.
+TEST(PatternMatcher, Regex) {
+  const char *Patterns[] = {"",
+                            "a",
+                            "a*",
+                            "a+b",
+                            "a?b?c?",
+                            "(a|ab)(c|bcd)?",
+                            "(?:a|b)+",
+                            "a{2}b",
+                            "a{1,}b",
+                            "a{0,3}b?",
+                            "a*?b",
+                            ".*",
+                            ".+<.*>",
+                            "[a-c]+",
+                            "[^a-c]+",
+                            "[-a]+",
+                            "[a-]+",
+                            "[\\w<>, ]+",
+                            "\\w+\\d*",
+                            "\\D+",
+                            "\\s.*|.*\\S",
+                            "[^\\s]+",
+                            "\\x61b",
+                            "operator\\=\\=",
+                            "operator.*",
+                            "^main$",
+                            "^_?main",
+                            "a|^b|c$",
+                            "a$b",
+                            "^$",
+                            "\\s*$^$c*",
+                            "(^a|b)+",
+                            "std::\\w+<.*>",
+                            "()",
+                            "(a*)*b",
+                            "[\xe9t]+",
+                            ".*a.*",
+                            ".*ma.*",
+                            ".*.*",
+                            "(?:.*ab.*)",
+                            ".*\\n.*",
+                            ".*a.b.*",
+                            ".*a.*b"};
+  for (const char *Pattern : Patterns) {
+    std::regex RE(Pattern);
+    PatternMatcher Matcher({makeMatch(Pattern, mm_regex)});
+    EXPECT_EQ(Matcher.getFallbackCount(), 0U) << Pattern;
+    for (const char *Input : Inputs)
+      EXPECT_EQ(Matcher.match(Input), std::regex_match(Input, RE))
+          << "pattern '" << Pattern << "' input '" << Input << "'";
+  }
+}
+
+// Test the expressions a DFA cannot express are left to std::regex.
+TEST(PatternMatcher, RegexFallback) {
+  const char *Patterns[] = {"(a)\\1", "a\\b", "(?=a)ab", "[[:alpha:]]+",
+                            "(a|b){1000}"};
+  for (const char *Pattern : Patterns) {
+    std::regex RE(Pattern);
+    PatternMatcher Matcher({makeMatch(Pattern, mm_regex)});
+    EXPECT_EQ(Matcher.getFallbackCount(), 1U) << Pattern;
+    for (const char *Input : Inputs)
+      EXPECT_EQ(Matcher.match(Input), std::regex_match(Input, RE))
+          << "pattern '" << Pattern << "' input '" << Input << "'";
+  }
+}
+
+// Test the expressions are split into several DFAs, or left to std::regex,
+// when one DFA would be too large.
+TEST(PatternMatcher, RegexLimits) {
+  // The .*text.* expressions need no DFA.
+  MatchInfo Words;
+  for (int Index = 0; Index < 200; ++Index) {
+    std::string Pattern = ".*word" + std::to_string(Index) + ".*";
+    Words.push_back(makeMatch(Pattern.c_str(), mm_regex));
+  }
+  PatternMatcher WordMatcher(Words);
+  EXPECT_EQ(WordMatcher.getDfaCount(), 0U);
+  EXPECT_EQ(WordMatcher.getFallbackCount(), 0U);
+  EXPECT_TRUE(WordMatcher.match("a_word199_b"));
+  EXPECT_FALSE(WordMatcher.match("a_word_b"));
+  EXPECT_FALSE(WordMatcher.match("a_word19\n9_b"));
+  EXPECT_FALSE(WordMatcher.match("a_word199\n"));
+
+  // Only the expression whose own DFA is too large is left to std::regex.
+  PatternMatcher Large({makeMatch("main", mm_regex),
+                        makeMatch(".*a.{16}", mm_regex),
+                        makeMatch("x\\d+", mm_regex)});
+  EXPECT_EQ(Large.getFallbackCount(), 1U);
+  EXPECT_EQ(Large.getDfaCount(), 2U);
+  EXPECT_TRUE(Large.match("main"));
+  EXPECT_TRUE(Large.match("x123"));
+  EXPECT_TRUE(Large.match("za0123456789abcdef"));
+  EXPECT_FALSE(Large.match("za0123456789abcde"));
+
+  // Expressions that are small on their own but large together are split.
+  MatchInfo Split;
+  std::vector<std::regex> Expressions;
+  for (int Index = 0; Index < 12; ++Index) {
+    std::string Pattern = ".*" + std::string(1, 'a' + Index) + ".{8}";
+    Split.push_back(makeMatch(Pattern.c_str(), mm_regex));
+    Expressions.emplace_back(Pattern);
+  }
+  PatternMatcher SplitMatcher(Split);
+  EXPECT_EQ(SplitMatcher.getFallbackCount(), 0U);
+  EXPECT_GT(SplitMatcher.getDfaCount(), 1U);
+  const char *SplitInputs[] = {"b12345678", "xxc1234567", "abcdefghijkl",
+                               "l12345678", "m12345678", ""};
+  for (const char *Input : SplitInputs) {
+    bool Expected = false;
+    for (const std::regex &RE : Expressions)
+      Expected = Expected || std::regex_match(Input, RE);
+    EXPECT_EQ(SplitMatcher.match(Input), Expected) << Input;
+  }
+}
+
+// Test all the kinds of pattern together.
+TEST(PatternMatcher, Combined) {
+  PatternMatcher Matcher(
+      {makeMatch("main", mm_match), makeMatch("::", mm_any),
+       makeMatch("a+b", mm_regex), makeMatch("x\\d(y\\d+)+z\\d+", mm_regex),
+       makeMatch("(a)\\1b", mm_regex), makeMatch("", mm_none)});
+  EXPECT_EQ(Matcher.getFallbackCount(), 1U);
+  EXPECT_TRUE(Matcher.match("main"));
+  EXPECT_TRUE(Matcher.match("std::vector<int>"));
+  EXPECT_TRUE(Matcher.match("aab"));
+  EXPECT_TRUE(Matcher.match("x1y22z333"));
+  EXPECT_TRUE(Matcher.match("aab"));
+  EXPECT_FALSE(Matcher.match("abc"));
+  EXPECT_FALSE(Matcher.match("_main"));
+  EXPECT_FALSE(Matcher.match(""));
+}
+
+// Test the names are matched through the cache as they are directly.
+TEST(PatternMatcher, NameMatchCache) {
+  PatternMatcher Matcher({makeMatch("main", mm_match), makeMatch("b", mm_any)});
+  NameMatchCache Cache;
+  for (int Pass = 0; Pass < 2; ++Pass)
+    for (const char *Input : Inputs) {
+      size_t Index = StringPool::getStringIndex(Input);
+      EXPECT_EQ(Cache.match(Matcher, Index), Matcher.match(Input)) << Input;
+    }
+
+  // The results are forgotten when the patterns change.
+  size_t Index = StringPool::getStringIndex("main");
+  EXPECT_TRUE(Cache.match(Matcher, Index));
+  Matcher = PatternMatcher({makeMatch("_main", mm_match)});
+  Cache.clear();
+  EXPECT_FALSE(Cache.match(Matcher, Index));
+
+  // A copy starts empty, while the original keeps its results.
+  NameMatchCache Copy(Cache);
+  Matcher = PatternMatcher({makeMatch("main", mm_match)});
+  EXPECT_TRUE(Copy.match(Matcher, Index));
+  EXPECT_FALSE(Cache.match(Matcher, Index));
+}
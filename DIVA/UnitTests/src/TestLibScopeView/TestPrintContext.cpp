@@ -0,0 +1,94 @@
+//===-- UnitTests/TestLibScopeView/TestPrintContext.cpp ---------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for LibScopeView::PrintContext.
+///
+//===----------------------------------------------------------------------===//
+
+#include "PrintContext.h"
+#include "UtilsForTesting.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+using namespace LibScopeView;
+
+namespace {
+
+// Print the same text with the given buffer size, into the given file.
+void printText(size_t BufferSize, const std::string &FileName) {
+  clearTestOutputFile(FileName);
+
+  PrintContext Context;
+  Context.setBufferSize(BufferSize);
+  ASSERT_TRUE(Context.open(getTestOutputFilePath(FileName)));
+  Context.print("%s %d\n", "Line", 1);
+  Context.write("Text that is longer than the buffer");
+  Context.writeLine(std::string(" and more"));
+  Context.print("%s\n", std::string(40, 'x').c_str());
+  Context.write("", 0);
+  Context.print("%05d", 42);
+  Context.close();
+}
+
+} // namespace
+
+TEST(PrintContext, Buffering) {
+  const std::string Expected =
+      "Line 1\nText that is longer than the buffer and more\n" +
+      std::string(40, 'x') + "\n00042";
+
+  // Fragments that fit the buffer, and some that do not.
+  printText(16, "print_context_small.txt");
+  EXPECT_EQ(readTestOutputFile("print_context_small.txt"), Expected);
+
+  printText(PrintContext::DefaultBufferSize, "print_context_default.txt");
+  EXPECT_EQ(readTestOutputFile("print_context_default.txt"), Expected);
+
+  // No buffer.
+  printText(0, "print_context_none.txt");
+  EXPECT_EQ(readTestOutputFile("print_context_none.txt"), Expected);
+}
+
+TEST(PrintContext, FlushOnOpen) {
+  std::string Outer("print_context_outer.txt");
+  std::string Inner("print_context_inner.txt");
+  clearTestOutputFile(Outer);
+  clearTestOutputFile(Inner);
+
+  PrintContext Context;
+  ASSERT_TRUE(Context.open(getTestOutputFilePath(Outer)));
+  Context.print("outer ");
+  // The text buffered for the outer file stays with it.
+  ASSERT_TRUE(Context.open(getTestOutputFilePath(Inner)));
+  Context.print("inner");
+  Context.close();
+  Context.print("outer again");
+  Context.close();
+
+  EXPECT_EQ(readTestOutputFile(Outer), "outer outer again");
+  EXPECT_EQ(readTestOutputFile(Inner), "inner");
+}
@@ -29,11 +29,14 @@
 
 #include "Line.h"
 #include "Reader.h"
+#include "Symbol.h"
 #include "Type.h"
 
 #include "dwarf.h"
 #include "gtest/gtest.h"
 
+#include <algorithm>
+
 using namespace LibScopeView;
 
 TEST(Scope, getAsText_Alias) {
@@ -125,7 +128,7 @@ TEST(Scope, getAsText_Block) {
   Block.setIsBlock();
   EXPECT_EQ(Block.getAsText(), "{Block}");
 
-  // See Object::getAttributeInfoAsText() for why the indent is this size.
+  // See Object::appendAttributeInfo() for why the indent is this size.
   const std::string AttrIndent(3 + 4 + 8 + ((Block.getLevel() + 1) * 2), ' ');
 
   Scope TryBlock(/*Level*/ 3);
@@ -215,7 +218,7 @@ TEST(Scope, getAsText_Class) {
   Class.setName("TestClass");
   EXPECT_EQ(Class.getAsText(), "{Class} \"TestClass\"");
 
-  // See Object::getAttributeInfoAsText() for why the indent is this size.
+  // See Object::appendAttributeInfo() for why the indent is this size.
   R.getOptions().resetFormatIndentation();
   std::string AttrIndent(3 + 4 + 8, ' ');
   AttrIndent += "- ";
@@ -475,7 +478,7 @@ TEST(Scope, getAsText_Function) {
   Reader R(nullptr);
   setReader(&R);
 
-  // See Object::getAttributeInfoAsText() for why the indent is this size.
+  // See Object::appendAttributeInfo() for why the indent is this size.
   R.getOptions().resetFormatIndentation();
   std::string AttrIndent(3 + 4 + 8, ' ');
   AttrIndent += "- ";
@@ -574,7 +577,7 @@ TEST(Scope, getAsText_Function_Attributes) {
   Reader R(nullptr);
   setReader(&R);
 
-  // See Object::getAttributeInfoAsText() for why the indent is this size.
+  // See Object::appendAttributeInfo() for why the indent is this size.
   R.getOptions().resetFormatIndentation();
   std::string AttrIndent(3 + 4 + 8, ' ');
   AttrIndent += "- ";
@@ -917,7 +920,7 @@ TEST(Scope, getAsText_Struct) {
   Struct.setName("TestStruct");
   EXPECT_EQ(Struct.getAsText(), "{Struct} \"TestStruct\"");
 
-  // See Object::getAttributeInfoAsText() for why the indent is this size.
+  // See Object::appendAttributeInfo() for why the indent is this size.
   R.getOptions().resetFormatIndentation();
   std::string AttrIndent(3 + 4 + 8, ' ');
   AttrIndent += "- ";
@@ -1091,7 +1094,7 @@ TEST(Scope, getAsText_Union) {
   Union.setName("TestUnion");
   EXPECT_EQ(Union.getAsText(), "{Union} \"TestUnion\"");
 
-  // See Object::getAttributeInfoAsText() for why the indent is this size.
+  // See Object::appendAttributeInfo() for why the indent is this size.
   R.getOptions().resetFormatIndentation();
   std::string AttrIndent(3 + 4 + 8, ' ');
   AttrIndent += "- ";
@@ -1135,3 +1138,96 @@ TEST(Scope, notPrintedAsObject) {
   EXPECT_FALSE(ScopeArray().getIsPrintedAsObject());
   EXPECT_FALSE(ScopeRoot().getIsPrintedAsObject());
 }
+
+TEST(Scope, propagateContentFlags) {
+  Reader R(nullptr);
+  setReader(&R);
+
+  ScopeRoot Root(0);
+  auto *CU = new ScopeCompileUnit(1);
+  CU->setIsCompileUnit();
+  Root.addObject(CU);
+  auto *Func = new ScopeFunction(2);
+  Func->setIsFunction();
+  CU->addObject(Func);
+  auto *Var = new Symbol(3);
+  Var->setIsGlobalReference();
+  Func->addObject(Var);
+  auto *Typedef = new TypeDefinition(2);
+  CU->addObject(Typedef);
+
+  // Adding a child only sets the flags of its parent.
+  EXPECT_TRUE(Func->getHasSymbols());
+  EXPECT_TRUE(Func->getHasGlobals());
+  EXPECT_FALSE(Func->getHasLocals());
+  EXPECT_FALSE(CU->getHasSymbols());
+  EXPECT_FALSE(CU->getHasGlobals());
+  EXPECT_TRUE(CU->getHasTypes());
+  EXPECT_TRUE(Root.getHasScopes());
+  EXPECT_FALSE(Root.getHasTypes());
+
+  Root.propagateContentFlags();
+  EXPECT_TRUE(CU->getHasSymbols());
+  EXPECT_TRUE(CU->getHasGlobals());
+  EXPECT_TRUE(CU->getHasLocals());
+  EXPECT_TRUE(Root.getHasSymbols());
+  EXPECT_TRUE(Root.getHasTypes());
+  EXPECT_TRUE(Root.getHasGlobals());
+  EXPECT_FALSE(Root.getHasLines());
+  EXPECT_FALSE(Func->getHasScopes());
+  EXPECT_FALSE(Func->getHasTypes());
+  EXPECT_FALSE(Func->getHasLocals());
+}
+
+TEST(Scope, sortChildren) {
+  Reader R(nullptr);
+  setReader(&R);
+
+  ScopeRoot Root(0);
+  auto *Func = new ScopeFunction(1);
+  Func->setIsFunction();
+  Func->setName("b");
+  Func->setLineNumber(3);
+  Func->setDieOffset(0x10);
+  Root.addObject(Func);
+  auto *Var = new Symbol(1);
+  Var->setIsVariable();
+  Var->setName("b");
+  Var->setLineNumber(3);
+  Var->setDieOffset(0x20);
+  Root.addObject(Var);
+  auto *Member = new Symbol(1);
+  Member->setIsMember();
+  Member->setName("a");
+  Member->setLineNumber(5);
+  Member->setDieOffset(0x08);
+  Root.addObject(Member);
+  auto *Typedef = new TypeDefinition(1);
+  Typedef->setName("c");
+  Typedef->setLineNumber(1);
+  Typedef->setDieOffset(0x18);
+  Root.addObject(Typedef);
+
+  struct {
+    SortMode Mode;
+    SortFunction SortFunc;
+  } Modes[] = {{sr_kind, sortByKind},
+               {sr_line, sortByLine},
+               {sr_name, sortByName},
+               {sr_offset, sortByOffset}};
+  for (const auto &Mode : Modes) {
+    std::vector<Object *> Expected(Root.getChildren());
+    std::sort(Expected.begin(), Expected.end(), Mode.SortFunc);
+
+    Root.sortChildren(ObjectSorter(Mode.Mode));
+    EXPECT_EQ(Root.getChildren(), Expected);
+    // The lists of each kind keep the order of the children.
+    EXPECT_EQ(Root.getTypes(), std::vector<Type *>{Typedef});
+    EXPECT_EQ(Root.getScopes(), std::vector<Scope *>{Func});
+    std::vector<Symbol *> Symbols;
+    for (Object *Obj : Expected)
+      if (Obj->getIsSymbol())
+        Symbols.push_back(static_cast<Symbol *>(Obj));
+    EXPECT_EQ(Root.getSymbols(), Symbols);
+  }
+}
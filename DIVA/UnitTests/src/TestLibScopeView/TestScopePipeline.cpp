@@ -0,0 +1,161 @@
+//===-- UnitTests/TestLibScopeView/TestScopePipeline.cpp --------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for LibScopeView::ScopePipeline.
+///
+//===----------------------------------------------------------------------===//
+
+#include "Reader.h"
+#include "Scope.h"
+#include "ScopePipeline.h"
+#include "Symbol.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <thread>
+
+using namespace LibScopeView;
+
+namespace {
+
+// A pass that records the order it visits the objects in, per slot.
+class RecordingPass : public ScopePass {
+public:
+  RecordingPass(const char *Name) : ScopePass(Name) {}
+
+  void begin(size_t Slots) override {
+    ++Begins;
+    Visits.assign(Slots, std::string());
+    Threads.assign(Slots, std::thread::id());
+  }
+
+  void visitBefore(Object *Obj, size_t Slot) override {
+    Visits[Slot] += std::string("+") + Obj->getName();
+    Threads[Slot] = std::this_thread::get_id();
+  }
+
+  void visitAfter(Object *Obj, size_t Slot) override {
+    Visits[Slot] += std::string("-") + Obj->getName();
+  }
+
+  void end() override { ++Ends; }
+
+  unsigned Begins = 0;
+  unsigned Ends = 0;
+  std::vector<std::string> Visits;
+  std::vector<std::thread::id> Threads;
+};
+
+} // namespace
+
+// Test the passes are fused into as few traversals as their dependencies
+// allow.
+TEST(ScopePipeline, Schedule) {
+  RecordingPass A("A"), B("B"), C("C"), D("D"), E("E");
+  B.addDependency(A, dk_object);
+  C.addDependency(A, dk_tree);
+  D.addDependency(B, dk_object);
+  D.addDependency(C, dk_object);
+  E.addDependency(C, dk_tree);
+  RecordingPass NotAdded("NotAdded");
+  E.addDependency(NotAdded, dk_tree);
+
+  ScopePipeline Pipeline;
+  Pipeline.addPass(A);
+  Pipeline.addPass(B);
+  Pipeline.addPass(C);
+  Pipeline.addPass(D);
+  Pipeline.addPass(E);
+
+  auto Schedule = Pipeline.getSchedule();
+  ASSERT_EQ(Schedule.size(), 3U);
+  EXPECT_EQ(Schedule[0], (std::vector<ScopePass *>{&A, &B}));
+  EXPECT_EQ(Schedule[1], (std::vector<ScopePass *>{&C, &D}));
+  EXPECT_EQ(Schedule[2], (std::vector<ScopePass *>{&E}));
+}
+
+// Test the order and slots the objects are visited with.
+TEST(ScopePipeline, Visit) {
+  // Create a global reader object as Scope.AddObject uses it.
+  Reader R(nullptr);
+  setReader(&R);
+
+  Scope Root;
+  Root.setName("R");
+  Scope *Child1 = new Scope();
+  Child1->setName("a");
+  Symbol *Child1_Child1 = new Symbol();
+  Child1_Child1->setName("b");
+  Scope *Child2 = new Scope();
+  Child2->setName("c");
+  Root.addObject(Child1);
+  Child1->addObject(Child1_Child1);
+  Root.addObject(Child2);
+
+  RecordingPass First("First"), Second("Second");
+  Second.addDependency(First, dk_tree);
+  ScopePipeline Pipeline;
+  Pipeline.addPass(First);
+  Pipeline.addPass(Second);
+  Pipeline.run(Root, /*Jobs=*/1);
+
+  for (const RecordingPass *Pass : {&First, &Second}) {
+    EXPECT_EQ(Pass->Begins, 1U);
+    EXPECT_EQ(Pass->Ends, 1U);
+    EXPECT_EQ(Pass->Visits,
+              (std::vector<std::string>{"+R-R", "+a+b-b-a", "+c-c"}));
+  }
+}
+
+// Test the linked children of the root are visited in order by one thread.
+TEST(ScopePipeline, Links) {
+  // Create a global reader object as Scope.AddObject uses it.
+  Reader R(nullptr);
+  setReader(&R);
+
+  Scope Root;
+  Root.setName("R");
+  std::vector<Scope *> Children;
+  for (const char *Name : {"a", "b", "c", "d"}) {
+    Scope *Child = new Scope();
+    Child->setName(Name);
+    Root.addObject(Child);
+    Children.push_back(Child);
+  }
+  Symbol *Sym = new Symbol();
+  Sym->setName("s");
+  Children[3]->addObject(Sym);
+
+  RecordingPass Pass("Pass");
+  ScopePipeline Pipeline;
+  Pipeline.addPass(Pass);
+  Pipeline.addLink(Sym, Children[1]);
+  Pipeline.run(Root, /*Jobs=*/3);
+
+  EXPECT_EQ(Pass.Visits, (std::vector<std::string>{"+R-R", "+a-a", "+b-b",
+                                                   "+c-c", "+d+s-s-d"}));
+  EXPECT_EQ(Pass.Threads[2], Pass.Threads[4]);
+}
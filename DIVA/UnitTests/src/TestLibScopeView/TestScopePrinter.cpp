@@ -43,9 +43,9 @@ class TestNamePrinter : public ScopePrinter {
 public:
   using ScopePrinter::ScopePrinter;
 private:
-  void printImpl(const Object *Obj, std::ostream &OutputStream) override {
+  bool printBefore(const Object *Obj, std::ostream &OutputStream) override {
     OutputStream << Obj->getName() << '\n';
-    printChildren(Obj);
+    return true;
   }
   const std::string &getFileExtension() override {
     static std::string Ext = "txt";
@@ -61,6 +61,30 @@ private:
   }
 };
 
+// Test printer that notes each object it prints in a log, and skips the
+// children of the object with a given name.
+class TestLogPrinter : public ScopePrinter {
+public:
+  TestLogPrinter(std::string Id, std::vector<std::string> &Log,
+                 std::string Skipped = "")
+      : Id(Id), Log(Log), Skipped(Skipped) {}
+
+private:
+  bool printBefore(const Object *Obj, std::ostream &OutputStream) override {
+    Log.push_back(Id + ":" + Obj->getName());
+    OutputStream << Obj->getName() << '\n';
+    return Obj->getName() != Skipped;
+  }
+  const std::string &getFileExtension() override {
+    static std::string Ext = "log";
+    return Ext;
+  }
+
+  std::string Id;
+  std::vector<std::string> &Log;
+  std::string Skipped;
+};
+
 } // end anonymous namespace
 
 TEST(ScopePrinter, StandardPrint) {
@@ -124,3 +148,46 @@ TEST(ScopePrinter, SplitPrint) {
   EXPECT_EQ(readTestOutputFile(CUFilename2),
             "HEADER\ntest.cu.2\nChild3\nChild4\nFOOTER\n");
 }
+
+TEST(ScopePrinter, PrintWithPrinters) {
+  Reader R(nullptr);
+  setReader(&R);
+
+  ScopeRoot Root;
+  Root.setName("Root");
+  auto *CU = new ScopeCompileUnit;
+  Root.addObject(CU);
+  CU->setIsCompileUnit();
+  CU->setName("test.cu.3");
+  Scope *Child1 = new Scope;
+  Scope *Child2 = new Scope;
+  Child1->setName("Child1");
+  Child2->setName("Child2");
+  CU->addObject(Child1);
+  Child1->addObject(Child2);
+
+  std::string CUFilename("test_cu_3.log");
+  clearTestOutputFile(CUFilename);
+
+  // Each object is printed by each of the printers in turn, in one walk.
+  std::vector<std::string> Log;
+  TestLogPrinter Printer1("1", Log);
+  TestLogPrinter Printer2("2", Log, "Child1");
+  TestLogPrinter Printer3("3", Log);
+  std::stringstream Output1;
+  std::stringstream Output2;
+  Printer1.setOutput(Output1);
+  Printer2.setOutput(Output2);
+  Printer3.setOutputDir(getTestOutputDir());
+  ScopePrinter::print(&Root, {&Printer1, &Printer2, &Printer3}, 1);
+
+  std::vector<std::string> ExpectedLog = {
+      "1:Root",      "2:Root",      "1:test.cu.3", "2:test.cu.3",
+      "3:test.cu.3", "1:Child1",    "2:Child1",    "3:Child1",
+      "1:Child2",    "3:Child2"};
+  EXPECT_EQ(Log, ExpectedLog);
+  EXPECT_EQ(Output1.str(), "Root\ntest.cu.3\nChild1\nChild2\n");
+  EXPECT_EQ(Output2.str(), "Root\ntest.cu.3\nChild1\n");
+  ASSERT_TRUE(doesFileExist(getTestOutputFilePath(CUFilename)));
+  EXPECT_EQ(readTestOutputFile(CUFilename), "test.cu.3\nChild1\nChild2\n");
+}
@@ -0,0 +1,124 @@
+//===-- UnitTests/TestLibScopeView/TestScopeTextPrinter.cpp -----*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for LibScopeView::ScopeTextPrinter.
+///
+//===----------------------------------------------------------------------===//
+
+#include "Reader.h"
+
+#include "Reader.h"
+#include "ScopeTextPrinter.h"
+#include "ScopeYAMLPrinter.h"
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+
+using namespace LibScopeView;
+
+namespace {
+
+// Creates a root with two compile units.
+void createTree(ScopeRoot &Root) {
+  Root.setIsRoot();
+  Root.setName("Input.o");
+  auto *CU1 = new ScopeCompileUnit(0U);
+  CU1->setIsCompileUnit();
+  CU1->setName("a.cpp");
+  CU1->setDieOffset(0x0b);
+  Root.addObject(CU1);
+  auto *CU2 = new ScopeCompileUnit(0U);
+  CU2->setIsCompileUnit();
+  CU2->setName("b.cpp");
+  CU2->setDieOffset(0x2a);
+  Root.addObject(CU2);
+}
+
+// Prints the tree with a text printer, one with the DIE offsets and levels,
+// and a YAML printer, in one walk on up to Jobs threads.
+void printViews(const ScopeRoot &Root, unsigned Jobs, std::string &Text,
+                std::string &ExtraText, std::string &YAML) {
+  CmdOptions ExtraOptions;
+  ExtraOptions.setAttributeOffset();
+  ExtraOptions.setAttributeLevel();
+  ScopeTextPrinter Printer;
+  ScopeTextPrinter ExtraPrinter;
+  ExtraPrinter.setOptions(ExtraOptions);
+  ScopeYAMLPrinter YAMLPrinter("Input.o", "V0");
+
+  std::stringstream Output;
+  std::stringstream ExtraOutput;
+  std::stringstream YAMLOutput;
+  Printer.setOutput(Output);
+  ExtraPrinter.setOutput(ExtraOutput);
+  YAMLPrinter.setOutput(YAMLOutput);
+  ScopePrinter::print(&Root, {&Printer, &ExtraPrinter, &YAMLPrinter}, Jobs);
+  Text = Output.str();
+  ExtraText = ExtraOutput.str();
+  YAML = YAMLOutput.str();
+}
+
+} // end anonymous namespace
+
+TEST(ScopeTextPrinter, PrintWithOtherPrinters) {
+  Reader R(nullptr);
+  setReader(&R);
+  R.getOptions().setPrintScopes();
+
+  ScopeRoot Root(-1);
+  createTree(Root);
+
+  std::string Text;
+  std::string ExtraText;
+  std::string YAML;
+  printViews(Root, 1, Text, ExtraText, YAML);
+
+  // Each text printer has a layout of its own.
+  std::string Indent(11, ' ');
+  EXPECT_EQ(Text, Indent + "{InputFile} \"Input.o\"\n\n" + Indent +
+                      "{CompileUnit} \"a.cpp\"\n\n" + Indent +
+                      "{CompileUnit} \"b.cpp\"\n");
+  EXPECT_EQ(ExtraText, std::string(26, ' ') + "{InputFile} \"Input.o\"\n\n" +
+                           "[0x0000000b]000" + Indent +
+                           "{CompileUnit} \"a.cpp\"\n\n" +
+                           "[0x0000002a]000" + Indent +
+                           "{CompileUnit} \"b.cpp\"\n");
+  EXPECT_FALSE(R.getOptions().getAttributeOffset());
+
+  // The YAML is the same as when it is printed on its own.
+  std::stringstream YAMLOutput;
+  ScopeYAMLPrinter("Input.o", "V0").print(&Root, YAMLOutput);
+  EXPECT_EQ(YAML, YAMLOutput.str());
+
+  // The compile units are printed the same on several threads.
+  std::string JobsText;
+  std::string JobsExtraText;
+  std::string JobsYAML;
+  printViews(Root, 2, JobsText, JobsExtraText, JobsYAML);
+  EXPECT_EQ(JobsText, Text);
+  EXPECT_EQ(JobsExtraText, ExtraText);
+  EXPECT_EQ(JobsYAML, YAML);
+}
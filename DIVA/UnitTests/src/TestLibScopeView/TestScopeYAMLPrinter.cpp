@@ -39,8 +39,9 @@ namespace {
 class FakeObject : public Scope {
 public:
   FakeObject(std::string FakeName) : FakeName(FakeName) {}
-  std::string getAsYAML() const override {
-    return std::string("object: Fake\nname: ") + FakeName;
+  void appendYAML(TextBuffer &YAML) const override {
+    YAML.append("object: Fake\nname: ");
+    YAML.append(FakeName);
   }
   std::string FakeName;
 };
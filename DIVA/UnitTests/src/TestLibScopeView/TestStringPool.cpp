@@ -0,0 +1,125 @@
+//===-- UnitTests/TestStringPool.cpp ----------------------------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for LibScopeView::StringPool.
+///
+//===----------------------------------------------------------------------===//
+
+#include "StringPool.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace LibScopeView;
+
+TEST(StringPool, EmptyString) {
+  // The empty string, and no string at all, are always index 0.
+  EXPECT_EQ(StringPool::getStringIndex(""), 0U);
+  EXPECT_EQ(StringPool::getStringIndex(nullptr), 0U);
+  EXPECT_EQ(StringPool::getStringIndex(std::string()), 0U);
+  EXPECT_STREQ(StringPool::getStringValue(0), "");
+}
+
+TEST(StringPool, Deduplicate) {
+  size_t Index = StringPool::getStringIndex("StringPool.Deduplicate");
+  EXPECT_NE(Index, 0U);
+  EXPECT_EQ(StringPool::getStringIndex(std::string("StringPool.Deduplicate")),
+            Index);
+  EXPECT_STREQ(StringPool::getStringValue(Index), "StringPool.Deduplicate");
+
+  // Strings that share a prefix are different strings.
+  size_t Prefix = StringPool::getStringIndex("StringPool.Dedup");
+  EXPECT_NE(Prefix, Index);
+  EXPECT_STREQ(StringPool::getStringValue(Prefix), "StringPool.Dedup");
+}
+
+TEST(StringPool, ManyStrings) {
+  // Enough strings to grow the tables and the storage several times. The
+  // strings returned earlier stay valid.
+  std::vector<size_t> Indexes;
+  std::vector<const char *> Values;
+  for (unsigned Index = 0; Index < 50000U; ++Index) {
+    std::string Str = "StringPool.ManyStrings." + std::to_string(Index);
+    Indexes.push_back(StringPool::getStringIndex(Str));
+    Values.push_back(StringPool::getStringValue(Indexes.back()));
+  }
+  for (unsigned Index = 0; Index < 50000U; ++Index) {
+    std::string Str = "StringPool.ManyStrings." + std::to_string(Index);
+    EXPECT_EQ(StringPool::getStringIndex(Str), Indexes[Index]);
+    EXPECT_EQ(Values[Index], Str);
+    EXPECT_EQ(StringPool::getStringValue(Indexes[Index]), Str);
+  }
+}
+
+TEST(StringPool, Threads) {
+  // Threads adding the same strings all get the same indexes.
+  const unsigned NumThreads = 4U;
+  const unsigned NumStrings = 20000U;
+  std::vector<std::vector<size_t>> Indexes(NumThreads);
+  std::vector<std::thread> Threads;
+  for (unsigned Thread = 0; Thread < NumThreads; ++Thread) {
+    Threads.emplace_back([&Indexes, Thread, NumStrings]() {
+      for (unsigned Index = 0; Index < NumStrings; ++Index) {
+        std::string Str = "StringPool.Threads." + std::to_string(Index);
+        size_t StrIndex = StringPool::getStringIndex(Str);
+        if (Str != StringPool::getStringValue(StrIndex))
+          StrIndex = 0;
+        Indexes[Thread].push_back(StrIndex);
+      }
+    });
+  }
+  for (std::thread &Thread : Threads)
+    Thread.join();
+
+  for (unsigned Index = 0; Index < NumStrings; ++Index) {
+    EXPECT_NE(Indexes[0][Index], 0U);
+    for (unsigned Thread = 1; Thread < NumThreads; ++Thread)
+      EXPECT_EQ(Indexes[Thread][Index], Indexes[0][Index]);
+  }
+}
+
+TEST(StringPool, BigStrings) {
+  // Strings bigger than the storage chunks, either side of strings that fill
+  // chunks.
+  std::string Big(3U << 20, 'b');
+  size_t BigIndex = StringPool::getStringIndex(Big);
+  std::vector<std::string> Medium;
+  std::vector<size_t> MediumIndexes;
+  for (char Ch = 'c'; Ch < 'k'; ++Ch) {
+    Medium.emplace_back(300000U, Ch);
+    MediumIndexes.push_back(StringPool::getStringIndex(Medium.back()));
+  }
+  std::string Exact((1U << 20) - 1U, 'k');
+  size_t ExactIndex = StringPool::getStringIndex(Exact);
+
+  EXPECT_EQ(StringPool::getStringValue(BigIndex), Big);
+  EXPECT_EQ(StringPool::getStringIndex(Big), BigIndex);
+  for (size_t Index = 0; Index < Medium.size(); ++Index)
+    EXPECT_EQ(StringPool::getStringValue(MediumIndexes[Index]), Medium[Index]);
+  EXPECT_EQ(StringPool::getStringValue(ExactIndex), Exact);
+}
@@ -0,0 +1,121 @@
+//===-- UnitTests/TestLibScopeView/TestTextBuffer.cpp -----------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for LibScopeView::TextBuffer.
+///
+//===----------------------------------------------------------------------===//
+
+
+#include "TextBuffer.h"
+
+#include "gtest/gtest.h"
+
+#include <climits>
+#include <cstdarg>
+#include <string>
+
+using namespace LibScopeView;
+
+namespace {
+
+void appendFormatted(TextBuffer &Buffer, const char *Fmt, ...) {
+  va_list Args;
+  va_start(Args, Fmt);
+  Buffer.appendFormatted(Fmt, Args);
+  va_end(Args);
+}
+
+} // namespace
+
+TEST(TextBuffer, Append) {
+  TextBuffer Buffer;
+  EXPECT_TRUE(Buffer.empty());
+
+  Buffer.append('{');
+  Buffer.append("Kind");
+  Buffer.append(std::string("} "));
+  Buffer.append("\"Name\" extra", 6);
+  Buffer.append(3, '-');
+  EXPECT_EQ(Buffer.str(), "{Kind} \"Name\"---");
+  EXPECT_EQ(Buffer.size(), Buffer.str().size());
+
+  Buffer.clear();
+  EXPECT_TRUE(Buffer.empty());
+  EXPECT_EQ(Buffer.str(), "");
+}
+
+TEST(TextBuffer, AppendDecimal) {
+  TextBuffer Buffer;
+  Buffer.appendDecimal(0);
+  Buffer.append(' ');
+  Buffer.appendDecimal(-42);
+  Buffer.append(' ');
+  Buffer.appendDecimal(42U);
+  EXPECT_EQ(Buffer.str(), "0 -42 42");
+
+  Buffer.clear();
+  Buffer.appendDecimal(LLONG_MIN);
+  Buffer.append(' ');
+  Buffer.appendDecimal(LLONG_MAX);
+  Buffer.append(' ');
+  Buffer.appendDecimal(ULLONG_MAX);
+  EXPECT_EQ(Buffer.str(), std::to_string(LLONG_MIN) + " " +
+                              std::to_string(LLONG_MAX) + " " +
+                              std::to_string(ULLONG_MAX));
+}
+
+TEST(TextBuffer, AppendHex) {
+  TextBuffer Buffer;
+  Buffer.appendHex(0);
+  Buffer.append(' ');
+  Buffer.appendHex(0xbeef, 8);
+  Buffer.append(' ');
+  Buffer.appendHex(0x123456789aULL, 8);
+  Buffer.append(' ');
+  Buffer.appendHex(UINT64_MAX);
+  EXPECT_EQ(Buffer.str(), "0 0000beef 123456789a ffffffffffffffff");
+}
+
+TEST(TextBuffer, AppendRight) {
+  TextBuffer Buffer;
+  Buffer.appendRight("12", 5);
+  Buffer.append('|');
+  Buffer.appendRight("123456", 5);
+  Buffer.append('|');
+  Buffer.appendRight("", 2);
+  EXPECT_EQ(Buffer.str(), "   12|123456|  ");
+}
+
+TEST(TextBuffer, AppendFormatted) {
+  TextBuffer Buffer;
+  Buffer.append('>');
+  appendFormatted(Buffer, "%s=%d", "Value", 7);
+  EXPECT_EQ(Buffer.str(), ">Value=7");
+
+  // Text longer than the buffer vsnprintf is first given.
+  std::string Long(1000, 'x');
+  appendFormatted(Buffer, "[%s]", Long.c_str());
+  EXPECT_EQ(Buffer.str(), ">Value=7[" + Long + "]");
+}
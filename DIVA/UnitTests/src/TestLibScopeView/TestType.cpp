@@ -251,7 +251,7 @@ TEST(Type, getAsText_PrimitiveType) {
   Ty.setName("qaz");
   EXPECT_EQ(Ty.getAsText(), "{PrimitiveType} -> \"qaz\"");
 
-  // See Object::getAttributeInfoAsText() for why the indent is this size.
+  // See Object::appendAttributeInfo() for why the indent is this size.
   std::string AttrIndent(3 + 4 + 8 + ((Ty.getLevel() + 1) * 2), ' ');
 
   Ty.setByteSize(4);
@@ -35,6 +35,9 @@
 
 #include "gtest/gtest.h"
 
+#include <regex>
+#include <string>
+
 using namespace LibScopeView;
 
 TEST(ViewSpecification, PrintObject_Line) {
@@ -149,3 +152,38 @@ TEST(ViewSpecification, PrintObject_Type) {
 
 #undef CHECK_TYPE_PRINT_OPTION
 }
+
+TEST(ViewSpecification, ManyPatterns) {
+  ViewSpecification Spec;
+  // Many patterns of each mode are compiled together once they are added.
+  for (int Index = 0; Index < 1000; ++Index) {
+    std::string Number = std::to_string(Index);
+    Match Exact;
+    Exact.Pattern = "name" + Number;
+    Exact.Mode = mm_match;
+    Spec.addFilterPattern(Exact);
+    Match Any;
+    Any.Pattern = "word" + Number;
+    Any.Mode = mm_any;
+    Spec.addFilterPattern(Any);
+    Match Regex;
+    Regex.Pattern = "re" + Number + ".*z";
+    Regex.RE = std::regex(Regex.Pattern);
+    Regex.Mode = mm_regex;
+    Spec.addFilterPattern(Regex);
+    Match Tree;
+    Tree.Pattern = ".*tree" + Number + ".*";
+    Tree.RE = std::regex(Tree.Pattern);
+    Tree.Mode = mm_regex;
+    Spec.addTreePattern(Tree);
+  }
+  Spec.compilePatterns();
+
+  EXPECT_TRUE(Spec.matchFilterPattern("name999"));
+  EXPECT_FALSE(Spec.matchFilterPattern("name1000"));
+  EXPECT_TRUE(Spec.matchFilterPattern("a_word512_b"));
+  EXPECT_TRUE(Spec.matchFilterPattern("re77_xyz"));
+  EXPECT_FALSE(Spec.matchFilterPattern("re77_xy"));
+  EXPECT_TRUE(Spec.matchTreePattern("the_tree640_node"));
+  EXPECT_FALSE(Spec.matchTreePattern("the_tre640_node"));
+}
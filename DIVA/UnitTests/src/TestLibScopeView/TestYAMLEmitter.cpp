@@ -0,0 +1,98 @@
+//===-- UnitTests/TestLibScopeView/TestYAMLEmitter.cpp ----------*- C++ -*-===//
+///
+/// Copyright (c) 2017 by Sony Interactive Entertainment Inc.
+///
+/// Permission is hereby granted, free of charge, to any person obtaining a copy
+/// of this software and associated documentation files (the "Software"), to
+/// deal in the Software without restriction, including without limitation the
+/// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+/// sell copies of the Software, and to permit persons to whom the Software is
+/// furnished to do so, subject to the following conditions:
+///
+/// The above copyright notice and this permission notice shall be included in
+/// all copies or substantial portions of the Software.
+///
+/// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+/// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+/// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+/// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+/// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+/// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+/// IN THE SOFTWARE.
+///
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Tests for LibScopeView::YAMLEmitter.
+///
+//===----------------------------------------------------------------------===//
+
+
+#include "YAMLEmitter.h"
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+
+using namespace LibScopeView;
+
+namespace {
+
+TextBuffer makeMapping(const char *YAML) {
+  TextBuffer Mapping;
+  Mapping.append(YAML);
+  return Mapping;
+}
+
+} // namespace
+
+TEST(YAMLEmitter, Nested) {
+  std::stringstream Output;
+  YAMLEmitter Emitter(2);
+  Emitter.setOutput(Output);
+
+  Emitter.emitItem(makeMapping("object: A\nattributes:\n  x: 1"));
+  Emitter.beginChildren();
+  Emitter.emitItem(makeMapping("object: B"));
+  Emitter.beginChildren();
+  Emitter.endChildren();
+  Emitter.emitItem(makeMapping("object: C"));
+  Emitter.emitNoChildren();
+  Emitter.endChildren();
+  EXPECT_EQ(Emitter.getDepth(), 1U);
+
+  // Nothing is written until the emitter is flushed.
+  EXPECT_EQ(Output.str(), "");
+  Emitter.flush();
+
+  std::string Expected("  - object: A\n"
+                       "    attributes:\n"
+                       "      x: 1\n"
+                       "    children:\n"
+                       "      - object: B\n"
+                       "        children: []\n"
+                       "      - object: C\n"
+                       "        children: []\n");
+  EXPECT_EQ(Output.str(), Expected);
+}
+
+TEST(YAMLEmitter, IndentSize) {
+  std::stringstream Output;
+  YAMLEmitter Emitter(4);
+  Emitter.setOutput(Output);
+
+  Emitter.emitItem(makeMapping("object: A\n"));
+  Emitter.beginChildren();
+  Emitter.emitItem(makeMapping("object: B\nname: b"));
+  Emitter.emitNoChildren();
+  Emitter.endChildren();
+  Emitter.flush();
+
+  std::string Expected("    - object: A\n"
+                       "      children:\n"
+                       "            - object: B\n"
+                       "              name: b\n"
+                       "              children: []\n");
+  EXPECT_EQ(Output.str(), Expected);
+}